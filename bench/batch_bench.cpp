@@ -0,0 +1,102 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   batch_bench.cpp                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/07/07 21:29:06 by etran             #+#    #+#             */
+/*   Updated: 2024/07/07 21:29:06 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "batch.h"
+#include "bench.h"
+
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace math;
+
+/**
+ * @brief Each kernel against the loop over single elements it replaced,
+ * in ns per element.
+ */
+static
+void _run(const std::size_t count) {
+    // Enough runs per sample to time small batches
+    const u32 runs = (u32)(1000000 / count);
+    const u64 items = (u64)runs * count;
+
+    std::mt19937 generator(3);
+    std::uniform_real_distribution<f32> distribution(-100.0f, 100.0f);
+    Vect3Soa lhs(count);
+    Vect3Soa rhs(count);
+    Vect3Soa halfExtents(count);
+    Vect3Soa transformed(count);
+    std::vector<f32> result(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        lhs.set(i, Vect3(distribution(generator), distribution(generator), distribution(generator)));
+        rhs.set(i, Vect3(distribution(generator), distribution(generator), distribution(generator)));
+        halfExtents.set(i, Vect3(
+            std::fabs(distribution(generator)),
+            std::fabs(distribution(generator)),
+            std::fabs(distribution(generator))));
+    }
+    Mat4 mat;
+    for (u32 i = 0; i < 16; ++i)
+        mat[i] = distribution(generator) / 100.0f;
+    const Vect4 plane(normalize(Vect3(distribution(generator), distribution(generator), distribution(generator))), 10.0f);
+
+    const std::string suffix = ", n = " + std::to_string(count);
+
+    bench::report(("transform" + suffix).c_str(), bench::measure(items, [&] {
+        for (u32 run = 0; run < runs; ++run) {
+            transform(mat, lhs, transformed);
+            bench::keep(transformed.x[0]);
+        }
+    }));
+    bench::report(("Mat4 * Vect3 loop" + suffix).c_str(), bench::measure(items, [&] {
+        for (u32 run = 0; run < runs; ++run) {
+            for (std::size_t i = 0; i < count; ++i)
+                transformed.set(i, mat * lhs.get(i));
+            bench::keep(transformed.x[0]);
+        }
+    }));
+
+    bench::report(("dot" + suffix).c_str(), bench::measure(items, [&] {
+        for (u32 run = 0; run < runs; ++run) {
+            dot(lhs, rhs, result);
+            bench::keep(result[0]);
+        }
+    }));
+    bench::report(("dot loop" + suffix).c_str(), bench::measure(items, [&] {
+        for (u32 run = 0; run < runs; ++run) {
+            for (std::size_t i = 0; i < count; ++i)
+                result[i] = dot(lhs.get(i), rhs.get(i));
+            bench::keep(result[0]);
+        }
+    }));
+
+    bench::report(("planeDistance" + suffix).c_str(), bench::measure(items, [&] {
+        for (u32 run = 0; run < runs; ++run) {
+            planeDistance(plane, lhs, halfExtents, result);
+            bench::keep(result[0]);
+        }
+    }));
+    bench::report(("planeDistance loop" + suffix).c_str(), bench::measure(items, [&] {
+        for (u32 run = 0; run < runs; ++run) {
+            for (std::size_t i = 0; i < count; ++i)
+                result[i] = planeDistance(plane, lhs.get(i), halfExtents.get(i));
+            bench::keep(result[0]);
+        }
+    }));
+}
+
+int main() {
+    // A handful of boxes, a render distance worth of chunks, a large batch
+    for (const std::size_t count: { 7, 256, 4096 })
+        _run(count);
+}
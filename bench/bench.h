@@ -0,0 +1,81 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   bench.h                                            :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/07/07 18:40:12 by etran             #+#    #+#             */
+/*   Updated: 2024/07/07 19:02:51 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#pragma once
+
+#include "types.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+
+namespace bench {
+
+static constexpr u32    REPEATS = 5;
+
+/**
+ * @brief Keeps the compiler from optimizing a result away.
+ */
+template <typename T>
+inline void keep(const T& value) noexcept {
+    asm volatile("" : : "r"(&value) : "memory");
+}
+
+/**
+ * @return Nanoseconds taken by one call to `function`.
+ */
+template <typename Function>
+f64 time(Function&& function) {
+    const auto start = std::chrono::steady_clock::now();
+    function();
+    return std::chrono::duration<f64, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * @brief Runs `function` REPEATS times, keeps the fastest run.
+ *
+ * @return Nanoseconds per item, `function` handling `items` items per run.
+ */
+template <typename Function>
+f64 measure(const u64 items, Function&& function) {
+    f64 best = std::numeric_limits<f64>::max();
+    for (u32 repeat = 0; repeat < REPEATS; ++repeat)
+        best = std::min(best, time(function));
+    return best / items;
+}
+
+/**
+ * @brief Prints the time per item and the matching rate, in readable units.
+ */
+inline void report(const char* name, const f64 nanoseconds) {
+    constexpr std::array<const char*, 4>    TIME_UNITS = { "ns", "us", "ms", "s" };
+    constexpr std::array<const char*, 4>    RATE_UNITS = { "/s", "k/s", "M/s", "G/s" };
+
+    f64 time = nanoseconds;
+    u32 timeUnit = 0;
+    for (; time >= 1000.0 && timeUnit + 1 < TIME_UNITS.size(); ++timeUnit)
+        time /= 1000.0;
+
+    f64 rate = 1e9 / nanoseconds;
+    u32 rateUnit = 0;
+    for (; rate >= 1000.0 && rateUnit + 1 < RATE_UNITS.size(); ++rateUnit)
+        rate /= 1000.0;
+
+    std::cout << std::left << std::setw(40) << name << std::right << std::fixed << std::setprecision(2)
+        << std::setw(10) << time << " " << std::left << std::setw(4) << TIME_UNITS[timeUnit] << std::right
+        << std::setw(10) << rate << " " << RATE_UNITS[rateUnit] << std::endl;
+}
+
+} // namespace bench
@@ -0,0 +1,172 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   block_pool_bench.cpp                               :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/07/07 23:19:30 by etran             #+#    #+#             */
+/*   Updated: 2024/07/07 23:19:30 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "block_pool.h"
+#include "block.h"
+#include "counter_rng.h"
+#include "game_decl.h"
+#include "bench.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+using mem::BlockPool;
+
+static constexpr std::size_t    BLOCK_SIZE = sizeof(game::Block) * CHUNK_VOLUME;
+static constexpr u32            CAPACITY = RENDER_VOLUME;
+
+/**
+ * @brief Chunk payloads from the pool, as World does.
+ */
+struct PoolAllocator {
+    BlockPool   m_pool;
+
+    PoolAllocator() { m_pool.init(BLOCK_SIZE, CAPACITY); }
+    ~PoolAllocator() { m_pool.destroy(); }
+
+    void*   acquire() { return m_pool.acquire(); }
+    void    release(void* block) noexcept { m_pool.release(block); }
+};
+
+/**
+ * @brief Same blocks from the global heap, with the pool alignment.
+ */
+struct HeapAllocator {
+    void*   acquire() { return ::operator new(BLOCK_SIZE, std::align_val_t(BlockPool::BLOCK_ALIGNMENT)); }
+    void    release(void* block) noexcept { ::operator delete(block, std::align_val_t(BlockPool::BLOCK_ALIGNMENT)); }
+};
+
+/**
+ * @brief Half of the chunks dense, then `count` random chunks switching
+ * between dense and height field. Payloads are filled like a materialized
+ * chunk when `fill` is set.
+ */
+template <typename Allocator>
+static
+void _churn(Allocator& allocator, std::vector<void*>& blocks, const u32 count, const u64 seed, const bool fill) {
+    proc::CounterRng rng(seed);
+    for (u32 i = 0; i < count; ++i) {
+        void*& block = blocks[rng.nextBelow(blocks.size())];
+        if (block != nullptr) {
+            allocator.release(block);
+            block = nullptr;
+        } else {
+            block = allocator.acquire();
+            if (fill)
+                std::memset(block, (u8)i, BLOCK_SIZE);
+        }
+    }
+}
+
+template <typename Allocator>
+static
+void _releaseAll(Allocator& allocator, std::vector<void*>& blocks) {
+    for (void*& block: blocks) {
+        allocator.release(block);
+        block = nullptr;
+    }
+}
+
+/**
+ * @brief Reads a byte per cache line of every live payload, as meshing the
+ * whole area would.
+ */
+static
+u64 _scan(const std::vector<void*>& blocks) {
+    u64 sum = 0;
+    for (const void* block: blocks) {
+        if (block == nullptr)
+            continue;
+        for (std::size_t offset = 0; offset < BLOCK_SIZE; offset += BlockPool::BLOCK_ALIGNMENT)
+            sum += ((const u8*)block)[offset];
+    }
+    return sum;
+}
+
+/**
+ * @brief Address range the live payloads span, over their total size.
+ */
+static
+f64 _spread(const std::vector<void*>& blocks) {
+    uintptr_t low = UINTPTR_MAX;
+    uintptr_t high = 0;
+    u32 live = 0;
+    for (const void* block: blocks) {
+        if (block == nullptr)
+            continue;
+        low = std::min(low, (uintptr_t)block);
+        high = std::max(high, (uintptr_t)block + BLOCK_SIZE);
+        ++live;
+    }
+    return live == 0 ? 0.0 : (f64)(high - low) / ((f64)live * BLOCK_SIZE);
+}
+
+template <typename Allocator>
+static
+void _run(const char* name, Allocator& allocator) {
+    constexpr u32 CHURN = 1000000;
+    constexpr u32 FILLED_CHURN = 100000;
+    constexpr u32 THREAD_CHURN = 200000;
+
+    const std::string prefix = name;
+    std::vector<void*> blocks(CAPACITY, nullptr);
+
+    bench::report((prefix + ", churn").c_str(), bench::measure(CHURN, [&] {
+        _churn(allocator, blocks, CHURN, 1, false);
+        _releaseAll(allocator, blocks);
+    }));
+
+    bench::report((prefix + ", churn and fill").c_str(), bench::measure(FILLED_CHURN, [&] {
+        _churn(allocator, blocks, FILLED_CHURN, 2, true);
+        _releaseAll(allocator, blocks);
+    }));
+
+    // Live payloads left after a long session of edits
+    _churn(allocator, blocks, CHURN, 3, true);
+    u32 live = 0;
+    for (const void* block: blocks)
+        live += block != nullptr;
+    bench::report((prefix + ", scan after churn").c_str(), bench::measure(live, [&] {
+        bench::keep(_scan(blocks));
+    }));
+    std::cout << "    " << live << " live payloads spread over " << _spread(blocks) << "x their size" << std::endl;
+    _releaseAll(allocator, blocks);
+
+    // Generation workers materializing chunks side by side
+    const u32 threadCount = std::clamp(std::thread::hardware_concurrency(), 2U, 8U);
+    bench::report((prefix + ", churn, " + std::to_string(threadCount) + " threads").c_str(), bench::measure(THREAD_CHURN * threadCount, [&] {
+        std::vector<std::thread> threads;
+        for (u32 t = 0; t < threadCount; ++t) {
+            threads.emplace_back([&, t] {
+                std::vector<void*> own(CAPACITY / threadCount, nullptr);
+                _churn(allocator, own, THREAD_CHURN, 10 + t, false);
+                _releaseAll(allocator, own);
+            });
+        }
+        for (std::thread& thread: threads)
+            thread.join();
+    }));
+}
+
+int main() {
+    PoolAllocator pool;
+    HeapAllocator heap;
+
+    _run("BlockPool", pool);
+    _run("new / delete", heap);
+}
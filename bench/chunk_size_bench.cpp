@@ -0,0 +1,233 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   chunk_size_bench.cpp                               :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/07/07 23:52:39 by etran             #+#    #+#             */
+/*   Updated: 2024/07/07 23:52:39 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "chunk_mesher.h"
+#include "chunk_layout.h"
+#include "noise_sampler.h"
+#include "counter_rng.h"
+#include "bench.h"
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using game::Block;
+using game::BlockFace;
+using game::MaterialType;
+using vox::gfx::BasicChunkMesher;
+
+// Same terrain meshed whatever the chunk size
+static constexpr u32    AREA_SIZE = 128;
+static constexpr u32    AREA_HEIGHT = 32;
+
+// Chunk ids: up to 8 chunks along x and z, 2 along y
+static constexpr u32    GRID_WIDTH_BITS = 3;
+static constexpr u32    GRID_HEIGHT_BITS = 1;
+
+static constexpr u32    FACE_COUNT = 6;
+static constexpr u32    LOD_COUNT = 3;
+
+/**
+ * @brief Chunk-like type with its own dimensions, what BasicChunkMesher
+ * expects of game::Chunk. Always dense, column masks cached.
+ */
+template <u32 Size, u32 Height>
+class SizedChunk final {
+public:
+    using Layout = game::ChunkLayout<Size, Height>;
+    using Instances = game::InstanceLayout<Layout, GRID_WIDTH_BITS, GRID_HEIGHT_BITS>;
+    using ColumnMask = typename Layout::ColumnMask;
+
+    SizedChunk(): m_blocks(Layout::VOLUME) {}
+
+    /**
+     * @brief Fills the chunk from the area height map, with some holes under
+     * the surface.
+     */
+    void generate(const std::vector<u32>& heights, const u32 chunkX, const u32 chunkY, const u32 chunkZ) {
+        m_id = Instances::packChunk(chunkX, chunkY, chunkZ);
+        m_masks.fill(0);
+
+        for (u32 z = 0; z < Size; ++z) {
+            for (u32 x = 0; x < Size; ++x) {
+                const u32 areaX = chunkX * Size + x;
+                const u32 areaZ = chunkZ * Size + z;
+                const u32 surface = heights[areaZ * AREA_SIZE + areaX];
+
+                for (u32 y = 0; y < Height; ++y) {
+                    const u32 areaY = chunkY * Height + y;
+                    const bool hole = areaY + 2 < surface
+                        && proc::CounterRng(42, areaX, areaY, areaZ).nextBelow(8) == 0;
+
+                    MaterialType material = MaterialType::Air;
+                    if (areaY < surface && !hole)
+                        material = areaY + 1 == surface ? MaterialType::Grass : MaterialType::Stone;
+
+                    m_blocks[Layout::toIndex(x, y, z)] = Block(material);
+                    if (material != MaterialType::Air)
+                        m_masks[z * Size + x] |= (ColumnMask)1 << y;
+                }
+            }
+        }
+    }
+
+    ColumnMask getColumnMask(const u32 x, const u32 z) const noexcept {
+        return m_masks[z * Size + x];
+    }
+
+    const Block& getBlock(const u32 x, const u32 y, const u32 z) const noexcept {
+        return m_blocks[Layout::toIndex(x, y, z)];
+    }
+
+    u16 getId() const noexcept {
+        return m_id;
+    }
+
+private:
+    std::vector<Block>                          m_blocks;
+    std::array<ColumnMask, Layout::AREA>        m_masks{};
+    u16                                         m_id = 0;
+};
+
+/**
+ * @brief Vertex instance packed with the layout of the chunk type, as
+ * VertexInstance does with the world one.
+ */
+template <typename Instances>
+struct SizedInstance {
+    u32 m_data;
+    u32 m_occlusion;
+
+    SizedInstance(
+        const BlockFace face,
+        const u8 textureId,
+        const u16 blockId,
+        const u16 chunkId,
+        const u8 lod,
+        const u8 occlusion = 0xFF
+    ):
+        m_data(Instances::pack((u8)face, textureId, blockId, chunkId, lod)),
+        m_occlusion(occlusion) {}
+};
+
+/**
+ * @brief The area cut in chunks of one size, meshed by its own mesher.
+ */
+template <u32 Size, u32 Height>
+class SizedArea final {
+public:
+    using Chunk = SizedChunk<Size, Height>;
+    using Mesher = BasicChunkMesher<Chunk>;
+    using Instance = SizedInstance<typename Chunk::Instances>;
+
+    static constexpr u32    WIDTH = AREA_SIZE / Size;
+    static constexpr u32    LAYERS = AREA_HEIGHT / Height;
+
+    static_assert(WIDTH <= 1U << GRID_WIDTH_BITS && LAYERS <= 1U << GRID_HEIGHT_BITS, "Chunk ids too narrow.");
+
+    explicit SizedArea(const std::vector<u32>& heights): m_chunks(WIDTH * LAYERS * WIDTH) {
+        for (u32 y = 0; y < LAYERS; ++y)
+            for (u32 z = 0; z < WIDTH; ++z)
+                for (u32 x = 0; x < WIDTH; ++x)
+                    _getChunk(x, y, z).generate(heights, x, y, z);
+    }
+
+    /**
+     * @return Number of instances.
+     */
+    u32 mesh(const u32 lod) {
+        u32 count = 0;
+        for (u32 y = 0; y < LAYERS; ++y) {
+            for (u32 z = 0; z < WIDTH; ++z) {
+                for (u32 x = 0; x < WIDTH; ++x) {
+                    const Chunk& chunk = _getChunk(x, y, z);
+                    Mesher::computeFaceMasks(chunk, _getNeighbors(x, y, z), lod, m_masks);
+
+                    m_instances.clear();
+                    for (u32 face = 0; face < FACE_COUNT; ++face)
+                        Mesher::emitFaces(chunk, m_masks, (BlockFace)face, lod, m_instances);
+                    count += m_instances.size();
+                }
+            }
+        }
+        return count;
+    }
+
+private:
+    std::vector<Chunk>              m_chunks;
+    std::vector<Instance>           m_instances;
+    typename Mesher::FaceMasks      m_masks;
+
+    Chunk& _getChunk(const u32 x, const u32 y, const u32 z) noexcept {
+        return m_chunks[(y * WIDTH + z) * WIDTH + x];
+    }
+
+    typename Mesher::Neighbors _getNeighbors(const u32 x, const u32 y, const u32 z) noexcept {
+        typename Mesher::Neighbors neighbors = { nullptr, nullptr, nullptr, nullptr, nullptr, nullptr };
+        if (x > 0)
+            neighbors[Mesher::Neighbor::Left] = &_getChunk(x - 1, y, z);
+        if (x + 1 < WIDTH)
+            neighbors[Mesher::Neighbor::Right] = &_getChunk(x + 1, y, z);
+        if (z > 0)
+            neighbors[Mesher::Neighbor::Back] = &_getChunk(x, y, z - 1);
+        if (z + 1 < WIDTH)
+            neighbors[Mesher::Neighbor::Front] = &_getChunk(x, y, z + 1);
+        if (y > 0)
+            neighbors[Mesher::Neighbor::Bottom] = &_getChunk(x, y - 1, z);
+        if (y + 1 < LAYERS)
+            neighbors[Mesher::Neighbor::Top] = &_getChunk(x, y + 1, z);
+        return neighbors;
+    }
+};
+
+template <u32 Size, u32 Height>
+static
+void _run(const std::vector<u32>& heights) {
+    constexpr u32 BLOCKS = AREA_SIZE * AREA_SIZE * AREA_HEIGHT;
+
+    SizedArea<Size, Height> area(heights);
+    const std::string name = std::to_string(Size) + "x" + std::to_string(Height) + "x" + std::to_string(Size);
+
+    for (u32 lod = 0; lod < LOD_COUNT; ++lod) {
+        const u32 count = area.mesh(lod);
+        bench::report((name + " chunks, LOD " + std::to_string(lod) + ", per block").c_str(), bench::measure(BLOCKS, [&] {
+            bench::keep(area.mesh(lod));
+        }));
+        std::cout << "    " << count << " instances" << std::endl;
+    }
+}
+
+/**
+ * @brief One terrain, meshed in chunks of 16^3, 16x32x16 and 32^3: per block
+ * meshing cost and instance count of each size, in one binary.
+ */
+int main() {
+    proc::NoiseMapInfo noiseInfo{};
+    noiseInfo.seed = 42;
+    noiseInfo.type = proc::PerlinNoiseType::PERLIN_NOISE_2D;
+    noiseInfo.layers = 3;
+    noiseInfo.frequency_0 = 0.05f;
+    noiseInfo.frequency_mult = 2.0f;
+    noiseInfo.amplitude_mult = 0.5f;
+    noiseInfo.scale = AREA_HEIGHT - 8.0f;
+    const proc::NoiseSampler terrain(noiseInfo);
+
+    std::vector<u32> heights(AREA_SIZE * AREA_SIZE);
+    for (u32 z = 0; z < AREA_SIZE; ++z)
+        for (u32 x = 0; x < AREA_SIZE; ++x)
+            heights[z * AREA_SIZE + x] = std::clamp<i32>(terrain.noiseAt(x, z) + 4.0f, 1, AREA_HEIGHT - 1);
+
+    _run<16, 16>(heights);
+    _run<16, 32>(heights);
+    _run<32, 32>(heights);
+}
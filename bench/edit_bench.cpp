@@ -0,0 +1,132 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   edit_bench.cpp                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/07/07 19:02:51 by etran             #+#    #+#             */
+/*   Updated: 2024/07/07 22:31:09 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "world.h"
+#include "chunk_mesher.h"
+#include "controller.h"
+#include "job_system.h"
+#include "counter_rng.h"
+#include "bench.h"
+
+#include <vector>
+
+using namespace game;
+using vox::gfx::ChunkMesher;
+
+static World    s_world;
+
+static constexpr u32    LOD_COUNT = ENABLE_LOD ? 3 : 1;
+static constexpr u32    FACE_COUNT = 6;
+
+/**
+ * @brief Digs or places stone in a square of `size` blocks around the
+ * center of the world, at any height.
+ */
+static
+std::vector<BlockEdit> _generateEdits(const u32 count, const i32 size, const u64 seed) {
+    proc::CounterRng rng(seed);
+    std::vector<BlockEdit> edits(count);
+    for (BlockEdit& edit: edits) {
+        edit.m_x = (WORLD_BLOCK_SIZE - size) / 2 + rng.nextBelow(size);
+        edit.m_y = rng.nextBelow(WORLD_BLOCK_HEIGHT);
+        edit.m_z = (WORLD_BLOCK_SIZE - size) / 2 + rng.nextBelow(size);
+        edit.m_material = rng.nextBelow(2) ? MaterialType::Air : MaterialType::Stone;
+    }
+    return edits;
+}
+
+/**
+ * @brief Meshes every level of a world chunk (y/z/x index), as the vertex
+ * buffer does for edited chunks.
+ */
+static
+void _remesh(const u32 index, std::vector<vox::gfx::VertexInstance>& instances) {
+    const u32 x = index % RENDER_DISTANCE;
+    const u32 z = (index / RENDER_DISTANCE) % RENDER_DISTANCE;
+    const u32 y = index / RENDER_AREA;
+
+    ChunkMesher::Neighbors neighbors = { nullptr, nullptr, nullptr, nullptr, nullptr, nullptr };
+    if (x > 0)
+        neighbors[ChunkMesher::Neighbor::Left] = &s_world.getChunk(x - 1, y, z);
+    if (x + 1 < RENDER_DISTANCE)
+        neighbors[ChunkMesher::Neighbor::Right] = &s_world.getChunk(x + 1, y, z);
+    if (z > 0)
+        neighbors[ChunkMesher::Neighbor::Back] = &s_world.getChunk(x, y, z - 1);
+    if (z + 1 < RENDER_DISTANCE)
+        neighbors[ChunkMesher::Neighbor::Front] = &s_world.getChunk(x, y, z + 1);
+    if (y > 0)
+        neighbors[ChunkMesher::Neighbor::Bottom] = &s_world.getChunk(x, y - 1, z);
+    if (y + 1 < RENDER_HEIGHT)
+        neighbors[ChunkMesher::Neighbor::Top] = &s_world.getChunk(x, y + 1, z);
+
+    const Chunk& chunk = s_world.getChunk(x, y, z);
+    for (u32 lod = 0; lod < LOD_COUNT; ++lod) {
+        ChunkMesher::FaceMasks masks;
+        ChunkMesher::computeFaceMasks(chunk, neighbors, lod, masks);
+
+        instances.clear();
+        for (u32 face = 0; face < FACE_COUNT; ++face)
+            ChunkMesher::emitFaces(chunk, masks, (BlockFace)face, lod, instances);
+        bench::keep(instances.size());
+    }
+}
+
+int main() {
+    constexpr u32 EDITS = 100000;
+    constexpr u32 BATCH = 64;
+    constexpr u32 BATCHES = 200;
+
+    jobs::JobSystem::init();
+    s_world.init(42);
+
+    // A new set per run: replaying one would only hit equal blocks
+    std::vector<std::vector<BlockEdit>> scattered;
+    for (u32 repeat = 0; repeat < bench::REPEATS; ++repeat)
+        scattered.push_back(_generateEdits(EDITS, WORLD_BLOCK_SIZE, repeat));
+
+    u32 run = 0;
+    bench::report("World::setBlock, whole area", bench::measure(EDITS, [&] {
+        bench::keep(s_world.applyEdits(scattered[run++]));
+    }));
+
+    // Gameplay: batches around the player, edited chunks remeshed after each
+    ui::Camera camera{};
+    camera.m_position = math::Vect3(WORLD_BLOCK_SIZE / 2, WORLD_BLOCK_HEIGHT, WORLD_BLOCK_SIZE / 2);
+    camera.m_front = math::Vect3(1.0f, 0.0f, 0.0f);
+
+    std::vector<vox::gfx::VertexInstance> instances;
+    f64 editTime = 0.0;
+    f64 remeshTime = 0.0;
+    u32 edited = 0;
+    u32 remeshed = 0;
+    for (u32 batch = 0; batch < BATCHES; ++batch) {
+        const std::vector<BlockEdit> edits = _generateEdits(BATCH, 48, 100 + batch);
+
+        editTime += bench::time([&] {
+            edited += s_world.applyEdits(edits);
+            s_world.update(camera, 0.0f);
+        });
+        remeshTime += bench::time([&] {
+            s_world.getScheduler().process(ChunkTask::Mesh, 1e9f, [&](const u32 chunk) {
+                _remesh(chunk, instances);
+                ++remeshed;
+            });
+        });
+    }
+
+    bench::report("batched edit, world side", editTime / edited);
+    bench::report("remesh, per chunk", remeshTime / remeshed);
+    bench::report("batched edit, with remesh", (editTime + remeshTime) / edited);
+
+    s_world.destroy();
+    jobs::JobSystem::destroy();
+}
@@ -0,0 +1,85 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   job_bench.cpp                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/07/07 22:52:04 by etran             #+#    #+#             */
+/*   Updated: 2024/07/07 22:52:04 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "job_system.h"
+#include "bench.h"
+
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+
+using jobs::JobSystem;
+
+/**
+ * @brief Some arithmetic that does not touch memory, so threads only share
+ * the queues.
+ */
+static
+u32 _work(u32 value) noexcept {
+    for (u32 i = 0; i < 256; ++i)
+        value = value * 1664525U + 1013904223U;
+    return value;
+}
+
+/**
+ * @brief Same workloads with 0 (inline), 1, 2, 4... workers up to one per
+ * hardware thread but the main one.
+ */
+int main() {
+    constexpr u32 ITEMS = 1 << 18;
+    constexpr u32 GRAIN = 256;
+    constexpr u32 OUTER = 64;
+
+    const u32 hardware = std::max(std::thread::hardware_concurrency(), 1U);
+    std::vector<u32> workerCounts = { 0 };
+    for (u32 count = 1; count < hardware; count *= 2)
+        workerCounts.push_back(count);
+    if (workerCounts.back() != hardware - 1)
+        workerCounts.push_back(hardware - 1);
+
+    std::vector<u32> results(ITEMS);
+    for (const u32 workerCount: workerCounts) {
+        // Not initialized: jobs run on the waiting thread
+        if (workerCount > 0)
+            JobSystem::init(workerCount);
+        const std::string suffix = ", " + std::to_string(workerCount) + " workers";
+
+        bench::report(("parallelFor" + suffix).c_str(), bench::measure(ITEMS, [&] {
+            JobSystem::parallelFor(ITEMS, GRAIN, [&](const u32 i) {
+                results[i] = _work(i);
+            });
+            bench::keep(results);
+        }));
+
+        // One job per item: queue traffic only
+        bench::report(("parallelFor, grain 1" + suffix).c_str(), bench::measure(ITEMS, [&] {
+            JobSystem::parallelFor(ITEMS, 1, [&](const u32 i) {
+                results[i] = i;
+            });
+            bench::keep(results);
+        }));
+
+        bench::report(("nested parallelFor" + suffix).c_str(), bench::measure(ITEMS, [&] {
+            JobSystem::parallelFor(OUTER, 1, [&](const u32 outer) {
+                JobSystem::parallelFor(ITEMS / OUTER, GRAIN / 4, [&](const u32 inner) {
+                    const u32 i = outer * (ITEMS / OUTER) + inner;
+                    results[i] = _work(i);
+                });
+            });
+            bench::keep(results);
+        }));
+
+        if (workerCount > 0)
+            JobSystem::destroy();
+    }
+}
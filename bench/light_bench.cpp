@@ -0,0 +1,97 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   light_bench.cpp                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/07/07 20:03:47 by etran             #+#    #+#             */
+/*   Updated: 2024/07/07 22:31:09 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "world.h"
+#include "job_system.h"
+#include "counter_rng.h"
+#include "bench.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace game;
+
+static World    s_world;
+
+
+/**
+ * @brief Changes a block, then relights around it.
+ *
+ * @return Nanoseconds taken by the relight alone.
+ */
+static
+f64 _relight(const i32 x, const i32 y, const i32 z, const MaterialType material) {
+    s_world.fillBlocks({ x, y, z }, { x + 1, y + 1, z + 1 }, material);
+    return bench::time([&] { s_world.getLight().onBlockChanged(x, y, z); });
+}
+
+static
+void _reportLatencies(const char* name, std::vector<f64>& latencies) {
+    std::sort(latencies.begin(), latencies.end());
+    const std::string prefix(name);
+    bench::report((prefix + ", median").c_str(), latencies[latencies.size() / 2]);
+    bench::report((prefix + ", p99").c_str(), latencies[latencies.size() * 99 / 100]);
+    bench::report((prefix + ", max").c_str(), latencies.back());
+}
+
+int main() {
+    constexpr u32 EDITS = 3000;
+    constexpr u32 EMITTERS = 200;
+
+    jobs::JobSystem::init();
+    s_world.init(42);
+    LightEngine& light = s_world.getLight();
+
+    proc::CounterRng rng(3);
+    for (u32 i = 0; i < EMITTERS; ++i)
+        light.setEmitter(rng.nextBelow(WORLD_BLOCK_SIZE), rng.nextBelow(WORLD_BLOCK_HEIGHT), rng.nextBelow(WORLD_BLOCK_SIZE), 1 + rng.nextBelow(LightEngine::MAX_LIGHT));
+
+    bench::report("full world light", bench::measure(1, [&] {
+        light.compute();
+    }));
+    std::cout << "lit on " << jobs::JobSystem::getWorkerCount() << " workers" << std::endl;
+
+    // Anywhere in the world: mostly in the dark, underground
+    std::vector<f64> latencies;
+    for (u32 i = 0; i < EDITS; ++i) {
+        const i32 x = rng.nextBelow(WORLD_BLOCK_SIZE);
+        const i32 y = rng.nextBelow(WORLD_BLOCK_HEIGHT);
+        const i32 z = rng.nextBelow(WORLD_BLOCK_SIZE);
+        const MaterialType material = rng.nextBelow(2) ? MaterialType::Air : MaterialType::Stone;
+        latencies.push_back(_relight(x, y, z, material));
+    }
+    _reportLatencies("relight, random edit", latencies);
+
+    // Roofing the open sky casts the longest shadows
+    latencies.clear();
+    for (u32 i = 0; i < EDITS; ++i) {
+        const i32 x = rng.nextBelow(WORLD_BLOCK_SIZE);
+        const i32 z = rng.nextBelow(WORLD_BLOCK_SIZE);
+        latencies.push_back(_relight(x, WORLD_BLOCK_HEIGHT - 1, z, MaterialType::Stone));
+        latencies.push_back(_relight(x, WORLD_BLOCK_HEIGHT - 1, z, MaterialType::Air));
+    }
+    _reportLatencies("relight, sky roof", latencies);
+
+    latencies.clear();
+    for (u32 i = 0; i < EDITS; ++i) {
+        const i32 x = rng.nextBelow(WORLD_BLOCK_SIZE);
+        const i32 y = rng.nextBelow(WORLD_BLOCK_HEIGHT);
+        const i32 z = rng.nextBelow(WORLD_BLOCK_SIZE);
+        latencies.push_back(bench::time([&] { light.setEmitter(x, y, z, LightEngine::MAX_LIGHT); }));
+        latencies.push_back(bench::time([&] { light.setEmitter(x, y, z, 0); }));
+    }
+    _reportLatencies("relight, brightest emitter", latencies);
+
+    s_world.destroy();
+    jobs::JobSystem::destroy();
+}
@@ -0,0 +1,119 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   math_bench.cpp                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/07/07 21:04:18 by etran             #+#    #+#             */
+/*   Updated: 2024/07/07 21:04:18 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "matrix.h"
+#include "bench.h"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace math;
+
+// Scalar code the SSE paths replaced, as it was
+
+static
+Mat4 _scalarMultiply(const Mat4& lhs, const Mat4& rhs) noexcept {
+    Mat4 result;
+    for (std::size_t i = 0; i < 4; i++) {
+        for (std::size_t j = 0; j < 4; j++) {
+            for (std::size_t k = 0; k < 4; k++) {
+                result[i * 4 + j] = static_cast<float>(
+                    std::fma(lhs[k * 4 + j], rhs[i * 4 + k], result[i * 4 + j]));
+            }
+        }
+    }
+    return result;
+}
+
+static
+Mat4 _scalarTranspose(const Mat4& mat) noexcept {
+    Mat4 result{};
+    for (std::size_t i = 0; i < 4; ++i) {
+        for (std::size_t j = 0; j < 4; ++j)
+            result[4 * i + j] = mat[4 * j + i];
+    }
+    return result;
+}
+
+static
+Mat4 _scalarInverse(const Mat4& mat) {
+    return mat.adjugate() * (1 / mat.det());
+}
+
+static
+Vect3 _scalarTransform(const Mat4& mat, const Vect3& point) noexcept {
+    return Vect3(
+        std::fma(mat[0], point.x, std::fma(mat[4], point.y, std::fma(mat[8], point.z, mat[12]))),
+        std::fma(mat[1], point.x, std::fma(mat[5], point.y, std::fma(mat[9], point.z, mat[13]))),
+        std::fma(mat[2], point.x, std::fma(mat[6], point.y, std::fma(mat[10], point.z, mat[14]))));
+}
+
+int main() {
+    constexpr u32 COUNT = 100000;
+
+    std::mt19937 generator(1);
+    std::uniform_real_distribution<f32> distribution(-2.0f, 2.0f);
+    std::vector<Mat4> lhs(COUNT);
+    std::vector<Mat4> rhs(COUNT);
+    std::vector<Vect3A> points(COUNT);
+    std::vector<Vect3A> transformed(COUNT);
+    for (u32 n = 0; n < COUNT; ++n) {
+        for (u32 i = 0; i < 16; ++i) {
+            lhs[n][i] = distribution(generator);
+            rhs[n][i] = distribution(generator);
+        }
+        points[n] = Vect3A(distribution(generator), distribution(generator), distribution(generator), 1.0f);
+    }
+
+    bench::report("Mat4 * Mat4", bench::measure(COUNT, [&] {
+        for (u32 n = 0; n < COUNT; ++n)
+            bench::keep(lhs[n] * rhs[n]);
+    }));
+    bench::report("Mat4 * Mat4, scalar", bench::measure(COUNT, [&] {
+        for (u32 n = 0; n < COUNT; ++n)
+            bench::keep(_scalarMultiply(lhs[n], rhs[n]));
+    }));
+
+    bench::report("Mat4::transpose", bench::measure(COUNT, [&] {
+        for (u32 n = 0; n < COUNT; ++n)
+            bench::keep(lhs[n].transpose());
+    }));
+    bench::report("Mat4::transpose, scalar", bench::measure(COUNT, [&] {
+        for (u32 n = 0; n < COUNT; ++n)
+            bench::keep(_scalarTranspose(lhs[n]));
+    }));
+
+    // Random matrices are almost never singular, none throws
+    bench::report("inverse", bench::measure(COUNT, [&] {
+        for (u32 n = 0; n < COUNT; ++n)
+            bench::keep(inverse(lhs[n]));
+    }));
+    bench::report("inverse, scalar", bench::measure(COUNT, [&] {
+        for (u32 n = 0; n < COUNT; ++n)
+            bench::keep(_scalarInverse(lhs[n]));
+    }));
+
+    bench::report("Mat4 * Vect3", bench::measure(COUNT, [&] {
+        for (u32 n = 0; n < COUNT; ++n)
+            bench::keep(lhs[n] * points[n].xyz());
+    }));
+    bench::report("Mat4 * Vect3, scalar", bench::measure(COUNT, [&] {
+        for (u32 n = 0; n < COUNT; ++n)
+            bench::keep(_scalarTransform(lhs[n], points[n].xyz()));
+    }));
+
+    bench::report("transform, per point", bench::measure(COUNT, [&] {
+        transform(lhs[0], points, transformed);
+        bench::keep(transformed.back());
+    }));
+}
@@ -0,0 +1,296 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   mesh_bench.cpp                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/07/07 23:27:52 by etran             #+#    #+#             */
+/*   Updated: 2024/07/07 23:43:25 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "world.h"
+#include "chunk_mesher.h"
+#include "job_system.h"
+#include "counter_rng.h"
+#include "maths.h"
+#include "bench.h"
+
+#include <array>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace game;
+using vox::gfx::ChunkMesher;
+using vox::gfx::VertexInstance;
+
+static World    s_world;
+
+static constexpr u32        FACE_COUNT = 6;
+
+// Same levels as VertexBuffer with ENABLE_LOD
+static constexpr u32                LOD_COUNT = 3;
+static constexpr std::array<f32, 2> LOD_DISTANCES = { 64.0f, 128.0f };
+static constexpr const char* LAYOUT = ENABLE_MORTON_LAYOUT ? "Morton layout" : "row layout";
+
+static
+ChunkMesher::Neighbors _getNeighbors(const u32 x, const u32 y, const u32 z) {
+    ChunkMesher::Neighbors neighbors = { nullptr, nullptr, nullptr, nullptr, nullptr, nullptr };
+    if (x > 0)
+        neighbors[ChunkMesher::Neighbor::Left] = &s_world.getChunk(x - 1, y, z);
+    if (x + 1 < RENDER_DISTANCE)
+        neighbors[ChunkMesher::Neighbor::Right] = &s_world.getChunk(x + 1, y, z);
+    if (z > 0)
+        neighbors[ChunkMesher::Neighbor::Back] = &s_world.getChunk(x, y, z - 1);
+    if (z + 1 < RENDER_DISTANCE)
+        neighbors[ChunkMesher::Neighbor::Front] = &s_world.getChunk(x, y, z + 1);
+    if (y > 0)
+        neighbors[ChunkMesher::Neighbor::Bottom] = &s_world.getChunk(x, y - 1, z);
+    if (y + 1 < RENDER_HEIGHT)
+        neighbors[ChunkMesher::Neighbor::Top] = &s_world.getChunk(x, y + 1, z);
+    return neighbors;
+}
+
+/**
+ * @brief Meshes every chunk of the world at a level of detail.
+ *
+ * @return Number of instances.
+ */
+static
+u32 _meshWorld(const u32 lod, std::vector<VertexInstance>& instances) {
+    ChunkMesher::FaceMasks masks;
+    u32 count = 0;
+
+    for (u32 y = 0; y < RENDER_HEIGHT; ++y) {
+        for (u32 z = 0; z < RENDER_DISTANCE; ++z) {
+            for (u32 x = 0; x < RENDER_DISTANCE; ++x) {
+                const Chunk& chunk = s_world.getChunk(x, y, z);
+                ChunkMesher::computeFaceMasks(chunk, _getNeighbors(x, y, z), lod, masks);
+
+                instances.clear();
+                for (u32 face = 0; face < FACE_COUNT; ++face)
+                    ChunkMesher::emitFaces(chunk, masks, (BlockFace)face, lod, instances);
+                count += instances.size();
+            }
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Meshes every chunk at the level its distance to `eye` selects, as
+ * the vertex buffer does (without hysteresis).
+ *
+ * @return Number of instances.
+ */
+static
+u32 _meshByDistance(const math::Vect3& eye, std::vector<VertexInstance>& instances) {
+    ChunkMesher::FaceMasks masks;
+    u32 count = 0;
+
+    for (u32 y = 0; y < RENDER_HEIGHT; ++y) {
+        for (u32 z = 0; z < RENDER_DISTANCE; ++z) {
+            for (u32 x = 0; x < RENDER_DISTANCE; ++x) {
+                const Chunk& chunk = s_world.getChunk(x, y, z);
+                const f32 distance = math::norm(chunk.getBoundingBox().getCenter() - eye);
+
+                u32 lod = 0;
+                while (lod + 1 < LOD_COUNT && distance > LOD_DISTANCES[lod])
+                    ++lod;
+
+                ChunkMesher::computeFaceMasks(chunk, _getNeighbors(x, y, z), lod, masks);
+                instances.clear();
+                for (u32 face = 0; face < FACE_COUNT; ++face)
+                    ChunkMesher::emitFaces(chunk, masks, (BlockFace)face, lod, instances);
+                count += instances.size();
+            }
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Column mask read block by block, as the previous mesher did.
+ */
+static
+ChunkMesher::ColumnMask _getBlockColumnMask(const Chunk& chunk, const u32 x, const u32 z) noexcept {
+    ChunkMesher::ColumnMask mask = 0;
+    for (u32 y = 0; y < CHUNK_HEIGHT; ++y) {
+        if (!chunk.getBlock(x, y, z).isVoid())
+            mask |= (ChunkMesher::ColumnMask)1 << y;
+    }
+    return mask;
+}
+
+/**
+ * @brief The mesher before the padded volume, kept as a reference: columns
+ * read in storage order, neighbor columns fetched behind a branch on each
+ * border, top and bottom neighbors ignored.
+ */
+static
+void _computeBranchingFaceMasks(const Chunk& chunk, const ChunkMesher::Neighbors& neighbors, ChunkMesher::FaceMasks& masks) noexcept {
+    using Neighbor = ChunkMesher::Neighbor;
+    using ColumnMask = ChunkMesher::ColumnMask;
+    constexpr u32 UPPER_LIMIT = CHUNK_SIZE - 1;
+
+    std::array<ColumnMask, CHUNK_AREA> solid{};
+    for (u32 i = 0; i < CHUNK_VOLUME; ++i) {
+        if (chunk[i].isVoid())
+            continue;
+
+        u32 x, y, z;
+        Chunk::toPosition(i, x, y, z);
+        solid[z * CHUNK_SIZE + x] |= (ColumnMask)1 << y;
+    }
+
+    for (u32 z = 0; z < CHUNK_SIZE; ++z) {
+        for (u32 x = 0; x < CHUNK_SIZE; ++x) {
+            const u32           column = z * CHUNK_SIZE + x;
+            const ColumnMask    blocks = solid[column];
+
+            const ColumnMask right = x != UPPER_LIMIT ? solid[column + 1]
+                : neighbors[Neighbor::Right] ? _getBlockColumnMask(*neighbors[Neighbor::Right], 0, z) : 0;
+            const ColumnMask left = x != 0 ? solid[column - 1]
+                : neighbors[Neighbor::Left] ? _getBlockColumnMask(*neighbors[Neighbor::Left], UPPER_LIMIT, z) : 0;
+            const ColumnMask front = z != UPPER_LIMIT ? solid[column + CHUNK_SIZE]
+                : neighbors[Neighbor::Front] ? _getBlockColumnMask(*neighbors[Neighbor::Front], x, 0) : 0;
+            const ColumnMask back = z != 0 ? solid[column - CHUNK_SIZE]
+                : neighbors[Neighbor::Back] ? _getBlockColumnMask(*neighbors[Neighbor::Back], x, UPPER_LIMIT) : 0;
+
+            masks.m_faces[(u8)BlockFace::Top][column] = blocks & ~(ColumnMask)(blocks >> 1);
+            masks.m_faces[(u8)BlockFace::Bottom][column] = blocks & ~(ColumnMask)(blocks << 1);
+            masks.m_faces[(u8)BlockFace::Right][column] = blocks & ~right;
+            masks.m_faces[(u8)BlockFace::Left][column] = blocks & ~left;
+            masks.m_faces[(u8)BlockFace::Front][column] = blocks & ~front;
+            masks.m_faces[(u8)BlockFace::Back][column] = blocks & ~back;
+        }
+    }
+}
+
+/**
+ * @brief Face masks of every chunk, through either mesher.
+ *
+ * @return Number of faces.
+ */
+template <bool Padded>
+static
+u32 _computeWorldFaceMasks(ChunkMesher::FaceMasks& masks) {
+    u32 count = 0;
+    for (u32 y = 0; y < RENDER_HEIGHT; ++y) {
+        for (u32 z = 0; z < RENDER_DISTANCE; ++z) {
+            for (u32 x = 0; x < RENDER_DISTANCE; ++x) {
+                const Chunk& chunk = s_world.getChunk(x, y, z);
+                if constexpr (Padded)
+                    ChunkMesher::computeFaceMasks(chunk, _getNeighbors(x, y, z), 0, masks);
+                else
+                    _computeBranchingFaceMasks(chunk, _getNeighbors(x, y, z), masks);
+                count += ChunkMesher::countFaces(masks, 0);
+            }
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Digs holes under the surface: columns with several holes no longer
+ * fit a height field, their chunks get a block array in the tested layout.
+ */
+static
+void _digCaves(const u32 count) {
+    proc::CounterRng rng(7);
+    for (u32 i = 0; i < count; ++i) {
+        const i32 x = rng.nextBelow(WORLD_BLOCK_SIZE);
+        const i32 z = rng.nextBelow(WORLD_BLOCK_SIZE);
+
+        i32 surface = WORLD_BLOCK_HEIGHT - 1;
+        while (surface > 0 && s_world.getBlock(x, surface, z).isVoid())
+            --surface;
+
+        const i32 y = rng.nextBelow(surface + 1);
+        s_world.fillBlocks({ x, y, z }, { x + 1, y + 1, z + 1 }, MaterialType::Air);
+    }
+}
+
+/**
+ * @brief Same world meshed in both block layouts: the Makefile builds this
+ * benchmark twice, ENABLE_MORTON_LAYOUT off then on.
+ */
+int main() {
+    jobs::JobSystem::init();
+    s_world.init(42);
+    _digCaves(RENDER_VOLUME * 1024);
+
+    std::vector<const Chunk*> dense;
+    for (const Chunk& chunk: s_world.getChunks()) {
+        if (chunk.isDense())
+            dense.push_back(&chunk);
+    }
+    std::cout << LAYOUT << ": " << dense.size() << " / " << RENDER_VOLUME << " dense chunks" << std::endl;
+
+    const std::string suffix = std::string(", ") + LAYOUT;
+    std::vector<VertexInstance> instances;
+
+    // Each level over the whole world, then levels picked by distance from
+    // the spawn point
+    const u32 fullCount = _meshWorld(0, instances);
+    for (u32 lod = 0; lod < LOD_COUNT; ++lod) {
+        const u32 count = _meshWorld(lod, instances);
+
+        bench::report(("mesh world, LOD " + std::to_string(lod) + suffix).c_str(), bench::measure(RENDER_VOLUME, [&] {
+            bench::keep(_meshWorld(lod, instances));
+        }));
+        std::cout << "    " << count << " instances (" << 100.0 * count / fullCount << "% of LOD 0)" << std::endl;
+    }
+
+    const u32 selectedCount = _meshByDistance(s_world.getOrigin(), instances);
+    bench::report(("mesh world, LOD by distance" + suffix).c_str(), bench::measure(RENDER_VOLUME, [&] {
+        bench::keep(_meshByDistance(s_world.getOrigin(), instances));
+    }));
+    std::cout << "    " << selectedCount << " instances (" << 100.0 * selectedCount / fullCount << "% of LOD 0)" << std::endl;
+
+    // Against the mesher before the padded volume: same faces on a single
+    // chunk layer, the previous one leaves faces between layers exposed
+    ChunkMesher::FaceMasks masks;
+    const u32 paddedFaces = _computeWorldFaceMasks<true>(masks);
+    const u32 branchingFaces = _computeWorldFaceMasks<false>(masks);
+    bench::report(("face masks, padded, per chunk" + suffix).c_str(), bench::measure(RENDER_VOLUME, [&] {
+        bench::keep(_computeWorldFaceMasks<true>(masks));
+    }));
+    bench::report(("face masks, branching, per chunk" + suffix).c_str(), bench::measure(RENDER_VOLUME, [&] {
+        bench::keep(_computeWorldFaceMasks<false>(masks));
+    }));
+    std::cout << "    " << paddedFaces << " faces padded, " << branchingFaces << " branching" << std::endl;
+
+    // What the mesher reads of a dense chunk
+    bench::report(("getColumnMask, dense" + suffix).c_str(), bench::measure(dense.size() * CHUNK_AREA, [&] {
+        u32 sum = 0;
+        for (const Chunk* chunk: dense)
+            for (u32 z = 0; z < CHUNK_SIZE; ++z)
+                for (u32 x = 0; x < CHUNK_SIZE; ++x)
+                    sum += chunk->getColumnMask(x, z);
+        bench::keep(sum);
+    }));
+
+    // Block and its 6 neighbors, as lighting and the simulation read them
+    bench::report(("getBlock + 6 neighbors, dense" + suffix).c_str(), bench::measure(dense.size() * CHUNK_VOLUME, [&] {
+        u32 solid = 0;
+        for (const Chunk* chunk: dense) {
+            for (u32 z = 1; z + 1 < CHUNK_SIZE; ++z) {
+                for (u32 x = 1; x + 1 < CHUNK_SIZE; ++x) {
+                    for (u32 y = 1; y + 1 < CHUNK_HEIGHT; ++y) {
+                        solid += !chunk->getBlock(x, y, z).isVoid()
+                            + !chunk->getBlock(x - 1, y, z).isVoid() + !chunk->getBlock(x + 1, y, z).isVoid()
+                            + !chunk->getBlock(x, y - 1, z).isVoid() + !chunk->getBlock(x, y + 1, z).isVoid()
+                            + !chunk->getBlock(x, y, z - 1).isVoid() + !chunk->getBlock(x, y, z + 1).isVoid();
+                    }
+                }
+            }
+        }
+        bench::keep(solid);
+    }));
+
+    s_world.destroy();
+    jobs::JobSystem::destroy();
+}
@@ -0,0 +1,138 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   occlusion_bench.cpp                                :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/07/07 23:04:15 by etran             #+#    #+#             */
+/*   Updated: 2024/07/07 23:04:15 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "occlusion_culler.h"
+#include "world.h"
+#include "controller.h"
+#include "job_system.h"
+#include "maths.h"
+#include "bench.h"
+
+#include <cmath>
+#include <iostream>
+#include <numbers>
+#include <vector>
+
+using namespace game;
+using vox::gfx::OcclusionCuller;
+
+static World            s_world;
+static OcclusionCuller  s_culler;
+
+// Same as VertexBuffer::OCCLUDER_DISTANCE
+static constexpr f32    OCCLUDER_DISTANCE = 96.0f;
+
+struct ChunkBox {
+    math::Vect3 m_min;
+    math::Vect3 m_max;
+    u32         m_solidHeight;
+    u32         m_topHeight;
+};
+
+/**
+ * @brief One frame of VertexBuffer::_cullOccludedChunks, boxes behind the
+ * camera left out as frustum culling would.
+ *
+ * @return Number of chunks culled.
+ */
+static
+u32 _cullFrame(const ui::Camera& camera, const std::vector<ChunkBox>& boxes, u32& tested) {
+    s_culler.begin(camera);
+    for (const ChunkBox& box: boxes) {
+        const math::Vect3 center = (box.m_min + box.m_max) * 0.5f;
+        if (box.m_solidHeight == 0 || math::norm(center - camera.m_position) > OCCLUDER_DISTANCE)
+            continue;
+
+        math::Vect3 max = box.m_max;
+        max.y = box.m_min.y + box.m_solidHeight;
+        s_culler.addOccluder(box.m_min, max);
+    }
+    s_culler.end();
+
+    u32 culled = 0;
+    tested = 0;
+    for (const ChunkBox& box: boxes) {
+        const math::Vect3 center = (box.m_min + box.m_max) * 0.5f;
+        if (box.m_topHeight == 0 || math::dot(center - camera.m_position, camera.m_front) < 0.0f)
+            continue;
+
+        math::Vect3 max = box.m_max;
+        max.y = box.m_min.y + box.m_topHeight;
+        ++tested;
+        culled += !s_culler.isVisible(box.m_min, max);
+    }
+    return culled;
+}
+
+/**
+ * @brief Cameras at the spawn point, turning around at ground level, then
+ * looking down from above the terrain.
+ */
+int main() {
+    constexpr u32 DIRECTIONS = 16;
+
+    jobs::JobSystem::init();
+    s_world.init(42);
+    s_culler.init();
+
+    std::vector<ChunkBox> boxes;
+    for (u32 y = 0; y < RENDER_HEIGHT; ++y) {
+        for (u32 z = 0; z < RENDER_DISTANCE; ++z) {
+            for (u32 x = 0; x < RENDER_DISTANCE; ++x) {
+                const Chunk& chunk = s_world.getChunk(x, y, z);
+                ChunkBox& box = boxes.emplace_back();
+                box.m_min = chunk.getBoundingBox().getMin();
+                box.m_max = chunk.getBoundingBox().getMax();
+                OcclusionCuller::measureChunk(chunk, box.m_solidHeight, box.m_topHeight);
+            }
+        }
+    }
+
+    for (const f32 height: { 2.0f, 24.0f }) {
+        std::vector<ui::Camera> cameras(DIRECTIONS);
+        for (u32 i = 0; i < DIRECTIONS; ++i) {
+            const f32 yaw = 2.0f * std::numbers::pi_v<f32> * i / DIRECTIONS;
+            const f32 pitch = height > 2.0f ? -0.5f : 0.0f;
+
+            ui::Camera& camera = cameras[i];
+            camera.m_position = s_world.getOrigin() + math::Vect3(0.0f, height, 0.0f);
+            camera.m_front = math::Vect3(
+                std::cos(yaw) * std::cos(pitch),
+                std::sin(pitch),
+                std::sin(yaw) * std::cos(pitch));
+            camera.m_right = math::normalize(math::cross(camera.m_front, math::Vect3(0.0f, 1.0f, 0.0f)));
+            camera.m_up = math::cross(camera.m_right, camera.m_front);
+        }
+
+        u32 culled = 0;
+        u32 tested = 0;
+        for (const ui::Camera& camera: cameras) {
+            u32 frameTested;
+            culled += _cullFrame(camera, boxes, frameTested);
+            tested += frameTested;
+        }
+
+        const f64 frameTime = bench::measure(DIRECTIONS, [&] {
+            u32 frameTested;
+            for (const ui::Camera& camera: cameras)
+                bench::keep(_cullFrame(camera, boxes, frameTested));
+        });
+
+        const char* name = height > 2.0f ? "occlusion, frame from above" : "occlusion, frame at ground level";
+        bench::report(name, frameTime);
+        std::cout << "    " << culled << " / " << tested << " chunks ahead culled ("
+            << 100.0 * culled / std::max(tested, 1U) << "%)" << std::endl;
+    }
+
+    s_world.destroy();
+    jobs::JobSystem::destroy();
+}
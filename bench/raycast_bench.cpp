@@ -0,0 +1,90 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   raycast_bench.cpp                                  :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/07/07 19:41:08 by etran             #+#    #+#             */
+/*   Updated: 2024/07/07 22:31:09 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "world.h"
+#include "job_system.h"
+#include "counter_rng.h"
+#include "bench.h"
+
+#include <array>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace game;
+using Ray = VoxelRaycaster::Ray;
+using Hit = VoxelRaycaster::Hit;
+
+static World    s_world;
+
+
+enum class RayKind {
+    Picking,    // from the player, a few blocks away
+    Sky,        // from above, down to the ground
+    Horizon     // grazing the terrain over long distances
+};
+
+static
+std::vector<Ray> _generateRays(const RayKind kind, const u32 count) {
+    proc::CounterRng rng(3, 0, 0, (i64)kind);
+    std::vector<Ray> rays(count);
+
+    for (Ray& ray: rays) {
+        const math::Vect3 position(rng.nextFloat(0.0f, WORLD_BLOCK_SIZE), rng.nextFloat(0.0f, WORLD_BLOCK_HEIGHT), rng.nextFloat(0.0f, WORLD_BLOCK_SIZE));
+        const math::Vect3 direction(rng.nextFloat(-1.0f, 1.0f), rng.nextFloat(-1.0f, 1.0f), rng.nextFloat(-1.0f, 1.0f));
+
+        switch (kind) {
+            case RayKind::Picking:
+                ray = { position, direction, 8.0f };
+                break;
+            case RayKind::Sky:
+                ray = { math::Vect3(position.x, WORLD_BLOCK_HEIGHT, position.z), math::Vect3(direction.x, -1.0f, direction.z), 400.0f };
+                break;
+            case RayKind::Horizon:
+                ray = { position, math::Vect3(direction.x, direction.y * 0.1f, direction.z), 400.0f };
+                break;
+        }
+    }
+    return rays;
+}
+
+int main() {
+    constexpr u32 RAYS = 200000;
+    constexpr std::array<std::pair<RayKind, const char*>, 3> KINDS = {{
+        { RayKind::Picking, "picking" },
+        { RayKind::Sky, "sky" },
+        { RayKind::Horizon, "horizon" }
+    }};
+
+    jobs::JobSystem::init();
+    s_world.init(42);
+    const VoxelRaycaster& raycaster = s_world.getRaycaster();
+
+    std::vector<Hit> hits(RAYS);
+    for (const auto& [kind, name]: KINDS) {
+        const std::vector<Ray> rays = _generateRays(kind, RAYS);
+
+        bench::report(("cast, " + std::string(name)).c_str(), bench::measure(RAYS, [&] {
+            for (u32 i = 0; i < RAYS; ++i)
+                hits[i] = raycaster.cast(rays[i]);
+            bench::keep(hits);
+        }));
+        bench::report(("batched cast, " + std::string(name)).c_str(), bench::measure(RAYS, [&] {
+            raycaster.cast(rays, hits);
+            bench::keep(hits);
+        }));
+    }
+    std::cout << "batches run on " << jobs::JobSystem::getWorkerCount() << " workers" << std::endl;
+
+    s_world.destroy();
+    jobs::JobSystem::destroy();
+}
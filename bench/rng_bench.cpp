@@ -0,0 +1,55 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   rng_bench.cpp                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/07/07 18:40:12 by etran             #+#    #+#             */
+/*   Updated: 2024/07/07 18:40:12 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "counter_rng.h"
+#include "bench.h"
+
+#include <random>
+
+using proc::CounterRng;
+
+int main() {
+    constexpr u64 SAMPLES = 100000000;
+    constexpr u64 KEYS = 1000000;
+
+    bench::report("CounterRng::next", bench::measure(SAMPLES, [] {
+        CounterRng rng(1);
+        u64 sum = 0;
+        for (u64 i = 0; i < SAMPLES; ++i)
+            sum += rng.next();
+        bench::keep(sum);
+    }));
+
+    bench::report("CounterRng::nextFloat", bench::measure(SAMPLES, [] {
+        CounterRng rng(1);
+        f32 sum = 0.0f;
+        for (u64 i = 0; i < SAMPLES; ++i)
+            sum += rng.nextFloat();
+        bench::keep(sum);
+    }));
+
+    // Per chunk use: a new key for a handful of values
+    bench::report("CounterRng key + next", bench::measure(KEYS, [] {
+        u64 sum = 0;
+        for (u64 i = 0; i < KEYS; ++i)
+            sum += CounterRng(42, i, 0, i >> 3, proc::RngStream::Decoration).next();
+        bench::keep(sum);
+    }));
+
+    bench::report("std::mt19937 (reference)", bench::measure(SAMPLES, [] {
+        std::mt19937 rng(1);
+        u64 sum = 0;
+        for (u64 i = 0; i < SAMPLES; ++i)
+            sum += rng();
+        bench::keep(sum);
+    }));
+}
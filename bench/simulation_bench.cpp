@@ -0,0 +1,108 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   simulation_bench.cpp                               :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/07/07 20:26:15 by etran             #+#    #+#             */
+/*   Updated: 2024/07/07 22:31:09 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "world.h"
+#include "job_system.h"
+#include "controller.h"
+#include "bench.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace game;
+
+static constexpr i32    FLOOR_HEIGHT = 3;
+static constexpr i32    FALL_HEIGHT = 10;
+static constexpr u32    MAX_TICKS = 5000;
+
+/**
+ * @brief Places a block of `material`, `size` wide, above a flat stone floor
+ * and runs the simulation until everything rests. Water is held in a basin
+ * four times as wide.
+ *
+ * Ticks are timed through World::update: moves are applied as edits, relit
+ * and woken around like any other.
+ */
+static
+void _run(const char* name, const MaterialType material, const i32 size, const u32 workerCount) {
+    jobs::JobSystem::init(workerCount);
+    std::unique_ptr<World> world = std::make_unique<World>();
+    world->init(42);
+
+    world->fillBlocks({ 0, 0, 0 }, { WORLD_BLOCK_SIZE, FLOOR_HEIGHT, WORLD_BLOCK_SIZE }, MaterialType::Stone);
+    world->fillBlocks({ 0, FLOOR_HEIGHT, 0 }, { WORLD_BLOCK_SIZE, WORLD_BLOCK_HEIGHT, WORLD_BLOCK_SIZE }, MaterialType::Air);
+
+    const i32 center = WORLD_BLOCK_SIZE / 2;
+    std::vector<BlockEdit> edits;
+    if (material == MaterialType::Water) {
+        const i32 basin = std::min(size * 2, center - 1);
+        for (i32 i = center - basin; i <= center + basin; ++i) {
+            for (i32 y = FLOOR_HEIGHT; y < FLOOR_HEIGHT + 3; ++y) {
+                edits.push_back({ i, y, center - basin, MaterialType::Stone });
+                edits.push_back({ i, y, center + basin, MaterialType::Stone });
+                edits.push_back({ center - basin, y, i, MaterialType::Stone });
+                edits.push_back({ center + basin, y, i, MaterialType::Stone });
+            }
+        }
+    }
+    for (i32 z = center - size / 2; z < center + size / 2; ++z) {
+        for (i32 y = WORLD_BLOCK_HEIGHT - FALL_HEIGHT; y < WORLD_BLOCK_HEIGHT; ++y) {
+            for (i32 x = center - size / 2; x < center + size / 2; ++x)
+                edits.push_back({ x, y, z, material });
+        }
+    }
+
+    world->getLight().compute();
+    world->applyEdits(edits);
+
+    ui::Camera camera{};
+    camera.m_position = math::Vect3(center, WORLD_BLOCK_HEIGHT, center);
+    camera.m_front = math::Vect3(1.0f, 0.0f, 0.0f);
+
+    u32 ticks = 0;
+    u64 cellUpdates = 0;
+    f64 nanoseconds = 0.0;
+    for (; ticks < MAX_TICKS && world->getSimulation().getActiveCount() != 0; ++ticks) {
+        cellUpdates += world->getSimulation().getActiveCount();
+        nanoseconds += bench::time([&] {
+            world->update(camera, (ticks + 1) * BlockSimulation::TICK_DURATION);
+        });
+        // Nothing is meshed here
+        world->getScheduler().process(ChunkTask::Mesh, 1e9f, [](const u32) {});
+    }
+
+    const u32 workers = jobs::JobSystem::getWorkerCount();
+    const std::string label = std::string(name) + " " + std::to_string(size) + "x" + std::to_string(size) + "x" + std::to_string(FALL_HEIGHT)
+        + ", " + std::to_string(workers) + (workers == 1 ? " worker" : " workers");
+    bench::report((label + ", tick").c_str(), nanoseconds / ticks);
+    bench::report((label + ", cell").c_str(), nanoseconds / cellUpdates);
+    std::cout << "    " << edits.size() << " blocks placed, " << ticks << " ticks to rest" << std::endl;
+
+    world->destroy();
+    jobs::JobSystem::destroy();
+}
+
+int main() {
+    std::vector<u32> workerCounts = { 1 };
+    if (std::thread::hardware_concurrency() > 2)
+        workerCounts.push_back(std::thread::hardware_concurrency() - 1);
+
+    for (const u32 workerCount: workerCounts) {
+        for (const i32 size: { 16, 32, 64 })
+            _run("sand collapse", MaterialType::Sand, size, workerCount);
+        for (const i32 size: { 8, 16, 32 })
+            _run("water flood", MaterialType::Water, size, workerCount);
+    }
+}
@@ -0,0 +1,128 @@
+#version 450
+#define VOX_CULL_LAYOUT
+
+#include "../src/engine/gfx/descriptor/sets/descriptor_decl.h"
+#include "../src/engine/game/game_decl.h"
+
+layout(local_size_x = CULL_GROUP_SIZE) in;
+
+// CullPhase
+layout(constant_id = 0) const uint PHASE = 0;
+const uint PHASE_EARLY = 0;
+const uint PHASE_LATE = 1;
+
+#define FACE_COUNT 6
+#define DRAW_COUNT (RENDER_VOLUME * FACE_COUNT)
+
+// VertexBuffer::CullChunk
+struct Chunk {
+    vec4 minCorner;
+    vec4 maxCorner;
+    uint first[FACE_COUNT];
+    uint count[FACE_COUNT];
+};
+
+// VkDrawIndirectCommand
+struct DrawCommand {
+    uint vertexCount;
+    uint instanceCount;
+    uint firstVertex;
+    uint firstInstance;
+};
+
+layout(set = CULL_SET, binding = 0) uniform sampler2D Pyramid;
+layout(std430, set = CULL_SET, binding = 1) readonly buffer Chunks {
+    Chunk at[];
+} chunks;
+layout(std430, set = CULL_SET, binding = 2) writeonly buffer Commands {
+    DrawCommand at[];
+} commands;
+layout(std430, set = CULL_SET, binding = 3) buffer Visibility {
+    uint at[];
+} visibility;
+
+layout(push_constant) uniform Cull {
+    mat4 viewProj;
+} cull;
+
+// --------------------------
+
+// Box against the Hi-Z pyramid, as HiZPyramid::isVisibleCoarse
+bool isVisible(const Chunk chunk) {
+    const vec2 size = vec2(textureSize(Pyramid, 0));
+
+    vec2 minPixel = size;
+    vec2 maxPixel = vec2(0.0);
+    float nearest = 0.0;
+    for (uint i = 0; i < 8; ++i) {
+        const vec3 corner = vec3(
+            (i & 1) != 0 ? chunk.maxCorner.x : chunk.minCorner.x,
+            (i & 2) != 0 ? chunk.maxCorner.y : chunk.minCorner.y,
+            (i & 4) != 0 ? chunk.maxCorner.z : chunk.minCorner.z);
+        const vec4 clip = cull.viewProj * vec4(corner, 1.0);
+
+        // Crosses the near plane: cannot be projected
+        if (clip.w < Z_NEAR)
+            return true;
+
+        const vec3 ndc = clip.xyz / clip.w;
+        const vec2 pixel = (ndc.xy * 0.5 + 0.5) * size;
+        minPixel = min(minPixel, pixel);
+        maxPixel = max(maxPixel, pixel);
+        nearest = max(nearest, 1.0 - ndc.z);
+    }
+
+    // Clipped to the first level, in whole pixels
+    const ivec2 start = ivec2(floor(clamp(minPixel, vec2(0.0), size)));
+    const ivec2 end = ivec2(ceil(clamp(maxPixel, vec2(0.0), size)));
+    if (any(greaterThanEqual(start, end)))
+        return false;
+
+    // Level where the rect spans at most two texels each way
+    const int extent = max(end.x - start.x, end.y - start.y);
+    const int level = min(findMSB(extent - 1) + 1, textureQueryLevels(Pyramid) - 1);
+    const ivec2 levelSize = textureSize(Pyramid, level);
+    const ivec2 first = min(start >> level, levelSize - 1);
+    const ivec2 last = min((end - 1) >> level, levelSize - 1);
+
+    for (int y = first.y; y <= last.y; ++y) {
+        for (int x = first.x; x <= last.x; ++x) {
+            if (texelFetch(Pyramid, ivec2(x, y), level).r <= nearest)
+                return true;
+        }
+    }
+    return false;
+}
+
+// Early: draws the chunks visible last frame, untested.
+// Late: tests every chunk against the pyramid of the early draws, draws those
+// the early phase missed and keeps the result for the next frame.
+void main() {
+    const uint index = gl_GlobalInvocationID.x;
+    if (index >= RENDER_VOLUME)
+        return;
+
+    const Chunk chunk = chunks.at[index];
+    const bool wasVisible = visibility.at[index] != 0;
+
+    bool drawn = wasVisible;
+    if (PHASE == PHASE_LATE) {
+        // Chunks dropped on the CPU have nothing to draw
+        bool candidate = false;
+        for (uint face = 0; face < FACE_COUNT; ++face)
+            candidate = candidate || chunk.count[face] != 0;
+
+        const bool visible = candidate && isVisible(chunk);
+        visibility.at[index] = visible ? 1 : 0;
+        drawn = visible && !wasVisible;
+    }
+
+    const uint base = PHASE * DRAW_COUNT + index * FACE_COUNT;
+    for (uint face = 0; face < FACE_COUNT; ++face) {
+        commands.at[base + face] = DrawCommand(
+            4,
+            drawn ? chunk.count[face] : 0,
+            0,
+            chunk.first[face]);
+    }
+}
@@ -21,11 +21,20 @@ layout(location = 3) out vec4 outNormalView;
 layout(location = 4) out vec4 outPositionView;
 #endif
 
+#if ENABLE_BAKED_AO
+layout(location = 5) in float inOcclusion;
+#endif
+
 layout(set = WORLD_SET, binding = 0) uniform sampler2DArray GameTex;
 
 void main() {
     outPosition = vec4(inPosition, gl_FragCoord.z / gl_FragCoord.w);
+#if ENABLE_BAKED_AO
+    // Normal alpha is free, carry the occlusion to the scene pass
+    outNormal = vec4(inNormal, inOcclusion);
+#else
     outNormal = vec4(inNormal, 1.0);
+#endif
     outAlbedo = texture(GameTex, inUVW);
 #if ENABLE_SSAO
     outNormalView = vec4(normalize(inNormalView), 1.0);
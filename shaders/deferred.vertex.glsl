@@ -6,6 +6,9 @@
 #include "../src/engine/vox_decl.h"
 
 layout(location = 0) in uint inData;
+#if ENABLE_BAKED_AO
+layout(location = 1) in uint inOcclusion;
+#endif
 
 layout(location = 0) out vec3 outUVW;
 layout(location = 1) out vec3 outNormal;
@@ -14,6 +17,9 @@ layout(location = 2) out vec3 outPosition;
 layout(location = 3) out vec3 outNormalView;
 layout(location = 4) out vec3 outPositionView;
 #endif
+#if ENABLE_BAKED_AO
+layout(location = 5) out float outOcclusion;
+#endif
 
 layout(push_constant) uniform Camera {
     mat4 view;
@@ -45,6 +51,11 @@ const vec2 UVS[4] = {
     { 0.0, 0.0 },
 };
 
+#if ENABLE_BAKED_AO
+// Light reaching a vertex, by number of solid blocks around it (3 - value)
+const float OCCLUSION[4] = { 0.45, 0.65, 0.85, 1.0 };
+#endif
+
 const vec3 NORMALS[6] = {
     {  0.0,  1.0,  0.0 },
     {  0.0, -1.0,  0.0 },
@@ -55,39 +66,52 @@ const vec3 NORMALS[6] = {
 };
 
 struct InstanceData {
-    vec3 chunkPos;  // 14 bits
-    vec3 blockPos;  // 12 bits
+    vec3 chunkPos;  // CHUNK_ID_BITS
+    vec3 blockPos;  // BLOCK_ID_BITS
     uint face;    // 3 bits
     uint textureIndex; // 3 bits
+    uint lod;   // 2 bits
 };
 
 InstanceData unpackData(in uint inputData) {
     InstanceData instanceData;
 
-    uint blockId = (inputData >> 14) & 0xFFF;
-    uint chunkId = inputData & 0x3FFF;
+    uint blockId = (inputData >> CHUNK_ID_BITS) & ((1u << BLOCK_ID_BITS) - 1u);
+    uint chunkId = inputData & ((1u << CHUNK_ID_BITS) - 1u);
 
     instanceData.chunkPos = CHUNK_SIZE * vec3(
-        float((chunkId >> 9) & 0x1F),
-        float((chunkId >> 5) & 0xF),
-        float(chunkId & 0x1F));
+        float((chunkId >> (CHUNK_ID_WIDTH_BITS + CHUNK_ID_HEIGHT_BITS)) & ((1u << CHUNK_ID_WIDTH_BITS) - 1u)),
+        float((chunkId >> CHUNK_ID_WIDTH_BITS) & ((1u << CHUNK_ID_HEIGHT_BITS) - 1u)),
+        float(chunkId & ((1u << CHUNK_ID_WIDTH_BITS) - 1u)));
     instanceData.blockPos = vec3(
-        float((blockId >> 8) & 0xF),
-        float((blockId >> 4) & 0xF),
-        float(blockId & 0xF));
-    instanceData.face = (inputData >> 26) & 0x7;
-    instanceData.textureIndex = (inputData >> 29) & 0x7;
+        float((blockId >> (CHUNK_HEIGHT_BITS + CHUNK_SIZE_BITS)) & (CHUNK_SIZE - 1u)),
+        float((blockId >> CHUNK_SIZE_BITS) & (CHUNK_HEIGHT - 1u)),
+        float(blockId & (CHUNK_SIZE - 1u)));
+    instanceData.face = (inputData >> INSTANCE_FACE_SHIFT) & 0x7;
+    instanceData.textureIndex = (inputData >> (INSTANCE_FACE_SHIFT + 3)) & 0x7;
+    instanceData.lod = (inputData >> INSTANCE_LOD_SHIFT) & 0x3;
 
     return instanceData;
 }
 
 void main() {
     const InstanceData instanceData = unpackData(inData);
-    const vec4 worldPos = vec4(CUBE_FACE[instanceData.face][gl_VertexIndex] + instanceData.chunkPos + instanceData.blockPos, 1.0);
+
+    // Padding instance: collapsed, no fragment
+    if (instanceData.face >= 6) {
+        gl_Position = vec4(0.0, 0.0, 0.0, 1.0);
+        return;
+    }
+
+    const float scale = float(1 << instanceData.lod);
+    const vec4 worldPos = vec4(CUBE_FACE[instanceData.face][gl_VertexIndex] * scale + instanceData.chunkPos + instanceData.blockPos, 1.0);
 
     outUVW = vec3(UVS[gl_VertexIndex], instanceData.textureIndex);
     outNormal = NORMALS[instanceData.face];
     outPosition = worldPos.xyz;
+#if ENABLE_BAKED_AO
+    outOcclusion = OCCLUSION[(inOcclusion >> (2 * gl_VertexIndex)) & 0x3];
+#endif
 
 #if ENABLE_SSAO
     const mat3 invView = transpose(inverse(mat3(camera.view)));
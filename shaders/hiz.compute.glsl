@@ -0,0 +1,44 @@
+#version 450
+#define VOX_HIZ_LAYOUT
+
+#include "../src/engine/gfx/descriptor/sets/descriptor_decl.h"
+#include "../src/engine/game/game_decl.h"
+
+layout(local_size_x = HIZ_GROUP_SIZE, local_size_y = HIZ_GROUP_SIZE) in;
+
+layout(set = HIZ_SET, binding = 0) uniform sampler2D DepthTex;
+layout(set = HIZ_SET, binding = 1, r32f) uniform image2D Levels[HIZ_MAX_LEVELS];
+
+layout(push_constant) uniform HiZ {
+    uint level;
+} hiz;
+
+// --------------------------
+
+// Stored as 1 - depth: 0 is nothing drawn, the reduction keeps the farthest
+// with min, as HiZPyramid does
+void main() {
+    const ivec2 texel = ivec2(gl_GlobalInvocationID.xy);
+    const ivec2 size = imageSize(Levels[hiz.level]);
+    if (any(greaterThanEqual(texel, size)))
+        return;
+
+    if (hiz.level == 0) {
+        imageStore(Levels[0], texel, vec4(1.0 - texelFetch(DepthTex, texel, 0).r));
+        return;
+    }
+
+    // Last texels take the leftover row or column of an odd source
+    const ivec2 srcSize = imageSize(Levels[hiz.level - 1]);
+    const ivec2 start = min(texel * 2, srcSize - 1);
+    const ivec2 end = ivec2(
+        texel.x + 1 == size.x ? srcSize.x : min(start.x + 2, srcSize.x),
+        texel.y + 1 == size.y ? srcSize.y : min(start.y + 2, srcSize.y));
+
+    float farthest = imageLoad(Levels[hiz.level - 1], start).r;
+    for (int y = start.y; y < end.y; ++y) {
+        for (int x = start.x; x < end.x; ++x)
+            farthest = min(farthest, imageLoad(Levels[hiz.level - 1], ivec2(x, y)).r);
+    }
+    imageStore(Levels[hiz.level], texel, vec4(farthest));
+}
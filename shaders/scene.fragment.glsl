@@ -66,7 +66,8 @@ float applyShadow(in vec4 position) {
 void main() {
     // Gbuffer
     const vec4 position = texture(PositionTex, inUV);
-    const vec3 normal = texture(NormalTex, inUV).rgb;
+    const vec4 normalData = texture(NormalTex, inUV);
+    const vec3 normal = normalData.rgb;
     const vec4 albedo = texture(AlbedoTex, inUV);
 
     if (albedo.a == 0.0)
@@ -98,6 +99,9 @@ void main() {
 #if ENABLE_SSAO
     const float ssao = texture(BlurSsaoTex, inUV).r;
     lighting *= ssao;
+#endif
+#if ENABLE_BAKED_AO
+    lighting *= normalData.a;
 #endif
     color *= lighting;
 
@@ -29,8 +29,8 @@ const vec3 CUBE_FACE[6][4] = {
 };
 
 struct InstanceData {
-    vec3 chunkPos;  // 14 bits
-    vec3 blockPos;  // 12 bits
+    vec3 chunkPos;  // CHUNK_ID_BITS
+    vec3 blockPos;  // BLOCK_ID_BITS
     uint face;    // 3 bits
     uint textureIndex; // 3 bits
 };
@@ -38,21 +38,21 @@ struct InstanceData {
 InstanceData unpackData(in uint inputData) {
     InstanceData instanceData;
 
-    uint textureIndex = (inputData >> 29) & 0x7;
-    uint face = (inputData >> 26) & 0x7;
-    uint blockId = (inputData >> 14) & 0xFFF;
-    uint chunkId = inputData & 0x3FFF;
+    uint textureIndex = (inputData >> (INSTANCE_FACE_SHIFT + 3)) & 0x7;
+    uint face = (inputData >> INSTANCE_FACE_SHIFT) & 0x7;
+    uint blockId = (inputData >> CHUNK_ID_BITS) & ((1u << BLOCK_ID_BITS) - 1u);
+    uint chunkId = inputData & ((1u << CHUNK_ID_BITS) - 1u);
 
     instanceData.chunkPos = CHUNK_SIZE * vec3(
-        float((chunkId >> 9) & 0x1F),
-        float((chunkId >> 5) & 0xF),
-        float(chunkId & 0x1F)
+        float((chunkId >> (CHUNK_ID_WIDTH_BITS + CHUNK_ID_HEIGHT_BITS)) & ((1u << CHUNK_ID_WIDTH_BITS) - 1u)),
+        float((chunkId >> CHUNK_ID_WIDTH_BITS) & ((1u << CHUNK_ID_HEIGHT_BITS) - 1u)),
+        float(chunkId & ((1u << CHUNK_ID_WIDTH_BITS) - 1u))
     );
 
     instanceData.blockPos = vec3(
-        float((blockId >> 8) & 0xF),
-        float((blockId >> 4) & 0xF),
-        float(blockId & 0xF)
+        float((blockId >> (CHUNK_HEIGHT_BITS + CHUNK_SIZE_BITS)) & (CHUNK_SIZE - 1u)),
+        float((blockId >> CHUNK_SIZE_BITS) & (CHUNK_HEIGHT - 1u)),
+        float(blockId & (CHUNK_SIZE - 1u))
     );
 
     instanceData.face = face;
@@ -65,6 +65,12 @@ InstanceData unpackData(in uint inputData) {
 void main() {
     InstanceData instanceData = unpackData(inData);
 
+    // Padding instance: collapsed, no fragment
+    if (instanceData.face >= 6) {
+        gl_Position = vec4(0.0, 0.0, 0.0, 1.0);
+        return;
+    }
+
     vec3 worldPos =
         CUBE_FACE[instanceData.face][gl_VertexIndex] +
         instanceData.chunkPos +
@@ -6,11 +6,13 @@
 /*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2024/02/27 18:17:53 by etran             #+#    #+#             */
-/*   Updated: 2024/05/31 13:07:40 by etran            ###   ########.fr       */
+/*   Updated: 2024/07/07 14:05:31 by etran            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #include "engine.h"
+#include "job_system.h"
+#include "allocation_counter.h"
 
 #include "debug.h"
 
@@ -23,14 +25,23 @@ namespace vox {
 /* ========================================================================== */
 
 Engine::Engine() {
-    m_game.init(m_window);
-    m_renderer.init(m_window, m_game);
+    jobs::JobSystem::init();
+    try {
+        m_game.init(m_window);
+        m_renderer.init(m_window, m_game);
+    } catch (...) {
+        // ~Engine won't run: workers must be joined before static destruction
+        jobs::JobSystem::destroy();
+        throw;
+    }
 
     LINFO("Engine initialized.");
 }
 
 Engine::~Engine() {
     m_renderer.destroy();
+    m_game.destroy();
+    jobs::JobSystem::destroy();
 
     LINFO("Engine destroyed.");
 }
@@ -40,10 +51,20 @@ Engine::~Engine() {
 void Engine::run() {
     m_timer.reset();
     while (m_window.isAlive()) {
+#ifdef __ALLOC_COUNT
+        const u64 allocationCount = mem::getAllocationCount();
+#endif
+
         m_window.pollEvents();
         m_game.update(m_window);
         m_renderer.render(m_game);
         m_timer.update();
+
+#ifdef __ALLOC_COUNT
+        // Steady state frames should not touch the heap
+        if (const u64 frameAllocations = mem::getAllocationCount() - allocationCount; frameAllocations != 0)
+            LDEBUG("Heap allocations during frame: " << frameAllocations);
+#endif
     }
 
     m_renderer.waitIdle();
@@ -6,7 +6,7 @@
 /*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2024/03/15 13:35:46 by etran             #+#    #+#             */
-/*   Updated: 2024/06/21 00:35:00 by etran            ###   ########.fr       */
+/*   Updated: 2024/07/08 10:41:17 by etran            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -18,6 +18,11 @@
 # define CHUNK_AREA     (CHUNK_SIZE * CHUNK_SIZE) // 256
 # define CHUNK_VOLUME   (CHUNK_AREA * CHUNK_HEIGHT) // 4096
 
+// Block coordinates in a packed block id, checked against game::ChunkLayout
+# define CHUNK_SIZE_BITS    4 // log2(CHUNK_SIZE)
+# define CHUNK_HEIGHT_BITS  4 // log2(CHUNK_HEIGHT)
+# define BLOCK_ID_BITS      (2 * CHUNK_SIZE_BITS + CHUNK_HEIGHT_BITS)
+
 # define WORLD_WIDTH    15
 # define WORLD_DEPTH    WORLD_WIDTH
 # define WORLD_SIZE     (WORLD_WIDTH * WORLD_DEPTH)
@@ -27,7 +32,22 @@
 
 # define RENDER_DISTANCE 16 // Number of chunks around the player
 # define RENDER_HEIGHT   1  // Number of chunks above and below the player
-# define RENDER_AREA     (RENDER_DISTANCE * RENDER_DISTANCE * RENDER_HEIGHT) // 2048
+# define RENDER_AREA     (RENDER_DISTANCE * RENDER_DISTANCE) // 256, chunks in a layer
+# define RENDER_VOLUME   (RENDER_AREA * RENDER_HEIGHT) // 256, chunks in the world
+
+// World size in blocks
+# define WORLD_BLOCK_SIZE   (RENDER_DISTANCE * CHUNK_SIZE) // 256, along x & z
+# define WORLD_BLOCK_HEIGHT (RENDER_HEIGHT * CHUNK_HEIGHT) // 16
+
+// Chunk coordinates in a packed chunk id, cf. game::InstanceLayout
+# define CHUNK_ID_WIDTH_BITS    4
+# define CHUNK_ID_HEIGHT_BITS   4
+# define CHUNK_ID_BITS          (2 * CHUNK_ID_WIDTH_BITS + CHUNK_ID_HEIGHT_BITS)
+
+// Vertex instance data: chunk id, block id, face (3 bits), texture (3 bits),
+// level of detail (2 bits)
+# define INSTANCE_FACE_SHIFT    (CHUNK_ID_BITS + BLOCK_ID_BITS)
+# define INSTANCE_LOD_SHIFT     (INSTANCE_FACE_SHIFT + 6)
 
 # define WORLD_ORIGIN   { RENDER_DISTANCE * CHUNK_SIZE * 0.5f, 0.0f, RENDER_DISTANCE * CHUNK_SIZE * 0.5f }
 
@@ -46,4 +66,9 @@
 # define SSAO_KERNEL_SIZE   64
 # define SSAO_RADIUS        0.5
 
+// GPU culling (ENABLE_GPU_CULLING)
+# define HIZ_MAX_LEVELS     14 // Hi-Z pyramid levels, up to 16383 pixels wide
+# define HIZ_GROUP_SIZE     8  // Hi-Z texels per workgroup side
+# define CULL_GROUP_SIZE    64 // Chunks per culling workgroup
+
 #endif // GAME_DECL_H
\ No newline at end of file
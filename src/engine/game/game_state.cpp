@@ -6,7 +6,7 @@
 /*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2024/03/15 13:46:03 by etran             #+#    #+#             */
-/*   Updated: 2024/06/21 17:09:09 by etran            ###   ########.fr       */
+/*   Updated: 2024/07/06 11:47:22 by etran            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -30,6 +30,10 @@ void GameState::init(const ui::Window& window) {
     m_gameClock.init();
 }
 
+void GameState::destroy() {
+    m_world.destroy();
+}
+
 /* ========================================================================== */
 
 // TODO Fix
@@ -45,6 +49,7 @@ float GameState::getElapsedTime() const noexcept {
 
 void GameState::update(const ui::Window& window) {
     m_controller.update((window));
+    m_world.update(m_controller.getCamera(), getElapsedTime());
 
 #if !TOGGLE_TIME
     float pos = -M_PI * 0.1;// M_PI * 0.5;
@@ -6,7 +6,7 @@
 /*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2024/03/11 16:56:28 by etran             #+#    #+#             */
-/*   Updated: 2024/06/06 02:22:35 by etran            ###   ########.fr       */
+/*   Updated: 2024/06/28 10:24:53 by etran            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -49,6 +49,7 @@ public:
     GameState() = default;
 
     void init(const ui::Window& window);
+    void destroy();
     void update(const ui::Window& window);
 
     /* ====================================================================== */
@@ -0,0 +1,333 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   block_simulation.cpp                               :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/07/06 10:12:53 by etran             #+#    #+#             */
+/*   Updated: 2024/07/07 22:31:09 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+#include "block_simulation.h"
+#include "world.h"
+#include "counter_rng.h"
+#include "job_system.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace game {
+
+namespace {
+
+constexpr std::array<std::pair<i32, i32>, 4> SIDES = {{
+    { -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 }
+}};
+
+} // namespace
+
+/* ========================================================================== */
+/*                                   PUBLIC                                   */
+/* ========================================================================== */
+
+void BlockSimulation::init(const World& world, const u32 seed) {
+    m_world = &world;
+    m_seed = seed;
+    m_tick = 0;
+    m_schedules = std::vector<ChunkSchedule>(CHUNK_COUNT);
+    m_claimed = std::vector<std::bitset<CHUNK_VOLUME>>(CHUNK_COUNT);
+}
+
+void BlockSimulation::destroy() noexcept {
+    m_schedules = std::vector<ChunkSchedule>();
+    m_claimed = std::vector<std::bitset<CHUNK_VOLUME>>();
+    m_activeChunks = std::vector<u32>();
+    m_tickChunks = std::vector<u32>();
+    m_tickCells = std::vector<std::vector<u16>>();
+    m_tickMoves = std::vector<std::vector<Move>>();
+    m_claimedChunks = std::vector<u32>();
+    m_world = nullptr;
+}
+
+/**
+ * @brief Schedules the cells a change at (x, y, z) may set in motion: the
+ * block itself, its neighbors, and the water above that may flow into it.
+ */
+void BlockSimulation::wake(const i32 x, const i32 y, const i32 z) {
+    _schedule(x, y, z);
+    _schedule(x, y - 1, z);
+    _schedule(x, y + 1, z);
+
+    for (const auto& [dx, dz]: SIDES) {
+        _schedule(x + dx, y, z + dz);
+        for (i32 distance = 1; distance <= FLOW_DISTANCE; ++distance)
+            _schedule(x + dx * distance, y + 1, z + dz * distance);
+    }
+}
+
+/**
+ * @brief Runs the scheduled cells once.
+ *
+ * @param edits Filled with the blocks to write, two per move. Writing them
+ * (through World::applyEdits) wakes the cells for the next tick.
+ */
+void BlockSimulation::tick(std::vector<BlockEdit>& edits) {
+    // Chunk order makes move acceptance deterministic
+    m_tickChunks.swap(m_activeChunks);
+    m_activeChunks.clear();
+    std::sort(m_tickChunks.begin(), m_tickChunks.end());
+
+    const u32 chunkCount = m_tickChunks.size();
+    if (m_tickCells.size() < chunkCount) {
+        m_tickCells.resize(chunkCount);
+        m_tickMoves.resize(chunkCount);
+    }
+    for (u32 slot = 0; slot < chunkCount; ++slot) {
+        ChunkSchedule& schedule = m_schedules[m_tickChunks[slot]];
+        m_tickCells[slot].swap(schedule.m_cells);
+        schedule.m_cells.clear();
+        schedule.m_queued.reset();
+    }
+
+    jobs::JobSystem::parallelFor(chunkCount, 1, [this](const u32 slot) {
+        _evaluate(slot);
+    });
+
+    for (u32 slot = 0; slot < chunkCount; ++slot) {
+        for (const Move& move: m_tickMoves[slot]) {
+            i32 fromX, fromY, fromZ, toX, toY, toZ;
+            _toPosition(move.m_from, fromX, fromY, fromZ);
+            _toPosition(move.m_to, toX, toY, toZ);
+
+            // Lost to an earlier move: tries again next tick
+            if (!_claim(move.m_from) || !_claim(move.m_to)) {
+                _schedule(fromX, fromY, fromZ);
+                continue;
+            }
+
+            const Block& from = m_world->getBlock(fromX, fromY, fromZ);
+            const Block& to = m_world->getBlock(toX, toY, toZ);
+
+            edits.push_back({ toX, toY, toZ, from.getMaterial(), from.getBiome() });
+            edits.push_back({ fromX, fromY, fromZ, to.getMaterial(), to.getBiome() });
+        }
+    }
+
+    for (const u32 chunk: m_claimedChunks)
+        m_claimed[chunk].reset();
+    m_claimedChunks.clear();
+    ++m_tick;
+}
+
+/* ========================================================================== */
+
+/**
+ * @brief Cells scheduled for the next tick.
+ */
+u32 BlockSimulation::getActiveCount() const noexcept {
+    u32 count = 0;
+    for (const u32 chunk: m_activeChunks)
+        count += m_schedules[chunk].m_cells.size();
+    return count;
+}
+
+u64 BlockSimulation::getTick() const noexcept {
+    return m_tick;
+}
+
+/* ========================================================================== */
+/*                                   PRIVATE                                  */
+/* ========================================================================== */
+
+/**
+ * @brief Queues a cell for the next tick, if it holds a block that moves.
+ */
+void BlockSimulation::_schedule(const i32 x, const i32 y, const i32 z) {
+    u32 location;
+    if (!_locate(x, y, z, location))
+        return;
+
+    const MaterialType material = _getMaterial(x, y, z);
+    if (material != MaterialType::Sand && material != MaterialType::Water)
+        return;
+
+    const u32 chunk = location >> 16;
+    const u16 cell = location & 0xFFFF;
+    ChunkSchedule& schedule = m_schedules[chunk];
+    if (schedule.m_queued.test(cell))
+        return;
+
+    if (schedule.m_cells.empty())
+        m_activeChunks.push_back(chunk);
+    schedule.m_queued.set(cell);
+    schedule.m_cells.push_back(cell);
+}
+
+/**
+ * @brief Decides the moves of the cells of one chunk. Only reads the world.
+ */
+void BlockSimulation::_evaluate(const u32 slot) {
+    const u32 chunk = m_tickChunks[slot];
+    std::vector<u16>& cells = m_tickCells[slot];
+    std::vector<Move>& moves = m_tickMoves[slot];
+
+    moves.clear();
+    std::sort(cells.begin(), cells.end());
+
+    for (const u16 cell: cells) {
+        const u32 from = (chunk << 16) | cell;
+
+        i32 x, y, z;
+        _toPosition(from, x, y, z);
+
+        const u64 random = proc::CounterRng(m_seed, x, y, z, proc::RngStream::Simulation).at(m_tick);
+
+        i32 toX, toY, toZ;
+        bool isMoving = false;
+        switch (_getMaterial(x, y, z)) {
+            case MaterialType::Sand:
+                isMoving = _evaluateSand(x, y, z, random, toX, toY, toZ);
+                break;
+            case MaterialType::Water:
+                isMoving = _evaluateWater(x, y, z, random, toX, toY, toZ);
+                break;
+            default:
+                break;
+        }
+
+        u32 to;
+        if (isMoving && _locate(toX, toY, toZ, to))
+            moves.push_back({ from, to });
+    }
+    cells.clear();
+}
+
+/**
+ * @brief Sand falls, sinks in water, and slides down the sides of piles.
+ */
+bool BlockSimulation::_evaluateSand(
+    const i32 x,
+    const i32 y,
+    const i32 z,
+    const u64 random,
+    i32& toX,
+    i32& toY,
+    i32& toZ
+) const noexcept {
+    const auto isLoose = [this](const i32 x, const i32 y, const i32 z) {
+        const MaterialType material = _getMaterial(x, y, z);
+        return material == MaterialType::Air || material == MaterialType::Water;
+    };
+
+    toX = x;
+    toY = y - 1;
+    toZ = z;
+    if (isLoose(x, y - 1, z))
+        return true;
+
+    for (u32 i = 0; i < SIDES.size(); ++i) {
+        const auto& [dx, dz] = SIDES[(random + i) % SIDES.size()];
+
+        if (_getMaterial(x + dx, y, z + dz) == MaterialType::Air && isLoose(x + dx, y - 1, z + dz)) {
+            toX = x + dx;
+            toZ = z + dz;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Water falls, or flows one block towards the closest drop within
+ * FLOW_DISTANCE. With no drop in reach it stays: pools settle.
+ */
+bool BlockSimulation::_evaluateWater(
+    const i32 x,
+    const i32 y,
+    const i32 z,
+    const u64 random,
+    i32& toX,
+    i32& toY,
+    i32& toZ
+) const noexcept {
+    toX = x;
+    toY = y - 1;
+    toZ = z;
+    if (_getMaterial(x, y - 1, z) == MaterialType::Air)
+        return true;
+
+    i32 closest = FLOW_DISTANCE + 1;
+    for (u32 i = 0; i < SIDES.size(); ++i) {
+        const auto& [dx, dz] = SIDES[(random + i) % SIDES.size()];
+
+        for (i32 distance = 1; distance < closest; ++distance) {
+            const i32 sideX = x + dx * distance;
+            const i32 sideZ = z + dz * distance;
+            if (_getMaterial(sideX, y, sideZ) != MaterialType::Air)
+                break;
+            if (_getMaterial(sideX, y - 1, sideZ) == MaterialType::Air) {
+                closest = distance;
+                toX = x + dx;
+                toY = y;
+                toZ = z + dz;
+                break;
+            }
+        }
+    }
+    return closest <= FLOW_DISTANCE;
+}
+
+/**
+ * @return false if the cell was already claimed this tick.
+ */
+bool BlockSimulation::_claim(const u32 location) {
+    const u32 chunk = location >> 16;
+    const u32 cell = location & 0xFFFF;
+
+    if (m_claimed[chunk].test(cell))
+        return false;
+    if (m_claimed[chunk].none())
+        m_claimedChunks.push_back(chunk);
+    m_claimed[chunk].set(cell);
+    return true;
+}
+
+/* ========================================================================== */
+
+/**
+ * @brief Outside the world counts as stone: nothing moves there.
+ */
+MaterialType BlockSimulation::_getMaterial(const i32 x, const i32 y, const i32 z) const noexcept {
+    if (x < 0 || x >= WORLD_BLOCK_SIZE || y < 0 || y >= WORLD_BLOCK_HEIGHT || z < 0 || z >= WORLD_BLOCK_SIZE)
+        return MaterialType::Stone;
+
+    return m_world->getBlock(x, y, z).getMaterial();
+}
+
+/**
+ * @brief Packs a world position as chunk index (y/z/x, like the world) << 16
+ * | cell.
+ * @return false outside the world.
+ */
+bool BlockSimulation::_locate(const i32 x, const i32 y, const i32 z, u32& location) noexcept {
+    if (x < 0 || x >= WORLD_BLOCK_SIZE || y < 0 || y >= WORLD_BLOCK_HEIGHT || z < 0 || z >= WORLD_BLOCK_SIZE)
+        return false;
+
+    const u32 chunk = (y / CHUNK_HEIGHT) * RENDER_AREA + (z / CHUNK_SIZE) * RENDER_DISTANCE + (x / CHUNK_SIZE);
+    location = (chunk << 16) | Chunk::toIndex(x % CHUNK_SIZE, y % CHUNK_HEIGHT, z % CHUNK_SIZE);
+    return true;
+}
+
+void BlockSimulation::_toPosition(const u32 location, i32& x, i32& y, i32& z) noexcept {
+    const u32 chunk = location >> 16;
+
+    u32 localX, localY, localZ;
+    Chunk::toPosition(location & 0xFFFF, localX, localY, localZ);
+
+    x = (chunk % RENDER_DISTANCE) * CHUNK_SIZE + localX;
+    z = ((chunk / RENDER_DISTANCE) % RENDER_DISTANCE) * CHUNK_SIZE + localZ;
+    y = (chunk / RENDER_AREA) * CHUNK_HEIGHT + localY;
+}
+
+} // namespace game
@@ -0,0 +1,132 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   block_simulation.h                                 :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/07/06 10:12:53 by etran             #+#    #+#             */
+/*   Updated: 2024/07/07 22:03:44 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#pragma once
+
+#include "types.h"
+#include "game_decl.h"
+#include "block_decl.h"
+
+#include <array>
+#include <bitset>
+#include <vector>
+
+namespace game {
+
+class World;
+struct BlockEdit;
+
+/**
+ * @brief Block updates of falling sand and flowing water.
+ *
+ * Only scheduled cells are updated: a change wakes the cells around it, a
+ * cell that cannot move falls asleep. Schedules are double buffered, cells
+ * woken during a tick run on the next one.
+ *
+ * A tick decides every move from the world as it was when the tick started,
+ * chunk by chunk on the job system. Moves are then accepted in chunk and cell
+ * order, each cell moving or being moved into at most once: the result does
+ * not depend on the threads. Accepted moves come out as block edits, to go
+ * through the world like any other.
+ */
+class BlockSimulation final {
+public:
+    /* ====================================================================== */
+    /*                             STATIC MEMBERS                             */
+    /* ====================================================================== */
+
+    static constexpr f32    TICK_DURATION = 0.05f;
+    static constexpr u32    MAX_CATCHUP_TICKS = 4;
+
+    // How far water looks sideways for somewhere to fall
+    static constexpr i32    FLOW_DISTANCE = 4;
+
+    static constexpr u32    CHUNK_COUNT = RENDER_VOLUME;
+
+    /* ====================================================================== */
+    /*                                 METHODS                                */
+    /* ====================================================================== */
+
+    BlockSimulation() = default;
+    ~BlockSimulation() = default;
+
+    BlockSimulation(BlockSimulation&& other) = delete;
+    BlockSimulation(const BlockSimulation& other) = delete;
+    BlockSimulation& operator=(BlockSimulation&& other) = delete;
+    BlockSimulation& operator=(const BlockSimulation& other) = delete;
+
+    /* ====================================================================== */
+
+    void    init(const World& world, const u32 seed);
+    void    destroy() noexcept;
+
+    void    wake(const i32 x, const i32 y, const i32 z);
+    void    tick(std::vector<BlockEdit>& edits);
+
+    /* ====================================================================== */
+
+    u32     getActiveCount() const noexcept;
+    u64     getTick() const noexcept;
+
+private:
+    /* ====================================================================== */
+    /*                                TYPEDEFS                                */
+    /* ====================================================================== */
+
+    struct Move {
+        u32 m_from = 0; // Chunk index << 16 | cell
+        u32 m_to = 0;
+    };
+
+    struct ChunkSchedule {
+        std::vector<u16>            m_cells;
+        std::bitset<CHUNK_VOLUME>   m_queued;
+    };
+
+    /* ====================================================================== */
+    /*                                  DATA                                  */
+    /* ====================================================================== */
+
+    const World*                m_world = nullptr;
+    u32                         m_seed = 0;
+    u64                         m_tick = 0;
+
+    // Cells to run next tick
+    std::vector<ChunkSchedule>  m_schedules;
+    std::vector<u32>            m_activeChunks;
+
+    // Running tick, one slot per active chunk
+    std::vector<u32>                m_tickChunks;
+    std::vector<std::vector<u16>>   m_tickCells;
+    std::vector<std::vector<Move>>  m_tickMoves;
+
+    std::vector<std::bitset<CHUNK_VOLUME>>  m_claimed;
+    std::vector<u32>                        m_claimedChunks;
+
+    /* ====================================================================== */
+    /*                                 METHODS                                */
+    /* ====================================================================== */
+
+    void    _schedule(const i32 x, const i32 y, const i32 z);
+    void    _evaluate(const u32 slot);
+    bool    _evaluateSand(const i32 x, const i32 y, const i32 z, const u64 random, i32& toX, i32& toY, i32& toZ) const noexcept;
+    bool    _evaluateWater(const i32 x, const i32 y, const i32 z, const u64 random, i32& toX, i32& toY, i32& toZ) const noexcept;
+    bool    _claim(const u32 location);
+
+    MaterialType    _getMaterial(const i32 x, const i32 y, const i32 z) const noexcept;
+
+    static bool     _locate(const i32 x, const i32 y, const i32 z, u32& location) noexcept;
+    static void     _toPosition(const u32 location, i32& x, i32& y, i32& z) noexcept;
+
+}; // class BlockSimulation
+
+} // namespace game
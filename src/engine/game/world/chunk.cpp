@@ -6,19 +6,21 @@
 /*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2024/03/15 16:08:27 by etran             #+#    #+#             */
-/*   Updated: 2024/06/13 15:50:32 by etran            ###   ########.fr       */
+/*   Updated: 2024/07/07 21:52:31 by etran            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #include "chunk.h"
-#include "perlin_noise.h"
-#include "voxmap.h"
+#include "noise_sampler.h"
+#include "biome_map.h"
+#include "block_pool.h"
 
-#include "debug.h"
+#include <cassert>
+#include <memory>
+#include <type_traits>
+#include <utility>
 
-namespace proc {
-using VoronoiDiagram = VoxMap;
-}
+#include "debug.h"
 
 namespace game {
 
@@ -26,15 +28,56 @@ namespace game {
 /*                                   PUBLIC                                   */
 /* ========================================================================== */
 
+Chunk::Chunk(Chunk&& other) noexcept:
+    m_blockPool(other.m_blockPool),
+    m_blocks(std::exchange(other.m_blocks, nullptr)),
+    m_columns(std::move(other.m_columns)),
+    m_boundingBox(std::move(other.m_boundingBox)),
+    m_position(other.m_position),
+    m_updated(other.m_updated) {}
+
+Chunk& Chunk::operator=(Chunk&& other) noexcept {
+    if (this != &other) {
+        m_blockPool = other.m_blockPool;
+        m_blocks = std::exchange(other.m_blocks, nullptr);
+        m_columns = std::move(other.m_columns);
+        m_boundingBox = std::move(other.m_boundingBox);
+        m_position = other.m_position;
+        m_updated = other.m_updated;
+    }
+    return *this;
+}
+
+/* ========================================================================== */
+
+/**
+ * @brief Block storage is taken from the pool on the first write. The chunk
+ * must be given back to the same pool with `destroy`.
+ */
+void Chunk::init(mem::BlockPool& blockPool) {
+    static_assert(std::is_trivially_destructible_v<Block>);
+
+    m_blockPool = &blockPool;
+}
+
+void Chunk::destroy(mem::BlockPool& blockPool) noexcept {
+    blockPool.release(m_blocks);
+    m_blocks = nullptr;
+}
+
+/* ========================================================================== */
+
 void Chunk::generate(
-    const proc::PerlinNoise& terrainNoise,
-    // const proc::PerlinNoise& moistureNoise,
-    const proc::VoronoiDiagram& biomeMap,
+    const proc::NoiseSampler& terrainNoise,
+    // const proc::NoiseSampler& moistureNoise,
+    proc::BiomeMap& biomeMap,
     const u32 offsetX,
     const u32 offsetY,
     const u32 offsetZ
-) noexcept {
-    m_blocks.resize(CHUNK_VOLUME);
+) {
+    // Back to a height field
+    m_blockPool->release(m_blocks);
+    m_blocks = nullptr;
 
     constexpr math::Vect3 HALF_CHUNK = math::Vect3(CHUNK_SIZE / 2.0f);
 
@@ -43,64 +86,126 @@ void Chunk::generate(
         HALF_CHUNK);
     m_position = { offsetX, offsetY, offsetZ };
 
+    for (Column& column: m_columns)
+        column.m_runCount = 0;
+
     // Only generate at height 0
     if (offsetY == 0) {
+        static_assert(proc::BiomeMap::TILE_SIZE % CHUNK_SIZE == 0, "Chunks must not straddle biome tiles.");
+
+        const i64 originX = (i64)offsetX * CHUNK_SIZE;
+        const i64 originZ = (i64)offsetZ * CHUNK_SIZE;
+        const u32 biomeX = proc::BiomeMap::toLocal(originX);
+        const u32 biomeZ = proc::BiomeMap::toLocal(originZ);
+        const proc::BiomeMap::TilePtr biomes = biomeMap.getTile(
+            proc::BiomeMap::toTile(originX),
+            proc::BiomeMap::toTile(originZ));
+
+        proc::NoiseTile terrain;
+        terrain.fill(terrainNoise, originX, originZ, CHUNK_SIZE, CHUNK_SIZE);
+
         for (u32 z = 0; z < CHUNK_SIZE; ++z) {
             for (u32 x = 0; x < CHUNK_SIZE; ++x) {
-                const u32 blockX = x + (offsetX * CHUNK_SIZE);
-                const u32 blockZ = z + (offsetZ * CHUNK_SIZE);
-
                 const f32 moisture = 0.0f; // moistureNoise.noiseAt(blockX, blockZ);
-                const Biome biome = _getBiome(biomeMap.getValue((f32)blockX, (f32)blockZ), moisture);
-                const u8 terrainHeight = _generateHeight(terrainNoise, biome, blockX, blockZ);
+                const Biome biome = _getBiome(biomes->getValue(biomeX + x, biomeZ + z), moisture);
+                const u8 terrainHeight = _generateHeight(terrain.noiseAt(x, z), biome);
 
-                MaterialType material = MaterialType::Dirt;
+                Column&         column = m_columns[z * CHUNK_SIZE + x];
+                MaterialType    material = MaterialType::Dirt;
 
                 for (u32 y = 0; y < terrainHeight; ++y) {
                     material = _getMaterial(biome, y);
-                    m_blocks[(y * CHUNK_AREA) + (z * CHUNK_SIZE) + x] = Block(material, biome);
+                    _pushRun(column, material, biome, y + 1);
                 }
 
                 if (material == MaterialType::Dirt)
-                    m_blocks[(terrainHeight * CHUNK_AREA) + (z * CHUNK_SIZE) + x] = MaterialType::Grass;
+                    _pushRun(column, MaterialType::Grass, Biome::Plains, terrainHeight + 1);
                 else
-                    m_blocks[(terrainHeight * CHUNK_AREA) + (z * CHUNK_SIZE) + x] = Block(material, biome);
+                    _pushRun(column, material, biome, terrainHeight + 1);
             }
         }
     }
 }
 
-Block& Chunk::operator[](const u32 index) noexcept {
-    return m_blocks[index];
-}
-
 const Block& Chunk::operator[](const u32 index) const noexcept {
-    return m_blocks[index];
-}
+    if (m_blocks != nullptr)
+        return m_blocks[index];
 
-Block& Chunk::getBlock(const u32 x, const u32 y, const u32 z) noexcept {
-    return m_blocks[(y * CHUNK_AREA) + (z * CHUNK_SIZE) + x];
+    u32 x, y, z;
+    toPosition(index, x, y, z);
+    return _getColumnBlock(x, y, z);
 }
 
 const Block& Chunk::getBlock(const u32 x, const u32 y, const u32 z) const noexcept {
-    return m_blocks[(y * CHUNK_AREA) + (z * CHUNK_SIZE) + x];
+    if (m_blocks != nullptr)
+        return m_blocks[toIndex(x, y, z)];
+    return _getColumnBlock(x, y, z);
 }
 
-const Chunk::BlockArray& Chunk::getBlocks() const {
-    return m_blocks;
+/**
+ * @note Only dense chunks have a block array: height fields go through
+ * getBlock().
+ */
+Chunk::BlockArray Chunk::getBlocks() const {
+    assert(isDense());
+    return BlockArray(m_blocks, CHUNK_VOLUME);
 }
 
 /**
  * @brief Returns packed chunk position. cf. chart.md
  */
 u16 Chunk::getId() const {
-    constexpr u32 sizeOfX = 5;
-    constexpr u32 sizeOfZ = 5;
-    constexpr u32 sizeOfY = 4;
+    static_assert(WorldInstanceLayout::CHUNK_BITS <= 16, "Update id size.");
 
-    static_assert((sizeOfX + sizeOfY + sizeOfZ) < 16, "Update id size.");
+    return WorldInstanceLayout::packChunk(m_position.m_x, m_position.m_y, m_position.m_z);
+}
+
+/**
+ * @brief Writes a block, keeping the chunk a height field when the column
+ * still fits in MAX_COLUMN_RUNS runs.
+ */
+void Chunk::setBlock(
+    const u32 x,
+    const u32 y,
+    const u32 z,
+    const MaterialType material,
+    const Biome biome
+) {
+    if (m_blocks == nullptr) {
+        if (_setColumnBlock(m_columns[z * CHUNK_SIZE + x], y, material, biome))
+            return;
+        _materialize();
+    }
+    m_blocks[toIndex(x, y, z)] = Block(material, biome);
+}
 
-    return (m_position.m_x << (sizeOfZ + sizeOfY)) | (m_position.m_y << sizeOfX) | m_position.m_z;
+bool Chunk::isDense() const noexcept {
+    return m_blocks != nullptr;
+}
+
+/**
+ * @brief Solid blocks of a column, bit y set for block y.
+ */
+u32 Chunk::getColumnMask(const u32 x, const u32 z) const noexcept {
+    static_assert(CHUNK_HEIGHT <= 32, "Column masks hold one bit per block.");
+
+    if (m_blocks == nullptr) {
+        const Column& column = m_columns[z * CHUNK_SIZE + x];
+
+        u32 mask = 0;
+        for (u32 i = 0, start = 0; i < column.m_runCount; start = column.m_runs[i++].m_end) {
+            if (!column.m_runs[i].m_block.isVoid())
+                mask |= (u32)(((1ULL << column.m_runs[i].m_end) - 1) & ~((1ULL << start) - 1));
+        }
+        return mask;
+    }
+
+    u32 mask = 0;
+    for (u32 y = 0; y < CHUNK_HEIGHT; ++y) {
+        if (!m_blocks[toIndex(x, y, z)].isVoid())
+            mask |= 1U << y;
+    }
+    return mask;
 }
 
 const vox::gfx::BoundingBox& Chunk::getBoundingBox() const noexcept {
@@ -117,6 +222,109 @@ void Chunk::cache() const {
 /*                                   PRIVATE                                  */
 /* ========================================================================== */
 
+/**
+ * @brief Expands the columns into the dense block array.
+ */
+void Chunk::_materialize() {
+    Block* blocks = (Block*)m_blockPool->acquire();
+
+    // Pool storage is recycled: start from air
+    std::uninitialized_default_construct_n(blocks, CHUNK_VOLUME);
+
+    for (u32 z = 0; z < CHUNK_SIZE; ++z) {
+        for (u32 x = 0; x < CHUNK_SIZE; ++x) {
+            const Column& column = m_columns[z * CHUNK_SIZE + x];
+
+            for (u32 i = 0, y = 0; i < column.m_runCount; ++i) {
+                const ColumnRun& run = column.m_runs[i];
+                for (; y < run.m_end; ++y)
+                    blocks[toIndex(x, y, z)] = Block(run.m_block.getMaterial(), run.m_block.getBiome());
+            }
+        }
+    }
+    m_blocks = blocks;
+}
+
+const Block& Chunk::_getColumnBlock(const u32 x, const u32 y, const u32 z) const noexcept {
+    static const Block AIR;
+
+    const Column& column = m_columns[z * CHUNK_SIZE + x];
+    for (u32 i = 0; i < column.m_runCount; ++i) {
+        if (y < column.m_runs[i].m_end)
+            return column.m_runs[i].m_block;
+    }
+    return AIR;
+}
+
+/**
+ * @brief Rebuilds the runs of a column with one block changed. Air may sit
+ * between runs, not above the last one. Leaves the column untouched if the
+ * result needs too many runs.
+ */
+bool Chunk::_setColumnBlock(
+    Column& column,
+    const u32 y,
+    const MaterialType material,
+    const Biome biome
+) noexcept {
+    std::array<MaterialType, CHUNK_HEIGHT>  materials;
+    std::array<Biome, CHUNK_HEIGHT>         biomes;
+    materials.fill(MaterialType::Air);
+    biomes.fill(Biome::Plains);
+
+    for (u32 i = 0, start = 0; i < column.m_runCount; start = column.m_runs[i++].m_end) {
+        for (u32 cell = start; cell < column.m_runs[i].m_end; ++cell) {
+            materials[cell] = column.m_runs[i].m_block.getMaterial();
+            biomes[cell] = column.m_runs[i].m_block.getBiome();
+        }
+    }
+    materials[y] = material;
+    biomes[y] = biome;
+
+    u32 top = CHUNK_HEIGHT;
+    while (top > 0 && materials[top - 1] == MaterialType::Air)
+        --top;
+
+    Column updated;
+    for (u32 cell = 0; cell < top; ++cell) {
+        if (updated.m_runCount > 0) {
+            ColumnRun& last = updated.m_runs[updated.m_runCount - 1];
+            if (last.m_block.getMaterial() == materials[cell] && last.m_block.getBiome() == biomes[cell]) {
+                last.m_end = cell + 1;
+                continue;
+            }
+        }
+        if (updated.m_runCount == MAX_COLUMN_RUNS)
+            return false;
+        updated.m_runs[updated.m_runCount++] = { Block(materials[cell], biomes[cell]), (u8)(cell + 1) };
+    }
+
+    column = std::move(updated);
+    return true;
+}
+
+/**
+ * @brief Appends blocks up to `end`, extending the last run if it holds the
+ * same block. Generated columns never need more than MAX_COLUMN_RUNS runs.
+ */
+void Chunk::_pushRun(
+    Column& column,
+    const MaterialType material,
+    const Biome biome,
+    const u8 end
+) noexcept {
+    if (column.m_runCount > 0) {
+        ColumnRun& last = column.m_runs[column.m_runCount - 1];
+        if (last.m_block.getMaterial() == material && last.m_block.getBiome() == biome) {
+            last.m_end = end;
+            return;
+        }
+    }
+
+    assert(column.m_runCount < MAX_COLUMN_RUNS);
+    column.m_runs[column.m_runCount++] = { Block(material, biome), end };
+}
+
 Biome Chunk::_getBiome(const f32 cellValue, const f32 moisture) const noexcept {
     if (cellValue < 0.4f && moisture > 0.0f) return Biome::Oceans;
     else if (cellValue < 0.3f) return Biome::Plains;
@@ -125,13 +333,8 @@ Biome Chunk::_getBiome(const f32 cellValue, const f32 moisture) const noexcept {
     return Biome::SnowMountains;
 }
 
-u8 Chunk::_generateHeight(
-    const proc::PerlinNoise& terrainNoise,
-    const Biome biome,
-    const u32 x,
-    const u32 z
-) const noexcept {
-    const u8 noiseValue = (u8)terrainNoise.noiseAt(x, z);
+u8 Chunk::_generateHeight(const f32 noise, const Biome biome) const noexcept {
+    const u8 noiseValue = (u8)noise;
 
     switch (biome) {
         case Biome::Plains:
@@ -6,7 +6,7 @@
 /*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2024/03/15 13:29:06 by etran             #+#    #+#             */
-/*   Updated: 2024/06/11 15:42:28 by etran            ###   ########.fr       */
+/*   Updated: 2024/07/07 17:52:19 by etran            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -14,26 +14,56 @@
 
 #include "types.h"
 #include "game_decl.h"
+#include "vox_decl.h"
 #include "block.h"
+#include "chunk_layout.h"
 #include "bounding_box.h"
 
-#include <vector>
+#include <array>
+#include <span>
+
+namespace mem {
+class BlockPool;
+}
 
 namespace proc {
-class PerlinNoise;
-class VoxMap;
-using VoronoiDiagram = VoxMap;
+class NoiseSampler;
+class BiomeMap;
 }
 
 namespace game {
 
+/**
+ * @brief Generated chunks are height fields: each column is stored as a few
+ * runs of blocks. Reads never change the storage: the dense block array is
+ * only taken from the pool when setBlock cannot keep a column in runs, and
+ * columns are not read anymore past that point.
+ */
 class Chunk final {
 public:
     /* ====================================================================== */
     /*                                TYPEDEFS                                */
     /* ====================================================================== */
 
-    using BlockArray = std::vector<Block>;
+    using Layout = WorldChunkLayout;
+    using BlockArray = std::span<const Block, Layout::VOLUME>;
+
+    // Ground layers, plus an air gap & a canopy for decorated columns
+    static constexpr u32    MAX_COLUMN_RUNS = 6;
+
+    /**
+     * @brief Blocks of a column from the bottom up, as runs of the same block.
+     * A run ends below `m_end`, air lies above the last one.
+     */
+    struct ColumnRun {
+        Block   m_block;
+        u8      m_end = 0;
+    };
+
+    struct Column {
+        std::array<ColumnRun, MAX_COLUMN_RUNS>  m_runs;
+        u8                                      m_runCount = 0;
+    };
 
     /* ====================================================================== */
     /*                                 METHODS                                */
@@ -41,31 +71,47 @@ public:
 
     Chunk() = default;
     ~Chunk() = default;
-    Chunk(Chunk&& other) = default;
-    Chunk& operator=(Chunk&& other) = default;
+    Chunk(Chunk&& other) noexcept;
+    Chunk& operator=(Chunk&& other) noexcept;
 
     Chunk(const Chunk& other) = delete;
     Chunk& operator=(const Chunk& other) = delete;
 
     /* ====================================================================== */
 
+    void    init(mem::BlockPool& blockPool);
+    void    destroy(mem::BlockPool& blockPool) noexcept;
+
     void    generate(
-        const proc::PerlinNoise& terrainNoise,
-        const proc::VoronoiDiagram& biomeMap,
+        const proc::NoiseSampler& terrainNoise,
+        proc::BiomeMap& biomeMap,
         const u32 offsetX,
         const u32 offsetY,
-        const u32 offsetZ) noexcept;
+        const u32 offsetZ);
 
     /* ====================================================================== */
 
-    Block&          operator[](const u32 index) noexcept;
     const Block&    operator[](const u32 index) const noexcept;
-    Block&          getBlock(const u32 x, const u32 y, const u32 z) noexcept;
     const Block&    getBlock(const u32 x, const u32 y, const u32 z) const noexcept;
 
-    const BlockArray&   getBlocks() const;
+    BlockArray          getBlocks() const;
     u16                 getId() const;
 
+    void                setBlock(
+        const u32 x,
+        const u32 y,
+        const u32 z,
+        const MaterialType material,
+        const Biome biome = Biome::Plains);
+
+    bool                isDense() const noexcept;
+    u32                 getColumnMask(const u32 x, const u32 z) const noexcept;
+
+    /* ====================================================================== */
+
+    static constexpr u32    toIndex(const u32 x, const u32 y, const u32 z) noexcept;
+    static constexpr void   toPosition(const u32 index, u32& x, u32& y, u32& z) noexcept;
+
     /* ====================================================================== */
 
     const vox::gfx::BoundingBox&  getBoundingBox() const noexcept;
@@ -79,7 +125,9 @@ private:
     /*                                  DATA                                  */
     /* ====================================================================== */
 
-    BlockArray              m_blocks;
+    mem::BlockPool*         m_blockPool = nullptr;
+    Block*                  m_blocks = nullptr;
+    std::array<Column, CHUNK_AREA>  m_columns;
     vox::gfx::BoundingBox   m_boundingBox;
     struct {
         u32 m_x = 0;
@@ -93,10 +141,64 @@ private:
     /* ====================================================================== */
 
     Biome   _getBiome(const f32 cellValue, const f32 moistureValue) const noexcept;
-    u8      _generateHeight(const proc::PerlinNoise& terrainNoise, const Biome biome, const u32 x, const u32 z) const noexcept;
+    u8      _generateHeight(const f32 noise, const Biome biome) const noexcept;
 
     MaterialType _getMaterial(const Biome biome, const u8 height) const noexcept;
 
+    void            _materialize();
+    const Block&    _getColumnBlock(const u32 x, const u32 y, const u32 z) const noexcept;
+
+    static void     _pushRun(Column& column, const MaterialType material, const Biome biome, const u8 end) noexcept;
+    static bool     _setColumnBlock(Column& column, const u32 y, const MaterialType material, const Biome biome) noexcept;
+
 }; // class Chunk
 
+/* ========================================================================== */
+/*                                   INLINE                                   */
+/* ========================================================================== */
+
+#if ENABLE_MORTON_LAYOUT
+
+static_assert(CHUNK_SIZE == 16 && CHUNK_HEIGHT == 16, "Morton layout expects 16^3 chunks.");
+
+/**
+ * @brief Spreads the 4 low bits of `value` 3 bits apart.
+ */
+constexpr u32 _mortonSpread(const u32 value) noexcept {
+    return (value & 0x1) | ((value & 0x2) << 2) | ((value & 0x4) << 4) | ((value & 0x8) << 6);
+}
+
+constexpr u32 _mortonCompact(const u32 value) noexcept {
+    return (value & 0x1) | ((value >> 2) & 0x2) | ((value >> 4) & 0x4) | ((value >> 6) & 0x8);
+}
+
+/**
+ * @brief Block index in Z-order (x, z, y interleaved): the 26 neighbors of a
+ * block mostly share its cache lines.
+ */
+constexpr u32 Chunk::toIndex(const u32 x, const u32 y, const u32 z) noexcept {
+    return _mortonSpread(x) | (_mortonSpread(z) << 1) | (_mortonSpread(y) << 2);
+}
+
+constexpr void Chunk::toPosition(const u32 index, u32& x, u32& y, u32& z) noexcept {
+    x = _mortonCompact(index);
+    z = _mortonCompact(index >> 1);
+    y = _mortonCompact(index >> 2);
+}
+
+#else
+
+/**
+ * @brief Block index in y/z/x rows: x is contiguous.
+ */
+constexpr u32 Chunk::toIndex(const u32 x, const u32 y, const u32 z) noexcept {
+    return Layout::toIndex(x, y, z);
+}
+
+constexpr void Chunk::toPosition(const u32 index, u32& x, u32& y, u32& z) noexcept {
+    Layout::toPosition(index, x, y, z);
+}
+
+#endif // ENABLE_MORTON_LAYOUT
+
 } // namespace game
\ No newline at end of file
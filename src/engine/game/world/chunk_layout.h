@@ -0,0 +1,149 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   chunk_layout.h                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/07/07 10:14:36 by etran             #+#    #+#             */
+/*   Updated: 2024/07/07 16:20:14 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+#pragma once
+
+#include "types.h"
+#include "game_decl.h"
+#include "block_decl.h"
+
+#include <bit>
+#include <type_traits>
+
+namespace game {
+
+/**
+ * @brief Dimensions of a chunk and everything derived from them: index
+ * layout, column mask type and packed block id.
+ *
+ * Chunk, the mesher and the instance packing read their sizes from here, so
+ * a chunk type with another layout can be meshed in the same binary.
+ */
+template <u32 Size, u32 Height>
+struct ChunkLayout final {
+    static_assert(std::has_single_bit(Size) && std::has_single_bit(Height), "Chunk sides must be powers of 2.");
+    static_assert(Height <= 64, "A chunk column must fit in a 64 bit mask.");
+
+    /* ====================================================================== */
+    /*                             STATIC MEMBERS                             */
+    /* ====================================================================== */
+
+    static constexpr u32    SIZE = Size;
+    static constexpr u32    HEIGHT = Height;
+    static constexpr u32    AREA = SIZE * SIZE;
+    static constexpr u32    VOLUME = AREA * HEIGHT;
+
+    static constexpr u32    SIZE_BITS = std::countr_zero(Size);
+    static constexpr u32    HEIGHT_BITS = std::countr_zero(Height);
+
+    // x, y, z in a block id, from the highest bits
+    static constexpr u32    BLOCK_BITS = 2 * SIZE_BITS + HEIGHT_BITS;
+
+    /* ====================================================================== */
+    /*                                TYPEDEFS                                */
+    /* ====================================================================== */
+
+    // Bit y of a column is set when block y is solid
+    using ColumnMask = std::conditional_t<HEIGHT <= 16, u16,
+                       std::conditional_t<HEIGHT <= 32, u32, u64>>;
+
+    /* ====================================================================== */
+    /*                                 METHODS                                */
+    /* ====================================================================== */
+
+    ChunkLayout() = delete;
+
+    /* ====================================================================== */
+
+    /**
+     * @brief Block index in y/z/x rows: x is contiguous.
+     */
+    static constexpr u32 toIndex(const u32 x, const u32 y, const u32 z) noexcept {
+        return (y << (2 * SIZE_BITS)) | (z << SIZE_BITS) | x;
+    }
+
+    static constexpr void toPosition(const u32 index, u32& x, u32& y, u32& z) noexcept {
+        x = index & (SIZE - 1);
+        z = (index >> SIZE_BITS) & (SIZE - 1);
+        y = index >> (2 * SIZE_BITS);
+    }
+
+    static constexpr u32 packBlock(const u32 x, const u32 y, const u32 z) noexcept {
+        return (x << (HEIGHT_BITS + SIZE_BITS)) | (y << SIZE_BITS) | z;
+    }
+
+}; // struct ChunkLayout
+
+/**
+ * @brief Bit layout of the packed data of a vertex instance, from the lowest
+ * bits: chunk id, block id, face, texture, level of detail.
+ *
+ * Chunk ids hold the chunk position in the rendered grid, `WidthBits` for x
+ * and z, `HeightBits` for y.
+ */
+template <typename Layout, u32 WidthBits, u32 HeightBits>
+struct InstanceLayout final {
+    /* ====================================================================== */
+    /*                             STATIC MEMBERS                             */
+    /* ====================================================================== */
+
+    static constexpr u32    CHUNK_BITS = 2 * WidthBits + HeightBits;
+    static constexpr u32    FACE_BITS = 3;
+    static constexpr u32    TEXTURE_BITS = 3;
+    static constexpr u32    LOD_BITS = 2;
+
+    static constexpr u32    BLOCK_SHIFT = CHUNK_BITS;
+    static constexpr u32    FACE_SHIFT = BLOCK_SHIFT + Layout::BLOCK_BITS;
+    static constexpr u32    TEXTURE_SHIFT = FACE_SHIFT + FACE_BITS;
+    static constexpr u32    LOD_SHIFT = TEXTURE_SHIFT + TEXTURE_BITS;
+
+    static_assert(LOD_SHIFT + LOD_BITS <= 32, "Vertex instance data overflows 32 bits.");
+
+    /* ====================================================================== */
+    /*                                 METHODS                                */
+    /* ====================================================================== */
+
+    InstanceLayout() = delete;
+
+    /* ====================================================================== */
+
+    static constexpr u32 packChunk(const u32 x, const u32 y, const u32 z) noexcept {
+        return (x << (WidthBits + HeightBits)) | (y << WidthBits) | z;
+    }
+
+    static constexpr u32 pack(
+        const u32 face,
+        const u32 textureId,
+        const u32 blockId,
+        const u32 chunkId,
+        const u32 lod = 0
+    ) noexcept {
+        return (lod << LOD_SHIFT) | (textureId << TEXTURE_SHIFT) | (face << FACE_SHIFT) | (blockId << BLOCK_SHIFT) | chunkId;
+    }
+
+}; // struct InstanceLayout
+
+/* ========================================================================== */
+
+// The world and the shaders, through the game_decl.h macros
+using WorldChunkLayout = ChunkLayout<CHUNK_SIZE, CHUNK_HEIGHT>;
+using WorldInstanceLayout = InstanceLayout<WorldChunkLayout, CHUNK_ID_WIDTH_BITS, CHUNK_ID_HEIGHT_BITS>;
+
+static_assert(WorldChunkLayout::SIZE_BITS == CHUNK_SIZE_BITS && WorldChunkLayout::HEIGHT_BITS == CHUNK_HEIGHT_BITS,
+    "CHUNK_SIZE_BITS and CHUNK_HEIGHT_BITS must match the chunk dimensions.");
+static_assert(WorldInstanceLayout::CHUNK_BITS == CHUNK_ID_BITS &&
+    WorldInstanceLayout::FACE_SHIFT == INSTANCE_FACE_SHIFT &&
+    WorldInstanceLayout::LOD_SHIFT == INSTANCE_LOD_SHIFT,
+    "Shaders unpack instances with the game_decl.h macros.");
+static_assert((1U << CHUNK_ID_WIDTH_BITS) >= RENDER_DISTANCE && (1U << CHUNK_ID_HEIGHT_BITS) >= RENDER_HEIGHT,
+    "Chunk id fields too narrow for the render area.");
+
+} // namespace game
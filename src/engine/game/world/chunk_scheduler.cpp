@@ -0,0 +1,161 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   chunk_scheduler.cpp                                :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/07/04 18:36:20 by etran             #+#    #+#             */
+/*   Updated: 2024/07/04 18:36:20 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "chunk_scheduler.h"
+
+#include <algorithm>
+
+namespace game {
+
+/* ========================================================================== */
+/*                                   PUBLIC                                   */
+/* ========================================================================== */
+
+/**
+ * @param width, height, depth Chunk counts along x, y and z, chunks being
+ * indexed y/z/x like the world.
+ */
+void ChunkScheduler::init(const u32 width, const u32 height, const u32 depth) {
+    m_width = width;
+    m_height = height;
+    m_depth = depth;
+
+    const u32 chunkCount = m_width * m_height * m_depth;
+    for (Queue& queue: m_queues) {
+        queue.m_heap.reserve(chunkCount);
+        queue.m_tickets.assign(chunkCount, 0);
+    }
+}
+
+void ChunkScheduler::destroy() noexcept {
+    for (Queue& queue: m_queues)
+        queue = Queue{};
+}
+
+/**
+ * @brief Moves the focus. Pending work is only reordered past a
+ * REFOCUS_DISTANCE move or a turn wider than acos(REFOCUS_COS): small
+ * camera motions don't reorder the queues every frame.
+ */
+void ChunkScheduler::setFocus(const math::Vect3& position, const math::Vect3& front) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    const bool moved = math::norm(position - m_position) > REFOCUS_DISTANCE;
+    const bool turned = math::dot(front, m_front) < REFOCUS_COS;
+    if (!moved && !turned)
+        return;
+
+    m_position = position;
+    m_front = front;
+    _reprioritize();
+}
+
+/* ========================================================================== */
+
+void ChunkScheduler::push(const ChunkTask task, const u32 chunk) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    Queue& queue = m_queues[(u32)task];
+    const u32 ticket = ++queue.m_tickets[chunk];
+    queue.m_heap.push_back({ chunk, ticket, _computePriority(chunk) });
+    std::push_heap(queue.m_heap.begin(), queue.m_heap.end(), _isLater);
+}
+
+/**
+ * @brief Drops the pending work of a chunk, if any.
+ */
+void ChunkScheduler::cancel(const ChunkTask task, const u32 chunk) noexcept {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ++m_queues[(u32)task].m_tickets[chunk];
+}
+
+/**
+ * @brief Takes the most urgent valid work of a kind.
+ * @return false if there is none.
+ */
+bool ChunkScheduler::pop(const ChunkTask task, u32& chunk) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    Queue& queue = m_queues[(u32)task];
+    while (!queue.m_heap.empty()) {
+        std::pop_heap(queue.m_heap.begin(), queue.m_heap.end(), _isLater);
+        const Work work = queue.m_heap.back();
+        queue.m_heap.pop_back();
+
+        if (work.m_ticket == queue.m_tickets[work.m_chunk]) {
+            // Consumed: a later cancel must not match anything
+            ++queue.m_tickets[work.m_chunk];
+            chunk = work.m_chunk;
+            return true;
+        }
+    }
+    return false;
+}
+
+/* ========================================================================== */
+
+/**
+ * @brief Pending entries, stale ones included.
+ */
+u32 ChunkScheduler::getPendingCount(const ChunkTask task) const noexcept {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_queues[(u32)task].m_heap.size();
+}
+
+/* ========================================================================== */
+/*                                   PRIVATE                                  */
+/* ========================================================================== */
+
+/**
+ * @brief Distance from the focus to the chunk center, stretched up to
+ * 1 + 2 * FACING_WEIGHT times as the chunk leaves the view direction.
+ * Lower runs first.
+ */
+f32 ChunkScheduler::_computePriority(const u32 chunk) const noexcept {
+    const u32 x = chunk % m_width;
+    const u32 z = (chunk / m_width) % m_depth;
+    const u32 y = chunk / (m_width * m_depth);
+
+    const math::Vect3 center = math::Vect3(x + 0.5f, y + 0.5f, z + 0.5f) * CHUNK_SIZE;
+    const math::Vect3 offset = center - m_position;
+    const f32 distance = math::norm(offset);
+    if (distance == 0.0f)
+        return 0.0f;
+
+    const f32 facing = math::dot(offset / distance, m_front);
+    return distance * (1.0f + FACING_WEIGHT * (1.0f - facing));
+}
+
+/**
+ * @brief Recomputes every priority, dropping stale entries on the way.
+ */
+void ChunkScheduler::_reprioritize() noexcept {
+    for (Queue& queue: m_queues) {
+        std::erase_if(queue.m_heap, [&queue](const Work& work) {
+            return work.m_ticket != queue.m_tickets[work.m_chunk];
+        });
+        for (Work& work: queue.m_heap)
+            work.m_priority = _computePriority(work.m_chunk);
+        std::make_heap(queue.m_heap.begin(), queue.m_heap.end(), _isLater);
+    }
+}
+
+/**
+ * @brief Heap order: the top is the lowest priority value.
+ */
+bool ChunkScheduler::_isLater(const Work& a, const Work& b) noexcept {
+    if (a.m_priority != b.m_priority)
+        return a.m_priority > b.m_priority;
+    return a.m_chunk > b.m_chunk;
+}
+
+} // namespace game
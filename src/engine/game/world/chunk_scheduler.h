@@ -0,0 +1,157 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   chunk_scheduler.h                                  :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/07/04 18:36:20 by etran             #+#    #+#             */
+/*   Updated: 2024/07/04 18:36:20 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#pragma once
+
+#include "types.h"
+#include "game_decl.h"
+#include "vector.h"
+
+#include <array>
+#include <chrono>
+#include <mutex>
+#include <vector>
+
+namespace game {
+
+/**
+ * @brief Kinds of chunk work, each kind has its own queue.
+ */
+enum class ChunkTask: u8 {
+    Generate,   // run by the workers
+    Mesh,       // run on the main thread, within a frame budget
+    Count
+};
+
+/**
+ * @brief Orders chunk work around a focus point: near chunks first, and
+ * among them the ones in front of the camera.
+ *
+ * Priorities are only re-evaluated once the focus moved or turned enough.
+ * Pushing a chunk again supersedes its pending work of the same kind, and
+ * cancelled or superseded entries are dropped when met.
+ *
+ * @note Thread safe.
+ */
+class ChunkScheduler final {
+public:
+    /* ====================================================================== */
+    /*                             STATIC MEMBERS                             */
+    /* ====================================================================== */
+
+    static constexpr u32    TASK_COUNT = (u32)ChunkTask::Count;
+
+    // A chunk behind the camera counts as 1 + 2 * FACING_WEIGHT times farther
+    static constexpr f32    FACING_WEIGHT = 1.0f;
+    static constexpr f32    REFOCUS_DISTANCE = CHUNK_SIZE * 0.5f;
+    static constexpr f32    REFOCUS_COS = 0.966f; // ~15 degrees
+
+    /* ====================================================================== */
+    /*                                TYPEDEFS                                */
+    /* ====================================================================== */
+
+    struct Work {
+        u32 m_chunk = 0;
+        u32 m_ticket = 0;
+        f32 m_priority = 0.0f;
+    };
+
+    /* ====================================================================== */
+    /*                                 METHODS                                */
+    /* ====================================================================== */
+
+    ChunkScheduler() = default;
+    ~ChunkScheduler() = default;
+
+    ChunkScheduler(ChunkScheduler&& other) = delete;
+    ChunkScheduler(const ChunkScheduler& other) = delete;
+    ChunkScheduler& operator=(ChunkScheduler&& other) = delete;
+    ChunkScheduler& operator=(const ChunkScheduler& other) = delete;
+
+    /* ====================================================================== */
+
+    void    init(const u32 width, const u32 height, const u32 depth);
+    void    destroy() noexcept;
+
+    void    setFocus(const math::Vect3& position, const math::Vect3& front);
+
+    /* ====================================================================== */
+
+    void    push(const ChunkTask task, const u32 chunk);
+    void    cancel(const ChunkTask task, const u32 chunk) noexcept;
+    bool    pop(const ChunkTask task, u32& chunk);
+
+    template <typename Fn>
+    u32     process(const ChunkTask task, const f32 budget, const Fn& fn);
+
+    /* ====================================================================== */
+
+    u32     getPendingCount(const ChunkTask task) const noexcept;
+
+private:
+    /* ====================================================================== */
+    /*                                  DATA                                  */
+    /* ====================================================================== */
+
+    struct Queue {
+        std::vector<Work>   m_heap;
+        std::vector<u32>    m_tickets; // Per chunk, only the latest is valid
+    };
+
+    mutable std::mutex              m_mutex;
+    std::array<Queue, TASK_COUNT>   m_queues;
+    u32                             m_width = 0;
+    u32                             m_height = 0;
+    u32                             m_depth = 0;
+
+    math::Vect3                     m_position;
+    math::Vect3                     m_front;
+
+    /* ====================================================================== */
+    /*                                 METHODS                                */
+    /* ====================================================================== */
+
+    f32     _computePriority(const u32 chunk) const noexcept;
+    void    _reprioritize() noexcept;
+
+    static bool _isLater(const Work& a, const Work& b) noexcept;
+
+}; // class ChunkScheduler
+
+/* ========================================================================== */
+/*                                  TEMPLATES                                 */
+/* ========================================================================== */
+
+/**
+ * @brief Runs `fn(chunk)` on the most urgent work of a kind until `budget`
+ * milliseconds are spent. At least one is run, so work always progresses.
+ *
+ * @return Number of chunks processed.
+ */
+template <typename Fn>
+u32 ChunkScheduler::process(const ChunkTask task, const f32 budget, const Fn& fn) {
+    using Clock = std::chrono::steady_clock;
+
+    const Clock::time_point start = Clock::now();
+    u32 count = 0;
+    u32 chunk;
+
+    while (pop(task, chunk)) {
+        fn(chunk);
+        ++count;
+        if (std::chrono::duration<f32, std::milli>(Clock::now() - start).count() >= budget)
+            break;
+    }
+    return count;
+}
+
+} // namespace game
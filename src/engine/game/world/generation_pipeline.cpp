@@ -0,0 +1,350 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   generation_pipeline.cpp                            :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/07/04 15:12:37 by etran             #+#    #+#             */
+/*   Updated: 2024/07/07 18:14:36 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "generation_pipeline.h"
+#include "chunk.h"
+#include "chunk_scheduler.h"
+#include "counter_rng.h"
+#include "job_system.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstdlib>
+#include <stdexcept>
+#include <utility>
+
+namespace game {
+
+/* ========================================================================== */
+/*                                   PUBLIC                                   */
+/* ========================================================================== */
+
+/**
+ * @param width, height, depth Chunk counts along x, y and z, `chunks` being
+ * indexed y/z/x like the world.
+ */
+void GenerationPipeline::init(
+    std::span<Chunk> chunks,
+    const u32 width,
+    const u32 height,
+    const u32 depth,
+    const proc::NoiseSampler& terrainNoise,
+    proc::BiomeMap& biomeMap,
+    ChunkScheduler& scheduler,
+    const u32 seed
+) {
+    if (chunks.size() != (u64)width * height * depth)
+        throw std::runtime_error("generation pipeline: chunk count does not match the dimensions");
+
+    m_chunks = chunks;
+    m_states = std::vector<ChunkState>(chunks.size());
+    m_width = width;
+    m_height = height;
+    m_depth = depth;
+    m_terrainNoise = &terrainNoise;
+    m_biomeMap = &biomeMap;
+    m_scheduler = &scheduler;
+    m_seed = seed;
+}
+
+void GenerationPipeline::destroy() noexcept {
+    m_states = std::vector<ChunkState>();
+    m_chunks = {};
+    m_terrainNoise = nullptr;
+    m_biomeMap = nullptr;
+    m_scheduler = nullptr;
+}
+
+/**
+ * @brief Brings every chunk to the last stage. Stages are chained from the
+ * workers as chunks complete, the calling thread helps until all are done.
+ */
+void GenerationPipeline::run() {
+    for (u32 index = 0; index < m_chunks.size(); ++index)
+        _schedule(index);
+    jobs::JobSystem::wait(m_counter);
+}
+
+/* ========================================================================== */
+
+GenerationStage GenerationPipeline::getStage(const u32 index) const noexcept {
+    return (GenerationStage)m_states[index].m_stage.load();
+}
+
+/* ========================================================================== */
+/*                                   PRIVATE                                  */
+/* ========================================================================== */
+
+/**
+ * @brief Submits the next stage of a chunk if its area is ready. Both a chunk
+ * and its neighbors try this on completion, the compare-exchange makes sure
+ * only one of them submits it.
+ *
+ * The job does not carry the chunk: it runs the most urgent ready one when
+ * a worker picks it up.
+ */
+void GenerationPipeline::_schedule(const u32 index) {
+    ChunkState& state = m_states[index];
+    u8 stage = state.m_stage.load();
+
+    if (stage == (u8)GenerationStage::Spill || !_isReady(index, stage))
+        return;
+    if (!state.m_scheduled.compare_exchange_strong(stage, stage + 1))
+        return;
+
+    m_scheduler->push(ChunkTask::Generate, index);
+
+    jobs::Job job{};
+    job.m_function = [](const void* data, const u32, const u32) {
+        GenerationPipeline& pipeline = *(GenerationPipeline*)data;
+
+        u32 chunk;
+        if (pipeline.m_scheduler->pop(ChunkTask::Generate, chunk))
+            pipeline._execute(chunk);
+    };
+    job.m_data = this;
+    job.m_counter = &m_counter;
+    jobs::JobSystem::run(job);
+}
+
+void GenerationPipeline::_execute(const u32 index) {
+    ChunkState& state = m_states[index];
+    const GenerationStage stage = (GenerationStage)state.m_scheduled.load();
+
+    switch (stage) {
+        case GenerationStage::Terrain:
+            _generateTerrain(index);
+            break;
+        case GenerationStage::Surface:
+            _generateSurface(index);
+            break;
+        case GenerationStage::Decoration:
+            _decorate(index);
+            break;
+        case GenerationStage::Spill:
+            _applyWrites(index);
+            break;
+        default:
+            return;
+    }
+
+    state.m_stage.store((u8)stage);
+    _notify(index);
+}
+
+/**
+ * @brief A completed stage may unlock the chunk itself or any neighbor.
+ */
+void GenerationPipeline::_notify(const u32 index) {
+    for (i32 dz = -1; dz <= 1; ++dz) {
+        for (i32 dx = -1; dx <= 1; ++dx) {
+            const i64 neighbor = _getNeighbor(index, dx, dz);
+            if (neighbor >= 0)
+                _schedule((u32)neighbor);
+        }
+    }
+}
+
+bool GenerationPipeline::_isReady(const u32 index, const u8 stage) const noexcept {
+    for (i32 dz = -1; dz <= 1; ++dz) {
+        for (i32 dx = -1; dx <= 1; ++dx) {
+            const i64 neighbor = _getNeighbor(index, dx, dz);
+            if (neighbor >= 0 && m_states[neighbor].m_stage.load() < stage)
+                return false;
+        }
+    }
+    return true;
+}
+
+/* ========================================================================== */
+
+void GenerationPipeline::_generateTerrain(const u32 index) {
+    u32 x, y, z;
+    _toPosition(index, x, y, z);
+
+    Chunk& chunk = m_chunks[index];
+    chunk.generate(*m_terrainNoise, *m_biomeMap, x, y, z);
+
+    // Later stages of the neighbors read the heights, never the chunk itself
+    ChunkState& state = m_states[index];
+    for (u32 column = 0; column < CHUNK_AREA; ++column)
+        state.m_heights[column] = std::bit_width(chunk.getColumnMask(column % CHUNK_SIZE, column / CHUNK_SIZE));
+}
+
+/**
+ * @brief Grass does not hold on steep drops: tops overlooking a cliff turn to
+ * stone.
+ */
+void GenerationPipeline::_generateSurface(const u32 index) {
+    constexpr std::array<std::pair<i32, i32>, 4> SIDES = {{
+        { -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 }
+    }};
+
+    Chunk& chunk = m_chunks[index];
+
+    for (i32 z = 0; z < (i32)CHUNK_SIZE; ++z) {
+        for (i32 x = 0; x < (i32)CHUNK_SIZE; ++x) {
+            const i32 height = _getHeight(index, x, z);
+            if (height == 0)
+                continue;
+
+            const Block& top = chunk.getBlock(x, height - 1, z);
+            if (top.getMaterial() != MaterialType::Grass)
+                continue;
+
+            for (const auto& [dx, dz]: SIDES) {
+                const i32 side = _getHeight(index, x + dx, z + dz);
+                if (side >= 0 && height - side >= (i32)CLIFF_HEIGHT) {
+                    chunk.setBlock(x, height - 1, z, MaterialType::Stone, top.getBiome());
+                    break;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Plants a few trees on plains grass. Canopies may reach into the
+ * neighbors, so every block goes through the write queues.
+ */
+void GenerationPipeline::_decorate(const u32 index) {
+    u32 chunkX, chunkY, chunkZ;
+    _toPosition(index, chunkX, chunkY, chunkZ);
+
+    const Chunk& chunk = m_chunks[index];
+    proc::CounterRng rng(m_seed, chunkX, chunkY, chunkZ, proc::RngStream::Decoration);
+    u32 order = 0;
+
+    for (u32 attempt = 0; attempt < TREE_ATTEMPTS; ++attempt) {
+        // Always draw the same amount of values per attempt
+        const i32 x = rng.nextBelow(CHUNK_SIZE);
+        const i32 z = rng.nextBelow(CHUNK_SIZE);
+        const i32 trunk = 3 + rng.nextBelow(2);
+
+        const i32 height = _getHeight(index, x, z);
+        if (height == 0 || height + trunk >= (i32)CHUNK_HEIGHT)
+            continue;
+
+        const Block& ground = chunk.getBlock(x, height - 1, z);
+        if (ground.getMaterial() != MaterialType::Grass || ground.getBiome() != Biome::Plains)
+            continue;
+
+        for (i32 y = height; y < height + trunk; ++y)
+            _emit(index, order, x, y, z, MaterialType::Wood);
+
+        for (i32 y = height + trunk - 2; y <= height + trunk; ++y) {
+            const i32 radius = y == height + trunk ? 1 : 2;
+            for (i32 dz = -radius; dz <= radius; ++dz) {
+                for (i32 dx = -radius; dx <= radius; ++dx) {
+                    if (radius == 2 && std::abs(dx) == 2 && std::abs(dz) == 2)
+                        continue;
+                    _emit(index, order, x + dx, y, z + dz, MaterialType::Grass);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Last stage: every neighbor finished decorating, the queue is
+ * complete. Writes only fill air, the first one wins.
+ */
+void GenerationPipeline::_applyWrites(const u32 index) {
+    ChunkState& state = m_states[index];
+    Chunk& chunk = m_chunks[index];
+
+    std::vector<PendingWrite> writes = std::move(state.m_writes);
+    std::sort(writes.begin(), writes.end(), [](const PendingWrite& a, const PendingWrite& b) {
+        return a.m_source != b.m_source ? a.m_source < b.m_source : a.m_order < b.m_order;
+    });
+
+    for (const PendingWrite& write: writes) {
+        if (chunk.getBlock(write.m_x, write.m_y, write.m_z).isVoid())
+            chunk.setBlock(write.m_x, write.m_y, write.m_z, write.m_material, write.m_biome);
+    }
+}
+
+/* ========================================================================== */
+
+/**
+ * @brief Queues a block at (x, y, z), relative to the `source` chunk, in the
+ * chunk that holds it. Blocks outside the world are dropped.
+ */
+void GenerationPipeline::_emit(
+    const u32 source,
+    u32& order,
+    const i32 x,
+    const i32 y,
+    const i32 z,
+    const MaterialType material
+) {
+    const u32 rank = order++;
+    if (y < 0 || y >= (i32)CHUNK_HEIGHT)
+        return;
+
+    const i32 dx = x < 0 ? -1 : x / (i32)CHUNK_SIZE;
+    const i32 dz = z < 0 ? -1 : z / (i32)CHUNK_SIZE;
+    const i64 target = _getNeighbor(source, dx, dz);
+    if (target < 0)
+        return;
+
+    PendingWrite write{};
+    write.m_source = source;
+    write.m_order = rank;
+    write.m_x = x - dx * (i32)CHUNK_SIZE;
+    write.m_y = y;
+    write.m_z = z - dz * (i32)CHUNK_SIZE;
+    write.m_material = material;
+    write.m_biome = Biome::Plains;
+
+    ChunkState& state = m_states[target];
+    std::lock_guard<std::mutex> lock(state.m_writeMutex);
+    state.m_writes.push_back(write);
+}
+
+/**
+ * @brief Height of a column relative to chunk `index`, up to one chunk away.
+ * @return -1 outside the world.
+ */
+i32 GenerationPipeline::_getHeight(const u32 index, const i32 x, const i32 z) const noexcept {
+    const i32 dx = x < 0 ? -1 : x / (i32)CHUNK_SIZE;
+    const i32 dz = z < 0 ? -1 : z / (i32)CHUNK_SIZE;
+    const i64 neighbor = _getNeighbor(index, dx, dz);
+    if (neighbor < 0)
+        return -1;
+
+    const u32 localX = x - dx * (i32)CHUNK_SIZE;
+    const u32 localZ = z - dz * (i32)CHUNK_SIZE;
+    return m_states[neighbor].m_heights[localZ * CHUNK_SIZE + localX];
+}
+
+/**
+ * @return Index of the chunk at (dx, dz) from `index`, -1 outside the world.
+ */
+i64 GenerationPipeline::_getNeighbor(const u32 index, const i32 dx, const i32 dz) const noexcept {
+    u32 x, y, z;
+    _toPosition(index, x, y, z);
+
+    const i64 neighborX = (i64)x + dx;
+    const i64 neighborZ = (i64)z + dz;
+    if (neighborX < 0 || neighborX >= m_width || neighborZ < 0 || neighborZ >= m_depth)
+        return -1;
+    return ((i64)y * m_depth + neighborZ) * m_width + neighborX;
+}
+
+void GenerationPipeline::_toPosition(const u32 index, u32& x, u32& y, u32& z) const noexcept {
+    x = index % m_width;
+    z = (index / m_width) % m_depth;
+    y = index / (m_width * m_depth);
+}
+
+} // namespace game
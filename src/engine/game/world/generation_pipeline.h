@@ -0,0 +1,173 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   generation_pipeline.h                              :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/07/04 15:12:37 by etran             #+#    #+#             */
+/*   Updated: 2024/07/07 18:14:36 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#pragma once
+
+#include "game_decl.h"
+#include "block.h"
+#include "job.h"
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <span>
+#include <vector>
+
+namespace proc {
+class NoiseSampler;
+class BiomeMap;
+}
+
+namespace game {
+
+class Chunk;
+class ChunkScheduler;
+
+/**
+ * @brief Last generation stage completed by a chunk.
+ */
+enum class GenerationStage: u8 {
+    None,
+    Terrain,    // height field & biomes
+    Surface,    // top blocks, reading the neighbors' heights
+    Decoration, // trees, may spill into the neighbors
+    Spill       // blocks spilled by the neighbors applied, chunk complete
+};
+
+/**
+ * @brief Generates chunks in stages on the job system.
+ *
+ * A chunk enters stage s once it and its 8 horizontal neighbors completed
+ * stage s - 1, so a stage can read the previous results of the whole 3x3
+ * area. Chunks only ever write to themselves: blocks spilling into a
+ * neighbor are queued there and applied in its last stage, ordered by source
+ * chunk then emission order, so the result does not depend on scheduling.
+ *
+ * Light is not a stage: sky light runs down whole stacks of chunks, which
+ * the 3x3 area does not cover. The world lights the complete area after the
+ * pipeline.
+ *
+ * Ready stages go through the scheduler: chunks near the focus complete
+ * first.
+ */
+class GenerationPipeline final {
+public:
+    /* ====================================================================== */
+    /*                             STATIC MEMBERS                             */
+    /* ====================================================================== */
+
+    static constexpr u32    TREE_ATTEMPTS = 3;
+    static constexpr u32    CLIFF_HEIGHT = 3;
+
+    /* ====================================================================== */
+    /*                                 METHODS                                */
+    /* ====================================================================== */
+
+    GenerationPipeline() = default;
+    ~GenerationPipeline() = default;
+
+    GenerationPipeline(GenerationPipeline&& other) = delete;
+    GenerationPipeline(const GenerationPipeline& other) = delete;
+    GenerationPipeline& operator=(GenerationPipeline&& other) = delete;
+    GenerationPipeline& operator=(const GenerationPipeline& other) = delete;
+
+    /* ====================================================================== */
+
+    void    init(
+        std::span<Chunk> chunks,
+        const u32 width,
+        const u32 height,
+        const u32 depth,
+        const proc::NoiseSampler& terrainNoise,
+        proc::BiomeMap& biomeMap,
+        ChunkScheduler& scheduler,
+        const u32 seed);
+    void    destroy() noexcept;
+
+    void    run();
+
+    /* ====================================================================== */
+
+    GenerationStage getStage(const u32 index) const noexcept;
+
+private:
+    /* ====================================================================== */
+    /*                                TYPEDEFS                                */
+    /* ====================================================================== */
+
+    /**
+     * @brief Block emitted by a chunk into another one.
+     */
+    struct PendingWrite {
+        u32             m_source = 0;
+        u32             m_order = 0;
+        u8              m_x = 0;
+        u8              m_y = 0;
+        u8              m_z = 0;
+        MaterialType    m_material = MaterialType::Air;
+        Biome           m_biome = Biome::Plains;
+    };
+
+    struct ChunkState {
+        std::atomic<u8>                 m_stage = 0;
+        std::atomic<u8>                 m_scheduled = 0;
+        std::array<u8, CHUNK_AREA>      m_heights;
+        std::mutex                      m_writeMutex;
+        std::vector<PendingWrite>       m_writes;
+    };
+
+    /* ====================================================================== */
+    /*                                  DATA                                  */
+    /* ====================================================================== */
+
+    std::span<Chunk>            m_chunks;
+    std::vector<ChunkState>     m_states;
+    u32                         m_width = 0;
+    u32                         m_height = 0;
+    u32                         m_depth = 0;
+
+    const proc::NoiseSampler*   m_terrainNoise = nullptr;
+    proc::BiomeMap*             m_biomeMap = nullptr;
+    ChunkScheduler*             m_scheduler = nullptr;
+    u32                         m_seed = 0;
+
+    jobs::Counter               m_counter;
+
+    /* ====================================================================== */
+    /*                                 METHODS                                */
+    /* ====================================================================== */
+
+    void    _schedule(const u32 index);
+    void    _execute(const u32 index);
+    void    _notify(const u32 index);
+    bool    _isReady(const u32 index, const u8 stage) const noexcept;
+
+    void    _generateTerrain(const u32 index);
+    void    _generateSurface(const u32 index);
+    void    _decorate(const u32 index);
+    void    _applyWrites(const u32 index);
+
+    void    _emit(
+        const u32 source,
+        u32& order,
+        const i32 x,
+        const i32 y,
+        const i32 z,
+        const MaterialType material);
+
+    i32     _getHeight(const u32 index, const i32 x, const i32 z) const noexcept;
+    i64     _getNeighbor(const u32 index, const i32 dx, const i32 dz) const noexcept;
+    void    _toPosition(const u32 index, u32& x, u32& y, u32& z) const noexcept;
+
+}; // class GenerationPipeline
+
+} // namespace game
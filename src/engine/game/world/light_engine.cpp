@@ -0,0 +1,443 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   light_engine.cpp                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/07/05 17:20:31 by etran             #+#    #+#             */
+/*   Updated: 2024/07/07 22:31:09 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+#include "light_engine.h"
+#include "world.h"
+#include "job_system.h"
+
+#include <algorithm>
+
+namespace game {
+
+namespace {
+
+struct Direction {
+    i32 m_x, m_y, m_z;
+};
+
+constexpr std::array<Direction, 6> DIRECTIONS = {{
+    {  0,  1,  0 },
+    {  0, -1,  0 },
+    { -1,  0,  0 },
+    {  1,  0,  0 },
+    {  0,  0,  1 },
+    {  0,  0, -1 },
+}};
+
+constexpr u32 DOWN = 1; // Index in DIRECTIONS
+
+} // namespace
+
+/* ========================================================================== */
+/*                                   PUBLIC                                   */
+/* ========================================================================== */
+
+void LightEngine::init(const World& world) {
+    m_world = &world;
+    m_chunks = std::vector<ChunkLight>(CHUNK_COUNT);
+}
+
+void LightEngine::destroy() noexcept {
+    m_chunks = std::vector<ChunkLight>();
+    m_addQueue = LightQueue();
+    m_removeQueue = LightQueue();
+    m_world = nullptr;
+}
+
+/**
+ * @brief Lights the whole world from scratch, on the job system.
+ *
+ * Sky columns are filled first, then every chunk spreads its own light and
+ * hands what crosses its border to the neighbors. Rounds go on until no
+ * light crosses a border anymore.
+ */
+void LightEngine::compute() {
+    for (ChunkLight& chunk: m_chunks) {
+        chunk.m_levels.fill(0);
+        chunk.m_inbox.clear();
+    }
+
+    jobs::JobSystem::parallelFor(RENDER_DISTANCE * RENDER_DISTANCE, 1, [this](const u32 column) {
+        _fillSkyColumns(column % RENDER_DISTANCE, column / RENDER_DISTANCE);
+    });
+
+    jobs::JobSystem::parallelFor(CHUNK_COUNT, 1, [this](const u32 chunk) {
+        LightQueue queue;
+        _seedChunk(chunk, queue);
+        _propagate(queue, chunk);
+    });
+
+    std::vector<u32> pending;
+    while (true) {
+        // No job runs between rounds: inboxes are read without locking
+        pending.clear();
+        for (u32 chunk = 0; chunk < CHUNK_COUNT; ++chunk) {
+            if (!m_chunks[chunk].m_inbox.empty())
+                pending.push_back(chunk);
+        }
+        if (pending.empty())
+            break;
+
+        jobs::JobSystem::parallelFor((u32)pending.size(), 1, [&](const u32 i) {
+            LightQueue queue;
+            _receive(pending[i], queue);
+            _propagate(queue, pending[i]);
+        });
+    }
+}
+
+/**
+ * @brief Relights around a block that just changed in the world.
+ */
+void LightEngine::onBlockChanged(const i32 x, const i32 y, const i32 z) {
+    u32 chunk, cell;
+    if (!_locate(x, y, z, chunk, cell))
+        return;
+
+    _relight(LightChannel::Sky, x, y, z);
+    _relight(LightChannel::Block, x, y, z);
+}
+
+/**
+ * @brief Makes a block emit light at `level`, 0 to stop. Emitters are not
+ * blocks: they light whatever block they sit in, if it lets light through.
+ */
+void LightEngine::setEmitter(const i32 x, const i32 y, const i32 z, const u8 level) {
+    u32 chunk, cell;
+    if (!_locate(x, y, z, chunk, cell))
+        return;
+
+    std::vector<Emitter>& emitters = m_chunks[chunk].m_emitters;
+    const auto it = std::find_if(emitters.begin(), emitters.end(), [cell](const Emitter& emitter) {
+        return emitter.m_cell == cell;
+    });
+
+    if (it != emitters.end() && level == 0)
+        emitters.erase(it);
+    else if (it != emitters.end())
+        it->m_level = std::min(level, MAX_LIGHT);
+    else if (level != 0)
+        emitters.push_back({ (u16)cell, std::min(level, MAX_LIGHT) });
+    else
+        return;
+
+    _relight(LightChannel::Block, x, y, z);
+}
+
+/* ========================================================================== */
+
+/**
+ * @return 0 outside the world.
+ */
+u8 LightEngine::getLight(const LightChannel channel, const i32 x, const i32 y, const i32 z) const noexcept {
+    u32 chunk, cell;
+    if (!_locate(x, y, z, chunk, cell))
+        return 0;
+    return _getLevel(chunk, cell, channel);
+}
+
+/* ========================================================================== */
+/*                                   PRIVATE                                  */
+/* ========================================================================== */
+
+/**
+ * @brief Sky light straight down the columns of a stack of chunks, until
+ * something stops it.
+ */
+void LightEngine::_fillSkyColumns(const u32 chunkX, const u32 chunkZ) noexcept {
+    for (u32 localZ = 0; localZ < CHUNK_SIZE; ++localZ) {
+        for (u32 localX = 0; localX < CHUNK_SIZE; ++localX) {
+            const i32 x = chunkX * CHUNK_SIZE + localX;
+            const i32 z = chunkZ * CHUNK_SIZE + localZ;
+
+            u8 level = MAX_LIGHT;
+            for (i32 y = WORLD_BLOCK_HEIGHT - 1; y >= 0; --y) {
+                const u8 attenuation = _getAttenuation(x, y, z, LightChannel::Sky, true, level);
+                if (attenuation >= level)
+                    break;
+                level -= attenuation;
+
+                u32 chunk, cell;
+                _locate(x, y, z, chunk, cell);
+                _setLevel(chunk, cell, LightChannel::Sky, level);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Queues the blocks of a chunk that may light others: emitters, and
+ * sky lit blocks next to a darker one. Only reads the chunk itself, blocks
+ * on its border are always queued.
+ */
+void LightEngine::_seedChunk(const u32 chunk, LightQueue& queue) noexcept {
+    ChunkLight& light = m_chunks[chunk];
+    const i32 originX = (chunk % RENDER_DISTANCE) * CHUNK_SIZE;
+    const i32 originZ = ((chunk / RENDER_DISTANCE) % RENDER_DISTANCE) * CHUNK_SIZE;
+    const i32 originY = (chunk / RENDER_AREA) * CHUNK_HEIGHT;
+
+    for (const Emitter& emitter: light.m_emitters) {
+        u32 x, y, z;
+        Chunk::toPosition(emitter.m_cell, x, y, z);
+        if (_getAttenuation(originX + x, originY + y, originZ + z, LightChannel::Block, false, MAX_LIGHT) > MAX_LIGHT)
+            continue;
+
+        _setLevel(chunk, emitter.m_cell, LightChannel::Block, emitter.m_level);
+        queue.push_back({ originX + (i32)x, originY + (i32)y, originZ + (i32)z, emitter.m_level, LightChannel::Block });
+    }
+
+    for (u32 y = 0; y < CHUNK_HEIGHT; ++y) {
+        for (u32 z = 0; z < CHUNK_SIZE; ++z) {
+            for (u32 x = 0; x < CHUNK_SIZE; ++x) {
+                const u8 level = _getLevel(chunk, Chunk::toIndex(x, y, z), LightChannel::Sky);
+                if (level <= 1)
+                    continue;
+
+                bool isSeed = x == 0 || x == CHUNK_SIZE - 1 || y == 0 || y == CHUNK_HEIGHT - 1 || z == 0 || z == CHUNK_SIZE - 1;
+                for (u32 i = 0; !isSeed && i < DIRECTIONS.size(); ++i) {
+                    const Direction& direction = DIRECTIONS[i];
+                    const u32 neighbor = Chunk::toIndex(x + direction.m_x, y + direction.m_y, z + direction.m_z);
+
+                    isSeed = _getLevel(chunk, neighbor, LightChannel::Sky) < level - 1 &&
+                        _getAttenuation(originX + x + direction.m_x, originY + y + direction.m_y, originZ + z + direction.m_z,
+                            LightChannel::Sky, false, level) <= MAX_LIGHT;
+                }
+                if (isSeed)
+                    queue.push_back({ originX + (i32)x, originY + (i32)y, originZ + (i32)z, level, LightChannel::Sky });
+            }
+        }
+    }
+}
+
+/**
+ * @brief Takes the light handed over by the neighbors, queues what brightens
+ * the chunk.
+ */
+void LightEngine::_receive(const u32 chunk, LightQueue& queue) {
+    ChunkLight& light = m_chunks[chunk];
+
+    std::vector<LightNode> inbox;
+    {
+        std::lock_guard<std::mutex> lock(light.m_inboxMutex);
+        inbox.swap(light.m_inbox);
+    }
+
+    for (const LightNode& node: inbox) {
+        u32 target, cell;
+        _locate(node.m_x, node.m_y, node.m_z, target, cell);
+        if (node.m_level <= _getLevel(chunk, cell, node.m_channel))
+            continue;
+
+        _setLevel(chunk, cell, node.m_channel, node.m_level);
+        queue.push_back(node);
+    }
+}
+
+/**
+ * @brief Spreads the queued blocks' light breadth first.
+ *
+ * @param confinedChunk Chunk the spread may write to, light leaving it goes
+ * to the inbox of the neighbor. -1 to write anywhere.
+ */
+void LightEngine::_propagate(LightQueue& queue, const i64 confinedChunk) {
+    for (u32 head = 0; head < queue.size(); ++head) {
+        const LightNode node = queue[head];
+
+        u32 chunk, cell;
+        _locate(node.m_x, node.m_y, node.m_z, chunk, cell);
+        // Brightened since queued: the brighter node spreads instead
+        if (_getLevel(chunk, cell, node.m_channel) != node.m_level)
+            continue;
+
+        for (u32 i = 0; i < DIRECTIONS.size(); ++i) {
+            const i32 x = node.m_x + DIRECTIONS[i].m_x;
+            const i32 y = node.m_y + DIRECTIONS[i].m_y;
+            const i32 z = node.m_z + DIRECTIONS[i].m_z;
+
+            u32 target;
+            if (!_locate(x, y, z, target, cell))
+                continue;
+
+            const u8 attenuation = _getAttenuation(x, y, z, node.m_channel, i == DOWN, node.m_level);
+            if (attenuation >= node.m_level)
+                continue;
+            const u8 level = node.m_level - attenuation;
+
+            if (confinedChunk >= 0 && target != confinedChunk) {
+                ChunkLight& neighbor = m_chunks[target];
+                std::lock_guard<std::mutex> lock(neighbor.m_inboxMutex);
+                neighbor.m_inbox.push_back({ x, y, z, level, node.m_channel });
+                continue;
+            }
+            if (level <= _getLevel(target, cell, node.m_channel))
+                continue;
+
+            _setLevel(target, cell, node.m_channel, level);
+            queue.push_back({ x, y, z, level, node.m_channel });
+        }
+    }
+    queue.clear();
+}
+
+/**
+ * @brief Darkens what the queued blocks lit. Neighbors as bright as the
+ * removed light have another source: they are queued to fill the dark area
+ * back.
+ */
+void LightEngine::_unpropagate(const LightChannel channel) {
+    for (u32 head = 0; head < m_removeQueue.size(); ++head) {
+        const LightNode node = m_removeQueue[head];
+
+        for (u32 i = 0; i < DIRECTIONS.size(); ++i) {
+            const i32 x = node.m_x + DIRECTIONS[i].m_x;
+            const i32 y = node.m_y + DIRECTIONS[i].m_y;
+            const i32 z = node.m_z + DIRECTIONS[i].m_z;
+
+            u32 chunk, cell;
+            if (!_locate(x, y, z, chunk, cell))
+                continue;
+
+            const u8 level = _getLevel(chunk, cell, channel);
+            if (level == 0)
+                continue;
+
+            const bool isSunColumn = channel == LightChannel::Sky && i == DOWN && node.m_level == MAX_LIGHT;
+            if (level >= node.m_level && !isSunColumn) {
+                m_addQueue.push_back({ x, y, z, level, channel });
+                continue;
+            }
+
+            _setLevel(chunk, cell, channel, 0);
+            m_removeQueue.push_back({ x, y, z, level, channel });
+
+            const u8 source = _getSource(channel, x, y, z);
+            if (source != 0) {
+                _setLevel(chunk, cell, channel, source);
+                m_addQueue.push_back({ x, y, z, source, channel });
+            }
+        }
+    }
+    m_removeQueue.clear();
+}
+
+/**
+ * @brief Recomputes one channel around a block whose light may have changed.
+ */
+void LightEngine::_relight(const LightChannel channel, const i32 x, const i32 y, const i32 z) {
+    u32 chunk, cell;
+    _locate(x, y, z, chunk, cell);
+
+    const u8 previous = _getLevel(chunk, cell, channel);
+    if (previous != 0) {
+        _setLevel(chunk, cell, channel, 0);
+        m_removeQueue.push_back({ x, y, z, previous, channel });
+        _unpropagate(channel);
+    }
+
+    const u8 source = _getSource(channel, x, y, z);
+    if (source > _getLevel(chunk, cell, channel)) {
+        _setLevel(chunk, cell, channel, source);
+        m_addQueue.push_back({ x, y, z, source, channel });
+    }
+
+    // Lit neighbors spread into the block again, if it lets light through
+    for (const Direction& direction: DIRECTIONS) {
+        const i32 neighborX = x + direction.m_x;
+        const i32 neighborY = y + direction.m_y;
+        const i32 neighborZ = z + direction.m_z;
+
+        u32 neighbor, neighborCell;
+        if (!_locate(neighborX, neighborY, neighborZ, neighbor, neighborCell))
+            continue;
+
+        const u8 level = _getLevel(neighbor, neighborCell, channel);
+        if (level != 0)
+            m_addQueue.push_back({ neighborX, neighborY, neighborZ, level, channel });
+    }
+
+    _propagate(m_addQueue, -1);
+}
+
+/* ========================================================================== */
+
+/**
+ * @brief Levels lost by light entering block (x, y, z), greater than
+ * MAX_LIGHT if the block stops it.
+ */
+u8 LightEngine::_getAttenuation(
+    const i32 x,
+    const i32 y,
+    const i32 z,
+    const LightChannel channel,
+    const bool downwards,
+    const u8 level
+) const noexcept {
+    switch (m_world->getBlock(x, y, z).getMaterial()) {
+        case MaterialType::Air:
+            return channel == LightChannel::Sky && downwards && level == MAX_LIGHT ? 0 : 1;
+        case MaterialType::Water:
+            return WATER_ATTENUATION;
+        default:
+            return MAX_LIGHT + 1;
+    }
+}
+
+/**
+ * @brief Light a block gets by itself: from its emitter, or from the sky
+ * right above the world.
+ */
+u8 LightEngine::_getSource(const LightChannel channel, const i32 x, const i32 y, const i32 z) const noexcept {
+    u32 chunk, cell;
+    _locate(x, y, z, chunk, cell);
+
+    if (channel == LightChannel::Sky) {
+        if (y != WORLD_BLOCK_HEIGHT - 1)
+            return 0;
+        const u8 attenuation = _getAttenuation(x, y, z, channel, true, MAX_LIGHT);
+        return attenuation < MAX_LIGHT ? MAX_LIGHT - attenuation : 0;
+    }
+
+    if (_getAttenuation(x, y, z, channel, false, MAX_LIGHT) > MAX_LIGHT)
+        return 0;
+    for (const Emitter& emitter: m_chunks[chunk].m_emitters) {
+        if (emitter.m_cell == cell)
+            return emitter.m_level;
+    }
+    return 0;
+}
+
+u8 LightEngine::_getLevel(const u32 chunk, const u32 cell, const LightChannel channel) const noexcept {
+    const u8 levels = m_chunks[chunk].m_levels[cell];
+    return channel == LightChannel::Sky ? levels >> 4 : levels & 0xF;
+}
+
+void LightEngine::_setLevel(const u32 chunk, const u32 cell, const LightChannel channel, const u8 level) noexcept {
+    u8& levels = m_chunks[chunk].m_levels[cell];
+    if (channel == LightChannel::Sky)
+        levels = (levels & 0x0F) | (level << 4);
+    else
+        levels = (levels & 0xF0) | level;
+}
+
+/**
+ * @brief Chunk index (y/z/x, like the world) and cell of a world position.
+ * @return false outside the world.
+ */
+bool LightEngine::_locate(const i32 x, const i32 y, const i32 z, u32& chunk, u32& cell) noexcept {
+    if (x < 0 || x >= WORLD_BLOCK_SIZE || y < 0 || y >= WORLD_BLOCK_HEIGHT || z < 0 || z >= WORLD_BLOCK_SIZE)
+        return false;
+
+    chunk = (y / CHUNK_HEIGHT) * RENDER_AREA + (z / CHUNK_SIZE) * RENDER_DISTANCE + (x / CHUNK_SIZE);
+    cell = Chunk::toIndex(x % CHUNK_SIZE, y % CHUNK_HEIGHT, z % CHUNK_SIZE);
+    return true;
+}
+
+} // namespace game
@@ -0,0 +1,143 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   light_engine.h                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/07/05 17:20:31 by etran             #+#    #+#             */
+/*   Updated: 2024/07/07 22:03:44 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#pragma once
+
+#include "types.h"
+#include "game_decl.h"
+#include "block_decl.h"
+
+#include <array>
+#include <mutex>
+#include <vector>
+
+namespace game {
+
+class World;
+
+/**
+ * @brief Light channels, each stored on a nibble of the cell.
+ */
+enum class LightChannel: u8 {
+    Sky,    // from the top of the world, full through air straight down
+    Block   // from emitters
+};
+
+/**
+ * @brief Voxel light levels (0 to MAX_LIGHT) of every block of the world.
+ *
+ * Light spreads breadth first, losing 1 level per block (more in water).
+ * Sky light does not fade going straight down through air.
+ *
+ * The initial pass works chunk by chunk on the job system: a chunk only
+ * writes its own levels, light leaving it is queued in the inbox of the
+ * neighbor, processed in the next round. Levels only ever rise, so the
+ * result does not depend on the order chunks run in.
+ *
+ * Edits are relit in place on the calling thread: light that went through
+ * the changed block is removed first, then filled back from the border of
+ * the removed area.
+ */
+class LightEngine final {
+public:
+    /* ====================================================================== */
+    /*                             STATIC MEMBERS                             */
+    /* ====================================================================== */
+
+    static constexpr u8     MAX_LIGHT = 15;
+    static constexpr u8     WATER_ATTENUATION = 3;
+    static constexpr u32    CHUNK_COUNT = RENDER_VOLUME;
+
+    /* ====================================================================== */
+    /*                                 METHODS                                */
+    /* ====================================================================== */
+
+    LightEngine() = default;
+    ~LightEngine() = default;
+
+    LightEngine(LightEngine&& other) = delete;
+    LightEngine(const LightEngine& other) = delete;
+    LightEngine& operator=(LightEngine&& other) = delete;
+    LightEngine& operator=(const LightEngine& other) = delete;
+
+    /* ====================================================================== */
+
+    void    init(const World& world);
+    void    destroy() noexcept;
+    void    compute();
+
+    void    onBlockChanged(const i32 x, const i32 y, const i32 z);
+    void    setEmitter(const i32 x, const i32 y, const i32 z, const u8 level);
+
+    /* ====================================================================== */
+
+    u8      getLight(const LightChannel channel, const i32 x, const i32 y, const i32 z) const noexcept;
+
+private:
+    /* ====================================================================== */
+    /*                                TYPEDEFS                                */
+    /* ====================================================================== */
+
+    struct LightNode {
+        i32             m_x = 0;
+        i32             m_y = 0;
+        i32             m_z = 0;
+        u8              m_level = 0;
+        LightChannel    m_channel = LightChannel::Sky;
+    };
+
+    struct Emitter {
+        u16 m_cell = 0;
+        u8  m_level = 0;
+    };
+
+    struct ChunkLight {
+        std::array<u8, CHUNK_VOLUME>    m_levels{}; // sky << 4 | block
+        std::vector<Emitter>            m_emitters;
+        std::mutex                      m_inboxMutex;
+        std::vector<LightNode>          m_inbox;
+    };
+
+    using LightQueue = std::vector<LightNode>;
+
+    /* ====================================================================== */
+    /*                                  DATA                                  */
+    /* ====================================================================== */
+
+    const World*            m_world = nullptr;
+    std::vector<ChunkLight> m_chunks;
+
+    // Reused by the incremental relight
+    LightQueue              m_addQueue;
+    LightQueue              m_removeQueue;
+
+    /* ====================================================================== */
+    /*                                 METHODS                                */
+    /* ====================================================================== */
+
+    void    _fillSkyColumns(const u32 chunkX, const u32 chunkZ) noexcept;
+    void    _seedChunk(const u32 chunk, LightQueue& queue) noexcept;
+    void    _receive(const u32 chunk, LightQueue& queue);
+    void    _propagate(LightQueue& queue, const i64 confinedChunk);
+    void    _unpropagate(const LightChannel channel);
+    void    _relight(const LightChannel channel, const i32 x, const i32 y, const i32 z);
+
+    u8      _getAttenuation(const i32 x, const i32 y, const i32 z, const LightChannel channel, const bool downwards, const u8 level) const noexcept;
+    u8      _getSource(const LightChannel channel, const i32 x, const i32 y, const i32 z) const noexcept;
+    u8      _getLevel(const u32 chunk, const u32 cell, const LightChannel channel) const noexcept;
+    void    _setLevel(const u32 chunk, const u32 cell, const LightChannel channel, const u8 level) noexcept;
+
+    static bool _locate(const i32 x, const i32 y, const i32 z, u32& chunk, u32& cell) noexcept;
+
+}; // class LightEngine
+
+} // namespace game
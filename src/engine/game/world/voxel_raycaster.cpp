@@ -0,0 +1,236 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   voxel_raycaster.cpp                                :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/07/05 14:03:19 by etran             #+#    #+#             */
+/*   Updated: 2024/07/07 22:31:09 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "voxel_raycaster.h"
+#include "world.h"
+#include "job_system.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace game {
+
+/* ========================================================================== */
+/*                                   PUBLIC                                   */
+/* ========================================================================== */
+
+void VoxelRaycaster::init(const World& world) {
+    m_world = &world;
+
+    for (u32 y = 0; y < RENDER_HEIGHT; ++y) {
+        for (u32 z = 0; z < RENDER_DISTANCE; ++z) {
+            for (u32 x = 0; x < RENDER_DISTANCE; ++x)
+                refresh(x, y, z);
+        }
+    }
+}
+
+void VoxelRaycaster::destroy() noexcept {
+    m_world = nullptr;
+    m_bricks.fill(0);
+}
+
+/**
+ * @brief Rebuilds the brick occupancy of a chunk, from its column masks.
+ */
+void VoxelRaycaster::refresh(const u32 chunkX, const u32 chunkY, const u32 chunkZ) noexcept {
+    constexpr u32 BRICK_BITS = (1U << BRICK_SIZE) - 1;
+
+    const Chunk& chunk = m_world->getChunk(chunkX, chunkY, chunkZ);
+
+    u64 bricks = 0;
+    for (u32 z = 0; z < CHUNK_SIZE; ++z) {
+        for (u32 x = 0; x < CHUNK_SIZE; ++x) {
+            const u32 mask = chunk.getColumnMask(x, z);
+            for (u32 brickY = 0; brickY < BRICKS_PER_SIDE; ++brickY) {
+                if ((mask >> (brickY * BRICK_SIZE)) & BRICK_BITS)
+                    bricks |= 1ULL << _toBrickIndex(x / BRICK_SIZE, brickY, z / BRICK_SIZE);
+            }
+        }
+    }
+    m_bricks[_toChunkIndex(chunkX, chunkY, chunkZ)] = bricks;
+}
+
+/* ========================================================================== */
+
+/**
+ * @brief Walks the blocks along the ray up to its max distance. Empty
+ * chunks and bricks are crossed in one jump to their exit point.
+ */
+VoxelRaycaster::Hit VoxelRaycaster::cast(const Ray& ray) const noexcept {
+    using Vect3i = std::array<i32, 3>;
+    using Vect3f = std::array<f32, 3>;
+
+    constexpr f32       INF = std::numeric_limits<f32>::infinity();
+    constexpr Vect3i    AREA = { WORLD_BLOCK_SIZE, WORLD_BLOCK_HEIGHT, WORLD_BLOCK_SIZE };
+
+    Hit hit{};
+
+    const f32 length = math::norm(ray.m_direction);
+    if (length == 0.0f)
+        return hit;
+
+    const Vect3f origin = { ray.m_origin.x, ray.m_origin.y, ray.m_origin.z };
+    const Vect3f direction = {
+        ray.m_direction.x / length,
+        ray.m_direction.y / length,
+        ray.m_direction.z / length };
+
+    // Clip to the world box
+    f32 t = 0.0f;
+    f32 tEnd = ray.m_maxDistance;
+    i32 axis = -1; // Crossed to enter the current block, -1 at the origin
+
+    for (i32 a = 0; a < 3; ++a) {
+        if (direction[a] == 0.0f) {
+            if (origin[a] < 0.0f || origin[a] >= AREA[a])
+                return hit;
+            continue;
+        }
+        const f32 t0 = -origin[a] / direction[a];
+        const f32 t1 = (AREA[a] - origin[a]) / direction[a];
+        if (std::min(t0, t1) > t) {
+            t = std::min(t0, t1);
+            axis = a;
+        }
+        tEnd = std::min(tEnd, std::max(t0, t1));
+    }
+    if (t > tEnd)
+        return hit;
+
+    Vect3i  step;
+    Vect3i  voxel;
+    Vect3f  tMax;
+    Vect3f  tDelta;
+    for (i32 a = 0; a < 3; ++a) {
+        step[a] = direction[a] > 0.0f ? 1 : (direction[a] < 0.0f ? -1 : 0);
+        tDelta[a] = step[a] != 0 ? std::abs(1.0f / direction[a]) : INF;
+    }
+
+    // Block at distance t, kept inside [low, high)
+    const auto locate = [&](const Vect3i& low, const Vect3i& high) {
+        for (i32 a = 0; a < 3; ++a) {
+            voxel[a] = std::clamp((i32)std::floor(origin[a] + direction[a] * t), low[a], high[a] - 1);
+            tMax[a] = step[a] != 0 ? std::max(t, (voxel[a] + (step[a] > 0) - origin[a]) / direction[a]) : INF;
+        }
+    };
+
+    // Moves to the first block past the aligned box of `size` around voxel
+    const auto skip = [&](const i32 size) {
+        Vect3i  low;
+        Vect3i  high;
+        f32     tExit = INF;
+        i32     exitAxis = 0;
+        for (i32 a = 0; a < 3; ++a) {
+            low[a] = voxel[a] & ~(size - 1);
+            high[a] = low[a] + size;
+            if (step[a] == 0)
+                continue;
+            const f32 tPlane = ((step[a] > 0 ? high[a] : low[a]) - origin[a]) / direction[a];
+            if (tPlane <= tExit) {
+                tExit = tPlane;
+                exitAxis = a;
+            }
+        }
+
+        t = tExit;
+        locate(low, high);
+        voxel[exitAxis] = step[exitAxis] > 0 ? high[exitAxis] : low[exitAxis] - 1;
+        tMax[exitAxis] = (voxel[exitAxis] + (step[exitAxis] > 0) - origin[exitAxis]) / direction[exitAxis];
+        axis = exitAxis;
+    };
+
+    locate({ 0, 0, 0 }, AREA);
+
+    while (t <= tEnd) {
+        if (voxel[0] < 0 || voxel[0] >= AREA[0] ||
+            voxel[1] < 0 || voxel[1] >= AREA[1] ||
+            voxel[2] < 0 || voxel[2] >= AREA[2])
+            break;
+
+        const u32 chunkX = voxel[0] / CHUNK_SIZE;
+        const u32 chunkY = voxel[1] / CHUNK_HEIGHT;
+        const u32 chunkZ = voxel[2] / CHUNK_SIZE;
+        const u64 bricks = m_bricks[_toChunkIndex(chunkX, chunkY, chunkZ)];
+        if (bricks == 0) {
+            skip(CHUNK_SIZE);
+            continue;
+        }
+
+        const u32 localX = voxel[0] % CHUNK_SIZE;
+        const u32 localY = voxel[1] % CHUNK_HEIGHT;
+        const u32 localZ = voxel[2] % CHUNK_SIZE;
+        if (((bricks >> _toBrickIndex(localX / BRICK_SIZE, localY / BRICK_SIZE, localZ / BRICK_SIZE)) & 1) == 0) {
+            skip(BRICK_SIZE);
+            continue;
+        }
+
+        const Block& block = m_world->getChunk(chunkX, chunkY, chunkZ).getBlock(localX, localY, localZ);
+        if (!block.isVoid()) {
+            constexpr BlockFace ENTERED_FORWARD[3] = { BlockFace::Left, BlockFace::Bottom, BlockFace::Back };
+            constexpr BlockFace ENTERED_BACKWARD[3] = { BlockFace::Right, BlockFace::Top, BlockFace::Front };
+
+            hit.m_hit = true;
+            hit.m_x = voxel[0];
+            hit.m_y = voxel[1];
+            hit.m_z = voxel[2];
+            hit.m_material = block.getMaterial();
+            if (axis >= 0) {
+                hit.m_face = step[axis] > 0 ? ENTERED_FORWARD[axis] : ENTERED_BACKWARD[axis];
+                hit.m_distance = t;
+            }
+            return hit;
+        }
+
+        // Next block along the axis whose boundary comes first
+        axis = tMax[0] < tMax[1] ? (tMax[0] < tMax[2] ? 0 : 2) : (tMax[1] < tMax[2] ? 1 : 2);
+        t = tMax[axis];
+        voxel[axis] += step[axis];
+        tMax[axis] += tDelta[axis];
+    }
+    return hit;
+}
+
+/**
+ * @brief Casts a batch of rays, hits[i] answering rays[i]. Large batches are
+ * spread over the job system.
+ */
+void VoxelRaycaster::cast(std::span<const Ray> rays, std::span<Hit> hits) const {
+    if (hits.size() < rays.size())
+        throw std::runtime_error("raycaster: fewer hits than rays");
+
+    if (rays.size() < PARALLEL_BATCH) {
+        for (u32 i = 0; i < rays.size(); ++i)
+            hits[i] = cast(rays[i]);
+        return;
+    }
+
+    jobs::JobSystem::parallelFor(rays.size(), PARALLEL_BATCH, [&](const u32 i) {
+        hits[i] = cast(rays[i]);
+    });
+}
+
+/* ========================================================================== */
+/*                                   PRIVATE                                  */
+/* ========================================================================== */
+
+u32 VoxelRaycaster::_toChunkIndex(const u32 x, const u32 y, const u32 z) noexcept {
+    return (y * RENDER_AREA) + (z * RENDER_DISTANCE) + x;
+}
+
+u32 VoxelRaycaster::_toBrickIndex(const u32 x, const u32 y, const u32 z) noexcept {
+    return (y * BRICKS_PER_SIDE + z) * BRICKS_PER_SIDE + x;
+}
+
+} // namespace game
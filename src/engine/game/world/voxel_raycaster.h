@@ -0,0 +1,119 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   voxel_raycaster.h                                  :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/07/05 14:03:19 by etran             #+#    #+#             */
+/*   Updated: 2024/07/07 22:03:44 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#pragma once
+
+#include "types.h"
+#include "game_decl.h"
+#include "block_decl.h"
+#include "vector.h"
+
+#include <array>
+#include <span>
+
+namespace game {
+
+class World;
+
+/**
+ * @brief Casts rays through the world blocks (Amanatides & Woo DDA).
+ *
+ * Keeps one occupancy bit per brick of BRICK_SIZE^3 blocks for every chunk:
+ * rays jump over empty chunks and empty bricks instead of visiting each of
+ * their blocks.
+ *
+ * @note Casting only reads: any thread may cast as long as the world is not
+ * edited meanwhile. Edited chunks must be refreshed before the next casts,
+ * World does it for its own raycaster in setBlock.
+ */
+class VoxelRaycaster final {
+public:
+    /* ====================================================================== */
+    /*                             STATIC MEMBERS                             */
+    /* ====================================================================== */
+
+    static constexpr u32    BRICK_SIZE = 4;
+    static constexpr u32    BRICKS_PER_SIDE = CHUNK_SIZE / BRICK_SIZE;
+    static constexpr u32    CHUNK_COUNT = RENDER_VOLUME;
+
+    // Batches below this size are cast on the calling thread
+    static constexpr u32    PARALLEL_BATCH = 256;
+
+    static_assert(CHUNK_SIZE == CHUNK_HEIGHT, "Bricks expect cubic chunks.");
+    static_assert(BRICKS_PER_SIDE * BRICKS_PER_SIDE * BRICKS_PER_SIDE == 64, "One u64 per chunk.");
+
+    /* ====================================================================== */
+    /*                                TYPEDEFS                                */
+    /* ====================================================================== */
+
+    struct Ray {
+        math::Vect3 m_origin;
+        math::Vect3 m_direction; // Needs not be normalized
+        f32         m_maxDistance = 0.0f;
+    };
+
+    /**
+     * @brief First solid block along a ray. `m_face` is the face the ray
+     * entered through, meaningless if the ray started inside the block
+     * (`m_distance` is 0 then).
+     */
+    struct Hit {
+        bool            m_hit = false;
+        i32             m_x = 0;
+        i32             m_y = 0;
+        i32             m_z = 0;
+        BlockFace       m_face = BlockFace::Top;
+        MaterialType    m_material = MaterialType::Air;
+        f32             m_distance = 0.0f;
+    };
+
+    /* ====================================================================== */
+    /*                                 METHODS                                */
+    /* ====================================================================== */
+
+    VoxelRaycaster() = default;
+    ~VoxelRaycaster() = default;
+
+    VoxelRaycaster(VoxelRaycaster&& other) = delete;
+    VoxelRaycaster(const VoxelRaycaster& other) = delete;
+    VoxelRaycaster& operator=(VoxelRaycaster&& other) = delete;
+    VoxelRaycaster& operator=(const VoxelRaycaster& other) = delete;
+
+    /* ====================================================================== */
+
+    void    init(const World& world);
+    void    destroy() noexcept;
+    void    refresh(const u32 chunkX, const u32 chunkY, const u32 chunkZ) noexcept;
+
+    /* ====================================================================== */
+
+    Hit     cast(const Ray& ray) const noexcept;
+    void    cast(std::span<const Ray> rays, std::span<Hit> hits) const;
+
+private:
+    /* ====================================================================== */
+    /*                                  DATA                                  */
+    /* ====================================================================== */
+
+    const World*                    m_world = nullptr;
+    std::array<u64, CHUNK_COUNT>    m_bricks{}; // 0: empty chunk
+
+    /* ====================================================================== */
+    /*                                 METHODS                                */
+    /* ====================================================================== */
+
+    static u32  _toChunkIndex(const u32 x, const u32 y, const u32 z) noexcept;
+    static u32  _toBrickIndex(const u32 x, const u32 y, const u32 z) noexcept;
+
+}; // class VoxelRaycaster
+
+} // namespace game
@@ -6,13 +6,17 @@
 /*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2024/03/15 15:51:38 by etran             #+#    #+#             */
-/*   Updated: 2024/06/14 17:16:06 by etran            ###   ########.fr       */
+/*   Updated: 2024/07/07 22:31:09 by etran            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #include "world.h"
-#include "perlin_noise.h"
-#include "voxmap.h"
+#include "noise_sampler.h"
+#include "biome_map.h"
+#include "generation_pipeline.h"
+#include "controller.h"
+
+#include <algorithm>
 
 #include "debug.h"
 
@@ -26,34 +30,81 @@ void World::init(const u32 seed) {
     proc::NoiseMapInfo noiseInfo{};
     noiseInfo.seed = seed;
     noiseInfo.type = proc::PerlinNoiseType::PERLIN_NOISE_2D;
-    noiseInfo.width = RENDER_DISTANCE * CHUNK_SIZE;
-    noiseInfo.height = RENDER_DISTANCE * CHUNK_SIZE;
     noiseInfo.layers = 3;
     noiseInfo.frequency_0 = 0.05f;
     noiseInfo.frequency_mult = 2.0f;
     noiseInfo.amplitude_mult = 0.5f;
     noiseInfo.scale = CHUNK_SIZE - 1.0f;
-    proc::PerlinNoise perlin(noiseInfo);
+    // Evaluated on demand: the world is not bound to a precomputed map
+    const proc::NoiseSampler terrain(noiseInfo);
 
-    proc::VoronoiDiagram voronoi;
-    if (voronoi.load("assets/maps/biomes.voxmap") == false) {
-        throw std::runtime_error("Failed to load biome map.");
-    }
+    // Biome cells of the whole area, computed in parallel before the chunks
+    // read them
+    m_biomeMap.init(seed);
+    m_biomeMap.prefetch(0, 0, WORLD_BLOCK_SIZE - 1, WORLD_BLOCK_SIZE - 1);
 
-    for (u32 z = 0; z < RENDER_DISTANCE; ++z) {
-        for (u32 x = 0; x < RENDER_DISTANCE; ++x) {
-            for (u32 y = 0; y < RENDER_HEIGHT; ++y) {
-                m_chunks[(y * RENDER_AREA) + (z * RENDER_DISTANCE) + x].generate(perlin, voronoi, x, y, z);
-            }
-        }
-    }
+    // Chunk payloads are recycled through the pool, not the global heap
+    m_blockPool.init(sizeof(Block) * CHUNK_VOLUME, m_chunks.size(), true);
+    for (Chunk& chunk: m_chunks)
+        chunk.init(m_blockPool);
+
+    // Chunk work starts around the spawn point, before the camera exists
+    m_scheduler.init(RENDER_DISTANCE, RENDER_HEIGHT, RENDER_DISTANCE);
+    m_scheduler.setFocus(WORLD_ORIGIN, math::Vect3(1.0f, 0.0f, 0.0f));
+
+    // Terrain, surface, decoration then spilled blocks, each stage waiting
+    // on the neighbors of a chunk to complete the previous one
+    GenerationPipeline pipeline;
+    pipeline.init(m_chunks, RENDER_DISTANCE, RENDER_HEIGHT, RENDER_DISTANCE, terrain, m_biomeMap, m_scheduler, seed);
+    pipeline.run();
+    pipeline.destroy();
+
+    // Light crosses chunks in every direction: lit once the area is complete
+    m_light.init(*this);
+    m_light.compute();
+
+    // Bricks follow every later edit through setBlock
+    m_raycaster.init(*this);
+
+    // Generated terrain is at rest: nothing is scheduled until edited
+    m_simulation.init(*this, seed);
+    m_simulationTime = 0.0f;
 
     m_origin = WORLD_ORIGIN;
-    m_origin.y = perlin.noiseAt(m_origin.x, m_origin.z);
+    m_origin.y = terrain.noiseAt(m_origin.x, m_origin.z);
 
     LINFO("World initialized.");
 }
 
+void World::destroy() {
+    for (Chunk& chunk: m_chunks)
+        chunk.destroy(m_blockPool);
+    m_blockPool.destroy();
+    m_biomeMap.destroy();
+    m_scheduler.destroy();
+    m_light.destroy();
+    m_simulation.destroy();
+    m_raycaster.destroy();
+}
+
+/**
+ * @brief Runs the block simulation up to `time` (in seconds), then queues the
+ * chunks edited since the last update for remeshing. Pending chunk work
+ * follows the camera.
+ */
+void World::update(const ui::Camera& camera, const f32 time) {
+    m_scheduler.setFocus(camera.m_position, camera.m_front);
+    _simulate(time);
+
+    if (m_dirtyChunks.none())
+        return;
+    for (u32 i = 0; i < m_dirtyChunks.size(); ++i) {
+        if (m_dirtyChunks.test(i))
+            m_scheduler.push(ChunkTask::Mesh, i);
+    }
+    m_dirtyChunks.reset();
+}
+
 /* ========================================================================== */
 
 const World::ChunkArray& World::getChunks() const noexcept {
@@ -72,8 +123,177 @@ const Chunk& World::getChunk(const u32 x, const u32 y, const u32 z) const noexce
     return m_chunks[(y * RENDER_AREA) + (z * RENDER_DISTANCE) + x];
 }
 
+/**
+ * @note x, y and z must lie inside the world.
+ */
+const Block& World::getBlock(const i32 x, const i32 y, const i32 z) const noexcept {
+    return getChunk(x / CHUNK_SIZE, y / CHUNK_HEIGHT, z / CHUNK_SIZE)
+        .getBlock(x % CHUNK_SIZE, y % CHUNK_HEIGHT, z % CHUNK_SIZE);
+}
+
 const math::Vect3& World::getOrigin() const noexcept {
     return m_origin;
 }
 
+ChunkScheduler& World::getScheduler() noexcept {
+    return m_scheduler;
+}
+
+const LightEngine& World::getLight() const noexcept {
+    return m_light;
+}
+
+LightEngine& World::getLight() noexcept {
+    return m_light;
+}
+
+const BlockSimulation& World::getSimulation() const noexcept {
+    return m_simulation;
+}
+
+const VoxelRaycaster& World::getRaycaster() const noexcept {
+    return m_raycaster;
+}
+
+/* ========================================================================== */
+
+/**
+ * @brief Changes a block at world coordinates, relights around it, wakes
+ * the simulation there and refreshes the raycaster bricks of its chunk.
+ * Marks its chunk for remeshing, and the neighbors it borders: their faces
+ * against it may change.
+ *
+ * @return false if nothing changed or the block is outside the world.
+ */
+bool World::setBlock(
+    const i32 x,
+    const i32 y,
+    const i32 z,
+    const MaterialType material,
+    const Biome biome
+) {
+    if (x < 0 || x >= WORLD_BLOCK_SIZE || y < 0 || y >= WORLD_BLOCK_HEIGHT || z < 0 || z >= WORLD_BLOCK_SIZE)
+        return false;
+
+    const u32 chunkX = x / CHUNK_SIZE;
+    const u32 chunkY = y / CHUNK_HEIGHT;
+    const u32 chunkZ = z / CHUNK_SIZE;
+    const u32 localX = x % CHUNK_SIZE;
+    const u32 localY = y % CHUNK_HEIGHT;
+    const u32 localZ = z % CHUNK_SIZE;
+
+    Chunk& chunk = getChunk(chunkX, chunkY, chunkZ);
+    const Block& current = chunk.getBlock(localX, localY, localZ);
+    // Air is air, whatever its biome
+    if (current.getMaterial() == material && (current.isVoid() || current.getBiome() == biome))
+        return false;
+
+    chunk.setBlock(localX, localY, localZ, material, biome);
+    m_light.onBlockChanged(x, y, z);
+    m_simulation.wake(x, y, z);
+    m_raycaster.refresh(chunkX, chunkY, chunkZ);
+
+    _markDirty(chunkX, chunkY, chunkZ);
+    if (localX == 0 && chunkX > 0)
+        _markDirty(chunkX - 1, chunkY, chunkZ);
+    if (localX == CHUNK_SIZE - 1 && chunkX + 1 < RENDER_DISTANCE)
+        _markDirty(chunkX + 1, chunkY, chunkZ);
+    if (localY == 0 && chunkY > 0)
+        _markDirty(chunkX, chunkY - 1, chunkZ);
+    if (localY == CHUNK_HEIGHT - 1 && chunkY + 1 < RENDER_HEIGHT)
+        _markDirty(chunkX, chunkY + 1, chunkZ);
+    if (localZ == 0 && chunkZ > 0)
+        _markDirty(chunkX, chunkY, chunkZ - 1);
+    if (localZ == CHUNK_SIZE - 1 && chunkZ + 1 < RENDER_DISTANCE)
+        _markDirty(chunkX, chunkY, chunkZ + 1);
+    return true;
+}
+
+/**
+ * @brief Applies edits in order. Chunks touched several times are still
+ * remeshed once.
+ *
+ * @return Number of blocks that changed.
+ */
+u32 World::applyEdits(std::span<const BlockEdit> edits) {
+    u32 count = 0;
+    for (const BlockEdit& edit: edits)
+        count += setBlock(edit.m_x, edit.m_y, edit.m_z, edit.m_material, edit.m_biome);
+    return count;
+}
+
+/**
+ * @brief Writes the blocks of the [min, max) box, clipped to the world,
+ * straight into the chunks. For bulk changes: the chunks are remeshed and
+ * their raycaster bricks refreshed, but nothing is relit nor woken, light
+ * is to be computed again once done.
+ */
+void World::fillBlocks(
+    const std::array<i32, 3>& min,
+    const std::array<i32, 3>& max,
+    const MaterialType material,
+    const Biome biome
+) {
+    const i32 minX = std::max(min[0], 0);
+    const i32 minY = std::max(min[1], 0);
+    const i32 minZ = std::max(min[2], 0);
+    const i32 maxX = std::min(max[0], WORLD_BLOCK_SIZE);
+    const i32 maxY = std::min(max[1], WORLD_BLOCK_HEIGHT);
+    const i32 maxZ = std::min(max[2], WORLD_BLOCK_SIZE);
+    if (minX >= maxX || minY >= maxY || minZ >= maxZ)
+        return;
+
+    for (i32 z = minZ; z < maxZ; ++z) {
+        for (i32 y = minY; y < maxY; ++y) {
+            for (i32 x = minX; x < maxX; ++x) {
+                getChunk(x / CHUNK_SIZE, y / CHUNK_HEIGHT, z / CHUNK_SIZE)
+                    .setBlock(x % CHUNK_SIZE, y % CHUNK_HEIGHT, z % CHUNK_SIZE, material, biome);
+            }
+        }
+    }
+
+    // Chunks next to the box may show new faces against it
+    const u32 firstX = std::max(minX - 1, 0) / CHUNK_SIZE;
+    const u32 firstY = std::max(minY - 1, 0) / CHUNK_HEIGHT;
+    const u32 firstZ = std::max(minZ - 1, 0) / CHUNK_SIZE;
+    const u32 lastX = std::min(maxX, WORLD_BLOCK_SIZE - 1) / CHUNK_SIZE;
+    const u32 lastY = std::min(maxY, WORLD_BLOCK_HEIGHT - 1) / CHUNK_HEIGHT;
+    const u32 lastZ = std::min(maxZ, WORLD_BLOCK_SIZE - 1) / CHUNK_SIZE;
+    for (u32 chunkZ = firstZ; chunkZ <= lastZ; ++chunkZ) {
+        for (u32 chunkY = firstY; chunkY <= lastY; ++chunkY) {
+            for (u32 chunkX = firstX; chunkX <= lastX; ++chunkX) {
+                m_raycaster.refresh(chunkX, chunkY, chunkZ);
+                _markDirty(chunkX, chunkY, chunkZ);
+            }
+        }
+    }
+}
+
+/* ========================================================================== */
+/*                                   PRIVATE                                  */
+/* ========================================================================== */
+
+void World::_markDirty(const u32 x, const u32 y, const u32 z) noexcept {
+    m_dirtyChunks.set((y * RENDER_AREA) + (z * RENDER_DISTANCE) + x);
+}
+
+/**
+ * @brief Fixed simulation steps. Past MAX_CATCHUP_TICKS behind, the late time
+ * is dropped rather than caught up.
+ */
+void World::_simulate(const f32 time) {
+    u32 ticks = 0;
+    while (time - m_simulationTime >= BlockSimulation::TICK_DURATION) {
+        if (ticks++ == BlockSimulation::MAX_CATCHUP_TICKS) {
+            m_simulationTime = time;
+            break;
+        }
+
+        m_simulationEdits.clear();
+        m_simulation.tick(m_simulationEdits);
+        applyEdits(m_simulationEdits);
+        m_simulationTime += BlockSimulation::TICK_DURATION;
+    }
+}
+
 } // namespace game
\ No newline at end of file
@@ -6,16 +6,42 @@
 /*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2024/03/15 15:24:42 by etran             #+#    #+#             */
-/*   Updated: 2024/06/07 01:50:03 by etran            ###   ########.fr       */
+/*   Updated: 2024/07/07 22:31:09 by etran            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #pragma once
 
 #include "chunk.h"
+#include "block_pool.h"
+#include "biome_map.h"
+#include "chunk_scheduler.h"
+#include "light_engine.h"
+#include "block_simulation.h"
+#include "voxel_raycaster.h"
+
+#include <array>
+#include <bitset>
+#include <span>
+#include <vector>
+
+namespace ui {
+struct Camera;
+}
 
 namespace game {
 
+/**
+ * @brief Block change at world coordinates.
+ */
+struct BlockEdit {
+    i32             m_x = 0;
+    i32             m_y = 0;
+    i32             m_z = 0;
+    MaterialType    m_material = MaterialType::Air;
+    Biome           m_biome = Biome::Plains;
+};
+
 /**
  * @brief The World class represents the game world.
  * Gives information on chunks and their data.
@@ -26,13 +52,15 @@ public:
     /*                                TYPEDEFS                                */
     /* ====================================================================== */
 
-    using ChunkArray = std::array<Chunk, RENDER_AREA * RENDER_HEIGHT>;
+    using ChunkArray = std::array<Chunk, RENDER_VOLUME>;
 
     /* ====================================================================== */
     /*                                 METHODS                                */
     /* ====================================================================== */
 
     void init(const u32 seed);
+    void destroy();
+    void update(const ui::Camera& camera, const f32 time);
 
     /* ====================================================================== */
 
@@ -42,16 +70,54 @@ public:
     Chunk&              getChunk(const u32 x, const u32 y, const u32 z) noexcept;
     const Chunk&        getChunk(const u32 x, const u32 y, const u32 z) const noexcept;
 
+    const Block&        getBlock(const i32 x, const i32 y, const i32 z) const noexcept;
     const math::Vect3&  getOrigin() const noexcept;
 
+    bool                setBlock(
+        const i32 x,
+        const i32 y,
+        const i32 z,
+        const MaterialType material,
+        const Biome biome = Biome::Plains);
+    u32                 applyEdits(std::span<const BlockEdit> edits);
+    void                fillBlocks(
+        const std::array<i32, 3>& min,
+        const std::array<i32, 3>& max,
+        const MaterialType material,
+        const Biome biome = Biome::Plains);
+
+    ChunkScheduler&     getScheduler() noexcept;
+    const LightEngine&  getLight() const noexcept;
+    LightEngine&        getLight() noexcept;
+    const BlockSimulation&  getSimulation() const noexcept;
+    const VoxelRaycaster&   getRaycaster() const noexcept;
+
 private:
     /* ====================================================================== */
     /*                                  DATA                                  */
     /* ====================================================================== */
 
-    ChunkArray  m_chunks;
+    ChunkArray      m_chunks;
+    mem::BlockPool  m_blockPool;
+    proc::BiomeMap  m_biomeMap;
+    ChunkScheduler  m_scheduler;
+    LightEngine     m_light;
+    BlockSimulation m_simulation;
+    VoxelRaycaster  m_raycaster;
+
+    std::bitset<RENDER_VOLUME>  m_dirtyChunks;
+
+    math::Vect3     m_origin = { 0.0f, 0.0f, 0.0f };
+
+    f32                     m_simulationTime = 0.0f;
+    std::vector<BlockEdit>  m_simulationEdits;
+
+    /* ====================================================================== */
+    /*                                 METHODS                                */
+    /* ====================================================================== */
 
-    math::Vect3 m_origin = { 0.0f, 0.0f, 0.0f };
+    void    _markDirty(const u32 x, const u32 y, const u32 z) noexcept;
+    void    _simulate(const f32 time);
 
 }; // class World
 
@@ -6,7 +6,7 @@
 /*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2024/02/27 17:40:32 by etran             #+#    #+#             */
-/*   Updated: 2024/05/31 14:54:17 by etran            ###   ########.fr       */
+/*   Updated: 2024/07/05 10:27:51 by etran            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -132,6 +132,21 @@ void Buffer::copyBuffer(
     LDEBUG("Buffer " << m_buffer << " copied from " << src.getBuffer() << ".");
 }
 
+/**
+ * @brief Copies only some ranges of src buffer, offsets & sizes in bytes.
+ */
+void Buffer::copyRegions(
+    const ICommandBuffer* cmdBuffer,
+    const Buffer& src,
+    std::span<const VkBufferCopy> regions
+) {
+    vkCmdCopyBuffer(
+        cmdBuffer->getBuffer(),
+        src.getBuffer(),
+        m_buffer,
+        (u32)regions.size(), regions.data());
+}
+
 Buffer Buffer::createStagingBuffer(const Device& device) const {
     BufferMetadata stagingMetadata{};
     stagingMetadata.m_format = m_metadata.m_format;
@@ -6,13 +6,14 @@
 /*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2024/02/27 17:14:27 by etran             #+#    #+#             */
-/*   Updated: 2024/05/31 02:29:42 by etran            ###   ########.fr       */
+/*   Updated: 2024/07/05 10:27:51 by etran            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #pragma once
 
 #include <vulkan/vulkan.h>
+#include <span>
 
 #include "types.h"
 
@@ -69,6 +70,10 @@ public:
         const Buffer& src,
         const u32 srcOffset = 0,
         const u32 dstOffset = 0);
+    void copyRegions(
+        const ICommandBuffer* cmdBuffer,
+        const Buffer& src,
+        std::span<const VkBufferCopy> regions);
 
     Buffer  createStagingBuffer(const Device& device) const;
 
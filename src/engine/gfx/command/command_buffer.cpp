@@ -6,7 +6,7 @@
 /*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2024/02/23 22:43:14 by etran             #+#    #+#             */
-/*   Updated: 2024/06/14 19:28:16 by etran            ###   ########.fr       */
+/*   Updated: 2024/06/27 11:48:20 by etran            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -90,9 +90,9 @@ void CommandBuffer::awaitEndOfRecording(const Device& device) const {
 }
 
 void CommandBuffer::submitRecording(
-    const std::vector<VkSemaphore>& waitSemaphores,
-    const std::vector<VkPipelineStageFlags>& waitStages,
-    const std::vector<VkSemaphore>& signalSemaphore,
+    const std::span<const VkSemaphore> waitSemaphores,
+    const std::span<const VkPipelineStageFlags> waitStages,
+    const std::span<const VkSemaphore> signalSemaphore,
     const VkFence fence
 ) const {
     VkSubmitInfo submitInfo{};
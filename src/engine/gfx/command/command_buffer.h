@@ -6,7 +6,7 @@
 /*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2024/02/23 20:01:10 by etran             #+#    #+#             */
-/*   Updated: 2024/06/14 19:28:30 by etran            ###   ########.fr       */
+/*   Updated: 2024/06/27 11:48:20 by etran            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -37,9 +37,9 @@ public:
     void    awaitEndOfRecording(const Device& device) const override;
 
     void    submitRecording(
-        const std::vector<VkSemaphore>& waitSemaphores,
-        const std::vector<VkPipelineStageFlags>& waitStages,
-        const std::vector<VkSemaphore>& signalSemaphore,
+        const std::span<const VkSemaphore> waitSemaphores,
+        const std::span<const VkPipelineStageFlags> waitStages,
+        const std::span<const VkSemaphore> signalSemaphore,
         const VkFence fence = VK_NULL_HANDLE) const override;
 
     void    bindPipeline(const VkPipeline& pipeline) const override;
@@ -6,14 +6,14 @@
 /*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2024/02/23 10:28:53 by etran             #+#    #+#             */
-/*   Updated: 2024/06/14 19:29:01 by etran            ###   ########.fr       */
+/*   Updated: 2024/06/27 11:48:20 by etran            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #pragma once
 
 #include <vulkan/vulkan.h>
-#include <vector>
+#include <span>
 
 namespace vox::gfx {
 
@@ -45,9 +45,9 @@ public:
     virtual void    awaitEndOfRecording(const Device& device) const = 0;
 
     virtual void    submitRecording(
-        const std::vector<VkSemaphore>& waitSemaphores,
-        const std::vector<VkPipelineStageFlags>& waitStages,
-        const std::vector<VkSemaphore>& signalSemaphore,
+        const std::span<const VkSemaphore> waitSemaphores,
+        const std::span<const VkPipelineStageFlags> waitStages,
+        const std::span<const VkSemaphore> signalSemaphore,
         const VkFence fence = VK_NULL_HANDLE) const = 0;
 
     virtual void    bindPipeline(const VkPipeline& pipeline) const = 0;
@@ -6,7 +6,7 @@
 /*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2024/02/28 19:55:31 by etran             #+#    #+#             */
-/*   Updated: 2024/06/21 14:21:59 by etran            ###   ########.fr       */
+/*   Updated: 2024/07/08 10:41:17 by etran            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -19,6 +19,10 @@
 #include "ssao_sets.h"
 #endif
 
+#if ENABLE_GPU_CULLING
+#include "cull_sets.h"
+#endif
+
 #include "debug.h"
 
 namespace vox::gfx {
@@ -36,6 +40,11 @@ DescriptorTable::DescriptorTable() {
     m_sets[(u32)DescriptorSetIndex::Ssao] = new SSAOSet();
     m_sets[(u32)DescriptorSetIndex::SsaoBlur] = new SSAOBlurSet();
 #endif
+
+#if ENABLE_GPU_CULLING
+    m_sets[(u32)DescriptorSetIndex::HiZ] = new HiZSet();
+    m_sets[(u32)DescriptorSetIndex::Cull] = new CullSet();
+#endif
 }
 
 DescriptorTable::~DescriptorTable() {
@@ -0,0 +1,152 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   cull_sets.cpp                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/07/08 10:02:51 by etran             #+#    #+#             */
+/*   Updated: 2024/07/08 10:02:51 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "cull_sets.h"
+#include "device.h"
+#include "buffer.h"
+#include "texture_table.h"
+#include "hiz_texture.h"
+#include "vertex_buffer.h"
+#include "vox_decl.h"
+#include "debug.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#if ENABLE_GPU_CULLING
+
+namespace vox::gfx {
+
+static
+VkDescriptorBufferInfo _getBufferInfo(const Buffer& buffer) noexcept {
+    VkDescriptorBufferInfo bufferInfo{};
+    bufferInfo.buffer = buffer.getBuffer();
+    bufferInfo.offset = 0;
+    bufferInfo.range = buffer.getMetadata().m_size * buffer.getMetadata().m_format;
+    return bufferInfo;
+}
+
+/* ========================================================================== */
+/*                                    HI-Z                                    */
+/* ========================================================================== */
+
+void HiZSet::init(const Device& device, const ICommandBuffer* cmdBuffer) {
+    std::array<VkDescriptorSetLayoutBinding, BINDING_COUNT> bindings = {
+        _createLayoutBinding(DescriptorTypeIndex::CombinedImageSampler, ShaderVisibility::CS, (u32)BindingIndex::Depth),
+        _createLayoutBinding(DescriptorTypeIndex::StorageImage, ShaderVisibility::CS, (u32)BindingIndex::Levels, HIZ_MAX_LEVELS),
+    };
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = BINDING_COUNT;
+    layoutInfo.pBindings = bindings.data();
+
+    if (vkCreateDescriptorSetLayout(device.getDevice(), &layoutInfo, nullptr, &m_layout) != VK_SUCCESS)
+        throw std::runtime_error("failed to create hi-z descriptor set layout");
+
+    LDEBUG("Hi-Z descriptor set layout created");
+}
+
+void HiZSet::destroy(const Device& device) {
+    vkDestroyDescriptorSetLayout(device.getDevice(), m_layout, nullptr);
+
+    LDEBUG("Hi-Z descriptor set destroyed");
+}
+
+void HiZSet::fill(const Device& device) {
+    const VkSampler sampler = TextureTable::getSampler(device, Sampler::Filter::Nearest, Sampler::Border::Edge, Sampler::BorderColor::WhiteFloat).getSampler();
+    const ImageBuffer& depth = TextureTable::getTexture(TextureIndex::GBufferDepth)->getImageBuffer();
+    const HiZTexture* pyramid = (const HiZTexture*)TextureTable::getTexture(TextureIndex::HiZ);
+
+    VkDescriptorImageInfo depthInfo{};
+    depthInfo.imageLayout = depth.getMetaData().m_layoutData.m_layout;
+    depthInfo.imageView = depth.getView();
+    depthInfo.sampler = sampler;
+
+    // The array is sized for the largest pyramid: slots past the last level
+    // repeat it and are never written
+    std::array<VkDescriptorImageInfo, HIZ_MAX_LEVELS> levelInfos{};
+    for (u32 i = 0; i < HIZ_MAX_LEVELS; ++i) {
+        levelInfos[i].imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+        levelInfos[i].imageView = pyramid->getLevelView(std::min(i, pyramid->getLevelCount() - 1));
+    }
+
+    std::array<VkWriteDescriptorSet, BINDING_COUNT> descriptorWrites = {
+        _createWriteDescriptorSet(DescriptorTypeIndex::CombinedImageSampler, depthInfo, (u32)BindingIndex::Depth),
+        _createWriteDescriptorSet(DescriptorTypeIndex::StorageImage, levelInfos[0], (u32)BindingIndex::Levels, HIZ_MAX_LEVELS),
+    };
+
+    vkUpdateDescriptorSets(device.getDevice(), BINDING_COUNT, descriptorWrites.data(), 0, nullptr);
+
+    LDEBUG("Hi-Z descriptor set filled");
+}
+
+/* ========================================================================== */
+/*                                    CULL                                    */
+/* ========================================================================== */
+
+void CullSet::init(const Device& device, const ICommandBuffer* cmdBuffer) {
+    std::array<VkDescriptorSetLayoutBinding, BINDING_COUNT> bindings = {
+        _createLayoutBinding(DescriptorTypeIndex::CombinedImageSampler, ShaderVisibility::CS, (u32)BindingIndex::Pyramid),
+        _createLayoutBinding(DescriptorTypeIndex::StorageBuffer, ShaderVisibility::CS, (u32)BindingIndex::Chunks),
+        _createLayoutBinding(DescriptorTypeIndex::StorageBuffer, ShaderVisibility::CS, (u32)BindingIndex::Commands),
+        _createLayoutBinding(DescriptorTypeIndex::StorageBuffer, ShaderVisibility::CS, (u32)BindingIndex::Visibility),
+    };
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = BINDING_COUNT;
+    layoutInfo.pBindings = bindings.data();
+
+    if (vkCreateDescriptorSetLayout(device.getDevice(), &layoutInfo, nullptr, &m_layout) != VK_SUCCESS)
+        throw std::runtime_error("failed to create cull descriptor set layout");
+
+    LDEBUG("Cull descriptor set layout created");
+}
+
+void CullSet::destroy(const Device& device) {
+    vkDestroyDescriptorSetLayout(device.getDevice(), m_layout, nullptr);
+
+    LDEBUG("Cull descriptor set destroyed");
+}
+
+/**
+ * @note The vertex buffer must be initialized: it owns the culling buffers.
+ */
+void CullSet::fill(const Device& device) {
+    const VkSampler sampler = TextureTable::getSampler(device, Sampler::Filter::Nearest, Sampler::Border::Edge, Sampler::BorderColor::WhiteFloat).getSampler();
+    const ImageBuffer& pyramid = TextureTable::getTexture(TextureIndex::HiZ)->getImageBuffer();
+
+    VkDescriptorImageInfo pyramidInfo{};
+    pyramidInfo.imageLayout = pyramid.getMetaData().m_layoutData.m_layout;
+    pyramidInfo.imageView = pyramid.getView();
+    pyramidInfo.sampler = sampler;
+
+    const VkDescriptorBufferInfo chunksInfo = _getBufferInfo(VertexBuffer::getCullChunks());
+    const VkDescriptorBufferInfo commandsInfo = _getBufferInfo(VertexBuffer::getDrawCommands());
+    const VkDescriptorBufferInfo visibilityInfo = _getBufferInfo(VertexBuffer::getChunkVisibility());
+
+    std::array<VkWriteDescriptorSet, BINDING_COUNT> descriptorWrites = {
+        _createWriteDescriptorSet(DescriptorTypeIndex::CombinedImageSampler, pyramidInfo, (u32)BindingIndex::Pyramid),
+        _createWriteDescriptorSet(DescriptorTypeIndex::StorageBuffer, chunksInfo, (u32)BindingIndex::Chunks),
+        _createWriteDescriptorSet(DescriptorTypeIndex::StorageBuffer, commandsInfo, (u32)BindingIndex::Commands),
+        _createWriteDescriptorSet(DescriptorTypeIndex::StorageBuffer, visibilityInfo, (u32)BindingIndex::Visibility),
+    };
+
+    vkUpdateDescriptorSets(device.getDevice(), BINDING_COUNT, descriptorWrites.data(), 0, nullptr);
+
+    LDEBUG("Cull descriptor set filled");
+}
+
+} // namespace vox::gfx
+
+#endif
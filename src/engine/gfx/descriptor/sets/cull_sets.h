@@ -0,0 +1,105 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   cull_sets.h                                        :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/07/08 10:02:51 by etran             #+#    #+#             */
+/*   Updated: 2024/07/08 10:02:51 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#pragma once
+
+#include "descriptor_set.h"
+#include "game_decl.h"
+
+namespace vox::gfx {
+
+/**
+ * @brief Hi-Z build: the GBuffer depth and every pyramid level as a storage
+ * image.
+ */
+class HiZSet final: public DescriptorSet {
+public:
+    /* ====================================================================== */
+    /*                                  ENUMS                                 */
+    /* ====================================================================== */
+
+    enum class BindingIndex: u32 {
+        Depth,
+        Levels,
+
+        Count
+    };
+
+    /* ====================================================================== */
+    /*                                TYPEDEFS                                */
+    /* ====================================================================== */
+
+    using super = DescriptorSet;
+
+    /* ====================================================================== */
+    /*                                 METHODS                                */
+    /* ====================================================================== */
+
+    void    init(const Device& device, const ICommandBuffer* cmdBuffer) override;
+    void    destroy(const Device& device) override;
+
+    void    fill(const Device& device) override;
+
+private:
+    /* ====================================================================== */
+    /*                             STATIC MEMBERS                             */
+    /* ====================================================================== */
+
+    static constexpr u32 BINDING_COUNT = (u32)BindingIndex::Count;
+
+}; // class HiZSet
+
+
+/**
+ * @brief Chunk culling: the pyramid, the chunk boxes and draw ranges the CPU
+ * writes each frame, the indirect draws and the visibility of last frame.
+ */
+class CullSet final: public DescriptorSet {
+public:
+    /* ====================================================================== */
+    /*                                  ENUMS                                 */
+    /* ====================================================================== */
+
+    enum class BindingIndex: u32 {
+        Pyramid,
+        Chunks,
+        Commands,
+        Visibility,
+
+        Count
+    };
+
+    /* ====================================================================== */
+    /*                                TYPEDEFS                                */
+    /* ====================================================================== */
+
+    using super = DescriptorSet;
+
+    /* ====================================================================== */
+    /*                                 METHODS                                */
+    /* ====================================================================== */
+
+    void    init(const Device& device, const ICommandBuffer* cmdBuffer) override;
+    void    destroy(const Device& device) override;
+
+    void    fill(const Device& device) override;
+
+private:
+    /* ====================================================================== */
+    /*                             STATIC MEMBERS                             */
+    /* ====================================================================== */
+
+    static constexpr u32 BINDING_COUNT = (u32)BindingIndex::Count;
+
+}; // class CullSet
+
+} // namespace vox::gfx
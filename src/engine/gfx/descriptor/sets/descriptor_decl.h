@@ -6,7 +6,7 @@
 /*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2024/02/28 23:42:29 by etran             #+#    #+#             */
-/*   Updated: 2024/06/21 03:45:48 by etran            ###   ########.fr       */
+/*   Updated: 2024/07/08 10:41:17 by etran            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -37,6 +37,10 @@ enum class DescriptorSetIndex: u32 {
     Ssao,
     SsaoBlur,
 #endif
+#if ENABLE_GPU_CULLING
+    HiZ,
+    Cull,
+#endif
 
     Count
 };
@@ -110,6 +114,12 @@ ShaderVisibility operator|(ShaderVisibility lhs, ShaderVisibility rhs) {
 #elif defined(VOX_SSAO_BLUR_LAYOUT)
 #define SSAO_BLUR_SET 0
 
+#elif defined(VOX_HIZ_LAYOUT)
+#define HIZ_SET 0
+
+#elif defined(VOX_CULL_LAYOUT)
+#define CULL_SET 0
+
 #endif
 
 #endif // VOX_CPP
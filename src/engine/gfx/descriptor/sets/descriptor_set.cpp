@@ -6,7 +6,7 @@
 /*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2024/02/28 19:54:32 by etran             #+#    #+#             */
-/*   Updated: 2024/06/20 19:08:21 by etran            ###   ########.fr       */
+/*   Updated: 2024/07/08 10:41:17 by etran            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -44,15 +44,16 @@ const DescriptorSet::PoolSizes& DescriptorSet::getSizes() const noexcept {
 VkDescriptorSetLayoutBinding DescriptorSet::_createLayoutBinding(
     const DescriptorTypeIndex typeIndex,
     const ShaderVisibility shaderStage,
-    const u32 bindingIndex
+    const u32 bindingIndex,
+    const u32 descriptorCount
 ) {
     VkDescriptorSetLayoutBinding layoutBinding = {};
     layoutBinding.binding = bindingIndex;
     layoutBinding.stageFlags = (VkShaderStageFlagBits)shaderStage;
-    layoutBinding.descriptorCount = 1;
+    layoutBinding.descriptorCount = descriptorCount;
     layoutBinding.descriptorType = DESCRIPTOR_TYPES[(u32)typeIndex];
 
-    ++m_poolSizes[(u32)typeIndex].descriptorCount;
+    m_poolSizes[(u32)typeIndex].descriptorCount += descriptorCount;
 
     return layoutBinding;
 }
@@ -74,17 +75,22 @@ VkWriteDescriptorSet DescriptorSet::_createWriteDescriptorSet(
     return writeDescriptorSet;
 }
 
+/**
+ * @note For an array binding, `imageInfo` is the first of `descriptorCount`
+ * contiguous infos.
+ */
 VkWriteDescriptorSet DescriptorSet::_createWriteDescriptorSet(
     const DescriptorTypeIndex typeIndex,
     const VkDescriptorImageInfo& imageInfo,
-    const u32 bindingIndex
+    const u32 bindingIndex,
+    const u32 descriptorCount
 ) const {
     VkWriteDescriptorSet writeDescriptorSet = {};
     writeDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
     writeDescriptorSet.dstSet = m_set;
     writeDescriptorSet.dstBinding = bindingIndex;
     writeDescriptorSet.dstArrayElement = 0;
-    writeDescriptorSet.descriptorCount = 1;
+    writeDescriptorSet.descriptorCount = descriptorCount;
     writeDescriptorSet.descriptorType = DESCRIPTOR_TYPES[(u32)typeIndex];
     writeDescriptorSet.pImageInfo = &imageInfo;
 
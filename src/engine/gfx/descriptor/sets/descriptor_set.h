@@ -6,7 +6,7 @@
 /*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2024/02/28 16:16:09 by etran             #+#    #+#             */
-/*   Updated: 2024/06/21 14:26:50 by etran            ###   ########.fr       */
+/*   Updated: 2024/07/08 10:41:17 by etran            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -60,12 +60,14 @@ protected:
     VkDescriptorSetLayoutBinding    _createLayoutBinding(
         const DescriptorTypeIndex typeIndex,
         const ShaderVisibility shaderStage,
-        const u32 bindingIndex);
+        const u32 bindingIndex,
+        const u32 descriptorCount = 1);
 
     VkWriteDescriptorSet            _createWriteDescriptorSet(
         const DescriptorTypeIndex typeIndex,
         const VkDescriptorImageInfo& imageInfo,
-        const u32 bindingIndex) const;
+        const u32 bindingIndex,
+        const u32 descriptorCount = 1) const;
 
     VkWriteDescriptorSet            _createWriteDescriptorSet(
         const DescriptorTypeIndex typeIndex,
@@ -6,7 +6,7 @@
 /*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2024/06/17 13:55:01 by etran             #+#    #+#             */
-/*   Updated: 2024/06/25 14:49:59 by etran            ###   ########.fr       */
+/*   Updated: 2024/07/04 09:48:03 by etran            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -16,9 +16,9 @@
 #include "icommand_buffer.h"
 #include "texture_table.h"
 #include "maths.h"
+#include "counter_rng.h"
 #include "debug.h"
 
-#include <random>
 #include <stdexcept>
 
 namespace vox::gfx {
@@ -100,18 +100,20 @@ void SSAOSet::fill(const Device& device) {
 Buffer SSAOSet::_createSamplesBuffer(const Device& device, const ICommandBuffer* transferBuffer) {
     Buffer buffer{};
 
-    std::uniform_real_distribution<float>   randomDistance(0.0f, 1.0f);
-    std::default_random_engine              gen;
+    // Sample i only depends on i: the kernel is the same on every run
+    proc::CounterRng rng(0, 0, 0, 0, proc::RngStream::SsaoKernel);
 
     std::vector<math::Vect3> ssaoKernel;
     ssaoKernel.reserve(SSAO_KERNEL_SIZE);
     for (u32 i = 0; i < SSAO_KERNEL_SIZE; ++i) {
+        rng.seek(i * 4);
+
         math::Vect3 sample(
-            randomDistance(gen) * 2.0f - 1.0f,
-            randomDistance(gen) * 2.0f - 1.0f,
-            randomDistance(gen));
+            rng.nextFloat(-1.0f, 1.0f),
+            rng.nextFloat(-1.0f, 1.0f),
+            rng.nextFloat());
         sample = math::normalize(sample);
-        sample *= randomDistance(gen);
+        sample *= rng.nextFloat();
 
         f32 scale = f32(i) / f32(SSAO_KERNEL_SIZE);
         scale = math::lerp(0.1f, 1.0f, scale * scale);
@@ -6,7 +6,7 @@
 /*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2024/03/17 23:05:38 by etran             #+#    #+#             */
-/*   Updated: 2024/06/21 14:30:11 by etran            ###   ########.fr       */
+/*   Updated: 2024/07/07 22:03:44 by etran            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -30,7 +30,7 @@ void ChunkDataSampler::init(const Device& device) {
     textureData.m_format = VK_FORMAT_R32_UINT;
     textureData.m_width = CHUNK_SIZE * 4;
     textureData.m_height = CHUNK_SIZE * 4;
-    textureData.m_layerCount = RENDER_AREA; // A layer = a chunk
+    textureData.m_layerCount = RENDER_VOLUME; // A layer = a chunk
     textureData.m_usage = VK_IMAGE_USAGE_SAMPLED_BIT |      // Sampled texture
                           VK_IMAGE_USAGE_TRANSFER_DST_BIT;  // Transfer destination
     textureData.m_viewType = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
@@ -52,7 +52,7 @@ void ChunkDataSampler::fill(
 
     Buffer stagingBuffer = m_imageBuffer.createStagingBuffer(device);
     stagingBuffer.map(device);
-    for (u32 i = 0; i < RENDER_AREA; i++)
+    for (u32 i = 0; i < RENDER_VOLUME; i++)
         stagingBuffer.copyFrom(chunks[i].getBlocks().data(), CHUNK_VOLUME, i * CHUNK_VOLUME);
     stagingBuffer.unmap(device);
 
@@ -6,7 +6,7 @@
 /*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2024/03/11 17:46:33 by etran             #+#    #+#             */
-/*   Updated: 2024/06/20 12:46:20 by etran            ###   ########.fr       */
+/*   Updated: 2024/07/07 21:46:52 by etran            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -16,6 +16,7 @@
 #include "icommand_buffer.h"
 
 #include "ppm_loader.h"
+#include "job_system.h"
 
 namespace vox::gfx {
 
@@ -57,10 +58,11 @@ std::array<scop::Image, IMAGE_COUNT> _loadAssets() {
         "assets/textures/undefined.ppm"
     };
 
-    for (u32 i = 0; i < IMAGE_COUNT; ++i) {
+    // Loaders may throw: parallelFor rethrows the first error on this thread
+    jobs::JobSystem::parallelFor(IMAGE_COUNT, 1, [&](const u32 i) {
         scop::PpmLoader loader(texturePaths[i]);
         textures[i] = loader.load();
-    }
+    });
 
     return textures;
 }
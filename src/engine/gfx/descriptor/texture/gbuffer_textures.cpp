@@ -6,7 +6,7 @@
 /*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2024/06/14 00:40:50 by etran             #+#    #+#             */
-/*   Updated: 2024/06/25 15:12:44 by etran            ###   ########.fr       */
+/*   Updated: 2024/07/08 10:41:17 by etran            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -121,6 +121,9 @@ void DepthTexture::init(const Device& device) {
     textureData.m_height = SwapChain::getImageExtent().height;
     textureData.m_sampleCount = VK_SAMPLE_COUNT_1_BIT;
     textureData.m_usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+#if ENABLE_GPU_CULLING
+    textureData.m_usage |= VK_IMAGE_USAGE_SAMPLED_BIT; // Reduced to the Hi-Z pyramid
+#endif
     textureData.m_aspectFlags = VK_IMAGE_ASPECT_DEPTH_BIT;
 
     m_imageBuffer.initImage(device, std::move(textureData));
@@ -0,0 +1,116 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   hiz_texture.cpp                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/07/08 09:41:17 by etran             #+#    #+#             */
+/*   Updated: 2024/07/08 09:41:17 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "hiz_texture.h"
+#include "device.h"
+#include "icommand_buffer.h"
+#include "swap_chain.h"
+#include "game_decl.h"
+
+#include "debug.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace vox::gfx {
+
+/* ========================================================================== */
+/*                                   PUBLIC                                   */
+/* ========================================================================== */
+
+void HiZTexture::init(const Device& device) {
+    ImageMetaData textureData{};
+    textureData.m_format = VK_FORMAT_R32_SFLOAT;
+    textureData.m_width = SwapChain::getImageExtent().width;
+    textureData.m_height = SwapChain::getImageExtent().height;
+    textureData.m_sampleCount = VK_SAMPLE_COUNT_1_BIT;
+    textureData.m_usage = VK_IMAGE_USAGE_STORAGE_BIT | // Written level by level
+                          VK_IMAGE_USAGE_SAMPLED_BIT;  // Fetched by the culling pass
+    textureData.m_aspectFlags = VK_IMAGE_ASPECT_COLOR_BIT;
+
+    // Down to 1x1 along both sides, not only the width
+    textureData.m_mipCount = 1;
+    for (u32 w = textureData.m_width, h = textureData.m_height; w > 1 || h > 1; w /= 2, h /= 2)
+        ++textureData.m_mipCount;
+    if (textureData.m_mipCount > HIZ_MAX_LEVELS)
+        throw std::runtime_error("hi-z pyramid has too many levels");
+
+    m_imageBuffer.initImage(device, std::move(textureData));
+    m_imageBuffer.initView(device);
+
+    const ImageMetaData& metadata = m_imageBuffer.getMetaData();
+    m_levelViews.resize(metadata.m_mipCount);
+    for (u32 level = 0; level < metadata.m_mipCount; ++level) {
+        VkImageViewCreateInfo viewInfo{};
+        viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewInfo.image = m_imageBuffer.getImage();
+        viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewInfo.format = metadata.m_format;
+        viewInfo.subresourceRange.aspectMask = metadata.m_aspectFlags;
+        viewInfo.subresourceRange.baseMipLevel = level;
+        viewInfo.subresourceRange.levelCount = 1;
+        viewInfo.subresourceRange.baseArrayLayer = 0;
+        viewInfo.subresourceRange.layerCount = 1;
+
+        if (vkCreateImageView(device.getDevice(), &viewInfo, nullptr, &m_levelViews[level]) != VK_SUCCESS)
+            throw std::runtime_error("failed to create hi-z level view");
+    }
+
+    LDEBUG("Hi-Z texture created: " << metadata.m_mipCount << " levels.");
+}
+
+void HiZTexture::destroy(const Device& device) {
+    for (VkImageView view: m_levelViews)
+        vkDestroyImageView(device.getDevice(), view, nullptr);
+    m_imageBuffer.destroy(device);
+}
+
+/**
+ * @brief Moves every level to the general layout, once: the pyramid is both
+ * written as a storage image and fetched, it never switches again.
+ */
+void HiZTexture::fill(
+    const Device& device,
+    const ICommandBuffer* cmdBuffer,
+    const void* data
+) {
+    constexpr LayoutData GENERAL_LAYOUT{
+        .m_layout = VK_IMAGE_LAYOUT_GENERAL,
+        .m_accessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+        .m_stageMask = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT };
+
+    cmdBuffer->reset();
+    cmdBuffer->startRecording();
+    m_imageBuffer.setLayout(cmdBuffer, GENERAL_LAYOUT);
+    cmdBuffer->stopRecording();
+    cmdBuffer->awaitEndOfRecording(device);
+}
+
+/* ========================================================================== */
+
+VkImageView HiZTexture::getLevelView(const u32 level) const noexcept {
+    return m_levelViews[level];
+}
+
+u32 HiZTexture::getLevelCount() const noexcept {
+    return m_levelViews.size();
+}
+
+u32 HiZTexture::getLevelWidth(const u32 level) const noexcept {
+    return std::max(m_imageBuffer.getMetaData().m_width >> level, 1u);
+}
+
+u32 HiZTexture::getLevelHeight(const u32 level) const noexcept {
+    return std::max(m_imageBuffer.getMetaData().m_height >> level, 1u);
+}
+
+} // namespace vox::gfx
@@ -0,0 +1,70 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   hiz_texture.h                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/07/08 09:41:17 by etran             #+#    #+#             */
+/*   Updated: 2024/07/08 09:41:17 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#pragma once
+
+#include "texture.h"
+
+#include <vector>
+
+namespace vox::gfx {
+
+/**
+ * @brief Hi-Z pyramid of the GBuffer depth, built by HiZPipeline and read
+ * by CullPipeline. Levels halve down to 1x1 as HiZPyramid ones do, each with
+ * its own view for the storage writes.
+ */
+class HiZTexture final: public Texture {
+public:
+    /* ====================================================================== */
+    /*                                TYPEDEFS                                */
+    /* ====================================================================== */
+
+    using super = Texture;
+
+    /* ====================================================================== */
+    /*                                 METHODS                                */
+    /* ====================================================================== */
+
+    HiZTexture(): super(false) {}
+
+    ~HiZTexture() = default;
+
+    HiZTexture(HiZTexture&& other) = delete;
+    HiZTexture(const HiZTexture& other) = delete;
+    HiZTexture& operator=(HiZTexture&& other) = delete;
+    HiZTexture& operator=(const HiZTexture& other) = delete;
+
+    /* ====================================================================== */
+
+    void    init(const Device& device) override;
+    void    destroy(const Device& device) override;
+
+    void    fill(const Device& device, const ICommandBuffer* cmdBuffer, const void* data = nullptr) override;
+
+    /* ====================================================================== */
+
+    VkImageView getLevelView(const u32 level) const noexcept;
+    u32         getLevelCount() const noexcept;
+    u32         getLevelWidth(const u32 level) const noexcept;
+    u32         getLevelHeight(const u32 level) const noexcept;
+
+private:
+    /* ====================================================================== */
+    /*                                  DATA                                  */
+    /* ====================================================================== */
+
+    std::vector<VkImageView>    m_levelViews;
+
+}; // class HiZTexture
+
+} // namespace vox::gfx
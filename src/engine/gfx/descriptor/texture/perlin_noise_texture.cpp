@@ -6,7 +6,7 @@
 /*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2024/03/27 15:41:25 by etran             #+#    #+#             */
-/*   Updated: 2024/06/20 16:11:08 by etran            ###   ########.fr       */
+/*   Updated: 2024/06/26 16:42:10 by etran            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -16,6 +16,7 @@
 #include "icommand_buffer.h"
 #include "buffer.h"
 #include "game_decl.h"
+#include "job_system.h"
 
 #include <array>
 
@@ -51,31 +52,24 @@ void PerlinNoiseSampler::fill(
     info.frequency_mult = 0.1f;
     info.amplitude_mult = 0.5f;
 
-    info.seed = 16;
-    const proc::PerlinNoise noise1(info);
-    auto noiseData1 = noise1.toPixels();
+    // Each map owns its generator: build them in parallel
+    constexpr std::array<u32, 4> seeds = { 16, 24, 32, 40 };
+    std::array<std::vector<u32>, seeds.size()> noiseData;
 
-    info.seed = 24;
-    const proc::PerlinNoise noise2(info);
-    auto noiseData2 = noise2.toPixels();
-
-    info.seed = 32;
-    const proc::PerlinNoise noise3(info);
-    auto noiseData3 = noise3.toPixels();
-
-    info.seed = 40;
-    const proc::PerlinNoise noise4(info);
-    auto noiseData4 = noise4.toPixels();
+    jobs::JobSystem::parallelFor(seeds.size(), 1, [&](const u32 i) {
+        proc::NoiseMapInfo layerInfo = info;
+        layerInfo.seed = seeds[i];
+        const proc::PerlinNoise noise(layerInfo);
+        noiseData[i] = noise.toPixels();
+    });
 
     const u32 imageSize = m_imageBuffer.getMetaData().getLayerSize()
                            * m_imageBuffer.getMetaData().getPixelSize();
 
     Buffer stagingBuffer = m_imageBuffer.createStagingBuffer(device);
     stagingBuffer.map(device);
-    stagingBuffer.copyFrom(noiseData1.data(), imageSize, 0);
-    stagingBuffer.copyFrom(noiseData2.data(), imageSize, imageSize);
-    stagingBuffer.copyFrom(noiseData3.data(), imageSize, imageSize * 2);
-    stagingBuffer.copyFrom(noiseData4.data(), imageSize, imageSize * 3);
+    for (u32 i = 0; i < noiseData.size(); ++i)
+        stagingBuffer.copyFrom(noiseData[i].data(), imageSize, imageSize * i);
     stagingBuffer.unmap(device);
 
     constexpr LayoutData FINAL_LAYOUT{
@@ -6,7 +6,7 @@
 /*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2024/06/17 12:46:17 by etran             #+#    #+#             */
-/*   Updated: 2024/06/25 14:49:21 by etran            ###   ########.fr       */
+/*   Updated: 2024/07/08 10:41:17 by etran            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -26,6 +26,10 @@ enum class TextureIndex: u32 {
     GBufferAlbedo,
     GBufferDepth,
 
+#if ENABLE_GPU_CULLING
+    HiZ,
+#endif
+
 #if ENABLE_CUBEMAP
     SkyCubemap,
 #endif
@@ -6,7 +6,7 @@
 /*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2024/06/20 13:21:04 by etran             #+#    #+#             */
-/*   Updated: 2024/06/25 14:50:11 by etran            ###   ########.fr       */
+/*   Updated: 2024/07/08 10:41:17 by etran            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -25,6 +25,10 @@
 #include "skybox_texture.h"
 #endif
 
+#if ENABLE_GPU_CULLING
+#include "hiz_texture.h"
+#endif
+
 #include "debug.h"
 
 namespace vox::gfx {
@@ -57,6 +61,9 @@ void TextureTable::init(const Device& device, const ICommandBuffer* cmdBuffer) {
 #if ENABLE_SHADOW_MAPPING
     ms_textures[(u32)TextureIndex::ShadowMap] = new ShadowmapSampler();
 #endif
+#if ENABLE_GPU_CULLING
+    ms_textures[(u32)TextureIndex::HiZ] = new HiZTexture();
+#endif
 
     for (auto texture: ms_textures) texture->init(device);
 
@@ -65,6 +72,9 @@ void TextureTable::init(const Device& device, const ICommandBuffer* cmdBuffer) {
 #if ENABLE_CUBEMAP
     ms_textures[(u32)TextureIndex::Skybox]->fill(device, cmdBuffer);
 #endif
+#if ENABLE_GPU_CULLING
+    ms_textures[(u32)TextureIndex::HiZ]->fill(device, cmdBuffer);
+#endif
 
     LDEBUG("Texture table: created textures");
 }
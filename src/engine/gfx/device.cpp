@@ -6,7 +6,7 @@
 /*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2024/02/21 23:37:02 by etran             #+#    #+#             */
-/*   Updated: 2024/06/14 01:46:08 by etran            ###   ########.fr       */
+/*   Updated: 2024/07/08 10:41:17 by etran            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -15,6 +15,7 @@
 #include "types.h"
 #include "buffer_decl.h"
 #include "swap_chain.h"
+#include "vox_decl.h"
 
 #include <set>
 #include <array>
@@ -220,6 +221,14 @@ bool _hasExpectedFeatures(const VkPhysicalDevice physDevice) {
     VkPhysicalDeviceFeatures supportedFeatures;
     vkGetPhysicalDeviceFeatures(physDevice, &supportedFeatures);
 
+#if ENABLE_GPU_CULLING
+    // One indirect draw per chunk face, storage image per Hi-Z level
+    if (!supportedFeatures.multiDrawIndirect ||
+        !supportedFeatures.drawIndirectFirstInstance ||
+        !supportedFeatures.shaderStorageImageArrayDynamicIndexing)
+        return false;
+#endif
+
     return supportedFeatures.samplerAnisotropy;
 }
 
@@ -327,6 +336,11 @@ void Device::_createLogicalDevice() {
 
     VkPhysicalDeviceFeatures    deviceFeatures{};
     deviceFeatures.samplerAnisotropy = VK_TRUE;
+#if ENABLE_GPU_CULLING
+    deviceFeatures.multiDrawIndirect = VK_TRUE;
+    deviceFeatures.drawIndirectFirstInstance = VK_TRUE;
+    deviceFeatures.shaderStorageImageArrayDynamicIndexing = VK_TRUE;
+#endif
 
     VkDeviceCreateInfo  deviceInfo{};
     deviceInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
@@ -6,7 +6,7 @@
 /*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2024/02/23 09:29:35 by etran             #+#    #+#             */
-/*   Updated: 2024/06/25 14:45:38 by etran            ###   ########.fr       */
+/*   Updated: 2024/07/08 10:41:17 by etran            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -19,6 +19,7 @@
 #include "push_constant.h"
 #include "game_state.h"
 #include "texture.h"
+#include "frame_arena.h"
 
 #include "main_render_pass.h"
 #include "shadow_render_pass.h"
@@ -34,6 +35,8 @@
 #include "debug_tex_pipeline.h"
 #include "ssao_pipeline.h"
 #include "ssao_blur_pipeline.h"
+#include "hiz_pipeline.h"
+#include "cull_pipeline.h"
 
 #include "debug.h"
 
@@ -44,6 +47,7 @@ namespace vox::gfx {
 /* ========================================================================== */
 
 void Renderer::init(ui::Window& window, const game::GameState& game) {
+    mem::FrameArena::init(FRAME_ARENA_SIZE);
     m_core.init(window);
     m_device.init(m_core);
     m_swapChain.init(m_core, m_device, window);
@@ -57,6 +61,13 @@ void Renderer::init(ui::Window& window, const game::GameState& game) {
 
     _createRenderPasses();
 
+    // Owns the culling buffers the descriptor sets point to
+#if ENABLE_FRUSTUM_CULLING
+    VertexBuffer::init(m_device, game);
+#else
+    VertexBuffer::init(m_device, transferBuffer, game);
+#endif
+
     m_descriptorPool.init(m_device, m_descriptorTable);
     m_descriptorTable.fill(m_device);
 
@@ -66,12 +77,6 @@ void Renderer::init(ui::Window& window, const game::GameState& game) {
     _createFences();
     _createGfxSemaphores();
 
-#if ENABLE_FRUSTUM_CULLING
-    VertexBuffer::init(m_device, game);
-#else
-    VertexBuffer::init(m_device, transferBuffer, game);
-#endif
-
     LDEBUG("Renderer initialized.");
 }
 
@@ -93,6 +98,7 @@ void Renderer::destroy() {
     m_swapChain.destroy(m_device);
     m_device.destroy();
     m_core.destroy();
+    mem::FrameArena::destroy();
 
     LDEBUG("Renderer destroyed.");
 }
@@ -103,14 +109,20 @@ void Renderer::waitIdle() const {
     m_device.idle();
 }
 
-void Renderer::render(const game::GameState& game) {
+void Renderer::render(game::GameState& game) {
     // Prepare frame resources ---------
     m_fences[(u32)FenceIndex::DrawInFlight].await(m_device);
+    mem::FrameArena::nextFrame();
     m_pushConstants[(u32)PushConstantIndex::Camera]->update(game);
+#if ENABLE_GPU_CULLING
+    m_pushConstants[(u32)PushConstantIndex::Cull]->update(game);
+#endif
     m_descriptorTable.update(game);
+    VertexBuffer::updateChunks(m_device, m_commandBuffers[(u32)CommandBufferIndex::Transfer], game);
 #if ENABLE_FRUSTUM_CULLING
     VertexBuffer::update(m_device, game);
 #endif
+    VertexBuffer::updateDrawRanges(game);
     if (m_swapChain.acquireNextImage(m_device, m_semaphores[(u32)SemaphoreIndex::ImageAvailable]) == false)
         // TODO: Handle this error
         return;
@@ -133,12 +145,33 @@ void Renderer::render(const game::GameState& game) {
     m_renderPasses[(u32)RenderPassIndex::Shadow]->end(offscreenBuffer);
 #endif
 
+#if ENABLE_GPU_CULLING
+    // Early culling: chunks visible last frame
+    m_pushConstants[(u32)PushConstantIndex::Cull]->bind(offscreenBuffer, m_pipelineLayouts[(u32)PipelineLayoutIndex::Cull]);
+    m_pipelines[(u32)PipelineIndex::CullEarly]->record(offscreenBuffer);
+#endif
+
     // Deferred pass
     cameraConstant->bind(offscreenBuffer, m_pipelineLayouts[(u32)PipelineLayoutIndex::Deferred]);
     m_renderPasses[(u32)RenderPassIndex::Deferred]->begin(offscreenBuffer, recordInfo);
     m_pipelines[(u32)PipelineIndex::Deferred]->record(offscreenBuffer);
     m_renderPasses[(u32)RenderPassIndex::Deferred]->end(offscreenBuffer);
 
+#if ENABLE_GPU_CULLING
+    // Hi-Z pyramid of the early draws
+    m_pushConstants[(u32)PushConstantIndex::HiZ]->bind(offscreenBuffer, m_pipelineLayouts[(u32)PipelineLayoutIndex::HiZ]);
+    m_pipelines[(u32)PipelineIndex::HiZ]->record(offscreenBuffer);
+
+    // Late culling: chunks the early draws do not hide, drawn over them
+    m_pushConstants[(u32)PushConstantIndex::Cull]->bind(offscreenBuffer, m_pipelineLayouts[(u32)PipelineLayoutIndex::Cull]);
+    m_pipelines[(u32)PipelineIndex::CullLate]->record(offscreenBuffer);
+
+    cameraConstant->bind(offscreenBuffer, m_pipelineLayouts[(u32)PipelineLayoutIndex::Deferred]);
+    m_renderPasses[(u32)RenderPassIndex::DeferredLate]->begin(offscreenBuffer, recordInfo);
+    m_pipelines[(u32)PipelineIndex::DeferredLate]->record(offscreenBuffer);
+    m_renderPasses[(u32)RenderPassIndex::DeferredLate]->end(offscreenBuffer);
+#endif
+
 #if ENABLE_SSAO
     // Ssao pass
     cameraConstant->bind(offscreenBuffer, m_pipelineLayouts[(u32)PipelineLayoutIndex::Ssao]);
@@ -181,15 +214,15 @@ void Renderer::render(const game::GameState& game) {
 
     // Submit command buffer ---------
     { // Offscreen buffer
-        static const std::vector<VkPipelineStageFlags>  waitStages = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
-        static const std::vector<VkSemaphore>           waitSemaphores = { m_semaphores[(u32)SemaphoreIndex::ImageAvailable].getSemaphore() };
-        static const std::vector<VkSemaphore>           signalSemaphores = { m_semaphores[(u32)SemaphoreIndex::OffscreenFinished].getSemaphore() };
+        const std::array<VkPipelineStageFlags, 1>   waitStages = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
+        const std::array<VkSemaphore, 1>            waitSemaphores = { m_semaphores[(u32)SemaphoreIndex::ImageAvailable].getSemaphore() };
+        const std::array<VkSemaphore, 1>            signalSemaphores = { m_semaphores[(u32)SemaphoreIndex::OffscreenFinished].getSemaphore() };
         offscreenBuffer->submitRecording(waitSemaphores, waitStages, signalSemaphores);
     }
     { // Draw buffer
-        static const std::vector<VkPipelineStageFlags>  waitStages = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
-        static const std::vector<VkSemaphore>           waitSemaphores = { m_semaphores[(u32)SemaphoreIndex::OffscreenFinished].getSemaphore() };
-        static const std::vector<VkSemaphore>           signalSemaphores = { m_semaphores[(u32)SemaphoreIndex::RenderFinished].getSemaphore() };
+        const std::array<VkPipelineStageFlags, 1>   waitStages = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
+        const std::array<VkSemaphore, 1>            waitSemaphores = { m_semaphores[(u32)SemaphoreIndex::OffscreenFinished].getSemaphore() };
+        const std::array<VkSemaphore, 1>            signalSemaphores = { m_semaphores[(u32)SemaphoreIndex::RenderFinished].getSemaphore() };
         drawBuffer->submitRecording(waitSemaphores, waitStages, signalSemaphores, m_fences[(u32)FenceIndex::DrawInFlight].getFence());
     }
     // --------------------------------
@@ -257,6 +290,14 @@ void Renderer::_createRenderPasses() {
         deferredPassInfo.m_targetWidth = SwapChain::getImageExtent().width;
         deferredPassInfo.m_targetHeight = SwapChain::getImageExtent().height;
         m_renderPasses[(u32)RenderPassIndex::Deferred]->init(m_device, &deferredPassInfo);
+
+#if ENABLE_GPU_CULLING
+        // Late draws, over the early ones
+        m_renderPasses[(u32)RenderPassIndex::DeferredLate] = new DeferredRenderPass();
+
+        deferredPassInfo.m_loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+        m_renderPasses[(u32)RenderPassIndex::DeferredLate]->init(m_device, &deferredPassInfo);
+#endif
     }
 
 #if ENABLE_SSAO
@@ -316,6 +357,10 @@ void Renderer::_createPushConstants() {
     m_pushConstants.reserve(PUSH_CONSTANT_COUNT);
 
     m_pushConstants[(u32)PushConstantIndex::Camera] = new CameraPushConstant();
+#if ENABLE_GPU_CULLING
+    m_pushConstants[(u32)PushConstantIndex::HiZ] = new HiZPushConstant();
+    m_pushConstants[(u32)PushConstantIndex::Cull] = new CullPushConstant();
+#endif
 }
 
 void Renderer::_createPipelineLayouts() {
@@ -353,6 +398,17 @@ void Renderer::_createPipelineLayouts() {
     }
 #endif
 
+#if ENABLE_GPU_CULLING
+    { // Hi-Z
+        sets = { m_descriptorTable[DescriptorSetIndex::HiZ] };
+        m_pipelineLayouts[(u32)PipelineLayoutIndex::HiZ].init(m_device, sets, m_pushConstants[(u32)PushConstantIndex::HiZ]);
+    }
+    { // Cull
+        sets = { m_descriptorTable[DescriptorSetIndex::Cull] };
+        m_pipelineLayouts[(u32)PipelineLayoutIndex::Cull].init(m_device, sets, m_pushConstants[(u32)PushConstantIndex::Cull]);
+    }
+#endif
+
 #if ENABLE_SHADOW_MAPPING
     { // Sky
         sets = { m_descriptorTable[DescriptorSetIndex::Pfd] };
@@ -383,6 +439,21 @@ void Renderer::_createPipelines() {
     m_pipelines[(u32)PipelineIndex::Deferred] = new DeferredPipeline();
     m_pipelines[(u32)PipelineIndex::Deferred]->init(m_device, deferredRenderpass, m_pipelineLayouts[(u32)PipelineLayoutIndex::Deferred]);
 
+#if ENABLE_GPU_CULLING
+    const VkRenderPass deferredLateRenderpass = m_renderPasses[(u32)RenderPassIndex::DeferredLate]->getRenderPass();
+
+    m_pipelines[(u32)PipelineIndex::DeferredLate] = new DeferredPipeline(CullPhase::Late);
+    m_pipelines[(u32)PipelineIndex::DeferredLate]->init(m_device, deferredLateRenderpass, m_pipelineLayouts[(u32)PipelineLayoutIndex::Deferred]);
+
+    // Compute pipelines, outside of any render pass
+    m_pipelines[(u32)PipelineIndex::HiZ] = new HiZPipeline();
+    m_pipelines[(u32)PipelineIndex::HiZ]->init(m_device, VK_NULL_HANDLE, m_pipelineLayouts[(u32)PipelineLayoutIndex::HiZ]);
+    m_pipelines[(u32)PipelineIndex::CullEarly] = new CullPipeline(CullPhase::Early);
+    m_pipelines[(u32)PipelineIndex::CullEarly]->init(m_device, VK_NULL_HANDLE, m_pipelineLayouts[(u32)PipelineLayoutIndex::Cull]);
+    m_pipelines[(u32)PipelineIndex::CullLate] = new CullPipeline(CullPhase::Late);
+    m_pipelines[(u32)PipelineIndex::CullLate]->init(m_device, VK_NULL_HANDLE, m_pipelineLayouts[(u32)PipelineLayoutIndex::Cull]);
+#endif
+
 #if ENABLE_SSAO
     const VkRenderPass ssaoRenderPass = m_renderPasses[(u32)RenderPassIndex::Ssao]->getRenderPass();
 
@@ -6,7 +6,7 @@
 /*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2024/02/21 12:17:21 by etran             #+#    #+#             */
-/*   Updated: 2024/06/20 16:05:06 by etran            ###   ########.fr       */
+/*   Updated: 2024/07/07 15:32:40 by etran            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -64,7 +64,7 @@ public:
     void destroy();
 
     void waitIdle() const;
-    void render(const game::GameState& game);
+    void render(game::GameState& game);
 
 private:
     /* ====================================================================== */
@@ -84,7 +84,8 @@ private:
     /*                             STATIC MEMBERS                             */
     /* ====================================================================== */
 
-    static constexpr u32    CMD_BUFFER_COUNT = (u32)CommandBufferIndex::Count;
+    static constexpr u32            CMD_BUFFER_COUNT = (u32)CommandBufferIndex::Count;
+    static constexpr std::size_t    FRAME_ARENA_SIZE = 8 * 1024 * 1024; // Per frame in flight, grown on overflow
 
     /* ====================================================================== */
     /*                                  DATA                                  */
@@ -6,7 +6,7 @@
 /*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2024/05/30 19:14:49 by etran             #+#    #+#             */
-/*   Updated: 2024/05/31 18:33:02 by etran            ###   ########.fr       */
+/*   Updated: 2024/07/06 16:58:03 by etran            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -37,6 +37,11 @@ public:
 
     bool                isVisible(const BoundingFrustum& frustum) const;
 
+    math::Vect3         getCenter() const noexcept;
+    math::Vect3         getMin() const noexcept;
+    math::Vect3         getMax() const noexcept;
+    math::Vect3         getHalfExtent() const noexcept;
+
 private:
     /* ====================================================================== */
     /*                                  DATA                                  */
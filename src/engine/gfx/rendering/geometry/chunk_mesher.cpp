@@ -0,0 +1,19 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   chunk_mesher.cpp                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/06/29 11:16:40 by etran             #+#    #+#             */
+/*   Updated: 2024/07/07 11:02:19 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "chunk_mesher.h"
+
+namespace vox::gfx {
+
+template class BasicChunkMesher<game::Chunk>;
+
+} // namespace vox::gfx
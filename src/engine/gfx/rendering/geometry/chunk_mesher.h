@@ -0,0 +1,494 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   chunk_mesher.h                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/06/29 11:16:40 by etran             #+#    #+#             */
+/*   Updated: 2024/07/07 16:20:14 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#pragma once
+
+#include "types.h"
+#include "vox_decl.h"
+#include "game_decl.h"
+#include "chunk.h"
+#include "vertex.h"
+
+#include <array>
+#include <bit>
+#include <type_traits>
+
+namespace vox::gfx {
+
+/**
+ * @brief Bitwise chunk mesher.
+ *
+ * Each (x, z) column of a chunk is reduced to an occupancy mask (bit y set if
+ * the block is solid). Exposed faces of a whole column are then found with a
+ * few shifts and masks.
+ *
+ * Masks are built in a padded (SIZE + 2)^3 volume: the extra border
+ * (apron) is copied once from the six neighbors, so the face pass has no
+ * bound or neighbor check.
+ *
+ * Distant chunks can be meshed at a coarser level of detail: at `lod`, a cell
+ * of 2^lod blocks per side is solid if any of its blocks is. Coarse cells live
+ * in the first (SIZE >> lod) columns of the same volume.
+ *
+ * Templated on the chunk type so that other chunk dimensions can be meshed
+ * side by side; sizes come from `ChunkType::Layout` (cf. game::ChunkLayout).
+ * The chunk type provides getColumnMask(x, z), getBlock(x, y, z) and getId().
+ */
+template <typename ChunkType>
+class BasicChunkMesher final {
+public:
+    /* ====================================================================== */
+    /*                                TYPEDEFS                                */
+    /* ====================================================================== */
+
+    using Layout = typename ChunkType::Layout;
+    using ColumnMask = typename Layout::ColumnMask;
+    using PaddedMask = std::conditional_t<Layout::HEIGHT + 2 <= 32, u32, u64>;
+
+    static_assert(Layout::HEIGHT + 2 <= 64, "Padded columns must fit in a 64 bit mask.");
+    static_assert(Layout::BLOCK_BITS <= 16, "Block ids are packed in 16 bits.");
+
+    static constexpr u32    PADDED_SIZE = Layout::SIZE + 2;
+    static constexpr u32    PADDED_AREA = PADDED_SIZE * PADDED_SIZE;
+
+    using PaddedVolume = std::array<PaddedMask, PADDED_AREA>;
+
+    enum Neighbor: u32 {
+        Left = 0,
+        Right,
+        Front,
+        Back,
+        Top,
+        Bottom,
+
+        Count
+    };
+
+    using Neighbors = std::array<const ChunkType*, Neighbor::Count>;
+
+    /**
+     * @brief Exposed faces, per face (indexed by game::BlockFace) and per
+     * column (z * SIZE + x).
+     */
+    struct FaceMasks {
+        std::array<std::array<ColumnMask, Layout::AREA>, 6> m_faces;
+#if ENABLE_BAKED_AO
+        PaddedVolume    m_solid; // Kept for the occlusion of each face vertex
+#endif
+    };
+
+    /* ====================================================================== */
+    /*                                 METHODS                                */
+    /* ====================================================================== */
+
+    BasicChunkMesher() = delete;
+
+    /* ====================================================================== */
+
+    static void computeFaceMasks(const ChunkType& chunk, const Neighbors& neighbors, const u32 lod, FaceMasks& masks) noexcept;
+    static u32  countFaces(const FaceMasks& masks, const u32 lod) noexcept;
+
+    template <typename InstanceVector>
+    static void emitFaces(const ChunkType& chunk, const FaceMasks& masks, const game::BlockFace face, const u32 lod, InstanceVector& instances);
+
+private:
+    /* ====================================================================== */
+    /*                                 METHODS                                */
+    /* ====================================================================== */
+
+    static void         _fillApron(const ChunkType& chunk, const Neighbors& neighbors, PaddedVolume& solid) noexcept;
+    static void         _fillCoarseApron(const ChunkType& chunk, const Neighbors& neighbors, const u32 lod, PaddedVolume& solid) noexcept;
+    static PaddedMask   _getColumnMask(const ChunkType& chunk, const u32 x, const u32 z) noexcept;
+    static bool         _isLayerSolid(const ChunkType& chunk, const u32 y, const u32 x, const u32 z, const u32 size) noexcept;
+    static u8           _computeOcclusion(const PaddedVolume& solid, const game::BlockFace face, const u32 x, const u32 y, const u32 z) noexcept;
+
+    static const game::Block&   _getCellBlock(const ChunkType& chunk, const u32 x, const u32 y, const u32 z, const u32 lod) noexcept;
+
+}; // class BasicChunkMesher
+
+/* ========================================================================== */
+/*                                  TEMPLATES                                 */
+/* ========================================================================== */
+
+/**
+ * @brief Appends one instance per exposed face looking towards `face`.
+ * Coarse instances are placed on their cell origin and carry their level,
+ * the vertex shader scales them by 2^lod.
+ */
+template <typename ChunkType>
+template <typename InstanceVector>
+void BasicChunkMesher<ChunkType>::emitFaces(
+    const ChunkType& chunk,
+    const FaceMasks& masks,
+    const game::BlockFace face,
+    const u32 lod,
+    InstanceVector& instances
+) {
+    const u16 chunkId = chunk.getId();
+    const u32 size = Layout::SIZE >> lod;
+    const auto& faceMasks = masks.m_faces[(u8)face];
+
+    for (u32 z = 0; z < size; ++z) {
+        for (u32 x = 0; x < size; ++x) {
+            ColumnMask exposed = faceMasks[z * Layout::SIZE + x];
+
+            while (exposed != 0) {
+                const u32 y = std::countr_zero(exposed);
+                exposed &= exposed - 1;
+
+                const u16 blockId = Layout::packBlock(x << lod, y << lod, z << lod);
+                const u8  textureId = _getCellBlock(chunk, x, y, z, lod).getTextureId(face);
+#if ENABLE_BAKED_AO
+                instances.emplace_back(face, textureId, blockId, chunkId, lod, _computeOcclusion(masks.m_solid, face, x, y, z));
+#else
+                instances.emplace_back(face, textureId, blockId, chunkId, lod);
+#endif
+            }
+        }
+    }
+}
+
+/* ========================================================================== */
+
+/**
+ * @brief Finds every exposed face of the chunk at the given level of detail.
+ * Missing neighbors count as air.
+ */
+template <typename ChunkType>
+void BasicChunkMesher<ChunkType>::computeFaceMasks(
+    const ChunkType& chunk,
+    const Neighbors& neighbors,
+    const u32 lod,
+    FaceMasks& masks
+) noexcept {
+    using game::BlockFace;
+    const u32           size = Layout::SIZE >> lod;
+    const PaddedMask    chunkBits = (((PaddedMask)1 << (Layout::HEIGHT >> lod)) - 1) << 1;
+
+    PaddedVolume solid{};
+    if (lod == 0)
+        _fillApron(chunk, neighbors, solid);
+    else
+        _fillCoarseApron(chunk, neighbors, lod, solid);
+
+    for (u32 z = 0; z < size; ++z) {
+        for (u32 x = 0; x < size; ++x) {
+            const u32           column = z * Layout::SIZE + x;
+            const u32           padded = (z + 1) * PADDED_SIZE + (x + 1);
+            const PaddedMask    blocks = solid[padded] & chunkBits;
+
+            // Back to chunk space: padded bit y + 1 is block y
+            masks.m_faces[(u8)BlockFace::Top][column] = (blocks & ~(solid[padded] >> 1)) >> 1;
+            masks.m_faces[(u8)BlockFace::Bottom][column] = (blocks & ~(solid[padded] << 1)) >> 1;
+            masks.m_faces[(u8)BlockFace::Right][column] = (blocks & ~solid[padded + 1]) >> 1;
+            masks.m_faces[(u8)BlockFace::Left][column] = (blocks & ~solid[padded - 1]) >> 1;
+            masks.m_faces[(u8)BlockFace::Front][column] = (blocks & ~solid[padded + PADDED_SIZE]) >> 1;
+            masks.m_faces[(u8)BlockFace::Back][column] = (blocks & ~solid[padded - PADDED_SIZE]) >> 1;
+        }
+    }
+
+#if ENABLE_BAKED_AO
+    masks.m_solid = solid;
+#endif
+}
+
+template <typename ChunkType>
+u32 BasicChunkMesher<ChunkType>::countFaces(const FaceMasks& masks, const u32 lod) noexcept {
+    const u32 size = Layout::SIZE >> lod;
+
+    u32 count = 0;
+    for (const auto& face: masks.m_faces) {
+        for (u32 z = 0; z < size; ++z) {
+            for (u32 x = 0; x < size; ++x)
+                count += std::popcount(face[z * Layout::SIZE + x]);
+        }
+    }
+    return count;
+}
+
+/* ========================================================================== */
+
+/**
+ * @brief Builds the padded occupancy volume: the chunk in the middle, the
+ * facing layer of each neighbor around it. Apron corners stay empty, faces
+ * never look diagonally.
+ */
+template <typename ChunkType>
+void BasicChunkMesher<ChunkType>::_fillApron(
+    const ChunkType& chunk,
+    const Neighbors& neighbors,
+    PaddedVolume& solid
+) noexcept {
+    constexpr u32 UPPER_LIMIT = Layout::SIZE - 1;
+    constexpr u32 LAST_PADDED = PADDED_SIZE - 1;
+
+    for (u32 z = 0; z < Layout::SIZE; ++z) {
+        for (u32 x = 0; x < Layout::SIZE; ++x)
+            solid[(z + 1) * PADDED_SIZE + (x + 1)] = _getColumnMask(chunk, x, z) << 1;
+    }
+
+    for (u32 i = 0; i < Layout::SIZE; ++i) {
+        if (neighbors[Neighbor::Left])
+            solid[(i + 1) * PADDED_SIZE] = _getColumnMask(*neighbors[Neighbor::Left], UPPER_LIMIT, i) << 1;
+        if (neighbors[Neighbor::Right])
+            solid[(i + 1) * PADDED_SIZE + LAST_PADDED] = _getColumnMask(*neighbors[Neighbor::Right], 0, i) << 1;
+        if (neighbors[Neighbor::Back])
+            solid[i + 1] = _getColumnMask(*neighbors[Neighbor::Back], i, UPPER_LIMIT) << 1;
+        if (neighbors[Neighbor::Front])
+            solid[LAST_PADDED * PADDED_SIZE + (i + 1)] = _getColumnMask(*neighbors[Neighbor::Front], i, 0) << 1;
+    }
+
+    for (u32 z = 0; z < Layout::SIZE; ++z) {
+        for (u32 x = 0; x < Layout::SIZE; ++x) {
+            PaddedMask& column = solid[(z + 1) * PADDED_SIZE + (x + 1)];
+
+            if (neighbors[Neighbor::Bottom] && !neighbors[Neighbor::Bottom]->getBlock(x, Layout::HEIGHT - 1, z).isVoid())
+                column |= 1;
+            if (neighbors[Neighbor::Top] && !neighbors[Neighbor::Top]->getBlock(x, 0, z).isVoid())
+                column |= (PaddedMask)1 << (Layout::HEIGHT + 1);
+        }
+    }
+}
+
+/**
+ * @brief Coarse counterpart of _fillApron.
+ *
+ * Neighbors may be drawn at any level of detail, so an apron cell only hides
+ * a face when the facing layer of the neighbor is fully solid: every level
+ * covers that layer, and no crack opens along a LOD seam.
+ */
+template <typename ChunkType>
+void BasicChunkMesher<ChunkType>::_fillCoarseApron(
+    const ChunkType& chunk,
+    const Neighbors& neighbors,
+    const u32 lod,
+    PaddedVolume& solid
+) noexcept {
+    constexpr u32 UPPER_LIMIT = Layout::SIZE - 1;
+
+    const u32           cell = 1U << lod;
+    const u32           size = Layout::SIZE >> lod;
+    const u32           height = Layout::HEIGHT >> lod;
+    const u32           lastPadded = size + 1;
+    const PaddedMask    cellBits = ((PaddedMask)1 << cell) - 1;
+
+    std::array<PaddedMask, Layout::AREA> columns;
+    for (u32 z = 0; z < Layout::SIZE; ++z) {
+        for (u32 x = 0; x < Layout::SIZE; ++x)
+            columns[z * Layout::SIZE + x] = _getColumnMask(chunk, x, z);
+    }
+
+    // Chunk cells: solid if any of their blocks is
+    for (u32 z = 0; z < size; ++z) {
+        for (u32 x = 0; x < size; ++x) {
+            PaddedMask blocks = 0;
+            for (u32 dz = 0; dz < cell; ++dz) {
+                for (u32 dx = 0; dx < cell; ++dx)
+                    blocks |= columns[((z << lod) + dz) * Layout::SIZE + (x << lod) + dx];
+            }
+
+            PaddedMask& column = solid[(z + 1) * PADDED_SIZE + (x + 1)];
+            for (u32 y = 0; y < height; ++y) {
+                if ((blocks >> (y << lod)) & cellBits)
+                    column |= (PaddedMask)1 << (y + 1);
+            }
+        }
+    }
+
+    // Side aprons: solid if every facing block is
+    const auto toCells = [&](const PaddedMask blocks) {
+        PaddedMask cells = 0;
+        for (u32 y = 0; y < height; ++y) {
+            if (((blocks >> (y << lod)) & cellBits) == cellBits)
+                cells |= (PaddedMask)1 << (y + 1);
+        }
+        return cells;
+    };
+
+    for (u32 i = 0; i < size; ++i) {
+        PaddedMask left = ~(PaddedMask)0;
+        PaddedMask right = ~(PaddedMask)0;
+        PaddedMask back = ~(PaddedMask)0;
+        PaddedMask front = ~(PaddedMask)0;
+
+        for (u32 d = 0; d < cell; ++d) {
+            const u32 j = (i << lod) + d;
+
+            if (neighbors[Neighbor::Left])
+                left &= _getColumnMask(*neighbors[Neighbor::Left], UPPER_LIMIT, j);
+            if (neighbors[Neighbor::Right])
+                right &= _getColumnMask(*neighbors[Neighbor::Right], 0, j);
+            if (neighbors[Neighbor::Back])
+                back &= _getColumnMask(*neighbors[Neighbor::Back], j, UPPER_LIMIT);
+            if (neighbors[Neighbor::Front])
+                front &= _getColumnMask(*neighbors[Neighbor::Front], j, 0);
+        }
+
+        if (neighbors[Neighbor::Left])
+            solid[(i + 1) * PADDED_SIZE] = toCells(left);
+        if (neighbors[Neighbor::Right])
+            solid[(i + 1) * PADDED_SIZE + lastPadded] = toCells(right);
+        if (neighbors[Neighbor::Back])
+            solid[i + 1] = toCells(back);
+        if (neighbors[Neighbor::Front])
+            solid[lastPadded * PADDED_SIZE + (i + 1)] = toCells(front);
+    }
+
+    for (u32 z = 0; z < size; ++z) {
+        for (u32 x = 0; x < size; ++x) {
+            PaddedMask& column = solid[(z + 1) * PADDED_SIZE + (x + 1)];
+
+            if (neighbors[Neighbor::Bottom] && _isLayerSolid(*neighbors[Neighbor::Bottom], Layout::HEIGHT - 1, x << lod, z << lod, cell))
+                column |= 1;
+            if (neighbors[Neighbor::Top] && _isLayerSolid(*neighbors[Neighbor::Top], 0, x << lod, z << lod, cell))
+                column |= (PaddedMask)1 << (height + 1);
+        }
+    }
+}
+
+template <typename ChunkType>
+typename BasicChunkMesher<ChunkType>::PaddedMask BasicChunkMesher<ChunkType>::_getColumnMask(
+    const ChunkType& chunk,
+    const u32 x,
+    const u32 z
+) noexcept {
+    return chunk.getColumnMask(x, z);
+}
+
+/**
+ * @brief Whether the `size` x `size` square of blocks at height y is solid.
+ */
+template <typename ChunkType>
+bool BasicChunkMesher<ChunkType>::_isLayerSolid(
+    const ChunkType& chunk,
+    const u32 y,
+    const u32 x,
+    const u32 z,
+    const u32 size
+) noexcept {
+    for (u32 dz = 0; dz < size; ++dz) {
+        for (u32 dx = 0; dx < size; ++dx) {
+            if (chunk.getBlock(x + dx, y, z + dz).isVoid())
+                return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Block representing a cell: the highest solid one, so that coarse
+ * terrain keeps its surface textures.
+ */
+template <typename ChunkType>
+const game::Block& BasicChunkMesher<ChunkType>::_getCellBlock(
+    const ChunkType& chunk,
+    const u32 x,
+    const u32 y,
+    const u32 z,
+    const u32 lod
+) noexcept {
+    const u32 cell = 1U << lod;
+
+    for (u32 dy = cell; dy > 0; --dy) {
+        for (u32 dz = 0; dz < cell; ++dz) {
+            for (u32 dx = 0; dx < cell; ++dx) {
+                const game::Block& block = chunk.getBlock((x << lod) + dx, (y << lod) + dy - 1, (z << lod) + dz);
+                if (!block.isVoid())
+                    return block;
+            }
+        }
+    }
+    return chunk.getBlock(x << lod, y << lod, z << lod);
+}
+
+#if ENABLE_BAKED_AO
+/**
+ * @brief Occlusion of the 4 vertices of a face, 2 bits each in the vertex
+ * order of the shaders (0: fully occluded, 3: unoccluded).
+ *
+ * A vertex looks at the 3 cells touching it in the layer the face opens on:
+ * both sides and the diagonal. Two solid sides occlude it fully, whatever the
+ * diagonal. The apron holds no diagonal neighbor, so vertices on a chunk edge
+ * may come out slightly lighter.
+ */
+template <typename ChunkType>
+u8 BasicChunkMesher<ChunkType>::_computeOcclusion(
+    const PaddedVolume& solid,
+    const game::BlockFace face,
+    const u32 x,
+    const u32 y,
+    const u32 z
+) noexcept {
+    struct Offset { i32 x, y, z; };
+
+    // Unit cube corners of each face, same order as CUBE_FACE in the shaders
+    static constexpr Offset A{1, 0, 1}, B{1, 0, 0}, C{1, 1, 0}, D{1, 1, 1};
+    static constexpr Offset E{0, 0, 1}, F{0, 0, 0}, G{0, 1, 0}, H{0, 1, 1};
+    static constexpr std::array<std::array<Offset, 4>, 6> CORNERS = {{
+        {C, D, G, H}, // Top
+        {A, B, E, F}, // Bottom
+        {F, G, E, H}, // Left
+        {A, D, B, C}, // Right
+        {E, H, A, D}, // Front
+        {B, C, F, G}, // Back
+    }};
+    static constexpr std::array<Offset, 6> NORMALS = {{
+        { 0,  1,  0},
+        { 0, -1,  0},
+        {-1,  0,  0},
+        { 1,  0,  0},
+        { 0,  0,  1},
+        { 0,  0, -1},
+    }};
+
+    const Offset& normal = NORMALS[(u8)face];
+    const auto isSolid = [&](const i32 dx, const i32 dy, const i32 dz) -> u8 {
+        const u32 column = (z + 1 + dz + normal.z) * PADDED_SIZE + (x + 1 + dx + normal.x);
+        return (solid[column] >> (y + 1 + dy + normal.y)) & 1;
+    };
+
+    u8 occlusion = 0;
+    for (u32 vertex = 0; vertex < 4; ++vertex) {
+        const Offset& corner = CORNERS[(u8)face][vertex];
+
+        // Towards the corner along the face tangents, none along the normal
+        const i32 tx = normal.x ? 0 : corner.x * 2 - 1;
+        const i32 ty = normal.y ? 0 : corner.y * 2 - 1;
+        const i32 tz = normal.z ? 0 : corner.z * 2 - 1;
+
+        u8 side1, side2;
+        if (normal.x) {
+            side1 = isSolid(0, ty, 0);
+            side2 = isSolid(0, 0, tz);
+        } else if (normal.y) {
+            side1 = isSolid(tx, 0, 0);
+            side2 = isSolid(0, 0, tz);
+        } else {
+            side1 = isSolid(tx, 0, 0);
+            side2 = isSolid(0, ty, 0);
+        }
+        const u8 value = (side1 && side2) ? 0 : 3 - (side1 + side2 + isSolid(tx, ty, tz));
+
+        occlusion |= value << (2 * vertex);
+    }
+    return occlusion;
+}
+#endif
+
+/* ========================================================================== */
+
+// Instantiated once in chunk_mesher.cpp
+extern template class BasicChunkMesher<game::Chunk>;
+
+using ChunkMesher = BasicChunkMesher<game::Chunk>;
+
+} // namespace vox::gfx
@@ -0,0 +1,250 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   chunk_visibility.cpp                               :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/07/01 10:04:51 by etran             #+#    #+#             */
+/*   Updated: 2024/07/02 16:40:19 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "chunk_visibility.h"
+#include "chunk.h"
+
+#include <algorithm>
+#include <bit>
+#include <bitset>
+#include <cmath>
+
+namespace vox::gfx {
+
+/* ========================================================================== */
+/*                                   HELPERS                                  */
+/* ========================================================================== */
+
+enum Face: u32 {
+    Left = 0,
+    Right,
+    Front,
+    Back,
+    Top,
+    Bottom
+};
+
+static constexpr u32 ALL_FACES = (1U << ChunkVisibility::FACE_COUNT) - 1;
+
+static constexpr u32 _opposite(const u32 face) noexcept {
+    return face ^ 1;
+}
+
+static constexpr u32 _cellIndex(const u32 x, const u32 y, const u32 z) noexcept {
+    return (y * CHUNK_SIZE + z) * CHUNK_SIZE + x;
+}
+
+/* ========================================================================== */
+/*                                CONNECTIVITY                                */
+/* ========================================================================== */
+
+bool ChunkVisibility::Connectivity::connects(const u32 from, const u32 to) const noexcept {
+    return m_faces[from] & (1U << to);
+}
+
+/* ========================================================================== */
+/*                                   PUBLIC                                   */
+/* ========================================================================== */
+
+/**
+ * @brief Every chunk is reachable until the first update.
+ */
+void ChunkVisibility::init(const u32 width, const u32 height, const u32 depth) {
+    m_width = width;
+    m_height = height;
+    m_depth = depth;
+
+    const u32 count = width * height * depth;
+    m_chunks.assign(count, Connectivity{});
+    m_reachable.assign(count, 1);
+    m_queue.reserve(count);
+}
+
+void ChunkVisibility::build(const u32 index, const game::Chunk& chunk) noexcept {
+    m_chunks[index] = computeConnectivity(chunk);
+}
+
+/**
+ * @brief Walks from the camera chunk through open faces. From outside of the
+ * area, the walk starts from every chunk on the sides facing the camera.
+ */
+void ChunkVisibility::update(const math::Vect3& eye) {
+    std::fill(m_reachable.begin(), m_reachable.end(), 0);
+    m_queue.clear();
+
+    const i32 cameraX = (i32)std::floor(eye.x / CHUNK_SIZE);
+    const i32 cameraY = (i32)std::floor(eye.y / CHUNK_HEIGHT);
+    const i32 cameraZ = (i32)std::floor(eye.z / CHUNK_SIZE);
+
+    u8 outside = 0;
+    if (cameraX < 0) outside |= 1U << Face::Left;
+    if (cameraX >= (i32)m_width) outside |= 1U << Face::Right;
+    if (cameraZ >= (i32)m_depth) outside |= 1U << Face::Front;
+    if (cameraZ < 0) outside |= 1U << Face::Back;
+    if (cameraY >= (i32)m_height) outside |= 1U << Face::Top;
+    if (cameraY < 0) outside |= 1U << Face::Bottom;
+
+    if (outside == 0) {
+        _push(cameraX, cameraY, cameraZ, NO_FACE, 0);
+    } else {
+        // Seen from several sides, seeds may leave through any face
+        const bool  single = std::has_single_bit(outside);
+        u8          inwards = 0;
+        for (u32 face = 0; face < FACE_COUNT; ++face) {
+            if (outside & (1U << face))
+                inwards |= 1U << _opposite(face);
+        }
+
+        for (u32 z = 0; z < m_depth; ++z) {
+            for (u32 x = 0; x < m_width; ++x) {
+                for (u32 y = 0; y < m_height; ++y) {
+                    u8 sides = 0;
+                    if (x == 0) sides |= 1U << Face::Left;
+                    if (x + 1 == m_width) sides |= 1U << Face::Right;
+                    if (z + 1 == m_depth) sides |= 1U << Face::Front;
+                    if (z == 0) sides |= 1U << Face::Back;
+                    if (y + 1 == m_height) sides |= 1U << Face::Top;
+                    if (y == 0) sides |= 1U << Face::Bottom;
+
+                    if ((sides & outside) == 0)
+                        continue;
+                    _push(x, y, z, single ? (u8)std::countr_zero(outside) : NO_FACE, inwards);
+                }
+            }
+        }
+    }
+
+    for (std::size_t head = 0; head < m_queue.size(); ++head) {
+        const Step          step = m_queue[head];
+        const Connectivity& chunk = m_chunks[_getIndex(step.m_x, step.m_y, step.m_z)];
+
+        for (u32 face = 0; face < FACE_COUNT; ++face) {
+            // Never walk back towards the camera
+            if (step.m_directions & (1U << _opposite(face)))
+                continue;
+            if (step.m_entry != NO_FACE && !chunk.connects(step.m_entry, face))
+                continue;
+
+            u32 x = step.m_x;
+            u32 y = step.m_y;
+            u32 z = step.m_z;
+            switch ((Face)face) {
+                case Face::Left:    if (x == 0) continue; --x; break;
+                case Face::Right:   if (++x == m_width) continue; break;
+                case Face::Front:   if (++z == m_depth) continue; break;
+                case Face::Back:    if (z == 0) continue; --z; break;
+                case Face::Top:     if (++y == m_height) continue; break;
+                case Face::Bottom:  if (y == 0) continue; --y; break;
+            }
+            _push(x, y, z, _opposite(face), step.m_directions | (1U << face));
+        }
+    }
+}
+
+bool ChunkVisibility::isReachable(const u32 index) const noexcept {
+    return m_reachable[index];
+}
+
+/* ========================================================================== */
+
+/**
+ * @brief Flood fills each pocket of air, then connects every pair of faces a
+ * pocket touches.
+ */
+ChunkVisibility::Connectivity ChunkVisibility::computeConnectivity(const game::Chunk& chunk) noexcept {
+    constexpr u32 UPPER_LIMIT = CHUNK_SIZE - 1;
+    constexpr u32 TOP_LIMIT = CHUNK_HEIGHT - 1;
+
+    Connectivity                    connectivity{};
+    std::bitset<CHUNK_VOLUME>       visited;
+    std::array<u16, CHUNK_VOLUME>   stack;
+
+    for (u32 z = 0; z < CHUNK_SIZE; ++z) {
+        for (u32 x = 0; x < CHUNK_SIZE; ++x) {
+            for (u32 mask = chunk.getColumnMask(x, z); mask != 0; mask &= mask - 1)
+                visited.set(_cellIndex(x, std::countr_zero(mask), z));
+        }
+    }
+
+    // Open chunk: skip the fill
+    if (visited.none()) {
+        connectivity.m_faces.fill(ALL_FACES);
+        return connectivity;
+    }
+
+    for (u32 start = 0; start < CHUNK_VOLUME; ++start) {
+        if (visited.test(start))
+            continue;
+
+        u32 size = 0;
+        u8  faces = 0;
+        stack[size++] = start;
+        visited.set(start);
+
+        while (size > 0) {
+            const u32 cell = stack[--size];
+            const u32 x = cell % CHUNK_SIZE;
+            const u32 z = (cell / CHUNK_SIZE) % CHUNK_SIZE;
+            const u32 y = cell / CHUNK_AREA;
+
+            if (x == 0) faces |= 1U << Face::Left;
+            if (x == UPPER_LIMIT) faces |= 1U << Face::Right;
+            if (z == UPPER_LIMIT) faces |= 1U << Face::Front;
+            if (z == 0) faces |= 1U << Face::Back;
+            if (y == TOP_LIMIT) faces |= 1U << Face::Top;
+            if (y == 0) faces |= 1U << Face::Bottom;
+
+            const auto visit = [&](const u32 next) {
+                if (!visited.test(next)) {
+                    visited.set(next);
+                    stack[size++] = next;
+                }
+            };
+            if (x > 0) visit(cell - 1);
+            if (x < UPPER_LIMIT) visit(cell + 1);
+            if (z > 0) visit(cell - CHUNK_SIZE);
+            if (z < UPPER_LIMIT) visit(cell + CHUNK_SIZE);
+            if (y > 0) visit(cell - CHUNK_AREA);
+            if (y < TOP_LIMIT) visit(cell + CHUNK_AREA);
+        }
+
+        for (u32 face = 0; face < FACE_COUNT; ++face) {
+            if (faces & (1U << face))
+                connectivity.m_faces[face] |= faces;
+        }
+    }
+    return connectivity;
+}
+
+/* ========================================================================== */
+/*                                   PRIVATE                                  */
+/* ========================================================================== */
+
+u32 ChunkVisibility::_getIndex(const u32 x, const u32 y, const u32 z) const noexcept {
+    return (z * m_width + x) * m_height + y;
+}
+
+void ChunkVisibility::_push(
+    const u32 x,
+    const u32 y,
+    const u32 z,
+    const u8 entry,
+    const u8 directions
+) {
+    u8& reachable = m_reachable[_getIndex(x, y, z)];
+    if (reachable)
+        return;
+    reachable = 1;
+    m_queue.push_back({ x, y, z, entry, directions });
+}
+
+} // namespace vox::gfx
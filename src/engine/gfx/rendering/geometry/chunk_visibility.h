@@ -0,0 +1,116 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   chunk_visibility.h                                 :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/07/01 10:04:51 by etran             #+#    #+#             */
+/*   Updated: 2024/07/01 10:04:51 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#pragma once
+
+#include "types.h"
+#include "game_decl.h"
+#include "vector.h"
+
+#include <array>
+#include <vector>
+
+namespace game {
+class Chunk;
+}
+
+namespace vox::gfx {
+
+/**
+ * @brief Cave culling.
+ *
+ * For each chunk, a flood fill of its air cells records which of its six
+ * faces can see each other through open space. At render time, a breadth
+ * first walk from the camera chunk only enters chunks reachable through
+ * connected faces, never turning back against a direction already taken.
+ *
+ * Faces are indexed like ChunkMesher::Neighbor: left, right, front, back,
+ * top, bottom. Chunks are indexed in z/x/y order, like VertexBuffer.
+ */
+class ChunkVisibility final {
+public:
+    /* ====================================================================== */
+    /*                                TYPEDEFS                                */
+    /* ====================================================================== */
+
+    static constexpr u32    FACE_COUNT = 6;
+
+    /**
+     * @brief Bit `g` of m_faces[f] is set if face f sees face g.
+     */
+    struct Connectivity {
+        std::array<u8, FACE_COUNT>  m_faces{};
+
+        bool    connects(const u32 from, const u32 to) const noexcept;
+    };
+
+    /* ====================================================================== */
+    /*                                 METHODS                                */
+    /* ====================================================================== */
+
+    ChunkVisibility() = default;
+    ~ChunkVisibility() = default;
+
+    ChunkVisibility(ChunkVisibility&& other) = delete;
+    ChunkVisibility(const ChunkVisibility& other) = delete;
+    ChunkVisibility& operator=(ChunkVisibility&& other) = delete;
+    ChunkVisibility& operator=(const ChunkVisibility& other) = delete;
+
+    /* ====================================================================== */
+
+    void    init(const u32 width, const u32 height, const u32 depth);
+    void    build(const u32 index, const game::Chunk& chunk) noexcept;
+    void    update(const math::Vect3& eye);
+
+    bool    isReachable(const u32 index) const noexcept;
+
+    /* ====================================================================== */
+
+    static Connectivity computeConnectivity(const game::Chunk& chunk) noexcept;
+
+private:
+    /* ====================================================================== */
+    /*                                TYPEDEFS                                */
+    /* ====================================================================== */
+
+    static constexpr u8     NO_FACE = 0xFF;
+
+    struct Step {
+        u32 m_x;
+        u32 m_y;
+        u32 m_z;
+        u8  m_entry;        // Face the walk came in through
+        u8  m_directions;   // Faces the walk already went out through
+    };
+
+    /* ====================================================================== */
+    /*                                  DATA                                  */
+    /* ====================================================================== */
+
+    u32 m_width = 0;
+    u32 m_height = 0;
+    u32 m_depth = 0;
+
+    std::vector<Connectivity>   m_chunks;
+    std::vector<u8>             m_reachable;
+    std::vector<Step>           m_queue;
+
+    /* ====================================================================== */
+    /*                                 METHODS                                */
+    /* ====================================================================== */
+
+    u32     _getIndex(const u32 x, const u32 y, const u32 z) const noexcept;
+    void    _push(const u32 x, const u32 y, const u32 z, const u8 entry, const u8 directions);
+
+}; // class ChunkVisibility
+
+} // namespace vox::gfx
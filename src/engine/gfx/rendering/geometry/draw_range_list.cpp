@@ -0,0 +1,47 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   draw_range_list.cpp                                :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/07/08 00:04:17 by etran             #+#    #+#             */
+/*   Updated: 2024/07/08 00:04:17 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "draw_range_list.h"
+
+namespace vox::gfx {
+
+/* ========================================================================== */
+/*                                   PUBLIC                                   */
+/* ========================================================================== */
+
+void DrawRangeList::init(const u32 maxRanges) {
+    m_ranges.clear();
+    m_ranges.reserve(maxRanges);
+}
+
+void DrawRangeList::clear() noexcept {
+    m_ranges.clear();
+}
+
+void DrawRangeList::push(const u32 first, const u32 count, const u32 lod) {
+    if (!m_ranges.empty()) {
+        DrawRange& last = m_ranges.back();
+        if (last.m_lod == lod && last.m_firstInstance + last.m_instanceCount == first) {
+            last.m_instanceCount += count;
+            return;
+        }
+    }
+    m_ranges.push_back({ first, count, lod });
+}
+
+/* ========================================================================== */
+
+const std::vector<DrawRange>& DrawRangeList::getRanges() const noexcept {
+    return m_ranges;
+}
+
+} // namespace vox::gfx
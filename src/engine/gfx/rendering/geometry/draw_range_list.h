@@ -0,0 +1,68 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   draw_range_list.h                                  :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/07/08 00:04:17 by etran             #+#    #+#             */
+/*   Updated: 2024/07/08 00:04:17 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#pragma once
+
+#include "types.h"
+
+#include <vector>
+
+namespace vox::gfx {
+
+struct DrawRange {
+    u32 m_firstInstance = 0;
+    u32 m_instanceCount = 0;
+    u32 m_lod = 0;
+};
+
+/**
+ * @brief Instance ranges drawn this frame, rebuilt every frame.
+ *
+ * A range pushed right after the last one, at the same level, extends it
+ * instead: contiguous buckets make a single draw. Room for `maxRanges`
+ * unmerged ranges is reserved once, so rebuilding stays off the heap.
+ */
+class DrawRangeList final {
+public:
+    /* ====================================================================== */
+    /*                                 METHODS                                */
+    /* ====================================================================== */
+
+    DrawRangeList() = default;
+    ~DrawRangeList() = default;
+
+    DrawRangeList(DrawRangeList&& other) = delete;
+    DrawRangeList(const DrawRangeList& other) = delete;
+    DrawRangeList& operator=(DrawRangeList&& other) = delete;
+    DrawRangeList& operator=(const DrawRangeList& other) = delete;
+
+    /* ====================================================================== */
+
+    void    init(const u32 maxRanges);
+
+    void    clear() noexcept;
+    void    push(const u32 first, const u32 count, const u32 lod);
+
+    /* ====================================================================== */
+
+    const std::vector<DrawRange>&   getRanges() const noexcept;
+
+private:
+    /* ====================================================================== */
+    /*                                  DATA                                  */
+    /* ====================================================================== */
+
+    std::vector<DrawRange>  m_ranges;
+
+}; // class DrawRangeList
+
+} // namespace vox::gfx
@@ -6,13 +6,14 @@
 /*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2024/05/31 15:07:11 by etran             #+#    #+#             */
-/*   Updated: 2024/05/31 18:32:53 by etran            ###   ########.fr       */
+/*   Updated: 2024/07/06 16:58:03 by etran            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #include "bounding_box.h"
 #include "bounding_frustum.h"
 #include "maths.h"
+#include "batch.h"
 #include "controller.h"
 
 namespace vox::gfx {
@@ -64,14 +65,27 @@ bool BoundingBox::isVisible(const BoundingFrustum& frustum) const {
     return true;
 }
 
-bool BoundingBox::_isInsidePlane(const math::Vect4& plane) const {
-    // Length of diag projected on plane normal
-    const float extent = math::dot(m_halfExtent, abs(plane.xyz));
-    const float signedDistance = math::dot(m_center, plane.xyz) - plane.w;
+math::Vect3 BoundingBox::getCenter() const noexcept {
+    return m_center;
+}
 
-    if (signedDistance + extent < 0.0f)
-        return false;
-    return true;
+math::Vect3 BoundingBox::getMin() const noexcept {
+    return m_center - m_halfExtent;
+}
+
+math::Vect3 BoundingBox::getMax() const noexcept {
+    return m_center + m_halfExtent;
+}
+
+math::Vect3 BoundingBox::getHalfExtent() const noexcept {
+    return m_halfExtent;
+}
+
+/* ========================================================================== */
+
+bool BoundingBox::_isInsidePlane(const math::Vect4& plane) const {
+    // Distance of the corner farthest along the plane normal
+    return math::planeDistance(plane, m_center, m_halfExtent) >= 0.0f;
 }
 
 } // namespace vox::gfx
\ No newline at end of file
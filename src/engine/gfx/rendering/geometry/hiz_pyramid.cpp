@@ -0,0 +1,257 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   hiz_pyramid.cpp                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/07/02 10:12:44 by etran             #+#    #+#             */
+/*   Updated: 2024/07/08 10:41:17 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "hiz_pyramid.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <stdexcept>
+
+namespace vox::gfx {
+
+/* ========================================================================== */
+/*                                   PUBLIC                                   */
+/* ========================================================================== */
+
+void HiZPyramid::init(const u32 width, const u32 height) {
+    if (width == 0 || height == 0)
+        throw std::runtime_error("hi-z pyramid size cannot be null");
+
+    m_levels.clear();
+
+    u32 offset = 0;
+    for (u32 w = width, h = height;; w = std::max(w / 2, 1u), h = std::max(h / 2, 1u)) {
+        m_levels.push_back({ offset, w, h });
+        offset += w * h;
+        if (w == 1 && h == 1)
+            break;
+    }
+    m_depth.assign(offset, 0.0f);
+}
+
+/**
+ * @brief Copies the depth image in the first level and reduces it down to a
+ * single texel.
+ */
+void HiZPyramid::build(const f32* depth) noexcept {
+    std::copy_n(depth, m_levels[0].m_width * m_levels[0].m_height, m_depth.begin());
+
+    for (u32 level = 1; level < m_levels.size(); ++level)
+        _reduce(m_levels[level - 1], m_levels[level]);
+}
+
+/**
+ * @brief Whether any pixel of the rect, in first level pixels, lies farther
+ * than `nearest`.
+ *
+ * Starts from the level where the rect spans at most two texels each way.
+ * A texel farther than `nearest` hides its whole area, a texel fully inside
+ * the rect answers for it, and only texels straddling the rect edge are
+ * refined, so the result matches a per pixel test.
+ */
+bool HiZPyramid::isVisible(
+    const f32 minX,
+    const f32 minY,
+    const f32 maxX,
+    const f32 maxY,
+    const f32 nearest
+) const noexcept {
+    Rect rect;
+    if (!_toRect(minX, minY, maxX, maxY, rect))
+        return false;
+
+    const u32 level = _getStartLevel(rect);
+    const u32 x0 = _toTexel(level, rect.m_startX, m_levels[level].m_width);
+    const u32 x1 = _toTexel(level, rect.m_endX - 1, m_levels[level].m_width);
+    const u32 y0 = _toTexel(level, rect.m_startY, m_levels[level].m_height);
+    const u32 y1 = _toTexel(level, rect.m_endY - 1, m_levels[level].m_height);
+
+    for (u32 y = y0; y <= y1; ++y) {
+        for (u32 x = x0; x <= x1; ++x) {
+            if (_isTexelVisible(level, x, y, rect, nearest))
+                return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief isVisible without the refinement, as cull.compute runs it: only the
+ * texels of the starting level are read, at most 2x2. It may keep a rect
+ * isVisible drops, never the other way around.
+ */
+bool HiZPyramid::isVisibleCoarse(
+    const f32 minX,
+    const f32 minY,
+    const f32 maxX,
+    const f32 maxY,
+    const f32 nearest
+) const noexcept {
+    Rect rect;
+    if (!_toRect(minX, minY, maxX, maxY, rect))
+        return false;
+
+    const u32 level = _getStartLevel(rect);
+    const u32 x0 = _toTexel(level, rect.m_startX, m_levels[level].m_width);
+    const u32 x1 = _toTexel(level, rect.m_endX - 1, m_levels[level].m_width);
+    const u32 y0 = _toTexel(level, rect.m_startY, m_levels[level].m_height);
+    const u32 y1 = _toTexel(level, rect.m_endY - 1, m_levels[level].m_height);
+
+    for (u32 y = y0; y <= y1; ++y) {
+        for (u32 x = x0; x <= x1; ++x) {
+            if (getDepth(level, x, y) <= nearest)
+                return true;
+        }
+    }
+    return false;
+}
+
+/* ========================================================================== */
+
+u32 HiZPyramid::getLevelCount() const noexcept {
+    return m_levels.size();
+}
+
+u32 HiZPyramid::getWidth(const u32 level) const noexcept {
+    return m_levels[level].m_width;
+}
+
+u32 HiZPyramid::getHeight(const u32 level) const noexcept {
+    return m_levels[level].m_height;
+}
+
+f32 HiZPyramid::getDepth(const u32 level, const u32 x, const u32 y) const noexcept {
+    const Level& lvl = m_levels[level];
+    return m_depth[lvl.m_offset + y * lvl.m_width + x];
+}
+
+/* ========================================================================== */
+/*                                   PRIVATE                                  */
+/* ========================================================================== */
+
+/**
+ * @brief Clips a rect to the first level, in whole pixels.
+ *
+ * @return false if nothing is left on screen.
+ */
+bool HiZPyramid::_toRect(
+    const f32 minX,
+    const f32 minY,
+    const f32 maxX,
+    const f32 maxY,
+    Rect& rect
+) const noexcept {
+    const Level& base = m_levels[0];
+
+    rect.m_startX = std::max((i32)std::floor(minX), 0);
+    rect.m_endX = std::min((i32)std::ceil(maxX), (i32)base.m_width);
+    rect.m_startY = std::max((i32)std::floor(minY), 0);
+    rect.m_endY = std::min((i32)std::ceil(maxY), (i32)base.m_height);
+    return rect.m_startX < rect.m_endX && rect.m_startY < rect.m_endY;
+}
+
+/**
+ * @brief Level where the rect spans at most two texels each way.
+ */
+u32 HiZPyramid::_getStartLevel(const Rect& rect) const noexcept {
+    const u32 extent = std::max(rect.m_endX - rect.m_startX, rect.m_endY - rect.m_startY);
+    return std::min<u32>(std::bit_width(extent - 1), m_levels.size() - 1);
+}
+
+/**
+ * @brief Texel of `level` covering a first level pixel. Texels that absorbed
+ * a leftover row or column sit last, so clamping keeps those pixels in.
+ */
+u32 HiZPyramid::_toTexel(const u32 level, const u32 pixel, const u32 size) noexcept {
+    return std::min(pixel >> level, size - 1);
+}
+
+/**
+ * @brief First level pixels covered by a texel, end excluded.
+ */
+void HiZPyramid::_getTexelSpan(
+    const u32 level,
+    const u32 texel,
+    const u32 size,
+    const u32 baseSize,
+    i32& start,
+    i32& end
+) noexcept {
+    start = texel << level;
+    end = texel + 1 == size ? baseSize : (texel + 1) << level;
+}
+
+bool HiZPyramid::_isTexelVisible(
+    const u32 level,
+    const u32 x,
+    const u32 y,
+    const Rect& rect,
+    const f32 nearest
+) const noexcept {
+    const Level& lvl = m_levels[level];
+    if (m_depth[lvl.m_offset + y * lvl.m_width + x] > nearest)
+        return false;
+
+    i32 startX, endX, startY, endY;
+    _getTexelSpan(level, x, lvl.m_width, m_levels[0].m_width, startX, endX);
+    _getTexelSpan(level, y, lvl.m_height, m_levels[0].m_height, startY, endY);
+
+    if (endX <= rect.m_startX || startX >= rect.m_endX || endY <= rect.m_startY || startY >= rect.m_endY)
+        return false;
+
+    const bool inside =
+        startX >= rect.m_startX && endX <= rect.m_endX &&
+        startY >= rect.m_startY && endY <= rect.m_endY;
+    if (inside || level == 0)
+        return true;
+
+    // Children of a last texel run up to the end of the finer level
+    const Level& child = m_levels[level - 1];
+    const u32 childEndX = x + 1 == lvl.m_width ? child.m_width : x * 2 + 2;
+    const u32 childEndY = y + 1 == lvl.m_height ? child.m_height : y * 2 + 2;
+
+    for (u32 cy = std::min(y * 2, child.m_height - 1); cy < childEndY; ++cy) {
+        for (u32 cx = std::min(x * 2, child.m_width - 1); cx < childEndX; ++cx) {
+            if (_isTexelVisible(level - 1, cx, cy, rect, nearest))
+                return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Farthest depth over the source texels under each destination texel.
+ */
+void HiZPyramid::_reduce(const Level& src, const Level& dst) noexcept {
+    const f32* in = m_depth.data() + src.m_offset;
+    f32*       out = m_depth.data() + dst.m_offset;
+
+    for (u32 y = 0; y < dst.m_height; ++y) {
+        const u32 startY = std::min(y * 2, src.m_height - 1);
+        const u32 endY = y + 1 == dst.m_height ? src.m_height : std::min(startY + 2, src.m_height);
+
+        for (u32 x = 0; x < dst.m_width; ++x) {
+            const u32 startX = std::min(x * 2, src.m_width - 1);
+            const u32 endX = x + 1 == dst.m_width ? src.m_width : std::min(startX + 2, src.m_width);
+
+            f32 farthest = in[startY * src.m_width + startX];
+            for (u32 sy = startY; sy < endY; ++sy) {
+                for (u32 sx = startX; sx < endX; ++sx)
+                    farthest = std::min(farthest, in[sy * src.m_width + sx]);
+            }
+            out[y * dst.m_width + x] = farthest;
+        }
+    }
+}
+
+} // namespace vox::gfx
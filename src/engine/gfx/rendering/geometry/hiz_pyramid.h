@@ -0,0 +1,129 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   hiz_pyramid.h                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/07/02 10:12:44 by etran             #+#    #+#             */
+/*   Updated: 2024/07/08 10:41:17 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#pragma once
+
+#include "types.h"
+
+#include <vector>
+
+namespace vox::gfx {
+
+/**
+ * @brief CPU hierarchical depth buffer, built over the software occlusion
+ * buffer of OcclusionCuller. It never reads the GPU depth.
+ *
+ * Each level halves the previous one and keeps the farthest depth of the
+ * texels it covers, so a single texel of a coarse level answers for a whole
+ * screen area. On odd sizes the last texel of a row or column also takes the
+ * one left over, so no source texel is ever dropped.
+ *
+ * Depth grows towards the camera (1 / w, or a reversed depth buffer) and 0
+ * means nothing was drawn: the farthest depth is the smallest value.
+ *
+ * Also the CPU reference of the GPU culling (ENABLE_GPU_CULLING): hiz.compute
+ * reduces the depth buffer the way build does, and cull.compute tests chunk
+ * boxes the way isVisibleCoarse does.
+ */
+class HiZPyramid final {
+public:
+    /* ====================================================================== */
+    /*                                 METHODS                                */
+    /* ====================================================================== */
+
+    HiZPyramid() = default;
+    ~HiZPyramid() = default;
+
+    HiZPyramid(HiZPyramid&& other) = delete;
+    HiZPyramid(const HiZPyramid& other) = delete;
+    HiZPyramid& operator=(HiZPyramid&& other) = delete;
+    HiZPyramid& operator=(const HiZPyramid& other) = delete;
+
+    /* ====================================================================== */
+
+    void    init(const u32 width, const u32 height);
+    void    build(const f32* depth) noexcept;
+
+    bool    isVisible(
+        const f32 minX,
+        const f32 minY,
+        const f32 maxX,
+        const f32 maxY,
+        const f32 nearest) const noexcept;
+    bool    isVisibleCoarse(
+        const f32 minX,
+        const f32 minY,
+        const f32 maxX,
+        const f32 maxY,
+        const f32 nearest) const noexcept;
+
+    u32     getLevelCount() const noexcept;
+    u32     getWidth(const u32 level) const noexcept;
+    u32     getHeight(const u32 level) const noexcept;
+    f32     getDepth(const u32 level, const u32 x, const u32 y) const noexcept;
+
+private:
+    /* ====================================================================== */
+    /*                                TYPEDEFS                                */
+    /* ====================================================================== */
+
+    struct Level {
+        u32 m_offset;
+        u32 m_width;
+        u32 m_height;
+    };
+
+    struct Rect {
+        i32 m_startX;
+        i32 m_startY;
+        i32 m_endX;
+        i32 m_endY;
+    };
+
+    /* ====================================================================== */
+    /*                                  DATA                                  */
+    /* ====================================================================== */
+
+    std::vector<Level>  m_levels;
+    std::vector<f32>    m_depth;
+
+    /* ====================================================================== */
+    /*                                 METHODS                                */
+    /* ====================================================================== */
+
+    bool    _toRect(
+        const f32 minX,
+        const f32 minY,
+        const f32 maxX,
+        const f32 maxY,
+        Rect& rect) const noexcept;
+    u32     _getStartLevel(const Rect& rect) const noexcept;
+    bool    _isTexelVisible(
+        const u32 level,
+        const u32 x,
+        const u32 y,
+        const Rect& rect,
+        const f32 nearest) const noexcept;
+    void    _reduce(const Level& src, const Level& dst) noexcept;
+
+    static u32  _toTexel(const u32 level, const u32 pixel, const u32 size) noexcept;
+    static void _getTexelSpan(
+        const u32 level,
+        const u32 texel,
+        const u32 size,
+        const u32 baseSize,
+        i32& start,
+        i32& end) noexcept;
+
+}; // class HiZPyramid
+
+} // namespace vox::gfx
@@ -0,0 +1,303 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   occlusion_culler.cpp                               :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/07/01 15:26:10 by etran             #+#    #+#             */
+/*   Updated: 2024/07/02 16:40:19 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "occlusion_culler.h"
+#include "controller.h"
+#include "chunk.h"
+#include "maths.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace vox::gfx {
+
+/* ========================================================================== */
+/*                                   PUBLIC                                   */
+/* ========================================================================== */
+
+void OcclusionCuller::init() {
+    m_pyramid.init(WIDTH, HEIGHT);
+}
+
+void OcclusionCuller::begin(const ui::Camera& camera) noexcept {
+    const math::Mat4 view = math::lookAt(camera.m_position, camera.m_front, camera.m_up, camera.m_right);
+    const math::Mat4 proj = math::perspective(
+        math::radians(camera.m_fov),
+        ui::Camera::ASPECT_RATIO,
+        ui::Camera::NEAR_PLANE,
+        ui::Camera::FAR_PLANE);
+
+    m_viewProj = proj * view;
+    m_eye = camera.m_position;
+    m_depth.fill(0.0f);
+}
+
+/**
+ * @brief The box must be fully solid. Boxes crossing the near plane are
+ * ignored.
+ *
+ * Each face turned towards the camera is drawn with its own depth plane.
+ * Pixels straddling two faces are covered by neither, so the silhouette is
+ * also drawn, flat at the depth of the farthest corner.
+ */
+void OcclusionCuller::addOccluder(const math::Vect3& min, const math::Vect3& max) noexcept {
+    // Corner i has bit 0 set for max.x, bit 1 for max.y, bit 2 for max.z
+    static constexpr u8 FACES[6][4] = {
+        { 0, 2, 3, 1 }, // -z
+        { 4, 5, 7, 6 }, // +z
+        { 0, 4, 6, 2 }, // -x
+        { 1, 3, 7, 5 }, // +x
+        { 0, 1, 5, 4 }, // -y
+        { 2, 6, 7, 3 }, // +y
+    };
+
+    Corners corners;
+    if (!_projectBox(min, max, corners))
+        return;
+
+    const bool facing[6] = {
+        m_eye.z < min.z, m_eye.z > max.z,
+        m_eye.x < min.x, m_eye.x > max.x,
+        m_eye.y < min.y, m_eye.y > max.y
+    };
+
+    for (u32 i = 0; i < 6; ++i) {
+        if (!facing[i])
+            continue;
+
+        const u8* face = FACES[i];
+        const ScreenVertex quad[4] = { corners[face[0]], corners[face[1]], corners[face[2]], corners[face[3]] };
+
+        DepthPlane plane;
+        if (_computeDepthPlane(quad[0], quad[1], quad[2], plane))
+            _rasterizePolygon(quad, 4, plane);
+    }
+
+    f32 farthest = corners[0].m_invW;
+    for (const ScreenVertex& corner: corners)
+        farthest = std::min(farthest, corner.m_invW);
+
+    std::array<ScreenVertex, 8> hull;
+    const u32 count = _computeHull(corners, hull);
+    _rasterizePolygon(hull.data(), count, { 0.0f, 0.0f, farthest });
+}
+
+/**
+ * @brief Builds the pyramid the visibility tests read from.
+ */
+void OcclusionCuller::end() noexcept {
+    m_pyramid.build(m_depth.data());
+}
+
+/**
+ * @brief Whether any pixel under the box is not hidden by a nearer occluder.
+ * Must be called after end().
+ */
+bool OcclusionCuller::isVisible(const math::Vect3& min, const math::Vect3& max) const noexcept {
+    Corners corners;
+    if (!_projectBox(min, max, corners))
+        return true;
+
+    f32 minX = corners[0].m_x, maxX = corners[0].m_x;
+    f32 minY = corners[0].m_y, maxY = corners[0].m_y;
+    f32 nearest = corners[0].m_invW;
+    for (const ScreenVertex& corner: corners) {
+        minX = std::min(minX, corner.m_x);
+        maxX = std::max(maxX, corner.m_x);
+        minY = std::min(minY, corner.m_y);
+        maxY = std::max(maxY, corner.m_y);
+        nearest = std::max(nearest, corner.m_invW);
+    }
+
+    return m_pyramid.isVisible(minX, minY, maxX, maxY, nearest);
+}
+
+/* ========================================================================== */
+
+/**
+ * @brief Height below which the chunk is fully solid, and height of its
+ * highest solid block.
+ */
+void OcclusionCuller::measureChunk(const game::Chunk& chunk, u32& solidHeight, u32& topHeight) noexcept {
+    solidHeight = CHUNK_HEIGHT;
+    topHeight = 0;
+
+    for (u32 z = 0; z < CHUNK_SIZE; ++z) {
+        for (u32 x = 0; x < CHUNK_SIZE; ++x) {
+            const u32 mask = chunk.getColumnMask(x, z);
+            solidHeight = std::min<u32>(solidHeight, std::countr_one(mask));
+            topHeight = std::max<u32>(topHeight, std::bit_width(mask));
+        }
+    }
+}
+
+/* ========================================================================== */
+/*                                   PRIVATE                                  */
+/* ========================================================================== */
+
+/**
+ * @brief Fails if a corner is behind the near plane.
+ */
+bool OcclusionCuller::_projectBox(
+    const math::Vect3& min,
+    const math::Vect3& max,
+    Corners& corners
+) const noexcept {
+    const float* m = m_viewProj.mat;
+
+    for (u32 i = 0; i < corners.size(); ++i) {
+        const f32 x = (i & 1) ? max.x : min.x;
+        const f32 y = (i & 2) ? max.y : min.y;
+        const f32 z = (i & 4) ? max.z : min.z;
+
+        // Column major
+        const f32 clipX = m[0] * x + m[4] * y + m[8] * z + m[12];
+        const f32 clipY = m[1] * x + m[5] * y + m[9] * z + m[13];
+        const f32 clipW = m[3] * x + m[7] * y + m[11] * z + m[15];
+
+        if (clipW < ui::Camera::NEAR_PLANE)
+            return false;
+
+        const f32 invW = 1.0f / clipW;
+        corners[i].m_x = (clipX * invW * 0.5f + 0.5f) * WIDTH;
+        corners[i].m_y = (clipY * invW * 0.5f + 0.5f) * HEIGHT;
+        corners[i].m_invW = invW;
+    }
+    return true;
+}
+
+/**
+ * @brief Plane of 1 / w over the screen, through three vertices.
+ */
+bool OcclusionCuller::_computeDepthPlane(
+    const ScreenVertex& a,
+    const ScreenVertex& b,
+    const ScreenVertex& c,
+    DepthPlane& plane
+) noexcept {
+    const f32 area = (b.m_x - a.m_x) * (c.m_y - a.m_y) - (b.m_y - a.m_y) * (c.m_x - a.m_x);
+
+    // Face seen edge-on
+    if (std::abs(area) < 1e-6f)
+        return false;
+
+    const f32 dw1 = b.m_invW - a.m_invW;
+    const f32 dw2 = c.m_invW - a.m_invW;
+    plane.m_x = (dw1 * (c.m_y - a.m_y) - dw2 * (b.m_y - a.m_y)) / area;
+    plane.m_y = (dw2 * (b.m_x - a.m_x) - dw1 * (c.m_x - a.m_x)) / area;
+    plane.m_c = a.m_invW - plane.m_x * a.m_x - plane.m_y * a.m_y;
+    return true;
+}
+
+/**
+ * @brief Convex hull of the projected corners (monotone chain), counter
+ * clockwise.
+ */
+u32 OcclusionCuller::_computeHull(const Corners& corners, std::array<ScreenVertex, 8>& hull) noexcept {
+    Corners sorted = corners;
+    std::sort(sorted.begin(), sorted.end(), [](const ScreenVertex& lhs, const ScreenVertex& rhs) {
+        return lhs.m_x < rhs.m_x || (lhs.m_x == rhs.m_x && lhs.m_y < rhs.m_y);
+    });
+
+    const auto cross = [](const ScreenVertex& o, const ScreenVertex& a, const ScreenVertex& b) {
+        return (a.m_x - o.m_x) * (b.m_y - o.m_y) - (a.m_y - o.m_y) * (b.m_x - o.m_x);
+    };
+
+    std::array<ScreenVertex, 16> chain;
+    u32 count = 0;
+    for (u32 i = 0; i < sorted.size(); ++i) {
+        while (count >= 2 && cross(chain[count - 2], chain[count - 1], sorted[i]) <= 0.0f)
+            --count;
+        chain[count++] = sorted[i];
+    }
+    for (u32 i = sorted.size() - 1, lower = count + 1; i-- > 0;) {
+        while (count >= lower && cross(chain[count - 2], chain[count - 1], sorted[i]) <= 0.0f)
+            --count;
+        chain[count++] = sorted[i];
+    }
+
+    // Last point closes the chain
+    count = std::min<u32>(count - 1, hull.size());
+    std::copy_n(chain.begin(), count, hull.begin());
+    return count;
+}
+
+/**
+ * @brief Half-space rasterization of a convex polygon. A pixel is written only
+ * if the polygon covers it entirely, with the farthest depth it has in it.
+ */
+void OcclusionCuller::_rasterizePolygon(
+    const ScreenVertex* vertices,
+    const u32 count,
+    const DepthPlane& plane
+) noexcept {
+    constexpr u32 MAX_EDGES = 8;
+
+    if (count < 3 || count > MAX_EDGES)
+        return;
+
+    f32 area = 0.0f;
+    f32 minX = vertices[0].m_x, maxX = vertices[0].m_x;
+    f32 minY = vertices[0].m_y, maxY = vertices[0].m_y;
+    for (u32 i = 0; i < count; ++i) {
+        const ScreenVertex& p = vertices[i];
+        const ScreenVertex& q = vertices[(i + 1) % count];
+        area += p.m_x * q.m_y - q.m_x * p.m_y;
+        minX = std::min(minX, p.m_x);
+        maxX = std::max(maxX, p.m_x);
+        minY = std::min(minY, p.m_y);
+        maxY = std::max(maxY, p.m_y);
+    }
+    if (std::abs(area) < 1e-6f)
+        return;
+
+    const i32 startX = std::max((i32)std::floor(minX), 0);
+    const i32 endX = std::min((i32)std::ceil(maxX), (i32)WIDTH);
+    const i32 startY = std::max((i32)std::floor(minY), 0);
+    const i32 endY = std::min((i32)std::ceil(maxY), (i32)HEIGHT);
+    if (startX >= endX || startY >= endY)
+        return;
+
+    // Edge functions e(x, y) = A * x + B * y + C, positive inside whatever
+    // the winding. The bias makes the edge hold at the worst pixel corner.
+    const f32 orientation = area > 0.0f ? 1.0f : -1.0f;
+    std::array<f32, MAX_EDGES> edgeA, edgeB, edgeC;
+    for (u32 i = 0; i < count; ++i) {
+        const ScreenVertex& p = vertices[i];
+        const ScreenVertex& q = vertices[(i + 1) % count];
+        edgeA[i] = orientation * (p.m_y - q.m_y);
+        edgeB[i] = orientation * (q.m_x - p.m_x);
+        edgeC[i] = orientation * (p.m_x * q.m_y - p.m_y * q.m_x) - 0.5f * (std::abs(edgeA[i]) + std::abs(edgeB[i]));
+    }
+
+    // Depth plane, lowered to its farthest value in the pixel
+    const f32 depthC = plane.m_c - 0.5f * (std::abs(plane.m_x) + std::abs(plane.m_y));
+
+    for (i32 y = startY; y < endY; ++y) {
+        const f32   py = y + 0.5f;
+        f32*        row = m_depth.data() + y * WIDTH;
+
+        for (i32 x = startX; x < endX; ++x) {
+            const f32 px = x + 0.5f;
+
+            bool inside = true;
+            for (u32 i = 0; i < count; ++i)
+                inside &= edgeA[i] * px + edgeB[i] * py + edgeC[i] >= 0.0f;
+
+            const f32 depth = plane.m_x * px + plane.m_y * py + depthC;
+            row[x] = inside ? std::max(row[x], depth) : row[x];
+        }
+    }
+}
+
+} // namespace vox::gfx
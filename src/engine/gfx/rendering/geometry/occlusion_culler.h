@@ -0,0 +1,122 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   occlusion_culler.h                                 :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/07/01 15:26:10 by etran             #+#    #+#             */
+/*   Updated: 2024/07/07 16:51:27 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#pragma once
+
+#include "types.h"
+#include "vector.h"
+#include "matrix.h"
+#include "hiz_pyramid.h"
+
+#include <array>
+
+namespace ui {
+struct Camera;
+} // namespace ui
+
+namespace game {
+class Chunk;
+} // namespace game
+
+namespace vox::gfx {
+
+/**
+ * @brief CPU occlusion culling.
+ *
+ * A few boxes known to be solid are rasterized into a small depth buffer,
+ * then boxes are tested against it. Both sides are conservative: occluders
+ * only cover pixels they fully cover, at their farthest depth in the pixel,
+ * and tested boxes use their nearest depth over their whole screen rect.
+ *
+ * Depth is stored as 1 / w: it interpolates linearly in screen space, and
+ * 0 means no occluder. Once every occluder is in, the buffer is reduced to a
+ * CPU HiZPyramid so each test reads a handful of texels whatever its size.
+ */
+class OcclusionCuller final {
+public:
+    /* ====================================================================== */
+    /*                             STATIC MEMBERS                             */
+    /* ====================================================================== */
+
+    static constexpr u32    WIDTH = 192;
+    static constexpr u32    HEIGHT = 128;
+
+    /* ====================================================================== */
+    /*                                 METHODS                                */
+    /* ====================================================================== */
+
+    OcclusionCuller() = default;
+    ~OcclusionCuller() = default;
+
+    OcclusionCuller(OcclusionCuller&& other) = delete;
+    OcclusionCuller(const OcclusionCuller& other) = delete;
+    OcclusionCuller& operator=(OcclusionCuller&& other) = delete;
+    OcclusionCuller& operator=(const OcclusionCuller& other) = delete;
+
+    /* ====================================================================== */
+
+    void    init();
+
+    void    begin(const ui::Camera& camera) noexcept;
+    void    addOccluder(const math::Vect3& min, const math::Vect3& max) noexcept;
+    void    end() noexcept;
+    bool    isVisible(const math::Vect3& min, const math::Vect3& max) const noexcept;
+
+    /* ====================================================================== */
+
+    static void measureChunk(const game::Chunk& chunk, u32& solidHeight, u32& topHeight) noexcept;
+
+private:
+    /* ====================================================================== */
+    /*                                TYPEDEFS                                */
+    /* ====================================================================== */
+
+    struct ScreenVertex {
+        f32 m_x;
+        f32 m_y;
+        f32 m_invW;
+    };
+
+    /**
+     * @brief 1 / w = m_x * x + m_y * y + m_c
+     */
+    struct DepthPlane {
+        f32 m_x;
+        f32 m_y;
+        f32 m_c;
+    };
+
+    using Corners = std::array<ScreenVertex, 8>;
+
+    /* ====================================================================== */
+    /*                                  DATA                                  */
+    /* ====================================================================== */
+
+    math::Mat4  m_viewProj;
+    math::Vect3 m_eye;
+
+    alignas(32) std::array<f32, WIDTH * HEIGHT> m_depth{};
+    HiZPyramid  m_pyramid;
+
+    /* ====================================================================== */
+    /*                                 METHODS                                */
+    /* ====================================================================== */
+
+    bool    _projectBox(const math::Vect3& min, const math::Vect3& max, Corners& corners) const noexcept;
+    void    _rasterizePolygon(const ScreenVertex* vertices, const u32 count, const DepthPlane& plane) noexcept;
+
+    static bool _computeDepthPlane(const ScreenVertex& a, const ScreenVertex& b, const ScreenVertex& c, DepthPlane& plane) noexcept;
+    static u32  _computeHull(const Corners& corners, std::array<ScreenVertex, 8>& hull) noexcept;
+
+}; // class OcclusionCuller
+
+} // namespace vox::gfx
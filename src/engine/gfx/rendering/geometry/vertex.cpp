@@ -6,11 +6,14 @@
 /*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2024/05/28 11:03:25 by etran             #+#    #+#             */
-/*   Updated: 2024/05/30 17:07:38 by etran            ###   ########.fr       */
+/*   Updated: 2024/07/07 16:20:14 by etran            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #include "vertex.h"
+#include "chunk_layout.h"
+
+#include <cstddef>
 
 namespace vox::gfx {
 
@@ -22,9 +25,25 @@ VertexInstance::VertexInstance(
     const game::BlockFace face,
     const u8 textureId,
     const u16 blockId,
-    const u16 chunkId
+    const u16 chunkId,
+    const u8 lod,
+    const u8 occlusion
 ) {
-    m_data = ((u8)textureId << 29) | ((u8)face << 26) | (blockId << 14) | chunkId;
+    m_data = game::WorldInstanceLayout::pack((u8)face, textureId, blockId, chunkId, lod);
+#if ENABLE_BAKED_AO
+    m_occlusion = occlusion;
+#else
+    (void)occlusion;
+#endif
+}
+
+/**
+ * @brief Placeholder filling the unused room of a buffer range.
+ */
+VertexInstance VertexInstance::createPadding() noexcept {
+    VertexInstance instance;
+    instance.m_data = (u32)PADDING_FACE << game::WorldInstanceLayout::FACE_SHIFT;
+    return instance;
 }
 
 VertexInstance::BindingsDescription VertexInstance::getBindingDescriptions() noexcept {
@@ -47,6 +66,13 @@ VertexInstance::AttributesDescription VertexInstance::getAttributeDescriptions()
     attributeDescriptions[0].format = VK_FORMAT_R32_UINT;
     attributeDescriptions[0].offset = 0;
 
+#if ENABLE_BAKED_AO
+    attributeDescriptions[1].binding = 0;
+    attributeDescriptions[1].location = 1;
+    attributeDescriptions[1].format = VK_FORMAT_R32_UINT;
+    attributeDescriptions[1].offset = offsetof(VertexInstance, m_occlusion);
+#endif
+
     return attributeDescriptions;
 }
 
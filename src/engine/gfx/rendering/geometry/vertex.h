@@ -6,7 +6,7 @@
 /*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2024/05/28 11:02:25 by etran             #+#    #+#             */
-/*   Updated: 2024/05/30 17:07:34 by etran            ###   ########.fr       */
+/*   Updated: 2024/07/07 16:20:14 by etran            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -15,17 +15,28 @@
 #include <vulkan/vulkan.h>
 #include <array>
 
+#include "vox_decl.h"
 #include "block_decl.h"
 
 namespace vox::gfx {
 
 class VertexInstance final {
 public:
+    /* ====================================================================== */
+    /*                             STATIC MEMBERS                             */
+    /* ====================================================================== */
+
+    // Not a BlockFace: shaders collapse it, nothing gets drawn
+    static constexpr u8     PADDING_FACE = 7;
+
+    // 2 bits per face vertex, 3 is unoccluded
+    static constexpr u8     NO_OCCLUSION = 0xFF;
+
     /* ====================================================================== */
     /*                                TYPEDEFS                                */
     /* ====================================================================== */
 
-    using AttributesDescription = std::array<VkVertexInputAttributeDescription, 1>;
+    using AttributesDescription = std::array<VkVertexInputAttributeDescription, 1 + ENABLE_BAKED_AO>;
     using BindingsDescription = std::array<VkVertexInputBindingDescription, 1>;
 
     /* ====================================================================== */
@@ -36,7 +47,9 @@ public:
         const game::BlockFace face,
         const u8 textureId,
         const u16 blockId,
-        const u16 chunkId);
+        const u16 chunkId,
+        const u8 lod,
+        const u8 occlusion = NO_OCCLUSION);
 
     VertexInstance() = default;
     ~VertexInstance() = default;
@@ -48,6 +61,8 @@ public:
 
     /* ====================================================================== */
 
+    static VertexInstance           createPadding() noexcept;
+
     static BindingsDescription      getBindingDescriptions() noexcept;
     static AttributesDescription    getAttributeDescriptions() noexcept;
     static u32                      getStride() noexcept;
@@ -58,6 +73,9 @@ private:
     /* ====================================================================== */
 
     u32 m_data = 0;
+#if ENABLE_BAKED_AO
+    u32 m_occlusion = NO_OCCLUSION;
+#endif
 
 }; // class VertexInstance
 
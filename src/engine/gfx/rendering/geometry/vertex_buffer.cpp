@@ -6,7 +6,7 @@
 /*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2024/05/20 14:58:48 by etran             #+#    #+#             */
-/*   Updated: 2024/06/12 12:10:07 by etran            ###   ########.fr       */
+/*   Updated: 2024/07/08 10:41:17 by etran            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -15,9 +15,15 @@
 #include "game_state.h"
 #include "bounding_box.h"
 #include "bounding_frustum.h"
+#include "chunk_mesher.h"
+#include "controller.h"
+#include "job_system.h"
 
 #include "debug.h"
 
+#include <algorithm>
+#include <chrono>
+
 namespace vox::gfx {
 
 /* ========================================================================== */
@@ -25,10 +31,32 @@ namespace vox::gfx {
 /* ========================================================================== */
 
 Buffer  VertexBuffer::ms_buffer;
+#if !ENABLE_FRUSTUM_CULLING
+Buffer  VertexBuffer::ms_stagingBuffer;
+#endif
+#if ENABLE_GPU_CULLING
+Buffer  VertexBuffer::ms_cullChunks;
+Buffer  VertexBuffer::ms_drawCommands;
+Buffer  VertexBuffer::ms_chunkVisibility;
+#endif
 u32     VertexBuffer::ms_instancesCount = 0;
 u32     VertexBuffer::ms_visibleAABBsCount = 0;
 u32     VertexBuffer::ms_maxVertexInstanceCount = 0;
 
+std::vector<u32>    VertexBuffer::ms_chunkInstanceCounts;
+
+std::vector<VertexBuffer::ChunkMesh>  VertexBuffer::ms_chunkMeshes;
+DrawRangeList                         VertexBuffer::ms_drawRanges;
+
+std::array<VertexBuffer::DrawRange, VertexBuffer::LOD_COUNT> VertexBuffer::ms_lodRanges{};
+
+ChunkVisibility VertexBuffer::ms_visibility;
+OcclusionCuller VertexBuffer::ms_occlusionCuller;
+
+math::Vect3Soa      VertexBuffer::ms_boxCenters;
+math::Vect3Soa      VertexBuffer::ms_boxHalfExtents;
+std::vector<f32>    VertexBuffer::ms_planeDistances;
+
 #if ENABLE_FRUSTUM_CULLING
 /**
  * @brief Creates a vertex buffer.
@@ -37,6 +65,9 @@ void VertexBuffer::init(
     const Device& device,
     const game::GameState& gameState
 ) {
+    computeMaxVertexInstanceCount(gameState);
+    _initChunkMeshes(gameState);
+
     BufferMetadata metadata{};
     metadata.m_format = sizeof(VertexInstance);
     metadata.m_size = ms_maxVertexInstanceCount;
@@ -45,16 +76,28 @@ void VertexBuffer::init(
 
     ms_buffer.init(device, std::move(metadata));
     ms_buffer.map(device);
+#if ENABLE_GPU_CULLING
+    _initCullBuffers(device);
+#endif
 }
 
+/**
+ * @note Called once the previous frame completed: the buffer is not in use.
+ */
+
 void VertexBuffer::update(const Device& device, const game::GameState& gameState) {
-    u32 visibleAABBs = 0;
-    const auto instances = _computeVertexInstances(gameState, visibleAABBs);
+    const ui::Camera& camera = gameState.getController().getCamera();
 
-    if (visibleAABBs == m_visibleAABBsCount)
-        return;
-    m_visibleAABBsCount = visibleAABBs;
+    _selectLods(camera.m_position);
+    ms_visibleAABBsCount = _updateVisibility(camera);
+
+    // Chunk meshes were rebuilt with the instances: the buffer must follow
+    const auto instances = _computeVertexInstances(gameState);
     ms_instancesCount = instances.size();
+
+    // Dirty chunks still waiting for their turn are meshed from the live
+    // world too, their count may not be up to date yet
+    _reserve(device, std::max(ms_maxVertexInstanceCount, ms_instancesCount));
     ms_buffer.copyFrom(instances.data(), sizeof(VertexInstance) * ms_instancesCount, 0);
 }
 
@@ -65,29 +108,11 @@ void VertexBuffer::init(
     const ICommandBuffer* cmdBuffer,
     const game::GameState& gameState
 ) {
-    const auto instances = _computeVertexInstances(gameState);
-    ms_instancesCount = instances.size();
-
-    BufferMetadata metadata{};
-    metadata.m_format = sizeof(VertexInstance);
-    metadata.m_size = ms_instancesCount;
-    metadata.m_usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
-    metadata.m_properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
-
-    ms_buffer.init(device, std::move(metadata));
-
-    Buffer  stagingBuffer = ms_buffer.createStagingBuffer(device);
-    stagingBuffer.map(device);
-    stagingBuffer.copyFrom(instances.data(), sizeof(VertexInstance) * ms_instancesCount, 0);
-    stagingBuffer.unmap(device);
-
-    cmdBuffer->reset();
-    cmdBuffer->startRecording();
-    ms_buffer.copyBuffer(cmdBuffer, stagingBuffer);
-    cmdBuffer->stopRecording();
-    cmdBuffer->awaitEndOfRecording(device);
-
-    stagingBuffer.destroy(device);
+    _initChunkMeshes(gameState);
+    _upload(device, cmdBuffer, gameState);
+#if ENABLE_GPU_CULLING
+    _initCullBuffers(device);
+#endif
     LINFO("Vertex buffer initialized.");
 }
 
@@ -95,6 +120,78 @@ void VertexBuffer::init(
 
 void VertexBuffer::destroy(const Device& device) {
     ms_buffer.destroy(device);
+#if !ENABLE_FRUSTUM_CULLING
+    ms_stagingBuffer.unmap(device);
+    ms_stagingBuffer.destroy(device);
+#endif
+#if ENABLE_GPU_CULLING
+    ms_cullChunks.unmap(device);
+    ms_cullChunks.destroy(device);
+    ms_drawCommands.destroy(device);
+    ms_chunkVisibility.unmap(device);
+    ms_chunkVisibility.destroy(device);
+#endif
+}
+
+/**
+ * @brief World chunks are indexed y/z/x, meshes z/x/y.
+ */
+static
+u32 _toMeshIndex(const u32 chunk) noexcept {
+    const u32 x = chunk % RENDER_DISTANCE;
+    const u32 z = (chunk % RENDER_AREA) / RENDER_DISTANCE;
+    const u32 y = chunk / RENDER_AREA;
+    return (z * RENDER_DISTANCE + x) * RENDER_HEIGHT + y;
+}
+
+/**
+ * @brief Remeshes the edited chunks, most urgent first, within
+ * REMESH_BUDGET. Their buffer slots are patched before the frame is
+ * recorded, so edits show up on the frame they were made.
+ *
+ * @note Called once the previous frame completed: the buffer is not in use.
+ */
+void VertexBuffer::updateChunks(
+    const Device& device,
+    const ICommandBuffer* cmdBuffer,
+    game::GameState& gameState
+) {
+    game::ChunkScheduler& scheduler = gameState.getWorld().getScheduler();
+
+#if ENABLE_FRUSTUM_CULLING
+    // Instances are rebuilt every frame: only the chunk metadata is stale
+    (void)cmdBuffer;
+    scheduler.process(game::ChunkTask::Mesh, REMESH_BUDGET, [&](const u32 chunk) {
+        const u32 index = _toMeshIndex(chunk);
+        _measureChunk(gameState, index);
+        _countChunkInstances(gameState, index);
+    });
+    _reserve(device, ms_maxVertexInstanceCount);
+#else
+    mem::FrameVector<VkBufferCopy> regions;
+    bool outgrown = false;
+
+    scheduler.process(game::ChunkTask::Mesh, REMESH_BUDGET, [&](const u32 chunk) {
+        const u32 index = _toMeshIndex(chunk);
+        _measureChunk(gameState, index);
+        outgrown = !_remeshChunk(gameState, index, regions) || outgrown;
+    });
+
+    if (outgrown) {
+        // Slots are laid out again around the new sizes
+        ms_buffer.destroy(device);
+        ms_stagingBuffer.unmap(device);
+        ms_stagingBuffer.destroy(device);
+        _upload(device, cmdBuffer, gameState);
+        LDEBUG("Vertex buffer rebuilt: a chunk outgrew its slot.");
+    } else if (!regions.empty()) {
+        cmdBuffer->reset();
+        cmdBuffer->startRecording();
+        ms_buffer.copyRegions(cmdBuffer, ms_stagingBuffer, regions);
+        cmdBuffer->stopRecording();
+        cmdBuffer->awaitEndOfRecording(device);
+    }
+#endif
 }
 
 void VertexBuffer::bind(const ICommandBuffer* cmdBuffer) {
@@ -104,6 +201,98 @@ void VertexBuffer::bind(const ICommandBuffer* cmdBuffer) {
     vkCmdBindVertexBuffers(cmdBuffer->getBuffer(), 0, 1, &buffer, &offset);
 }
 
+/**
+ * @brief A face bucket is dropped when the camera stands behind the plane of
+ * the chunk side it looks at: none of its faces can be front facing.
+ */
+static
+bool _canFaceCamera(const game::BlockFace face, const BoundingBox& box, const math::Vect3& eye) noexcept {
+    switch (face) {
+        case game::BlockFace::Top:      return eye.y > box.getMin().y;
+        case game::BlockFace::Bottom:   return eye.y < box.getMax().y;
+        case game::BlockFace::Left:     return eye.x < box.getMax().x;
+        case game::BlockFace::Right:    return eye.x > box.getMin().x;
+        case game::BlockFace::Front:    return eye.z > box.getMin().z;
+        case game::BlockFace::Back:     return eye.z < box.getMax().z;
+    }
+    return true;
+}
+
+/**
+ * @brief Collects the face buckets that may face the camera, merging
+ * contiguous ones in a single draw. Ranges are sorted by level of detail.
+ *
+ * With ENABLE_GPU_CULLING, writes the chunk records of the culling pass
+ * instead: draws are built on the GPU.
+ */
+void VertexBuffer::updateDrawRanges(const game::GameState& gameState) {
+    const ui::Camera&   camera = gameState.getController().getCamera();
+    const math::Vect3&  eye = camera.m_position;
+
+#if !ENABLE_FRUSTUM_CULLING
+    // Every level is in the buffer, switching is free
+    _selectLods(eye);
+    _updateVisibility(camera);
+#endif
+
+#if ENABLE_GPU_CULLING
+    mem::FrameVector<CullChunk> chunks(RENDER_VOLUME);
+    for (u32 i = 0; i < RENDER_VOLUME; ++i) {
+        const ChunkMesh&    mesh = ms_chunkMeshes[i];
+        const FaceOffsets&  offsets = mesh.m_offsets[mesh.m_lod];
+        const math::Vect3   min = mesh.m_boundingBox.getMin();
+        const math::Vect3   max = mesh.m_boundingBox.getMax();
+
+        CullChunk& chunk = chunks[i];
+        chunk.m_min = { min.x, min.y, min.z, 1.0f };
+        chunk.m_max = { max.x, max.y, max.z, 1.0f };
+        for (u32 face = 0; face < FACE_COUNT; ++face) {
+            const bool drawn = mesh.m_visible && _canFaceCamera((game::BlockFace)face, mesh.m_boundingBox, eye);
+            chunk.m_first[face] = offsets[face];
+            chunk.m_count[face] = drawn ? offsets[face + 1] - offsets[face] : 0;
+        }
+    }
+    ms_cullChunks.copyFrom(chunks.data(), sizeof(CullChunk) * RENDER_VOLUME, 0);
+#else
+
+    ms_drawRanges.clear();
+    for (u32 lod = 0; lod < LOD_COUNT; ++lod) {
+        for (const ChunkMesh& mesh: ms_chunkMeshes) {
+            if (!mesh.m_visible || mesh.m_lod != lod)
+                continue;
+
+            const FaceOffsets& offsets = mesh.m_offsets[lod];
+            for (u32 face = 0; face < FACE_COUNT; ++face) {
+                const u32 first = offsets[face];
+                const u32 count = offsets[face + 1] - first;
+
+                if (count == 0 || !_canFaceCamera((game::BlockFace)face, mesh.m_boundingBox, eye))
+                    continue;
+
+                ms_drawRanges.push(first, count, lod);
+            }
+        }
+    }
+#endif
+}
+
+#if ENABLE_GPU_CULLING
+/**
+ * @brief One draw per face bucket of every chunk, those the culling pass
+ * dropped have no instance.
+ */
+void VertexBuffer::drawCulled(const ICommandBuffer* cmdBuffer, const CullPhase phase) {
+    constexpr u32 DRAW_COUNT = RENDER_VOLUME * FACE_COUNT;
+
+    vkCmdDrawIndirect(
+        cmdBuffer->getBuffer(),
+        ms_drawCommands.getBuffer(),
+        (u32)phase * DRAW_COUNT * sizeof(VkDrawIndirectCommand),
+        DRAW_COUNT,
+        sizeof(VkDrawIndirectCommand));
+}
+#endif
+
 /* ========================================================================== */
 
 const Buffer& VertexBuffer::getBuffer() noexcept {
@@ -114,198 +303,471 @@ u32 VertexBuffer::getInstancesCount() noexcept {
     return ms_instancesCount;
 }
 
+const std::vector<VertexBuffer::DrawRange>& VertexBuffer::getDrawRanges() noexcept {
+    return ms_drawRanges.getRanges();
+}
+
+/**
+ * @brief Every instance of a level, regardless of the selected levels.
+ */
+VertexBuffer::DrawRange VertexBuffer::getLodRange(const u32 lod) noexcept {
+    return ms_lodRanges[lod];
+}
+
+#if ENABLE_GPU_CULLING
+const Buffer& VertexBuffer::getCullChunks() noexcept {
+    return ms_cullChunks;
+}
+
+const Buffer& VertexBuffer::getDrawCommands() noexcept {
+    return ms_drawCommands;
+}
+
+const Buffer& VertexBuffer::getChunkVisibility() noexcept {
+    return ms_chunkVisibility;
+}
+#endif
+
 /* ========================================================================== */
 /*                                   PRIVATE                                  */
 /* ========================================================================== */
 
-enum ChunkNeighbor: u32 {
-    Left = 0,
-    Right,
-    Front,
-    Back,
+/**
+ * @brief One mesh slot per chunk, in z/x/y order, along with its face
+ * connectivity.
+ */
+void VertexBuffer::_initChunkMeshes(const game::GameState& gameState) {
+    ms_chunkMeshes.assign(RENDER_VOLUME, ChunkMesh{});
+    ms_drawRanges.init(RENDER_VOLUME * FACE_COUNT);
+    ms_visibility.init(RENDER_DISTANCE, RENDER_HEIGHT, RENDER_DISTANCE);
+    ms_boxCenters.resize(RENDER_VOLUME);
+    ms_boxHalfExtents.resize(RENDER_VOLUME);
+    ms_planeDistances.resize(RENDER_VOLUME);
+#if ENABLE_OCCLUSION_CULLING && !ENABLE_GPU_CULLING
+    ms_occlusionCuller.init();
+#endif
+
+    jobs::JobSystem::parallelFor(RENDER_VOLUME, RENDER_HEIGHT, [&](const u32 i) {
+        _measureChunk(gameState, i);
+    });
+}
+
+#if ENABLE_GPU_CULLING
+/**
+ * @brief Every chunk counts as visible on the first frame: the early phase
+ * draws them all, there is no depth to test against yet.
+ */
+void VertexBuffer::_initCullBuffers(const Device& device) {
+    BufferMetadata chunksData{};
+    chunksData.m_format = sizeof(CullChunk);
+    chunksData.m_size = RENDER_VOLUME;
+    chunksData.m_usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+    chunksData.m_properties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+
+    ms_cullChunks.init(device, std::move(chunksData));
+    ms_cullChunks.map(device);
+
+    // Early draws, then late draws
+    BufferMetadata commandsData{};
+    commandsData.m_format = sizeof(VkDrawIndirectCommand);
+    commandsData.m_size = 2 * RENDER_VOLUME * FACE_COUNT;
+    commandsData.m_usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT;
+    commandsData.m_properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+
+    ms_drawCommands.init(device, std::move(commandsData));
+
+    BufferMetadata visibilityData{};
+    visibilityData.m_format = sizeof(u32);
+    visibilityData.m_size = RENDER_VOLUME;
+    visibilityData.m_usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+    visibilityData.m_properties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+
+    ms_chunkVisibility.init(device, std::move(visibilityData));
+    ms_chunkVisibility.map(device);
+
+    const std::vector<u32> visible(RENDER_VOLUME, 1);
+    ms_chunkVisibility.copyFrom(visible.data(), sizeof(u32) * RENDER_VOLUME, 0);
+}
+#endif
+
+/**
+ * @brief Culling data of a chunk, to refresh whenever its blocks change.
+ */
+void VertexBuffer::_measureChunk(const game::GameState& gameState, const u32 index) {
+    const u32 y = index % RENDER_HEIGHT;
+    const u32 x = (index / RENDER_HEIGHT) % RENDER_DISTANCE;
+    const u32 z = index / (RENDER_HEIGHT * RENDER_DISTANCE);
+
+    const game::Chunk& chunk = gameState.getWorld().getChunk(x, y, z);
+    ChunkMesh& mesh = ms_chunkMeshes[index];
+    mesh.m_boundingBox = chunk.getBoundingBox();
+    ms_boxCenters.set(index, mesh.m_boundingBox.getCenter());
+    ms_boxHalfExtents.set(index, mesh.m_boundingBox.getHalfExtent());
+    OcclusionCuller::measureChunk(chunk, mesh.m_solidHeight, mesh.m_topHeight);
+    ms_visibility.build(index, chunk);
+}
 
-    Count
-};
+/**
+ * @brief Flags the chunks worth drawing this frame.
+ */
+u32 VertexBuffer::_updateVisibility(const ui::Camera& camera) {
+#if ENABLE_CAVE_CULLING
+    ms_visibility.update(camera.m_position);
+#endif
+
+    for (u32 i = 0; i < RENDER_VOLUME; ++i)
+        ms_chunkMeshes[i].m_visible = ms_visibility.isReachable(i);
+
+#if ENABLE_FRUSTUM_CULLING
+    // One plane against every box at once, same test as BoundingBox::isVisible
+    const BoundingFrustum frustum(camera);
+    for (const math::Vect4& plane: frustum.m_planes) {
+        math::planeDistance(plane, ms_boxCenters, ms_boxHalfExtents, ms_planeDistances);
+        for (u32 i = 0; i < RENDER_VOLUME; ++i)
+            ms_chunkMeshes[i].m_visible = ms_chunkMeshes[i].m_visible && ms_planeDistances[i] >= 0.0f;
+    }
+#endif
+
+#if ENABLE_OCCLUSION_CULLING && !ENABLE_GPU_CULLING
+    // The Hi-Z pyramid replaces the software occluders
+    _cullOccludedChunks(camera);
+#endif
+
+    u32 visibleCount = 0;
+    for (const ChunkMesh& mesh: ms_chunkMeshes)
+        visibleCount += mesh.m_visible;
+    return visibleCount;
+}
+
+/**
+ * @brief Drops the chunks hidden behind the solid base of nearer chunks.
+ * Occluders are taken regardless of visibility: solid is solid.
+ */
+void VertexBuffer::_cullOccludedChunks(const ui::Camera& camera) noexcept {
+    ms_occlusionCuller.begin(camera);
+
+    for (const ChunkMesh& mesh: ms_chunkMeshes) {
+        if (mesh.m_solidHeight == 0 || math::norm(mesh.m_boundingBox.getCenter() - camera.m_position) > OCCLUDER_DISTANCE)
+            continue;
+
+        const math::Vect3   min = mesh.m_boundingBox.getMin();
+        math::Vect3         max = mesh.m_boundingBox.getMax();
+        max.y = min.y + mesh.m_solidHeight;
+        ms_occlusionCuller.addOccluder(min, max);
+    }
+    ms_occlusionCuller.end();
+
+    for (ChunkMesh& mesh: ms_chunkMeshes) {
+        if (!mesh.m_visible)
+            continue;
+
+        const math::Vect3   min = mesh.m_boundingBox.getMin();
+        math::Vect3         max = mesh.m_boundingBox.getMax();
+        max.y = min.y + mesh.m_topHeight;
+        mesh.m_visible = mesh.m_topHeight > 0 && ms_occlusionCuller.isVisible(min, max);
+    }
+}
+
+/**
+ * @brief Moves each chunk to the level matching its distance to the camera.
+ */
+void VertexBuffer::_selectLods(const math::Vect3& eye) noexcept {
+    for (ChunkMesh& mesh: ms_chunkMeshes) {
+        const f32 distance = math::norm(mesh.m_boundingBox.getCenter() - eye);
+
+        u32 lod = mesh.m_lod;
+        while (lod + 1 < LOD_COUNT && distance > LOD_DISTANCES[lod] + LOD_HYSTERESIS)
+            ++lod;
+        while (lod > 0 && distance < LOD_DISTANCES[lod - 1] - LOD_HYSTERESIS)
+            --lod;
+        mesh.m_lod = lod;
+    }
+}
 
 static
-bool _isExposed(
-    const game::Chunk* neighbor,
-    const u32 checkedX,
-    const u32 checkedY,
-    const u32 checkedZ
+ChunkMesher::Neighbors _getNeighbors(
+    const game::GameState& gameState,
+    const u32 x,
+    const u32 y,
+    const u32 z
 ) {
-    return (neighbor && neighbor->getBlock(checkedX, checkedY, checkedZ).isVoid()) || neighbor == nullptr;
+    ChunkMesher::Neighbors  neighbors = {nullptr, nullptr, nullptr, nullptr, nullptr, nullptr};
+    if (x > 0)
+        neighbors[ChunkMesher::Neighbor::Left] = &gameState.getWorld().getChunk(x - 1, y, z);
+    if (x < RENDER_DISTANCE - 1)
+        neighbors[ChunkMesher::Neighbor::Right] = &gameState.getWorld().getChunk(x + 1, y, z);
+    if (z > 0)
+        neighbors[ChunkMesher::Neighbor::Back] = &gameState.getWorld().getChunk(x, y, z - 1);
+    if (z < RENDER_DISTANCE - 1)
+        neighbors[ChunkMesher::Neighbor::Front] = &gameState.getWorld().getChunk(x, y, z + 1);
+    if (y > 0)
+        neighbors[ChunkMesher::Neighbor::Bottom] = &gameState.getWorld().getChunk(x, y - 1, z);
+    if (y + 1 < RENDER_HEIGHT)
+        neighbors[ChunkMesher::Neighbor::Top] = &gameState.getWorld().getChunk(x, y + 1, z);
+    return neighbors;
 }
 
+/**
+ * @brief Appends the chunk instances at a level of detail, one bucket per face
+ * direction.
+ */
+template <typename InstanceVector>
 static
 void _evaluateChunk(
     const game::Chunk& chunk,
-    std::vector<VertexInstance>& instances,
-    const std::array<const game::Chunk*, ChunkNeighbor::Count>& neighbors // Don't count top/bottom yet
+    InstanceVector& instances,
+    const ChunkMesher::Neighbors& neighbors,
+    const u32 lod,
+    VertexBuffer::FaceOffsets& offsets
 ) {
-    constexpr u32 UPPER_LIMIT = CHUNK_SIZE - 1;
-    constexpr u32 LOWER_LIMIT = 0;
-
-    for (u32 z = 0; z < CHUNK_SIZE; ++z) {
-        for (u32 x = 0; x < CHUNK_SIZE; ++x) {
-            for (u32 y = 0; y < CHUNK_SIZE; ++y) {
-                const auto& block = chunk.getBlock(x, y, z);
+    ChunkMesher::FaceMasks masks;
+    ChunkMesher::computeFaceMasks(chunk, neighbors, lod, masks);
 
-                if (block.isVoid())
-                    continue;
-
-                const u16 blockId = (x << 8) | (y << 4) | z;
-                const u16 chunkId = chunk.getId();
-
-                // Check if block face is visible
-                if (y == UPPER_LIMIT || chunk.getBlock(x, y + 1, z).isVoid()) {
-                    instances.emplace_back(game::BlockFace::Top, block.getTextureId(game::BlockFace::Top), blockId, chunkId);
-                }
-                if (y == LOWER_LIMIT || chunk.getBlock(x, y - 1, z).isVoid()) {
-                    instances.emplace_back(game::BlockFace::Bottom, block.getTextureId(game::BlockFace::Bottom), blockId, chunkId);
-                }
-
-                if ((x != UPPER_LIMIT && chunk.getBlock(x + 1, y, z).isVoid()) || (x == UPPER_LIMIT && _isExposed(neighbors[ChunkNeighbor::Right], LOWER_LIMIT, y, z)))
-                    instances.emplace_back(game::BlockFace::Right, block.getTextureId(game::BlockFace::Right), blockId, chunkId);
-                if ((x != LOWER_LIMIT && chunk.getBlock(x - 1, y, z).isVoid()) || (x == LOWER_LIMIT && _isExposed(neighbors[ChunkNeighbor::Left], UPPER_LIMIT, y, z)))
-                    instances.emplace_back(game::BlockFace::Left, block.getTextureId(game::BlockFace::Left), blockId, chunkId);
-                if ((z != UPPER_LIMIT && chunk.getBlock(x, y, z + 1).isVoid()) || (z == UPPER_LIMIT && _isExposed(neighbors[ChunkNeighbor::Front], x, y, LOWER_LIMIT)))
-                    instances.emplace_back(game::BlockFace::Front, block.getTextureId(game::BlockFace::Front), blockId, chunkId);
-                if ((z != LOWER_LIMIT && chunk.getBlock(x, y, z - 1).isVoid()) || (z == LOWER_LIMIT && _isExposed(neighbors[ChunkNeighbor::Back], x, y, UPPER_LIMIT)))
-                    instances.emplace_back(game::BlockFace::Back, block.getTextureId(game::BlockFace::Back), blockId, chunkId);
-            }
-        }
+    for (u32 face = 0; face < VertexBuffer::FACE_COUNT; ++face) {
+        offsets[face] = instances.size();
+        ChunkMesher::emitFaces(chunk, masks, (game::BlockFace)face, lod, instances);
     }
+    offsets[VertexBuffer::FACE_COUNT] = instances.size();
 }
 
 #if ENABLE_FRUSTUM_CULLING
 
-std::vector<VertexInstance> VertexBuffer::_computeVertexInstances(
-    const game::GameState& gameState,
-    u32& visibleAABBs
-) {
-    std::vector<VertexInstance> instances;
+/**
+ * @brief Recreates the buffer when it cannot hold `instancesCount`
+ * instances, with 1 / SLOT_SLACK_DIVISOR more room so that the next edits
+ * do not rebuild it again.
+ */
+void VertexBuffer::_reserve(const Device& device, const u32 instancesCount) {
+    if (instancesCount <= ms_buffer.getMetadata().m_size)
+        return;
+
+    BufferMetadata metadata = ms_buffer.getMetadata();
+    metadata.m_size = instancesCount + instancesCount / SLOT_SLACK_DIVISOR;
+
+    ms_buffer.unmap(device);
+    ms_buffer.destroy(device);
+    ms_buffer.init(device, std::move(metadata));
+    ms_buffer.map(device);
+    LDEBUG("Vertex buffer grown to " << instancesCount << " instances.");
+}
 
-    const BoundingFrustum frustum(gameState.getController().getCamera());
+/**
+ * @brief Called every frame: instances live in the frame arena. Only the
+ * selected level of each visible chunk is meshed, level by level.
+ */
+mem::FrameVector<VertexInstance> VertexBuffer::_computeVertexInstances(const game::GameState& gameState) {
+    mem::FrameVector<VertexInstance> instances;
+    instances.reserve(ms_maxVertexInstanceCount);
 
     // Retrieve blocks and cull invisible faces
-    for (u32 z = 0; z < RENDER_DISTANCE; ++z) {
-        for (u32 x = 0; x < RENDER_DISTANCE; ++x) {
-            for (u32 y = 0; y < RENDER_HEIGHT; ++y) {
-                auto& chunk = gameState.getWorld().getChunk(x, y, z);
-
-                std::array<const game::Chunk*, ChunkNeighbor::Count>  neighbors = {nullptr, nullptr, nullptr, nullptr};
-                if (x > 0)
-                    neighbors[ChunkNeighbor::Left] = &gameState.getWorld().getChunk(x - 1, y, z);
-                if (x < RENDER_DISTANCE - 1)
-                    neighbors[ChunkNeighbor::Right] = &gameState.getWorld().getChunk(x + 1, y, z);
-                if (z > 0)
-                    neighbors[ChunkNeighbor::Back] = &gameState.getWorld().getChunk(x, y, z - 1);
-                if (z < RENDER_DISTANCE - 1)
-                    neighbors[ChunkNeighbor::Front] = &gameState.getWorld().getChunk(x, y, z + 1);
-
-                const BoundingBox AABB = chunk.getBoundingBox();
-
-                if (AABB.isVisible(frustum)) {
-                    ++visibleAABBs;
-                    _evaluateChunk(chunk, instances, neighbors);
-                }
-            }
+    for (u32 lod = 0; lod < LOD_COUNT; ++lod) {
+        const u32 first = instances.size();
+
+        for (u32 i = 0; i < RENDER_VOLUME; ++i) {
+            ChunkMesh& mesh = ms_chunkMeshes[i];
+            if (!mesh.m_visible || mesh.m_lod != lod)
+                continue;
+
+            const u32 y = i % RENDER_HEIGHT;
+            const u32 x = (i / RENDER_HEIGHT) % RENDER_DISTANCE;
+            const u32 z = i / (RENDER_HEIGHT * RENDER_DISTANCE);
+
+            _evaluateChunk(gameState.getWorld().getChunk(x, y, z), instances, _getNeighbors(gameState, x, y, z), lod, mesh.m_offsets[lod]);
         }
+        ms_lodRanges[lod] = { first, (u32)instances.size() - first, lod };
     }
     return instances;
 }
 
 #else
 
+/**
+ * @brief Meshes every level of every chunk once. The buffer holds all of
+ * level 0, then all of level 1, etc. Each chunk level sits in its own slot,
+ * padded to leave room for edits.
+ */
 std::vector<VertexInstance> VertexBuffer::_computeVertexInstances(const game::GameState& gameState) {
-    std::vector<VertexInstance> instances;
+    // Each chunk is meshed in its own vector, then concatenated in chunk z/x/y order
+    std::vector<std::vector<VertexInstance>> chunkInstances(LOD_COUNT * RENDER_VOLUME);
+
+    for (u32 lod = 0; lod < LOD_COUNT; ++lod) {
+        const auto meshingStart = std::chrono::steady_clock::now();
+
+        jobs::JobSystem::parallelFor(RENDER_VOLUME, RENDER_HEIGHT, [&](const u32 i) {
+            const u32 y = i % RENDER_HEIGHT;
+            const u32 x = (i / RENDER_HEIGHT) % RENDER_DISTANCE;
+            const u32 z = i / (RENDER_HEIGHT * RENDER_DISTANCE);
+
+            _evaluateChunk(
+                gameState.getWorld().getChunk(x, y, z),
+                chunkInstances[lod * RENDER_VOLUME + i],
+                _getNeighbors(gameState, x, y, z),
+                lod,
+                ms_chunkMeshes[i].m_offsets[lod]);
+        });
+
+        const f32 meshingTime = std::chrono::duration<f32, std::milli>(std::chrono::steady_clock::now() - meshingStart).count();
+        u32 facesCount = 0;
+        for (u32 i = 0; i < RENDER_VOLUME; ++i)
+            facesCount += chunkInstances[lod * RENDER_VOLUME + i].size();
+        LINFO("Meshed " << facesCount << " faces at LOD " << lod << " in " << meshingTime << " ms.");
+    }
 
-    // Retrieve blocks and cull invisible faces
-    for (u32 z = 0; z < RENDER_DISTANCE; ++z) {
-        for (u32 x = 0; x < RENDER_DISTANCE; ++x) {
-            for (u32 y = 0; y < RENDER_HEIGHT; ++y) {
-                auto& chunk = gameState.getWorld().getChunk(x, y, z);
-
-                std::array<const game::Chunk*, ChunkNeighbor::Count>  neighbors = {nullptr, nullptr, nullptr, nullptr};
-                if (x > 0)
-                    neighbors[ChunkNeighbor::Left] = &gameState.getWorld().getChunk(x - 1, y, z);
-                if (x < RENDER_DISTANCE - 1)
-                    neighbors[ChunkNeighbor::Right] = &gameState.getWorld().getChunk(x + 1, y, z);
-                if (z > 0)
-                    neighbors[ChunkNeighbor::Back] = &gameState.getWorld().getChunk(x, y, z - 1);
-                if (z < RENDER_DISTANCE - 1)
-                    neighbors[ChunkNeighbor::Front] = &gameState.getWorld().getChunk(x, y, z + 1);
-
-                _evaluateChunk(chunk, instances, neighbors);
-            }
+    // Chunk offsets were local to their own vector
+    u32 instancesCount = 0;
+    for (u32 lod = 0; lod < LOD_COUNT; ++lod) {
+        ms_lodRanges[lod] = { instancesCount, 0, lod };
+        for (u32 i = 0; i < RENDER_VOLUME; ++i) {
+            const u32 count = chunkInstances[lod * RENDER_VOLUME + i].size();
+            const u32 slack = std::max(count / SLOT_SLACK_DIVISOR, SLOT_MIN_SLACK);
+
+            ms_chunkMeshes[i].m_slots[lod] = { instancesCount, count + slack };
+            for (u32& offset: ms_chunkMeshes[i].m_offsets[lod])
+                offset += instancesCount;
+            instancesCount += count + slack;
+        }
+        ms_lodRanges[lod].m_instanceCount = instancesCount - ms_lodRanges[lod].m_firstInstance;
+    }
+
+    std::vector<VertexInstance> instances;
+    instances.reserve(instancesCount);
+    for (u32 lod = 0; lod < LOD_COUNT; ++lod) {
+        for (u32 i = 0; i < RENDER_VOLUME; ++i) {
+            auto& chunk = chunkInstances[lod * RENDER_VOLUME + i];
+            instances.insert(instances.end(), std::make_move_iterator(chunk.begin()), std::make_move_iterator(chunk.end()));
+            while (instances.size() < ms_chunkMeshes[i].m_slots[lod].m_first + ms_chunkMeshes[i].m_slots[lod].m_capacity)
+                instances.push_back(VertexInstance::createPadding());
         }
     }
     return instances;
 }
 
+/**
+ * @brief Creates the device buffer from a full meshing of the world. The
+ * staging buffer is kept mapped, chunk patches go through it.
+ */
+void VertexBuffer::_upload(
+    const Device& device,
+    const ICommandBuffer* cmdBuffer,
+    const game::GameState& gameState
+) {
+    const auto instances = _computeVertexInstances(gameState);
+    ms_instancesCount = instances.size();
+
+    BufferMetadata metadata{};
+    metadata.m_format = sizeof(VertexInstance);
+    metadata.m_size = ms_instancesCount;
+    metadata.m_usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    metadata.m_properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+
+    ms_buffer.init(device, std::move(metadata));
+
+    ms_stagingBuffer = ms_buffer.createStagingBuffer(device);
+    ms_stagingBuffer.map(device);
+    ms_stagingBuffer.copyFrom(instances.data(), sizeof(VertexInstance) * ms_instancesCount, 0);
+
+    cmdBuffer->reset();
+    cmdBuffer->startRecording();
+    ms_buffer.copyBuffer(cmdBuffer, ms_stagingBuffer);
+    cmdBuffer->stopRecording();
+    cmdBuffer->awaitEndOfRecording(device);
+}
+
+/**
+ * @brief Meshes every level of a chunk again into its slots, through the
+ * staging buffer, and queues the copy of the slots.
+ *
+ * @return false if a level no longer fits in its slot, leaving the slots
+ * untouched.
+ */
+bool VertexBuffer::_remeshChunk(
+    const game::GameState& gameState,
+    const u32 index,
+    mem::FrameVector<VkBufferCopy>& regions
+) {
+    const u32 y = index % RENDER_HEIGHT;
+    const u32 x = (index / RENDER_HEIGHT) % RENDER_DISTANCE;
+    const u32 z = index / (RENDER_HEIGHT * RENDER_DISTANCE);
+
+    const game::Chunk&              chunk = gameState.getWorld().getChunk(x, y, z);
+    const ChunkMesher::Neighbors    neighbors = _getNeighbors(gameState, x, y, z);
+    ChunkMesh&                      mesh = ms_chunkMeshes[index];
+
+    std::array<mem::FrameVector<VertexInstance>, LOD_COUNT> levels;
+    std::array<FaceOffsets, LOD_COUNT>                      offsets;
+    for (u32 lod = 0; lod < LOD_COUNT; ++lod) {
+        levels[lod].reserve(mesh.m_slots[lod].m_capacity);
+        _evaluateChunk(chunk, levels[lod], neighbors, lod, offsets[lod]);
+        if (levels[lod].size() > mesh.m_slots[lod].m_capacity)
+            return false;
+    }
+
+    for (u32 lod = 0; lod < LOD_COUNT; ++lod) {
+        const Slot& slot = mesh.m_slots[lod];
+        while (levels[lod].size() < slot.m_capacity)
+            levels[lod].push_back(VertexInstance::createPadding());
+
+        for (u32 face = 0; face <= FACE_COUNT; ++face)
+            mesh.m_offsets[lod][face] = slot.m_first + offsets[lod][face];
+
+        const u32 byteOffset = slot.m_first * sizeof(VertexInstance);
+        const u32 byteSize = slot.m_capacity * sizeof(VertexInstance);
+        ms_stagingBuffer.copyFrom(levels[lod].data(), byteSize, byteOffset);
+        regions.push_back({ byteOffset, byteOffset, byteSize });
+    }
+    return true;
+}
+
 #endif
 
 /* ========================================================================== */
 /*                                    OTHER                                   */
 /* ========================================================================== */
 
+/**
+ * @brief Largest face count among the levels: any of them may be selected.
+ */
 static
 u32 _evaluateChunkInstances(
     const game::Chunk& chunk,
-    const std::array<const game::Chunk*, ChunkNeighbor::Count>& neighbors // Don't count top/bottom yet
+    const ChunkMesher::Neighbors& neighbors
 ) {
-    constexpr u32 UPPER_LIMIT = CHUNK_SIZE - 1;
-    constexpr u32 LOWER_LIMIT = 0;
+    u32 count = 0;
+    for (u32 lod = 0; lod < VertexBuffer::LOD_COUNT; ++lod) {
+        ChunkMesher::FaceMasks masks;
+        ChunkMesher::computeFaceMasks(chunk, neighbors, lod, masks);
+        count = std::max(count, ChunkMesher::countFaces(masks, lod));
+    }
+    return count;
+}
 
-    u32 instances = 0;
+void VertexBuffer::computeMaxVertexInstanceCount(const game::GameState& gameState) {
+    ms_chunkInstanceCounts.assign(RENDER_VOLUME, 0);
 
-    for (u32 z = 0; z < CHUNK_SIZE; ++z) {
-        for (u32 x = 0; x < CHUNK_SIZE; ++x) {
-            for (u32 y = 0; y < CHUNK_SIZE; ++y) {
-                if (chunk.getBlock(x, y, z).isVoid())
-                    continue;
+    jobs::JobSystem::parallelFor(RENDER_VOLUME, RENDER_HEIGHT, [&](const u32 i) {
+        const u32 y = i % RENDER_HEIGHT;
+        const u32 x = (i / RENDER_HEIGHT) % RENDER_DISTANCE;
+        const u32 z = i / (RENDER_HEIGHT * RENDER_DISTANCE);
 
-                // Check if block face is visible
-                if (y == UPPER_LIMIT || chunk.getBlock(x, y + 1, z).isVoid()) ++instances;
-                if (y == LOWER_LIMIT || chunk.getBlock(x, y - 1, z).isVoid()) ++instances;
-
-                if ((x != UPPER_LIMIT && chunk.getBlock(x + 1, y, z).isVoid()) || (x == UPPER_LIMIT && _isExposed(neighbors[ChunkNeighbor::Right], LOWER_LIMIT, y, z)))
-                    ++instances;
-                if ((x != LOWER_LIMIT && chunk.getBlock(x - 1, y, z).isVoid()) || (x == LOWER_LIMIT && _isExposed(neighbors[ChunkNeighbor::Left], UPPER_LIMIT, y, z)))
-                    ++instances;
-                if ((z != UPPER_LIMIT && chunk.getBlock(x, y, z + 1).isVoid()) || (z == UPPER_LIMIT && _isExposed(neighbors[ChunkNeighbor::Front], x, y, LOWER_LIMIT)))
-                    ++instances;
-                if ((z != LOWER_LIMIT && chunk.getBlock(x, y, z - 1).isVoid()) || (z == LOWER_LIMIT && _isExposed(neighbors[ChunkNeighbor::Back], x, y, UPPER_LIMIT)))
-                    ++instances;
-            }
-        }
-    }
-    return instances;
+        ms_chunkInstanceCounts[i] = _evaluateChunkInstances(gameState.getWorld().getChunk(x, y, z), _getNeighbors(gameState, x, y, z));
+    });
+
+    ms_maxVertexInstanceCount = 0;
+    for (const u32 count: ms_chunkInstanceCounts)
+        ms_maxVertexInstanceCount += count;
 }
 
-void VertexBuffer::computeMaxVertexInstanceCount(const game::GameState& gameState) {
-    std::array<const game::Chunk*, ChunkNeighbor::Count>  neighbors = {nullptr, nullptr, nullptr, nullptr};
-
-    for (u32 z = 0; z < RENDER_DISTANCE; ++z) {
-        for (u32 x = 0; x < RENDER_DISTANCE; ++x) {
-            for (u32 y = 0; y < RENDER_HEIGHT; ++y) {
-                auto& chunk = gameState.getWorld().getChunk(x, y, z);
-
-                std::array<const game::Chunk*, ChunkNeighbor::Count>  neighbors = {nullptr, nullptr, nullptr, nullptr};
-                if (x > 0)
-                    neighbors[ChunkNeighbor::Left] = &gameState.getWorld().getChunk(x - 1, y, z);
-                if (x < RENDER_DISTANCE - 1)
-                    neighbors[ChunkNeighbor::Right] = &gameState.getWorld().getChunk(x + 1, y, z);
-                if (z > 0)
-                    neighbors[ChunkNeighbor::Back] = &gameState.getWorld().getChunk(x, y, z - 1);
-                if (z < RENDER_DISTANCE - 1)
-                    neighbors[ChunkNeighbor::Front] = &gameState.getWorld().getChunk(x, y, z + 1);
-
-                ms_maxVertexInstanceCount += _evaluateChunkInstances(chunk, neighbors);
-            }
-        }
-    }
+/**
+ * @brief Keeps the instance bound in step with an edited chunk.
+ */
+void VertexBuffer::_countChunkInstances(const game::GameState& gameState, const u32 index) {
+    const u32 y = index % RENDER_HEIGHT;
+    const u32 x = (index / RENDER_HEIGHT) % RENDER_DISTANCE;
+    const u32 z = index / (RENDER_HEIGHT * RENDER_DISTANCE);
+
+    const u32 count = _evaluateChunkInstances(gameState.getWorld().getChunk(x, y, z), _getNeighbors(gameState, x, y, z));
+    ms_maxVertexInstanceCount += count - ms_chunkInstanceCounts[index];
+    ms_chunkInstanceCounts[index] = count;
 }
 
 } // namespace vox::gfx
\ No newline at end of file
@@ -6,7 +6,7 @@
 /*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2024/05/20 13:34:05 by etran             #+#    #+#             */
-/*   Updated: 2024/06/12 12:07:53 by etran            ###   ########.fr       */
+/*   Updated: 2024/07/08 10:41:17 by etran            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -16,18 +16,111 @@
 #include <vector>
 #include <stack>
 
+#include "vox_decl.h"
+#include "game_decl.h"
 #include "buffer.h"
 #include "vertex.h"
+#include "chunk_layout.h"
+#include "bounding_box.h"
+#include "chunk_visibility.h"
+#include "occlusion_culler.h"
+#include "draw_range_list.h"
+#include "frame_arena.h"
+#include "batch.h"
+#include "pipeline_decl.h"
 
 namespace game {
 class GameState;
 class Chunk;
 }
 
+namespace ui {
+struct Camera;
+}
+
 namespace vox::gfx {
 
 class VertexBuffer final {
 public:
+    /* ====================================================================== */
+    /*                             STATIC MEMBERS                             */
+    /* ====================================================================== */
+
+    static constexpr u32    FACE_COUNT = 6;
+
+    /**
+     * @brief Level `lod` meshes cells of 2^lod blocks. A chunk switches to the
+     * next level past LOD_DISTANCES[lod] blocks from the camera, the hysteresis
+     * margin keeps it from flickering around the threshold.
+     */
+    static constexpr u32                LOD_COUNT = ENABLE_LOD ? 3 : 1;
+    static_assert(LOD_COUNT <= 1U << game::WorldInstanceLayout::LOD_BITS, "Levels are packed in the instance data.");
+    static constexpr std::array<f32, 2> LOD_DISTANCES = { 64.0f, 128.0f };
+    static constexpr f32                LOD_HYSTERESIS = 8.0f;
+
+    /**
+     * @brief Only chunks this close to the camera act as occluders.
+     */
+    static constexpr f32    OCCLUDER_DISTANCE = 96.0f;
+
+    /**
+     * @brief Edited chunks are remeshed in place: each chunk level owns a
+     * slot of the buffer with 1 / SLOT_SLACK_DIVISOR more room than needed
+     * (SLOT_MIN_SLACK at least), the rest being padding instances. The
+     * buffer is only rebuilt when a remeshed chunk outgrows its slot.
+     */
+    static constexpr u32    SLOT_SLACK_DIVISOR = 4;
+    static constexpr u32    SLOT_MIN_SLACK = 16;
+
+    /**
+     * @brief Main thread milliseconds spent remeshing per frame, the
+     * remaining chunks wait for the next frames.
+     */
+    static constexpr f32    REMESH_BUDGET = 2.0f;
+
+    /* ====================================================================== */
+    /*                                TYPEDEFS                                */
+    /* ====================================================================== */
+
+    using DrawRange = gfx::DrawRange;
+
+    using FaceOffsets = std::array<u32, FACE_COUNT + 1>;
+
+    struct Slot {
+        u32 m_first = 0;
+        u32 m_capacity = 0;
+    };
+
+    /**
+     * @brief Instances of a chunk are grouped by face direction (game::BlockFace
+     * order): bucket `f` of level `lod` spans
+     * [m_offsets[lod][f], m_offsets[lod][f + 1]).
+     */
+    struct ChunkMesh {
+        BoundingBox                         m_boundingBox;
+        std::array<FaceOffsets, LOD_COUNT>  m_offsets{};
+        std::array<Slot, LOD_COUNT>         m_slots{};
+        u32                                 m_lod = 0;
+        u32                                 m_solidHeight = 0; // Fully solid below
+        u32                                 m_topHeight = CHUNK_HEIGHT; // Empty above
+        bool                                m_visible = true;
+    };
+
+#if ENABLE_GPU_CULLING
+    /**
+     * @brief Chunk record of the culling pass (cull.compute): its box and
+     * the instances of its face buckets at the selected level, a zero count
+     * for buckets dropped on the CPU.
+     */
+    struct CullChunk {
+        std::array<f32, 4>          m_min;
+        std::array<f32, 4>          m_max;
+        std::array<u32, FACE_COUNT> m_first;
+        std::array<u32, FACE_COUNT> m_count;
+    };
+    static_assert(sizeof(CullChunk) == 80, "Laid out as the std430 shader struct.");
+#endif
+
     /* ====================================================================== */
     /*                                 METHODS                                */
     /* ====================================================================== */
@@ -50,13 +143,28 @@ public:
 #endif
     static void     destroy(const Device& device);
 
+    static void     updateChunks(const Device& device, const ICommandBuffer* cmdBuffer, game::GameState& gameState);
+
     static void     bind(const ICommandBuffer* cmdBuffer);
+    static void     updateDrawRanges(const game::GameState& gameState);
+#if ENABLE_GPU_CULLING
+    static void     drawCulled(const ICommandBuffer* cmdBuffer, const CullPhase phase);
+#endif
 
     /* ====================================================================== */
 
     static const Buffer&   getBuffer() noexcept;
     static u32             getInstancesCount() noexcept;
 
+    static const std::vector<DrawRange>&   getDrawRanges() noexcept;
+    static DrawRange                        getLodRange(const u32 lod) noexcept;
+
+#if ENABLE_GPU_CULLING
+    static const Buffer&   getCullChunks() noexcept;
+    static const Buffer&   getDrawCommands() noexcept;
+    static const Buffer&   getChunkVisibility() noexcept;
+#endif
+
     /* ====================================================================== */
 
     static void computeMaxVertexInstanceCount(const game::GameState& gameState);
@@ -67,18 +175,62 @@ private:
     /* ====================================================================== */
 
     static Buffer   ms_buffer;
+#if !ENABLE_FRUSTUM_CULLING
+    static Buffer   ms_stagingBuffer;
+#endif
+
+#if ENABLE_GPU_CULLING
+    // Chunk records in, indirect draws of both phases out, and the chunks
+    // visible last frame, kept by the late phase
+    static Buffer   ms_cullChunks;
+    static Buffer   ms_drawCommands;
+    static Buffer   ms_chunkVisibility;
+#endif
 
     static u32      ms_instancesCount;
     static u32      ms_visibleAABBsCount;
 
     static u32      ms_maxVertexInstanceCount;
 
+    // Largest instance count of each chunk among its levels, in mesh order
+    static std::vector<u32> ms_chunkInstanceCounts;
+
+    static std::vector<ChunkMesh>   ms_chunkMeshes;
+    static DrawRangeList            ms_drawRanges;
+
+    static std::array<DrawRange, LOD_COUNT> ms_lodRanges;
+
+    static ChunkVisibility  ms_visibility;
+    static OcclusionCuller  ms_occlusionCuller;
+
+    // Bounding boxes of ms_chunkMeshes, laid out for the batch plane tests
+    static math::Vect3Soa   ms_boxCenters;
+    static math::Vect3Soa   ms_boxHalfExtents;
+    static std::vector<f32> ms_planeDistances;
+
     /* ====================================================================== */
     /*                                 METHODS                                */
     /* ====================================================================== */
 
+    static void     _initChunkMeshes(const game::GameState& gameState);
+#if ENABLE_GPU_CULLING
+    static void     _initCullBuffers(const Device& device);
+#endif
+    static void     _selectLods(const math::Vect3& eye) noexcept;
+    static u32      _updateVisibility(const ui::Camera& camera);
+    static void     _cullOccludedChunks(const ui::Camera& camera) noexcept;
+    static void     _measureChunk(const game::GameState& gameState, const u32 index);
+    static void     _countChunkInstances(const game::GameState& gameState, const u32 index);
+
+#if ENABLE_FRUSTUM_CULLING
+    static void     _reserve(const Device& device, const u32 instancesCount);
+#else
+    static void     _upload(const Device& device, const ICommandBuffer* cmdBuffer, const game::GameState& gameState);
+    static bool     _remeshChunk(const game::GameState& gameState, const u32 index, mem::FrameVector<VkBufferCopy>& regions);
+#endif
+
 #if ENABLE_FRUSTUM_CULLING
-    static std::vector<VertexInstance> _computeVertexInstances(const game::GameState& gameState, u32& visibleAABBs);
+    static mem::FrameVector<VertexInstance> _computeVertexInstances(const game::GameState& gameState);
 #else
     static std::vector<VertexInstance> _computeVertexInstances(const game::GameState& gameState);
 #endif
@@ -6,7 +6,7 @@
 /*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2024/06/13 17:50:52 by etran             #+#    #+#             */
-/*   Updated: 2024/06/25 14:59:02 by etran            ###   ########.fr       */
+/*   Updated: 2024/07/08 10:41:17 by etran            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -87,15 +87,17 @@ void DeferredRenderPass::_createRenderPass(const Device& device, const RenderPas
     // Attachments
     std::array<VkAttachmentDescription, ATTACHMENT_COUNT> attachments{};
 
-    auto createAtt = [](const ImageMetaData& imgData){
+    const VkAttachmentLoadOp loadOp = deferredInfo->m_loadOp;
+    auto createAtt = [loadOp](const ImageMetaData& imgData){
         VkAttachmentDescription attDesc{};
         attDesc.format = imgData.m_format;
         attDesc.samples = imgData.m_sampleCount;
-        attDesc.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        attDesc.loadOp = loadOp;
         attDesc.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
         attDesc.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
         attDesc.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-        attDesc.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        // Loaded targets are left by the previous pass in their final layout
+        attDesc.initialLayout = loadOp == VK_ATTACHMENT_LOAD_OP_LOAD ? imgData.m_layoutData.m_layout : VK_IMAGE_LAYOUT_UNDEFINED;
         attDesc.finalLayout = imgData.m_layoutData.m_layout;
 
         return attDesc;
@@ -151,6 +153,15 @@ void DeferredRenderPass::_createRenderPass(const Device& device, const RenderPas
     dependencies[0].srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
     dependencies[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
     dependencies[0].dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+#if ENABLE_GPU_CULLING
+    // Depth was reduced to the Hi-Z pyramid by the previous frame or pass
+    dependencies[0].srcStageMask |= VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+    dependencies[0].dstStageMask |= VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    dependencies[0].dstAccessMask |= VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    if (loadOp == VK_ATTACHMENT_LOAD_OP_LOAD)
+        dependencies[0].dstAccessMask |= VK_ACCESS_COLOR_ATTACHMENT_READ_BIT;
+    dependencies[0].dependencyFlags = 0;
+#endif
 
     dependencies[1].srcSubpass = 0;
     dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
@@ -159,6 +170,13 @@ void DeferredRenderPass::_createRenderPass(const Device& device, const RenderPas
     dependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
     dependencies[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
     dependencies[1].dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+#if ENABLE_GPU_CULLING
+    // Depth is then reduced to the Hi-Z pyramid
+    dependencies[1].srcStageMask |= VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    dependencies[1].dstStageMask |= VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+    dependencies[1].srcAccessMask |= VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    dependencies[1].dependencyFlags = 0;
+#endif
 
     // Render pass
     VkRenderPassCreateInfo renderPassInfo{};
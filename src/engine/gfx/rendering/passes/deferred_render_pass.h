@@ -6,7 +6,7 @@
 /*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2024/06/13 17:25:43 by etran             #+#    #+#             */
-/*   Updated: 2024/06/25 12:29:53 by etran            ###   ########.fr       */
+/*   Updated: 2024/07/08 10:41:17 by etran            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -48,6 +48,9 @@ struct DeferredRenderPassInfo final: public RenderPassInfo {
     const ImageBuffer& m_normalViewTexture;
     const ImageBuffer& m_positionViewTexture;
 #endif
+
+    // LOAD draws over a previous pass on the same targets
+    VkAttachmentLoadOp m_loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
 };
 
 class DeferredRenderPass final: public RenderPass {
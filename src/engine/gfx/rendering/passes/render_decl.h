@@ -6,7 +6,7 @@
 /*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2024/03/07 14:55:18 by etran             #+#    #+#             */
-/*   Updated: 2024/06/16 22:01:06 by etran            ###   ########.fr       */
+/*   Updated: 2024/07/08 10:41:17 by etran            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -22,6 +22,10 @@ enum class RenderPassIndex: u32 {
     Main,
     Deferred,
 
+#if ENABLE_GPU_CULLING
+    DeferredLate,
+#endif
+
 #if ENABLE_SSAO
     Ssao,
     SsaoBlur,
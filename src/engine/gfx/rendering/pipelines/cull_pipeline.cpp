@@ -0,0 +1,102 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   cull_pipeline.cpp                                  :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/07/08 10:27:36 by etran             #+#    #+#             */
+/*   Updated: 2024/07/08 10:27:36 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "cull_pipeline.h"
+#include "device.h"
+#include "icommand_buffer.h"
+#include "pipeline_layout.h"
+#include "game_decl.h"
+#include "debug.h"
+
+#include <stdexcept>
+
+namespace vox::gfx {
+
+/* ========================================================================== */
+/*                                   PUBLIC                                   */
+/* ========================================================================== */
+
+/**
+ * @note Compute pipeline: the render pass is unused. The phase is the
+ * shader specialization constant 0.
+ */
+void CullPipeline::init(
+    const Device& device,
+    const VkRenderPass& renderPass,
+    const PipelineLayout& pipelineLayout
+) {
+    m_pipelineLayout = &pipelineLayout;
+
+    const VkShaderModule computeModule = _createShaderModule(device, "obj/shaders/cull.compute.spv");
+
+    VkSpecializationMapEntry phaseEntry{};
+    phaseEntry.constantID = 0;
+    phaseEntry.offset = 0;
+    phaseEntry.size = sizeof(m_phase);
+
+    VkSpecializationInfo specialization{};
+    specialization.mapEntryCount = 1;
+    specialization.pMapEntries = &phaseEntry;
+    specialization.dataSize = sizeof(m_phase);
+    specialization.pData = &m_phase;
+
+    VkComputePipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipelineInfo.stage.stage = (VkShaderStageFlagBits)ShaderType::CS;
+    pipelineInfo.stage.module = computeModule;
+    pipelineInfo.stage.pName = "main";
+    pipelineInfo.stage.pSpecializationInfo = &specialization;
+    pipelineInfo.layout = m_pipelineLayout->getLayout();
+    pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
+    pipelineInfo.basePipelineIndex = -1;
+
+    if (vkCreateComputePipelines(device.getDevice(), VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_pipeline) != VK_SUCCESS)
+        throw std::runtime_error("Failed to assemble cull pipeline.");
+
+    vkDestroyShaderModule(device.getDevice(), computeModule, nullptr);
+
+    LDEBUG("Cull pipeline assembled: " << m_pipeline);
+}
+
+void CullPipeline::destroy(const Device& device) {
+    vkDestroyPipeline(device.getDevice(), m_pipeline, nullptr);
+
+    LDEBUG("Cull pipeline destroyed.");
+}
+
+/* ========================================================================== */
+
+/**
+ * @note The cull push constant is bound beforehand, as the camera is for
+ * the graphics pipelines.
+ */
+void CullPipeline::record(const ICommandBuffer* cmdBuffer) const {
+    _bindCompute(cmdBuffer);
+    vkCmdDispatch(cmdBuffer->getBuffer(), (RENDER_VOLUME + CULL_GROUP_SIZE - 1) / CULL_GROUP_SIZE, 1, 1);
+
+    // Draws of the phase follow
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+
+    vkCmdPipelineBarrier(
+        cmdBuffer->getBuffer(),
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+        0,
+        1, &barrier,
+        0, nullptr,
+        0, nullptr);
+}
+
+} // namespace vox::gfx
@@ -0,0 +1,71 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   cull_pipeline.h                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/07/08 10:27:36 by etran             #+#    #+#             */
+/*   Updated: 2024/07/08 10:27:36 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#pragma once
+
+#include "pipeline.h"
+#include "pipeline_decl.h"
+
+namespace vox::gfx {
+
+class ICommandBuffer;
+
+/**
+ * @brief Writes the indirect draws of a culling phase, one chunk per
+ * invocation.
+ *
+ * Early: chunks visible last frame, untested.
+ * Late: every chunk tested against the Hi-Z pyramid of the early draws; those
+ * found visible that were not drawn early are drawn now, and the result is
+ * kept for the next frame.
+ */
+class CullPipeline final: public Pipeline {
+public:
+    /* ====================================================================== */
+    /*                                TYPEDEFS                                */
+    /* ====================================================================== */
+
+    using super = Pipeline;
+
+    /* ====================================================================== */
+    /*                                 METHODS                                */
+    /* ====================================================================== */
+
+    CullPipeline(const CullPhase phase): m_phase(phase) {}
+    ~CullPipeline() = default;
+
+    CullPipeline() = delete;
+    CullPipeline(CullPipeline&& other) = delete;
+    CullPipeline(const CullPipeline& other) = delete;
+    CullPipeline& operator=(CullPipeline&& other) = delete;
+    CullPipeline& operator=(const CullPipeline& other) = delete;
+
+    /* ====================================================================== */
+
+    void    init(
+        const Device& device,
+        const VkRenderPass& renderPass,
+        const PipelineLayout& pipelineLayout) override;
+    void    destroy(const Device& device) override;
+
+    void    record(const ICommandBuffer* cmdBuffer) const override;
+
+private:
+    /* ====================================================================== */
+    /*                                  DATA                                  */
+    /* ====================================================================== */
+
+    const CullPhase m_phase;
+
+}; // class CullPipeline
+
+} // namespace vox::gfx
@@ -6,7 +6,7 @@
 /*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2024/06/13 17:09:22 by etran             #+#    #+#             */
-/*   Updated: 2024/06/25 15:05:36 by etran            ###   ########.fr       */
+/*   Updated: 2024/07/08 10:41:17 by etran            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -15,6 +15,7 @@
 #include "icommand_buffer.h"
 #include "vertex_buffer.h"
 #include "pipeline_layout.h"
+#include "push_constant.h"
 #include "vox_decl.h"
 #include "debug.h"
 
@@ -154,7 +155,14 @@ void DeferredPipeline::record(const ICommandBuffer* cmdBuffer) const {
     cmdBuffer->bindPipeline(m_pipeline);
     VertexBuffer::bind(cmdBuffer);
 
-    vkCmdDraw(cmdBuffer->getBuffer(), 4, VertexBuffer::getInstancesCount(), 0, 0);
+#if ENABLE_GPU_CULLING
+    // Draws written by the culling pass of the phase
+    VertexBuffer::drawCulled(cmdBuffer, m_phase);
+#else
+    // Only the face buckets that may look at the camera, instances carry their level of detail
+    for (const VertexBuffer::DrawRange& range: VertexBuffer::getDrawRanges())
+        vkCmdDraw(cmdBuffer->getBuffer(), 4, range.m_instanceCount, 0, range.m_firstInstance);
+#endif
 }
 
 } // namespace vox::gfx
\ No newline at end of file
@@ -6,13 +6,14 @@
 /*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2024/06/13 17:04:18 by etran             #+#    #+#             */
-/*   Updated: 2024/06/16 15:14:01 by etran            ###   ########.fr       */
+/*   Updated: 2024/07/08 10:41:17 by etran            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #pragma once
 
 #include "pipeline.h"
+#include "pipeline_decl.h"
 
 namespace game {
 class GameState;
@@ -45,7 +46,7 @@ public:
     /*                                 METHODS                                */
     /* ====================================================================== */
 
-    DeferredPipeline() = default;
+    DeferredPipeline(const CullPhase phase = CullPhase::Early): m_phase(phase) {}
     ~DeferredPipeline() = default;
 
     DeferredPipeline(DeferredPipeline&& other) = delete;
@@ -70,6 +71,13 @@ private:
 
     static constexpr u32    SHADER_STAGE_COUNT = (u32)ShaderStage::Count;
 
+    /* ====================================================================== */
+    /*                                  DATA                                  */
+    /* ====================================================================== */
+
+    // Indirect draws recorded with ENABLE_GPU_CULLING
+    const CullPhase m_phase;
+
 }; // class DeferredPipeline
 
 } // namespace vox::gfx
\ No newline at end of file
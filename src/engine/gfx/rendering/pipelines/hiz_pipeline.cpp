@@ -0,0 +1,118 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   hiz_pipeline.cpp                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/07/08 10:27:36 by etran             #+#    #+#             */
+/*   Updated: 2024/07/08 10:27:36 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "hiz_pipeline.h"
+#include "device.h"
+#include "icommand_buffer.h"
+#include "pipeline_layout.h"
+#include "push_constant.h"
+#include "texture_table.h"
+#include "hiz_texture.h"
+#include "game_decl.h"
+#include "debug.h"
+
+#include <stdexcept>
+
+#if ENABLE_GPU_CULLING
+
+namespace vox::gfx {
+
+/* ========================================================================== */
+/*                                   PUBLIC                                   */
+/* ========================================================================== */
+
+/**
+ * @note Compute pipeline: the render pass is unused.
+ */
+void HiZPipeline::init(
+    const Device& device,
+    const VkRenderPass& renderPass,
+    const PipelineLayout& pipelineLayout
+) {
+    m_pipelineLayout = &pipelineLayout;
+
+    const VkShaderModule computeModule = _createShaderModule(device, "obj/shaders/hiz.compute.spv");
+
+    VkComputePipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipelineInfo.stage.stage = (VkShaderStageFlagBits)ShaderType::CS;
+    pipelineInfo.stage.module = computeModule;
+    pipelineInfo.stage.pName = "main";
+    pipelineInfo.layout = m_pipelineLayout->getLayout();
+    pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
+    pipelineInfo.basePipelineIndex = -1;
+
+    if (vkCreateComputePipelines(device.getDevice(), VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_pipeline) != VK_SUCCESS)
+        throw std::runtime_error("Failed to assemble hi-z pipeline.");
+
+    vkDestroyShaderModule(device.getDevice(), computeModule, nullptr);
+
+    LDEBUG("Hi-Z pipeline assembled: " << m_pipeline);
+}
+
+void HiZPipeline::destroy(const Device& device) {
+    vkDestroyPipeline(device.getDevice(), m_pipeline, nullptr);
+
+    LDEBUG("Hi-Z pipeline destroyed.");
+}
+
+/* ========================================================================== */
+
+/**
+ * @brief Level 0 copies the depth, each next level reduces the previous one.
+ * @note Depth writes are made visible by the deferred render pass dependency.
+ */
+void HiZPipeline::record(const ICommandBuffer* cmdBuffer) const {
+    const VkCommandBuffer   cmd = cmdBuffer->getBuffer();
+    const HiZTexture*       pyramid = (const HiZTexture*)TextureTable::getTexture(TextureIndex::HiZ);
+
+    _bindCompute(cmdBuffer);
+
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+    for (u32 level = 0; level < pyramid->getLevelCount(); ++level) {
+        // Each level reads the one before
+        if (level > 0) {
+            vkCmdPipelineBarrier(
+                cmd,
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                0,
+                1, &barrier,
+                0, nullptr,
+                0, nullptr);
+        }
+
+        const HiZPushConstant::Data data{ level };
+        vkCmdPushConstants(cmd, m_pipelineLayout->getLayout(), VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(data), &data);
+
+        const u32 width = pyramid->getLevelWidth(level);
+        const u32 height = pyramid->getLevelHeight(level);
+        vkCmdDispatch(cmd, (width + HIZ_GROUP_SIZE - 1) / HIZ_GROUP_SIZE, (height + HIZ_GROUP_SIZE - 1) / HIZ_GROUP_SIZE, 1);
+    }
+
+    // The culling pass fetches every level
+    vkCmdPipelineBarrier(
+        cmd,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        0,
+        1, &barrier,
+        0, nullptr,
+        0, nullptr);
+}
+
+} // namespace vox::gfx
+
+#endif
@@ -0,0 +1,57 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   hiz_pipeline.h                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/07/08 10:27:36 by etran             #+#    #+#             */
+/*   Updated: 2024/07/08 10:27:36 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#pragma once
+
+#include "pipeline.h"
+
+namespace vox::gfx {
+
+class ICommandBuffer;
+
+/**
+ * @brief Reduces the GBuffer depth to the Hi-Z pyramid, one dispatch per
+ * level, as HiZPyramid::build does on the CPU.
+ */
+class HiZPipeline final: public Pipeline {
+public:
+    /* ====================================================================== */
+    /*                                TYPEDEFS                                */
+    /* ====================================================================== */
+
+    using super = Pipeline;
+
+    /* ====================================================================== */
+    /*                                 METHODS                                */
+    /* ====================================================================== */
+
+    HiZPipeline() = default;
+    ~HiZPipeline() = default;
+
+    HiZPipeline(HiZPipeline&& other) = delete;
+    HiZPipeline(const HiZPipeline& other) = delete;
+    HiZPipeline& operator=(HiZPipeline&& other) = delete;
+    HiZPipeline& operator=(const HiZPipeline& other) = delete;
+
+    /* ====================================================================== */
+
+    void    init(
+        const Device& device,
+        const VkRenderPass& renderPass,
+        const PipelineLayout& pipelineLayout) override;
+    void    destroy(const Device& device) override;
+
+    void    record(const ICommandBuffer* cmdBuffer) const override;
+
+}; // class HiZPipeline
+
+} // namespace vox::gfx
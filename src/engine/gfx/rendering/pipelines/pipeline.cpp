@@ -6,12 +6,14 @@
 /*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2024/02/29 22:13:57 by etran             #+#    #+#             */
-/*   Updated: 2024/06/16 15:43:09 by etran            ###   ########.fr       */
+/*   Updated: 2024/07/08 10:41:17 by etran            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #include "pipeline.h"
 #include "device.h"
+#include "icommand_buffer.h"
+#include "pipeline_layout.h"
 #include "io_helpers.h"
 
 #include <string>
@@ -52,4 +54,19 @@ VkShaderModule Pipeline::_createShaderModule(const Device& device, const char* b
     return shaderModule;
 }
 
+/**
+ * @brief Binds the pipeline and its sets on the compute point: compute
+ * passes are recorded in draw command buffers, whose binds are graphics ones.
+ */
+void Pipeline::_bindCompute(const ICommandBuffer* cmdBuffer) const {
+    vkCmdBindPipeline(cmdBuffer->getBuffer(), VK_PIPELINE_BIND_POINT_COMPUTE, m_pipeline);
+    vkCmdBindDescriptorSets(
+        cmdBuffer->getBuffer(),
+        VK_PIPELINE_BIND_POINT_COMPUTE,
+        m_pipelineLayout->getLayout(),
+        0, m_pipelineLayout->getSets().size(),
+        m_pipelineLayout->getSets().data(),
+        0, nullptr);
+}
+
 } // namespace vox::gfx
\ No newline at end of file
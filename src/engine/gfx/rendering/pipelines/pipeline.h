@@ -6,7 +6,7 @@
 /*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2024/02/28 15:26:02 by etran             #+#    #+#             */
-/*   Updated: 2024/06/16 16:57:42 by etran            ###   ########.fr       */
+/*   Updated: 2024/07/08 10:41:17 by etran            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -71,6 +71,7 @@ protected:
     /* ====================================================================== */
 
     VkShaderModule  _createShaderModule(const Device& device, const char* binPath) const;
+    void            _bindCompute(const ICommandBuffer* cmdBuffer) const;
 
 }; // class Pipeline
 
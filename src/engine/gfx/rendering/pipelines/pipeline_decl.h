@@ -6,7 +6,7 @@
 /*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2024/02/29 22:37:23 by etran             #+#    #+#             */
-/*   Updated: 2024/06/16 18:56:24 by etran            ###   ########.fr       */
+/*   Updated: 2024/07/08 10:41:17 by etran            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -30,6 +30,13 @@ enum class PipelineIndex: u32 {
 
     Deferred,
 
+#if ENABLE_GPU_CULLING
+    DeferredLate,
+    HiZ,
+    CullEarly,
+    CullLate,
+#endif
+
 #if ENABLE_SHADOW_MAPPING
     ShadowPipeline,
 #endif
@@ -56,6 +63,11 @@ enum class PipelineLayoutIndex: u32 {
     Sky,
 #endif
 
+#if ENABLE_GPU_CULLING
+    HiZ,
+    Cull,
+#endif
+
 #if ENABLE_SHADOW_MAPPING
     Shadows,
 #endif
@@ -75,9 +87,25 @@ constexpr u32 PIPELINE_LAYOUT_COUNT = (u32)PipelineLayoutIndex::Count;
 enum class PushConstantIndex: u32 {
     Camera,
 
+#if ENABLE_GPU_CULLING
+    HiZ,
+    Cull,
+#endif
+
     Count
 };
 
 constexpr u32 PUSH_CONSTANT_COUNT = (u32)PushConstantIndex::Count;
 
+// -----------------------
+
+/**
+ * @brief GPU culling phases: chunks visible last frame are drawn first, the
+ * others once tested against the depth they left.
+ */
+enum class CullPhase: u32 {
+    Early,
+    Late
+};
+
 } // namespace vox::gfx
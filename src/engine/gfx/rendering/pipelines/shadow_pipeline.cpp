@@ -6,7 +6,7 @@
 /*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2024/06/03 10:06:29 by etran             #+#    #+#             */
-/*   Updated: 2024/06/16 15:16:59 by etran            ###   ########.fr       */
+/*   Updated: 2024/06/30 17:41:22 by etran            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -132,7 +132,9 @@ void ShadowPipeline::record(const ICommandBuffer* cmdBuffer) const {
     cmdBuffer->bindPipeline(m_pipeline);
     VertexBuffer::bind(cmdBuffer);
 
-    vkCmdDraw(cmdBuffer->getBuffer(), 4, VertexBuffer::getInstancesCount(), 0, 0);
+    // Full resolution meshes only
+    const VertexBuffer::DrawRange range = VertexBuffer::getLodRange(0);
+    vkCmdDraw(cmdBuffer->getBuffer(), 4, range.m_instanceCount, 0, range.m_firstInstance);
 }
 
 } // namespace vox::gfx
\ No newline at end of file
@@ -6,7 +6,7 @@
 /*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2024/06/13 10:49:11 by etran             #+#    #+#             */
-/*   Updated: 2024/06/21 14:35:36 by etran            ###   ########.fr       */
+/*   Updated: 2024/07/08 10:41:17 by etran            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -74,4 +74,102 @@ const void* CameraPushConstant::getObject(const u32 index) const noexcept {
     }
 }
 
+#if ENABLE_GPU_CULLING
+
+/* HI-Z PUSH CONSTANT ======================================================= */
+
+HiZPushConstant::HiZPushConstant() {
+    m_ranges.resize((u32)Objects::Count);
+
+    m_ranges[(u32)Objects::Data].offset = offsetof(HiZPushConstant::Data, m_level);
+    m_ranges[(u32)Objects::Data].size = sizeof(HiZPushConstant::Data);
+    m_ranges[(u32)Objects::Data].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+    LDEBUG("Hi-Z push constant created.");
+}
+
+/**
+ * @brief Levels do not depend on the game state.
+ */
+void HiZPushConstant::update(const game::GameState& gameState) noexcept {
+    (void)gameState;
+}
+
+void HiZPushConstant::bind(const ICommandBuffer* cmdBuffer, const PipelineLayout& layout) const {
+    for (u32 i = 0; i < (u32)Objects::Count; ++i) {
+        vkCmdPushConstants(
+            cmdBuffer->getBuffer(),
+            layout.getLayout(),
+            m_ranges[i].stageFlags,
+            m_ranges[i].offset,
+            m_ranges[i].size,
+            getObject(i));
+    }
+}
+
+VkPushConstantRange HiZPushConstant::getRange(const u32 index) const noexcept {
+    return m_ranges[index];
+}
+
+const void* HiZPushConstant::getObject(const u32 index) const noexcept {
+    switch ((Objects)index) {
+        case Objects::Data: return (void*)&m_data;
+        default:
+            assert(false);
+    }
+}
+
+/* CULL PUSH CONSTANT ======================================================= */
+
+CullPushConstant::CullPushConstant() {
+    m_ranges.resize((u32)Objects::Count);
+
+    m_ranges[(u32)Objects::Data].offset = offsetof(CullPushConstant::Data, m_viewProj);
+    m_ranges[(u32)Objects::Data].size = sizeof(CullPushConstant::Data);
+    m_ranges[(u32)Objects::Data].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+    LDEBUG("Cull push constant created.");
+}
+
+/**
+ * @brief Same projection as OcclusionCuller, chunk boxes are projected alike.
+ */
+void CullPushConstant::update(const game::GameState& gameState) noexcept {
+    const ui::Camera&   camera = gameState.getController().getCamera();
+
+    const math::Mat4 view = math::lookAt(camera.m_position, camera.m_front, camera.m_up, camera.m_right);
+    const math::Mat4 proj = math::perspective(
+        math::radians(camera.m_fov),
+        ui::Camera::ASPECT_RATIO,
+        ui::Camera::NEAR_PLANE,
+        ui::Camera::FAR_PLANE);
+    m_data.m_viewProj = proj * view;
+}
+
+void CullPushConstant::bind(const ICommandBuffer* cmdBuffer, const PipelineLayout& layout) const {
+    for (u32 i = 0; i < (u32)Objects::Count; ++i) {
+        vkCmdPushConstants(
+            cmdBuffer->getBuffer(),
+            layout.getLayout(),
+            m_ranges[i].stageFlags,
+            m_ranges[i].offset,
+            m_ranges[i].size,
+            getObject(i));
+    }
+}
+
+VkPushConstantRange CullPushConstant::getRange(const u32 index) const noexcept {
+    return m_ranges[index];
+}
+
+const void* CullPushConstant::getObject(const u32 index) const noexcept {
+    switch ((Objects)index) {
+        case Objects::Data: return (void*)&m_data;
+        default:
+            assert(false);
+    }
+}
+
+#endif
+
 } // namespace vox::gfx
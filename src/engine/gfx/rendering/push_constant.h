@@ -6,7 +6,7 @@
 /*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2024/06/12 21:21:33 by etran             #+#    #+#             */
-/*   Updated: 2024/06/21 14:35:48 by etran            ###   ########.fr       */
+/*   Updated: 2024/07/08 10:41:17 by etran            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -92,4 +92,95 @@ private:
 
 }; // class CameraPushConstant
 
+#if ENABLE_GPU_CULLING
+
+// ----------------------------------------------------------------------------
+
+/**
+ * @brief Pyramid level a Hi-Z dispatch writes. HiZPipeline pushes each level
+ * as it records them, bind only pushes the first.
+ */
+class HiZPushConstant final: public PushConstant {
+public:
+    /* ====================================================================== */
+    /*                                  ENUMS                                 */
+    /* ====================================================================== */
+
+    enum class Objects: u32 {
+        Data,
+
+        Count
+    };
+
+    /* ====================================================================== */
+    /*                                TYPEDEFS                                */
+    /* ====================================================================== */
+
+    struct Data {
+        u32 m_level;
+    };
+
+    /* ====================================================================== */
+    /*                                 METHODS                                */
+    /* ====================================================================== */
+
+    HiZPushConstant();
+
+    void    update(const game::GameState& gameState) noexcept override;
+    void    bind(const ICommandBuffer* cmdBuffer, const PipelineLayout& layout) const override;
+
+    const void*         getObject(const u32 index) const noexcept override;
+    VkPushConstantRange getRange(const u32 index) const noexcept override;
+
+private:
+    /* ====================================================================== */
+    /*                                  DATA                                  */
+    /* ====================================================================== */
+
+    Data    m_data{};
+
+}; // class HiZPushConstant
+
+// ----------------------------------------------------------------------------
+
+/**
+ * @brief Camera of the culling pass, projection and view combined.
+ */
+class CullPushConstant final: public PushConstant {
+public:
+    /* ====================================================================== */
+    /*                                  ENUMS                                 */
+    /* ====================================================================== */
+
+    enum class Objects: u32 {
+        Data,
+
+        Count
+    };
+
+    /* ====================================================================== */
+    /*                                 METHODS                                */
+    /* ====================================================================== */
+
+    CullPushConstant();
+
+    void    update(const game::GameState& gameState) noexcept override;
+    void    bind(const ICommandBuffer* cmdBuffer, const PipelineLayout& layout) const override;
+
+    const void*         getObject(const u32 index) const noexcept override;
+    VkPushConstantRange getRange(const u32 index) const noexcept override;
+
+private:
+    /* ====================================================================== */
+    /*                                  DATA                                  */
+    /* ====================================================================== */
+
+    struct Data {
+        math::Mat4  m_viewProj;
+    }   m_data;
+
+}; // class CullPushConstant
+
+#endif
+
 } // namespace vox::gfx
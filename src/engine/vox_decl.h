@@ -6,7 +6,7 @@
 /*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2024/06/03 09:05:39 by etran             #+#    #+#             */
-/*   Updated: 2024/06/25 16:02:29 by etran            ###   ########.fr       */
+/*   Updated: 2024/07/08 10:41:17 by etran            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -18,10 +18,18 @@
 # define ENABLE_FRUSTUM_CULLING 0
 # define ENABLE_SHADOW_MAPPING 0
 # define ENABLE_SSAO 0
+# define ENABLE_BAKED_AO 1 // Per-vertex voxel AO from the mesher, cheaper than SSAO
 
 #ifdef VOX_CPP
 
 # define ENABLE_HIGH_RES 0
+# ifndef ENABLE_MORTON_LAYOUT // Set by the Makefile for the layout benchmark
+#  define ENABLE_MORTON_LAYOUT 0 // Chunk blocks in Z-order instead of y/z/x rows
+# endif
+# define ENABLE_LOD 1 // Coarser meshes for distant chunks
+# define ENABLE_CAVE_CULLING 1 // Skip chunks hidden behind solid ones
+# define ENABLE_OCCLUSION_CULLING 1 // Skip chunks hidden behind nearer terrain
+# define ENABLE_GPU_CULLING 0 // Hi-Z occlusion culling on the GPU, chunks drawn indirectly
 
 # if !ENABLE_SKYBOX && ENABLE_CUBEMAP
     static_assert(false, "Cubemap cannot be enabled if skybox is disabled");
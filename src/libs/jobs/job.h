@@ -0,0 +1,134 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   job.h                                              :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/06/26 14:01:48 by etran             #+#    #+#             */
+/*   Updated: 2024/07/07 14:21:08 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#pragma once
+
+#include "types.h"
+
+#include <atomic>
+#include <exception>
+
+namespace jobs {
+
+/**
+ * @brief Tracks how many jobs of a batch are still pending, and the first
+ * exception one of them threw.
+ *
+ * @note The counter must outlive every job referring to it.
+ */
+class Counter final {
+public:
+    /* ====================================================================== */
+    /*                                 METHODS                                */
+    /* ====================================================================== */
+
+    Counter() = default;
+    ~Counter() = default;
+
+    Counter(Counter&& other) = delete;
+    Counter(const Counter& other) = delete;
+    Counter& operator=(Counter&& other) = delete;
+    Counter& operator=(const Counter& other) = delete;
+
+    /* ====================================================================== */
+
+    void    add(const u32 count = 1) noexcept {
+        m_value.fetch_add(count, std::memory_order_relaxed);
+    }
+
+    void    done() noexcept {
+        m_value.fetch_sub(1, std::memory_order_release);
+    }
+
+    bool    isDone() const noexcept {
+        return m_value.load(std::memory_order_acquire) == 0;
+    }
+
+    /**
+     * @brief Keeps the first exception, published by the following done().
+     */
+    void    fail(std::exception_ptr exception) noexcept {
+        if (!m_failed.exchange(true, std::memory_order_relaxed))
+            m_exception = exception;
+    }
+
+    /**
+     * @brief Forwards the exception of a failed job, once isDone().
+     */
+    void    rethrow() const {
+        if (m_exception)
+            std::rethrow_exception(m_exception);
+    }
+
+private:
+    /* ====================================================================== */
+    /*                                  DATA                                  */
+    /* ====================================================================== */
+
+    std::atomic<u32>    m_value = 0;
+    std::atomic<bool>   m_failed = false;
+    std::exception_ptr  m_exception;
+
+}; // class Counter
+
+/**
+ * @brief Unit of work: runs m_function over the [m_begin, m_end) range.
+ *
+ * @note Jobs don't own m_data, the caller keeps it alive until the counter
+ * reaches zero.
+ */
+struct Job final {
+    /* ====================================================================== */
+    /*                                TYPEDEFS                                */
+    /* ====================================================================== */
+
+    using Function = void (*)(const void* data, const u32 begin, const u32 end);
+
+    /* ====================================================================== */
+    /*                                  DATA                                  */
+    /* ====================================================================== */
+
+    Function    m_function = nullptr;
+    const void* m_data = nullptr;
+    u32         m_begin = 0;
+    u32         m_end = 0;
+    Counter*    m_counter = nullptr;
+
+    /* ====================================================================== */
+    /*                                 METHODS                                */
+    /* ====================================================================== */
+
+    /**
+     * @brief The counter is decremented on every exit path: a throwing job
+     * hands its exception to the counter instead of leaving waiters spinning.
+     */
+    void    execute() const {
+        if (m_counter == nullptr) {
+            m_function(m_data, m_begin, m_end);
+            return;
+        }
+
+        struct Done {
+            Counter* m_counter;
+            ~Done() { m_counter->done(); }
+        } done{ m_counter };
+
+        try {
+            m_function(m_data, m_begin, m_end);
+        } catch (...) {
+            m_counter->fail(std::current_exception());
+        }
+    }
+
+}; // struct Job
+
+} // namespace jobs
@@ -0,0 +1,173 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   job_system.cpp                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/06/26 14:02:58 by etran             #+#    #+#             */
+/*   Updated: 2024/07/07 14:21:08 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "job_system.h"
+#include "work_stealing_queue.h"
+
+#include "debug.h"
+
+namespace jobs {
+
+std::vector<std::thread>        JobSystem::ms_workers;
+std::vector<WorkStealingQueue*> JobSystem::ms_queues;
+
+std::atomic<bool>               JobSystem::ms_isRunning = false;
+std::atomic<u32>                JobSystem::ms_pendingJobs = 0;
+std::mutex                      JobSystem::ms_sleepMutex;
+std::condition_variable         JobSystem::ms_wakeUp;
+
+thread_local u32                JobSystem::ts_threadIndex = 0;
+
+/* ========================================================================== */
+/*                                   PUBLIC                                   */
+/* ========================================================================== */
+
+/**
+ * @brief Spawns the worker threads.
+ *
+ * @param workerCount Number of workers. 0 uses every hardware thread but the
+ * main one.
+ */
+void JobSystem::init(u32 workerCount) {
+    if (workerCount == 0) {
+        const u32 hardwareThreads = std::thread::hardware_concurrency();
+        workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+    }
+
+    ms_queues.reserve(workerCount + 1);
+    for (u32 i = 0; i < workerCount + 1; ++i)
+        ms_queues.emplace_back(new WorkStealingQueue(QUEUE_CAPACITY));
+
+    ts_threadIndex = 0;
+    ms_isRunning.store(true);
+
+    ms_workers.reserve(workerCount);
+    for (u32 i = 0; i < workerCount; ++i)
+        ms_workers.emplace_back(_workerLoop, i + 1);
+
+    LINFO("Job system initialized: " << workerCount << " workers.");
+}
+
+void JobSystem::destroy() {
+    {
+        std::lock_guard<std::mutex> lock(ms_sleepMutex);
+        ms_isRunning.store(false);
+    }
+    ms_wakeUp.notify_all();
+
+    for (std::thread& worker: ms_workers) worker.join();
+    ms_workers.clear();
+
+    for (WorkStealingQueue* queue: ms_queues) delete queue;
+    ms_queues.clear();
+
+    LINFO("Job system destroyed.");
+}
+
+/* ========================================================================== */
+
+/**
+ * @brief Schedules a job on the calling thread's queue.
+ */
+void JobSystem::run(Job job) {
+    if (job.m_counter != nullptr)
+        job.m_counter->add();
+
+    if (!ms_queues.empty()) {
+        ms_pendingJobs.fetch_add(1, std::memory_order_release);
+        if (ms_queues[ts_threadIndex]->push(job)) {
+            if (!ms_workers.empty()) {
+                { std::lock_guard<std::mutex> lock(ms_sleepMutex); }
+                ms_wakeUp.notify_one();
+            }
+            return;
+        }
+        ms_pendingJobs.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    // Not initialized or queue full: run it right away.
+    job.execute();
+}
+
+/**
+ * @brief Runs pending jobs until the counter reaches zero, then rethrows the
+ * exception of a failed job if any.
+ */
+void JobSystem::wait(const Counter& counter) {
+    while (!counter.isDone()) {
+        if (!_executeNext())
+            std::this_thread::yield();
+    }
+    counter.rethrow();
+}
+
+/* ========================================================================== */
+
+u32 JobSystem::getWorkerCount() noexcept {
+    return (u32)ms_workers.size();
+}
+
+/**
+ * @brief Index of the calling thread. 0 is the main thread.
+ */
+u32 JobSystem::getThreadIndex() noexcept {
+    return ts_threadIndex;
+}
+
+/* ========================================================================== */
+/*                                   PRIVATE                                  */
+/* ========================================================================== */
+
+void JobSystem::_workerLoop(const u32 threadIndex) {
+    ts_threadIndex = threadIndex;
+
+    while (ms_isRunning.load(std::memory_order_relaxed)) {
+        if (_executeNext())
+            continue;
+
+        std::unique_lock<std::mutex> lock(ms_sleepMutex);
+        ms_wakeUp.wait(lock, [] {
+            return ms_pendingJobs.load(std::memory_order_acquire) > 0 || !ms_isRunning.load();
+        });
+    }
+}
+
+/**
+ * @brief Pops from the own queue first, then steals from the others.
+ */
+bool JobSystem::_fetchJob(Job& job) {
+    if (ms_queues.empty())
+        return false;
+
+    const u32 queueCount = (u32)ms_queues.size();
+    if (ms_queues[ts_threadIndex]->pop(job))
+        return true;
+
+    for (u32 i = 1; i < queueCount; ++i) {
+        const u32 victim = (ts_threadIndex + i) % queueCount;
+        if (ms_queues[victim]->steal(job))
+            return true;
+    }
+    return false;
+}
+
+bool JobSystem::_executeNext() {
+    Job job;
+    if (!_fetchJob(job))
+        return false;
+
+    ms_pendingJobs.fetch_sub(1, std::memory_order_relaxed);
+    job.execute();
+    return true;
+}
+
+} // namespace jobs
@@ -0,0 +1,136 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   job_system.h                                       :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/06/26 14:08:14 by etran             #+#    #+#             */
+/*   Updated: 2024/06/26 14:08:14 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#pragma once
+
+#include "job.h"
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+
+namespace jobs {
+
+class WorkStealingQueue;
+
+/**
+ * @brief Engine-wide work-stealing job system.
+ *
+ * Each thread (main thread included, at index 0) owns a deque. Jobs are pushed
+ * to the deque of the calling thread, idle workers steal from the others.
+ * The main thread never blocks on a counter: `wait` runs pending jobs until
+ * the counter reaches zero.
+ *
+ * @note Without `init`, or without any worker, jobs simply run on the thread
+ * calling `wait`.
+ */
+class JobSystem final {
+public:
+    /* ====================================================================== */
+    /*                             STATIC MEMBERS                             */
+    /* ====================================================================== */
+
+    static constexpr u32    QUEUE_CAPACITY = 4096;
+
+    /* ====================================================================== */
+    /*                                 METHODS                                */
+    /* ====================================================================== */
+
+    JobSystem() = delete;
+
+    /* ====================================================================== */
+
+    static void init(u32 workerCount = 0);
+    static void destroy();
+
+    /* ====================================================================== */
+
+    static void run(Job job);
+    static void wait(const Counter& counter);
+
+    template <typename Fn>
+    static void parallelFor(const u32 count, const u32 grain, const Fn& fn, Counter& counter);
+    template <typename Fn>
+    static void parallelFor(const u32 count, const u32 grain, const Fn& fn);
+
+    /* ====================================================================== */
+
+    static u32  getWorkerCount() noexcept;
+    static u32  getThreadIndex() noexcept;
+
+private:
+    /* ====================================================================== */
+    /*                             STATIC MEMBERS                             */
+    /* ====================================================================== */
+
+    static std::vector<std::thread>         ms_workers;
+    static std::vector<WorkStealingQueue*>  ms_queues;
+
+    static std::atomic<bool>                ms_isRunning;
+    static std::atomic<u32>                 ms_pendingJobs;
+    static std::mutex                       ms_sleepMutex;
+    static std::condition_variable          ms_wakeUp;
+
+    static thread_local u32                 ts_threadIndex;
+
+    /* ====================================================================== */
+    /*                                 METHODS                                */
+    /* ====================================================================== */
+
+    static void _workerLoop(const u32 threadIndex);
+    static bool _fetchJob(Job& job);
+    static bool _executeNext();
+
+}; // class JobSystem
+
+/* ========================================================================== */
+/*                                  TEMPLATES                                 */
+/* ========================================================================== */
+
+/**
+ * @brief Splits [0, count) in batches of `grain` indices and schedules
+ * `fn(index)` on each of them. Does not wait.
+ *
+ * @note `fn` must stay alive until `counter` is done.
+ */
+template <typename Fn>
+void JobSystem::parallelFor(const u32 count, const u32 grain, const Fn& fn, Counter& counter) {
+    const u32 step = std::max(grain, 1U);
+
+    for (u32 begin = 0; begin < count; begin += step) {
+        Job job{};
+        job.m_function = [](const void* data, const u32 first, const u32 last) {
+            const Fn& function = *(const Fn*)data;
+            for (u32 i = first; i < last; ++i)
+                function(i);
+        };
+        job.m_data = &fn;
+        job.m_begin = begin;
+        job.m_end = std::min(begin + step, count);
+        job.m_counter = &counter;
+        run(job);
+    }
+}
+
+/**
+ * @brief Blocking version: returns once every index was processed.
+ */
+template <typename Fn>
+void JobSystem::parallelFor(const u32 count, const u32 grain, const Fn& fn) {
+    Counter counter;
+    parallelFor(count, grain, fn, counter);
+    wait(counter);
+}
+
+} // namespace jobs
@@ -0,0 +1,131 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   work_stealing_queue.cpp                            :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/06/26 14:00:42 by etran             #+#    #+#             */
+/*   Updated: 2024/07/07 14:48:52 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "work_stealing_queue.h"
+
+#include <cassert>
+
+namespace jobs {
+
+/* ========================================================================== */
+/*                                   PUBLIC                                   */
+/* ========================================================================== */
+
+/**
+ * @param capacity Must be a power of 2.
+ */
+WorkStealingQueue::WorkStealingQueue(const u32 capacity):
+    m_jobs(capacity),
+    m_mask((i64)capacity - 1)
+{
+    assert((capacity & (capacity - 1)) == 0);
+}
+
+/* ========================================================================== */
+
+/**
+ * @brief Pushes a job at the bottom of the queue.
+ *
+ * @return false if the queue is full, the caller should then run the job itself.
+ */
+bool WorkStealingQueue::push(const Job& job) noexcept {
+    const i64 bottom = m_bottom.load(std::memory_order_relaxed);
+    const i64 top = m_top.load(std::memory_order_acquire);
+
+    // A stale top can only underestimate the free space.
+    if (bottom - top > m_mask)
+        return false;
+
+    m_jobs[bottom & m_mask].store(job);
+    m_bottom.store(bottom + 1, std::memory_order_release);
+    return true;
+}
+
+/**
+ * @brief Pops the most recently pushed job.
+ */
+bool WorkStealingQueue::pop(Job& job) noexcept {
+    const i64 bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+    m_bottom.store(bottom, std::memory_order_seq_cst);
+    i64 top = m_top.load(std::memory_order_seq_cst);
+
+    if (top > bottom) {
+        // Empty
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        return false;
+    }
+
+    job = m_jobs[bottom & m_mask].load();
+    if (top == bottom) {
+        // Last job: race against thieves
+        const bool won = m_top.compare_exchange_strong(
+            top, top + 1,
+            std::memory_order_seq_cst,
+            std::memory_order_relaxed);
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        return won;
+    }
+    return true;
+}
+
+/**
+ * @brief Steals the oldest job of the queue.
+ *
+ * @note The slot is read before the CAS: it can only be overwritten by a push
+ * once top moved past it, in which case the CAS fails and the copy is
+ * discarded.
+ */
+bool WorkStealingQueue::steal(Job& job) noexcept {
+    i64 top = m_top.load(std::memory_order_seq_cst);
+    const i64 bottom = m_bottom.load(std::memory_order_seq_cst);
+
+    if (top >= bottom)
+        return false;
+
+    job = m_jobs[top & m_mask].load();
+    return m_top.compare_exchange_strong(
+        top, top + 1,
+        std::memory_order_seq_cst,
+        std::memory_order_relaxed);
+}
+
+bool WorkStealingQueue::isEmpty() const noexcept {
+    return m_top.load(std::memory_order_relaxed) >= m_bottom.load(std::memory_order_relaxed);
+}
+
+/* ========================================================================== */
+/*                                   PRIVATE                                  */
+/* ========================================================================== */
+
+/**
+ * @brief Ordered by the release store of bottom in push.
+ */
+void WorkStealingQueue::Slot::store(const Job& job) noexcept {
+    m_function.store(job.m_function, std::memory_order_relaxed);
+    m_data.store(job.m_data, std::memory_order_relaxed);
+    m_range.store(((u64)job.m_end << 32) | job.m_begin, std::memory_order_relaxed);
+    m_counter.store(job.m_counter, std::memory_order_relaxed);
+}
+
+Job WorkStealingQueue::Slot::load() const noexcept {
+    const u64 range = m_range.load(std::memory_order_relaxed);
+
+    Job job;
+    job.m_function = m_function.load(std::memory_order_relaxed);
+    job.m_data = m_data.load(std::memory_order_relaxed);
+    job.m_begin = (u32)range;
+    job.m_end = (u32)(range >> 32);
+    job.m_counter = m_counter.load(std::memory_order_relaxed);
+    return job;
+}
+
+} // namespace jobs
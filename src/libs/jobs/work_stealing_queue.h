@@ -0,0 +1,87 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   work_stealing_queue.h                              :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/06/26 14:08:16 by etran             #+#    #+#             */
+/*   Updated: 2024/07/07 14:48:52 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#pragma once
+
+#include "job.h"
+
+#include <atomic>
+#include <vector>
+
+namespace jobs {
+
+/**
+ * @brief Fixed capacity Chase-Lev deque.
+ *
+ * The owner thread pushes and pops at the bottom (LIFO, cache friendly),
+ * other threads steal from the top (FIFO, oldest and usually biggest jobs).
+ *
+ * Slots are made of relaxed atomics: a thief reads its slot before the CAS on
+ * top while the owner may already be refilling it. The copy is then torn, but
+ * the CAS fails and it is discarded.
+ *
+ * @note https://www.di.ens.fr/~zappa/readings/ppopp13.pdf
+ */
+class WorkStealingQueue final {
+public:
+    /* ====================================================================== */
+    /*                                 METHODS                                */
+    /* ====================================================================== */
+
+    WorkStealingQueue(const u32 capacity);
+
+    ~WorkStealingQueue() = default;
+
+    WorkStealingQueue() = delete;
+    WorkStealingQueue(WorkStealingQueue&& other) = delete;
+    WorkStealingQueue(const WorkStealingQueue& other) = delete;
+    WorkStealingQueue& operator=(WorkStealingQueue&& other) = delete;
+    WorkStealingQueue& operator=(const WorkStealingQueue& other) = delete;
+
+    /* ====================================================================== */
+
+    // Owner only
+    bool    push(const Job& job) noexcept;
+    bool    pop(Job& job) noexcept;
+
+    // Any thread
+    bool    steal(Job& job) noexcept;
+    bool    isEmpty() const noexcept;
+
+private:
+    /* ====================================================================== */
+    /*                                TYPEDEFS                                */
+    /* ====================================================================== */
+
+    struct Slot {
+        std::atomic<Job::Function>  m_function = nullptr;
+        std::atomic<const void*>    m_data = nullptr;
+        std::atomic<u64>            m_range = 0;
+        std::atomic<Counter*>       m_counter = nullptr;
+
+        void    store(const Job& job) noexcept;
+        Job     load() const noexcept;
+    };
+
+    /* ====================================================================== */
+    /*                                  DATA                                  */
+    /* ====================================================================== */
+
+    std::vector<Slot>   m_jobs;
+    const i64           m_mask;
+
+    alignas(64) std::atomic<i64>    m_top = 0;
+    alignas(64) std::atomic<i64>    m_bottom = 0;
+
+}; // class WorkStealingQueue
+
+} // namespace jobs
@@ -0,0 +1,140 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   batch.cpp                                          :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/07/06 16:12:48 by etran             #+#    #+#             */
+/*   Updated: 2024/07/06 16:12:48 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+#include "batch.h"
+
+#include <algorithm> // std::min
+
+namespace math {
+
+namespace {
+
+std::size_t	_count(const Vect3Soa& vectors) noexcept {
+	return std::min({ vectors.x.size(), vectors.y.size(), vectors.z.size() });
+}
+
+} // namespace
+
+/* ========================================================================== */
+
+/**
+ * @brief Points (w = 1) multiplied by the matrix, 4 at a time.
+ */
+void	transform(const Mat4& mat, const Vect3Soa& points, Vect3Soa& result) noexcept {
+	const std::size_t	count = std::min(_count(points), _count(result));
+	std::size_t			i = 0;
+
+#if MATH_SIMD_SSE
+	const __m128	m0 = _mm_set1_ps(mat.mat[0]);
+	const __m128	m1 = _mm_set1_ps(mat.mat[1]);
+	const __m128	m2 = _mm_set1_ps(mat.mat[2]);
+	const __m128	m4 = _mm_set1_ps(mat.mat[4]);
+	const __m128	m5 = _mm_set1_ps(mat.mat[5]);
+	const __m128	m6 = _mm_set1_ps(mat.mat[6]);
+	const __m128	m8 = _mm_set1_ps(mat.mat[8]);
+	const __m128	m9 = _mm_set1_ps(mat.mat[9]);
+	const __m128	m10 = _mm_set1_ps(mat.mat[10]);
+	const __m128	m12 = _mm_set1_ps(mat.mat[12]);
+	const __m128	m13 = _mm_set1_ps(mat.mat[13]);
+	const __m128	m14 = _mm_set1_ps(mat.mat[14]);
+
+	for (; i + 4 <= count; i += 4) {
+		const __m128	x = _mm_loadu_ps(&points.x[i]);
+		const __m128	y = _mm_loadu_ps(&points.y[i]);
+		const __m128	z = _mm_loadu_ps(&points.z[i]);
+
+		_mm_storeu_ps(&result.x[i], _mm_add_ps(
+			_mm_add_ps(_mm_mul_ps(m0, x), _mm_mul_ps(m4, y)),
+			_mm_add_ps(_mm_mul_ps(m8, z), m12)));
+		_mm_storeu_ps(&result.y[i], _mm_add_ps(
+			_mm_add_ps(_mm_mul_ps(m1, x), _mm_mul_ps(m5, y)),
+			_mm_add_ps(_mm_mul_ps(m9, z), m13)));
+		_mm_storeu_ps(&result.z[i], _mm_add_ps(
+			_mm_add_ps(_mm_mul_ps(m2, x), _mm_mul_ps(m6, y)),
+			_mm_add_ps(_mm_mul_ps(m10, z), m14)));
+	}
+#endif
+	for (; i < count; ++i)
+		result.set(i, mat * points.get(i));
+}
+
+void	dot(const Vect3Soa& lhs, const Vect3& rhs, std::span<float> result) noexcept {
+	const std::size_t	count = std::min(_count(lhs), result.size());
+	std::size_t			i = 0;
+
+#if MATH_SIMD_SSE
+	const __m128	rx = _mm_set1_ps(rhs.x);
+	const __m128	ry = _mm_set1_ps(rhs.y);
+	const __m128	rz = _mm_set1_ps(rhs.z);
+
+	for (; i + 4 <= count; i += 4) {
+		_mm_storeu_ps(&result[i], _mm_add_ps(
+			_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&lhs.x[i]), rx), _mm_mul_ps(_mm_loadu_ps(&lhs.y[i]), ry)),
+			_mm_mul_ps(_mm_loadu_ps(&lhs.z[i]), rz)));
+	}
+#endif
+	for (; i < count; ++i)
+		result[i] = lhs.x[i] * rhs.x + lhs.y[i] * rhs.y + lhs.z[i] * rhs.z;
+}
+
+void	dot(const Vect3Soa& lhs, const Vect3Soa& rhs, std::span<float> result) noexcept {
+	const std::size_t	count = std::min({ _count(lhs), _count(rhs), result.size() });
+	std::size_t			i = 0;
+
+#if MATH_SIMD_SSE
+	for (; i + 4 <= count; i += 4) {
+		_mm_storeu_ps(&result[i], _mm_add_ps(
+			_mm_add_ps(
+				_mm_mul_ps(_mm_loadu_ps(&lhs.x[i]), _mm_loadu_ps(&rhs.x[i])),
+				_mm_mul_ps(_mm_loadu_ps(&lhs.y[i]), _mm_loadu_ps(&rhs.y[i]))),
+			_mm_mul_ps(_mm_loadu_ps(&lhs.z[i]), _mm_loadu_ps(&rhs.z[i]))));
+	}
+#endif
+	for (; i < count; ++i)
+		result[i] = lhs.x[i] * rhs.x[i] + lhs.y[i] * rhs.y[i] + lhs.z[i] * rhs.z[i];
+}
+
+/**
+ * @brief planeDistance() of every box.
+ */
+void	planeDistance(
+	const Vect4& plane,
+	const Vect3Soa& centers,
+	const Vect3Soa& halfExtents,
+	std::span<float> result
+) noexcept {
+	const std::size_t	count = std::min({ _count(centers), _count(halfExtents), result.size() });
+	std::size_t			i = 0;
+
+#if MATH_SIMD_SSE
+	const __m128	nx = _mm_set1_ps(plane.x);
+	const __m128	ny = _mm_set1_ps(plane.y);
+	const __m128	nz = _mm_set1_ps(plane.z);
+	const __m128	ax = _mm_set1_ps(std::fabs(plane.x));
+	const __m128	ay = _mm_set1_ps(std::fabs(plane.y));
+	const __m128	az = _mm_set1_ps(std::fabs(plane.z));
+	const __m128	w = _mm_set1_ps(plane.w);
+
+	for (; i + 4 <= count; i += 4) {
+		const __m128	extent = _mm_add_ps(
+			_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&halfExtents.x[i]), ax), _mm_mul_ps(_mm_loadu_ps(&halfExtents.y[i]), ay)),
+			_mm_mul_ps(_mm_loadu_ps(&halfExtents.z[i]), az));
+		const __m128	distance = _mm_add_ps(
+			_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&centers.x[i]), nx), _mm_mul_ps(_mm_loadu_ps(&centers.y[i]), ny)),
+			_mm_mul_ps(_mm_loadu_ps(&centers.z[i]), nz));
+		_mm_storeu_ps(&result[i], _mm_add_ps(_mm_sub_ps(distance, w), extent));
+	}
+#endif
+	for (; i < count; ++i)
+		result[i] = planeDistance(plane, centers.get(i), halfExtents.get(i));
+}
+
+} // namespace math
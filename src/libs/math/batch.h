@@ -0,0 +1,99 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   batch.h                                            :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/07/06 16:12:48 by etran             #+#    #+#             */
+/*   Updated: 2024/07/06 16:12:48 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+#pragma once
+
+// Std
+# include <span>
+# include <vector>
+
+# include "matrix.h"
+
+namespace math {
+
+/**
+ * @brief Vectors stored as 3 arrays of components, so a batch kernel works
+ * on 4 of them per SSE register.
+ */
+struct Vect3Soa {
+	/* ========================================================================= */
+	/*                                    DATA                                   */
+	/* ========================================================================= */
+
+	std::vector<float>	x;
+	std::vector<float>	y;
+	std::vector<float>	z;
+
+	/* ========================================================================= */
+	/*                                  METHODS                                  */
+	/* ========================================================================= */
+
+	Vect3Soa() = default;
+	explicit Vect3Soa(std::size_t count): x(count), y(count), z(count) {}
+
+	Vect3Soa(const Vect3Soa& other) = default;
+	Vect3Soa(Vect3Soa&& other) = default;
+	Vect3Soa& operator=(const Vect3Soa& rhs) = default;
+	Vect3Soa& operator=(Vect3Soa&& rhs) = default;
+	~Vect3Soa() = default;
+
+	/* ========================================================================= */
+
+	void	resize(std::size_t count) {
+		x.resize(count);
+		y.resize(count);
+		z.resize(count);
+	}
+
+	std::size_t	size() const noexcept {
+		return x.size();
+	}
+
+	void	set(std::size_t index, const Vect3& vec) noexcept {
+		x[index] = vec.x;
+		y[index] = vec.y;
+		z[index] = vec.z;
+	}
+
+	Vect3	get(std::size_t index) const noexcept {
+		return Vect3(x[index], y[index], z[index]);
+	}
+
+}; // struct Vect3Soa
+
+/* ========================================================================== */
+/*                                   KERNELS                                  */
+/* ========================================================================== */
+
+// Every kernel processes min(sizes) elements, result may alias an input.
+
+void	transform(const Mat4& mat, const Vect3Soa& points, Vect3Soa& result) noexcept;
+void	dot(const Vect3Soa& lhs, const Vect3& rhs, std::span<float> result) noexcept;
+void	dot(const Vect3Soa& lhs, const Vect3Soa& rhs, std::span<float> result) noexcept;
+void	planeDistance(
+	const Vect4& plane,
+	const Vect3Soa& centers,
+	const Vect3Soa& halfExtents,
+	std::span<float> result) noexcept;
+
+/**
+ * @brief Signed distance from the plane (normal, w) to the farthest corner of
+ * the box along the normal: negative when the box lies entirely behind it.
+ */
+inline float	planeDistance(const Vect4& plane, const Vect3& center, const Vect3& halfExtent) noexcept {
+	const float	extent =
+		halfExtent.x * std::fabs(plane.x) +
+		halfExtent.y * std::fabs(plane.y) +
+		halfExtent.z * std::fabs(plane.z);
+	return center.x * plane.x + center.y * plane.y + center.z * plane.z - plane.w + extent;
+}
+
+} // namespace math
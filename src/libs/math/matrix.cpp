@@ -6,16 +6,68 @@
 /*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2023/05/19 23:18:11 by etran             #+#    #+#             */
-/*   Updated: 2024/06/10 15:24:52 by etran            ###   ########.fr       */
+/*   Updated: 2024/07/06 15:40:12 by etran            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #include "matrix.h"
 
+#include <algorithm> // std::min
 #include <cstring> // memset
 
 namespace math {
 
+#if MATH_SIMD_SSE
+namespace {
+
+/**
+ * @brief Matrices stay plain float arrays (they are copied as is to the GPU),
+ * columns are loaded unaligned.
+ */
+inline __m128	_loadColumn(const Mat4& mat, std::size_t column) noexcept {
+	return _mm_loadu_ps(&mat.mat[column * 4]);
+}
+
+/**
+ * @brief Columns c0 to c3 weighted by the 4 components of `vec`.
+ */
+inline __m128	_combine(
+	const __m128 c0,
+	const __m128 c1,
+	const __m128 c2,
+	const __m128 c3,
+	const __m128 vec
+) noexcept {
+	__m128	result = _mm_mul_ps(c0, _mm_shuffle_ps(vec, vec, _MM_SHUFFLE(0, 0, 0, 0)));
+	result = _mm_add_ps(result, _mm_mul_ps(c1, _mm_shuffle_ps(vec, vec, _MM_SHUFFLE(1, 1, 1, 1))));
+	result = _mm_add_ps(result, _mm_mul_ps(c2, _mm_shuffle_ps(vec, vec, _MM_SHUFFLE(2, 2, 2, 2))));
+	return _mm_add_ps(result, _mm_mul_ps(c3, _mm_shuffle_ps(vec, vec, _MM_SHUFFLE(3, 3, 3, 3))));
+}
+
+// 2x2 blocks packed as (m00, m01, m10, m11)
+inline __m128	_mul2x2(const __m128 a, const __m128 b) noexcept {
+	return _mm_add_ps(
+		_mm_mul_ps(a, _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 3, 0))),
+		_mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 2, 1, 2))));
+}
+
+// adj(a) * b
+inline __m128	_adjMul2x2(const __m128 a, const __m128 b) noexcept {
+	return _mm_sub_ps(
+		_mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 0, 3, 3)), b),
+		_mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 1, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 0, 3, 2))));
+}
+
+// a * adj(b)
+inline __m128	_mulAdj2x2(const __m128 a, const __m128 b) noexcept {
+	return _mm_sub_ps(
+		_mm_mul_ps(a, _mm_shuffle_ps(b, b, _MM_SHUFFLE(0, 3, 0, 3))),
+		_mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 2, 1, 2))));
+}
+
+} // namespace
+#endif
+
 /* ========================================================================== */
 /*                                 4X4 MATRIX                                 */
 /* ========================================================================== */
@@ -95,6 +147,23 @@ Mat4	Mat4::operator-(const Mat4& rhs) const noexcept {
 }
 
 Mat4&	Mat4::operator*=(const Mat4& rhs) noexcept {
+#if MATH_SIMD_SSE
+	// Column i of the result: the columns of this weighted by column i of rhs
+	const __m128	c0 = _loadColumn(*this, 0);
+	const __m128	c1 = _loadColumn(*this, 1);
+	const __m128	c2 = _loadColumn(*this, 2);
+	const __m128	c3 = _loadColumn(*this, 3);
+
+	const __m128	r0 = _combine(c0, c1, c2, c3, _loadColumn(rhs, 0));
+	const __m128	r1 = _combine(c0, c1, c2, c3, _loadColumn(rhs, 1));
+	const __m128	r2 = _combine(c0, c1, c2, c3, _loadColumn(rhs, 2));
+	const __m128	r3 = _combine(c0, c1, c2, c3, _loadColumn(rhs, 3));
+
+	_mm_storeu_ps(&mat[0], r0);
+	_mm_storeu_ps(&mat[4], r1);
+	_mm_storeu_ps(&mat[8], r2);
+	_mm_storeu_ps(&mat[12], r3);
+#else
 	Mat4	result;
 	for (std::size_t i = 0; i < 4; i++) {
 		for (std::size_t j = 0; j < 4; j++) {
@@ -106,6 +175,7 @@ Mat4&	Mat4::operator*=(const Mat4& rhs) noexcept {
 		}
 	}
 	*this = result;
+#endif
 	return *this;
 }
 
@@ -130,7 +200,16 @@ Mat4	Mat4::operator*(float rhs) const noexcept {
 
 Vect3	Mat4::operator*(const Vect3& rhs) const noexcept {
 	Vect3 result;
-
+#if MATH_SIMD_SSE
+	const __m128	point = _mm_setr_ps(rhs.x, rhs.y, rhs.z, 1.0f);
+	float			transformed[4];
+
+	_mm_storeu_ps(transformed, _combine(
+		_loadColumn(*this, 0), _loadColumn(*this, 1), _loadColumn(*this, 2), _loadColumn(*this, 3), point));
+	result.x = transformed[0];
+	result.y = transformed[1];
+	result.z = transformed[2];
+#else
 	result.x = static_cast<float>(
 		std::fma(
 			mat[0],
@@ -152,6 +231,26 @@ Vect3	Mat4::operator*(const Vect3& rhs) const noexcept {
 			std::fma(mat[6], rhs.y, std::fma(mat[10], rhs.z, mat[14]))
 		)
 	);
+#endif
+	return result;
+}
+
+/**
+ * @brief Full 4-component product: w of `rhs` decides whether the
+ * translation applies.
+ */
+Vect3A	Mat4::operator*(const Vect3A& rhs) const noexcept {
+	Vect3A	result;
+#if MATH_SIMD_SSE
+	_mm_store_ps(&result.x, _combine(
+		_loadColumn(*this, 0), _loadColumn(*this, 1), _loadColumn(*this, 2), _loadColumn(*this, 3),
+		_mm_load_ps(&rhs.x)));
+#else
+	result.x = mat[0] * rhs.x + mat[4] * rhs.y + mat[8] * rhs.z + mat[12] * rhs.w;
+	result.y = mat[1] * rhs.x + mat[5] * rhs.y + mat[9] * rhs.z + mat[13] * rhs.w;
+	result.z = mat[2] * rhs.x + mat[6] * rhs.y + mat[10] * rhs.z + mat[14] * rhs.w;
+	result.w = mat[3] * rhs.x + mat[7] * rhs.y + mat[11] * rhs.z + mat[15] * rhs.w;
+#endif
 	return result;
 }
 
@@ -170,7 +269,7 @@ Mat3	Mat4::minor(std::size_t row, std::size_t column) const {
 		if (line != row) {
 			for (std::size_t col = 0; col < 4; ++col) {
 				if (col != column) {
-					submatrix[y * 3 + x] = mat[line * 3 + col];
+					submatrix[y * 3 + x] = mat[line * 4 + col];
 					++x;
 				}
 			}
@@ -219,11 +318,24 @@ Mat4	Mat4::adjugate() const {
 Mat4	Mat4::transpose() const {
 	Mat4	result{};
 
+#if MATH_SIMD_SSE
+	__m128	c0 = _loadColumn(*this, 0);
+	__m128	c1 = _loadColumn(*this, 1);
+	__m128	c2 = _loadColumn(*this, 2);
+	__m128	c3 = _loadColumn(*this, 3);
+
+	_MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+	_mm_storeu_ps(&result.mat[0], c0);
+	_mm_storeu_ps(&result.mat[4], c1);
+	_mm_storeu_ps(&result.mat[8], c2);
+	_mm_storeu_ps(&result.mat[12], c3);
+#else
 	for (std::size_t i = 0; i < 4; ++i) {
 		for (std::size_t j = 0; j < 4; ++j) {
 			result[4 * i + j] = mat[4 * j + i];
 		}
 	}
+#endif
 	return result;
 }
 
@@ -406,17 +518,134 @@ Mat4	translate(const Mat4& mat, const Vect3& dir) noexcept {
 
 /**
  * @brief Compute the inverse of a 4x4 matrix.
+ *
+ * @details SSE: block-wise inversion on the 4 2x2 blocks (A B / C D), from
+ * their adjugates and determinants. Scalar: cofactors from the 12 2x2
+ * determinants of the upper and lower halves.
 */
 Mat4	inverse(const Mat4& mat) {
-	const float determinant = mat.det();
+	Mat4	result;
+
+#if MATH_SIMD_SSE
+	// Works on columns as rows: the inverse of the transpose is the
+	// transpose of the inverse
+	const __m128	c0 = _loadColumn(mat, 0);
+	const __m128	c1 = _loadColumn(mat, 1);
+	const __m128	c2 = _loadColumn(mat, 2);
+	const __m128	c3 = _loadColumn(mat, 3);
+
+	const __m128	a = _mm_movelh_ps(c0, c1);
+	const __m128	b = _mm_movehl_ps(c1, c0);
+	const __m128	c = _mm_movelh_ps(c2, c3);
+	const __m128	d = _mm_movehl_ps(c3, c2);
+
+	// (|A|, |B|, |C|, |D|)
+	const __m128	blockDets = _mm_sub_ps(
+		_mm_mul_ps(_mm_shuffle_ps(c0, c2, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(c1, c3, _MM_SHUFFLE(3, 1, 3, 1))),
+		_mm_mul_ps(_mm_shuffle_ps(c0, c2, _MM_SHUFFLE(3, 1, 3, 1)), _mm_shuffle_ps(c1, c3, _MM_SHUFFLE(2, 0, 2, 0))));
+	const __m128	detA = _mm_shuffle_ps(blockDets, blockDets, _MM_SHUFFLE(0, 0, 0, 0));
+	const __m128	detB = _mm_shuffle_ps(blockDets, blockDets, _MM_SHUFFLE(1, 1, 1, 1));
+	const __m128	detC = _mm_shuffle_ps(blockDets, blockDets, _MM_SHUFFLE(2, 2, 2, 2));
+	const __m128	detD = _mm_shuffle_ps(blockDets, blockDets, _MM_SHUFFLE(3, 3, 3, 3));
+
+	const __m128	dc = _adjMul2x2(d, c);
+	const __m128	ab = _adjMul2x2(a, b);
+
+	// Adjugates of the blocks of the inverse, times |M|
+	__m128	x = _mm_sub_ps(_mm_mul_ps(detD, a), _mul2x2(b, dc));
+	__m128	y = _mm_sub_ps(_mm_mul_ps(detB, c), _mulAdj2x2(d, ab));
+	__m128	z = _mm_sub_ps(_mm_mul_ps(detC, b), _mulAdj2x2(a, dc));
+	__m128	w = _mm_sub_ps(_mm_mul_ps(detA, d), _mul2x2(c, ab));
+
+	// |M| = |A||D| + |B||C| - tr(adj(A)B adj(D)C)
+	__m128	trace = _mm_mul_ps(ab, _mm_shuffle_ps(dc, dc, _MM_SHUFFLE(3, 1, 2, 0)));
+	trace = _mm_add_ps(trace, _mm_shuffle_ps(trace, trace, _MM_SHUFFLE(1, 0, 3, 2)));
+	trace = _mm_add_ps(trace, _mm_shuffle_ps(trace, trace, _MM_SHUFFLE(2, 3, 0, 1)));
+	const __m128	determinant = _mm_sub_ps(
+		_mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC)), trace);
+
+	if (_mm_cvtss_f32(determinant) == 0.0f) {
+		// The matrix is singular.
+		throw std::invalid_argument("Attempt to inverse a singular matrix.");
+	}
+
+	const __m128	scale = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), determinant);
+	x = _mm_mul_ps(x, scale);
+	y = _mm_mul_ps(y, scale);
+	z = _mm_mul_ps(z, scale);
+	w = _mm_mul_ps(w, scale);
+
+	// Adjugate shuffle and back to columns at once
+	_mm_storeu_ps(&result.mat[0], _mm_shuffle_ps(x, y, _MM_SHUFFLE(1, 3, 1, 3)));
+	_mm_storeu_ps(&result.mat[4], _mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 2, 0, 2)));
+	_mm_storeu_ps(&result.mat[8], _mm_shuffle_ps(z, w, _MM_SHUFFLE(1, 3, 1, 3)));
+	_mm_storeu_ps(&result.mat[12], _mm_shuffle_ps(z, w, _MM_SHUFFLE(0, 2, 0, 2)));
+#else
+	const float*	m = mat.mat;
+
+	const float	s0 = m[0] * m[5] - m[4] * m[1];
+	const float	s1 = m[0] * m[6] - m[4] * m[2];
+	const float	s2 = m[0] * m[7] - m[4] * m[3];
+	const float	s3 = m[1] * m[6] - m[5] * m[2];
+	const float	s4 = m[1] * m[7] - m[5] * m[3];
+	const float	s5 = m[2] * m[7] - m[6] * m[3];
+
+	const float	c5 = m[10] * m[15] - m[14] * m[11];
+	const float	c4 = m[9] * m[15] - m[13] * m[11];
+	const float	c3 = m[9] * m[14] - m[13] * m[10];
+	const float	c2 = m[8] * m[15] - m[12] * m[11];
+	const float	c1 = m[8] * m[14] - m[12] * m[10];
+	const float	c0 = m[8] * m[13] - m[12] * m[9];
+
+	const float	determinant = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
 	if (!determinant) {
 		// The matrix is singular.
 		throw std::invalid_argument("Attempt to inverse a singular matrix.");
 	}
+	const float	inv = 1.0f / determinant;
+
+	result.mat[0] = (m[5] * c5 - m[6] * c4 + m[7] * c3) * inv;
+	result.mat[1] = (-m[1] * c5 + m[2] * c4 - m[3] * c3) * inv;
+	result.mat[2] = (m[13] * s5 - m[14] * s4 + m[15] * s3) * inv;
+	result.mat[3] = (-m[9] * s5 + m[10] * s4 - m[11] * s3) * inv;
+
+	result.mat[4] = (-m[4] * c5 + m[6] * c2 - m[7] * c1) * inv;
+	result.mat[5] = (m[0] * c5 - m[2] * c2 + m[3] * c1) * inv;
+	result.mat[6] = (-m[12] * s5 + m[14] * s2 - m[15] * s1) * inv;
+	result.mat[7] = (m[8] * s5 - m[10] * s2 + m[11] * s1) * inv;
+
+	result.mat[8] = (m[4] * c4 - m[5] * c2 + m[7] * c0) * inv;
+	result.mat[9] = (-m[0] * c4 + m[1] * c2 - m[3] * c0) * inv;
+	result.mat[10] = (m[12] * s4 - m[13] * s2 + m[15] * s0) * inv;
+	result.mat[11] = (-m[8] * s4 + m[9] * s2 - m[11] * s0) * inv;
+
+	result.mat[12] = (-m[4] * c3 + m[5] * c1 - m[6] * c0) * inv;
+	result.mat[13] = (m[0] * c3 - m[1] * c1 + m[2] * c0) * inv;
+	result.mat[14] = (-m[12] * s3 + m[13] * s1 - m[14] * s0) * inv;
+	result.mat[15] = (m[8] * s3 - m[9] * s1 + m[10] * s0) * inv;
+#endif
+	return result;
+}
 
-	// Calculate the adjugate matrix.
-	Mat4	adjugate = mat.adjugate();
-	return adjugate * (1 / determinant);
+/**
+ * @brief Multiplies every vector by the matrix, `result` may be `vectors`.
+ * Columns are loaded once for the whole batch.
+ */
+void	transform(const Mat4& mat, std::span<const Vect3A> vectors, std::span<Vect3A> result) noexcept {
+	const std::size_t	count = std::min(vectors.size(), result.size());
+
+#if MATH_SIMD_SSE
+	const __m128	c0 = _loadColumn(mat, 0);
+	const __m128	c1 = _loadColumn(mat, 1);
+	const __m128	c2 = _loadColumn(mat, 2);
+	const __m128	c3 = _loadColumn(mat, 3);
+
+	for (std::size_t i = 0; i < count; ++i)
+		_mm_store_ps(&result[i].x, _combine(c0, c1, c2, c3, _mm_load_ps(&vectors[i].x)));
+#else
+	for (std::size_t i = 0; i < count; ++i)
+		result[i] = mat * vectors[i];
+#endif
 }
 
 /* ========================================================================== */
@@ -454,7 +683,7 @@ Mat2	Mat3::minor(std::size_t row, std::size_t column) const {
 		if (line != row) {
 			for (std::size_t col = 0; col < 3; ++col) {
 				if (col != column) {
-					submatrix[2 * y + x] = mat[2 * line + col];
+					submatrix[2 * y + x] = mat[3 * line + col];
 					++x;
 				}
 			}
@@ -6,7 +6,7 @@
 /*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2023/06/04 17:16:40 by etran             #+#    #+#             */
-/*   Updated: 2024/06/04 16:06:16 by etran            ###   ########.fr       */
+/*   Updated: 2024/07/06 15:40:12 by etran            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -15,8 +15,10 @@
 // Std
 # include <stdexcept>
 # include <cstring>
+# include <span>
 
 # include "vector.h"
+# include "simd.h"
 
 namespace math {
 struct Mat2;
@@ -60,6 +62,7 @@ struct Mat4 {
 	Mat4&			operator*=(float rhs) noexcept;
 	Mat4			operator*(float rhs) const noexcept;
 	Vect3			operator*(const Vect3& rhs) const noexcept;
+	Vect3A			operator*(const Vect3A& rhs) const noexcept;
 
 	Mat3			minor(std::size_t row, std::size_t col) const;
 	float			det() const;
@@ -82,6 +85,7 @@ Mat4	rotate(const Mat4& mat, float angle, const Vect3& axis) noexcept;
 Mat4	scale(const Mat4& mat, const Vect3& scale) noexcept;
 Mat4	translate(const Mat4& mat, const Vect3& dir) noexcept;
 Mat4	inverse(const Mat4& mat);
+void	transform(const Mat4& mat, std::span<const Vect3A> vectors, std::span<Vect3A> result) noexcept;
 
 /* ========================================================================== */
 /*                                 UTILITARIES                                */
@@ -0,0 +1,149 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   simd.h                                             :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/07/06 14:25:10 by etran             #+#    #+#             */
+/*   Updated: 2024/07/06 14:25:10 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+#pragma once
+
+// Std
+# include <cmath>
+
+# include "vector.h"
+
+// SSE2 is part of every x86-64 target. Define MATH_NO_SIMD to build the
+// scalar paths instead.
+# if !defined(MATH_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64))
+#  define MATH_SIMD_SSE 1
+#  include <emmintrin.h>
+# else
+#  define MATH_SIMD_SSE 0
+# endif
+
+namespace math {
+
+/**
+ * @brief 3D vector padded to 16 bytes, held in a single SSE register.
+ * Meant for hot loops and batches: Vect3 stays the packed type of shared and
+ * GPU data.
+ *
+ * @note w is carried along by every operation: 1 for points, 0 for
+ * directions, so matrices apply their translation to points only.
+ */
+struct alignas(16) Vect3A {
+	/* ========================================================================= */
+	/*                                    DATA                                   */
+	/* ========================================================================= */
+
+	float	x, y, z, w;
+
+	/* ========================================================================= */
+	/*                                  METHODS                                  */
+	/* ========================================================================= */
+
+	constexpr Vect3A(): x(0.0f), y(0.0f), z(0.0f), w(0.0f) {}
+	constexpr Vect3A(float new_x, float new_y, float new_z, float new_w = 0.0f):
+		x(new_x), y(new_y), z(new_z), w(new_w) {}
+	constexpr explicit Vect3A(const Vect3& vec, float new_w = 0.0f):
+		x(vec.x), y(vec.y), z(vec.z), w(new_w) {}
+
+	constexpr Vect3A(const Vect3A& other) = default;
+	constexpr Vect3A& operator=(const Vect3A& rhs) = default;
+	~Vect3A() = default;
+
+	/* ========================================================================= */
+
+	constexpr Vect3	xyz() const noexcept {
+		return Vect3(x, y, z);
+	}
+
+}; // struct Vect3A
+
+static_assert(sizeof(Vect3A) == 16, "Vect3A must fill one SSE register.");
+
+/* ========================================================================== */
+
+inline Vect3A	operator+(const Vect3A& lhs, const Vect3A& rhs) noexcept {
+	Vect3A	result;
+# if MATH_SIMD_SSE
+	_mm_store_ps(&result.x, _mm_add_ps(_mm_load_ps(&lhs.x), _mm_load_ps(&rhs.x)));
+# else
+	result = Vect3A(lhs.x + rhs.x, lhs.y + rhs.y, lhs.z + rhs.z, lhs.w + rhs.w);
+# endif
+	return result;
+}
+
+inline Vect3A	operator-(const Vect3A& lhs, const Vect3A& rhs) noexcept {
+	Vect3A	result;
+# if MATH_SIMD_SSE
+	_mm_store_ps(&result.x, _mm_sub_ps(_mm_load_ps(&lhs.x), _mm_load_ps(&rhs.x)));
+# else
+	result = Vect3A(lhs.x - rhs.x, lhs.y - rhs.y, lhs.z - rhs.z, lhs.w - rhs.w);
+# endif
+	return result;
+}
+
+inline Vect3A	operator*(const Vect3A& lhs, float rhs) noexcept {
+	Vect3A	result;
+# if MATH_SIMD_SSE
+	_mm_store_ps(&result.x, _mm_mul_ps(_mm_load_ps(&lhs.x), _mm_set1_ps(rhs)));
+# else
+	result = Vect3A(lhs.x * rhs, lhs.y * rhs, lhs.z * rhs, lhs.w * rhs);
+# endif
+	return result;
+}
+
+/**
+ * @brief Dot product of x, y and z, w is ignored.
+ */
+inline float	dot(const Vect3A& lhs, const Vect3A& rhs) noexcept {
+# if MATH_SIMD_SSE
+	const __m128	product = _mm_mul_ps(_mm_load_ps(&lhs.x), _mm_load_ps(&rhs.x));
+	const __m128	y = _mm_shuffle_ps(product, product, _MM_SHUFFLE(1, 1, 1, 1));
+	const __m128	z = _mm_shuffle_ps(product, product, _MM_SHUFFLE(2, 2, 2, 2));
+	return _mm_cvtss_f32(_mm_add_ss(_mm_add_ss(product, y), z));
+# else
+	return std::fma(lhs.x, rhs.x, std::fma(lhs.y, rhs.y, lhs.z * rhs.z));
+# endif
+}
+
+/**
+ * @brief Cross product, w of the result is 0.
+ */
+inline Vect3A	cross(const Vect3A& lhs, const Vect3A& rhs) noexcept {
+	Vect3A	result;
+# if MATH_SIMD_SSE
+	const __m128	a = _mm_load_ps(&lhs.x);
+	const __m128	b = _mm_load_ps(&rhs.x);
+	const __m128	aYzx = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+	const __m128	bYzx = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+	const __m128	zxy = _mm_sub_ps(_mm_mul_ps(a, bYzx), _mm_mul_ps(aYzx, b));
+	_mm_store_ps(&result.x, _mm_shuffle_ps(zxy, zxy, _MM_SHUFFLE(3, 0, 2, 1)));
+# else
+	result = Vect3A(
+		lhs.y * rhs.z - lhs.z * rhs.y,
+		lhs.z * rhs.x - lhs.x * rhs.z,
+		lhs.x * rhs.y - lhs.y * rhs.x,
+		0.0f);
+# endif
+	return result;
+}
+
+inline float	norm(const Vect3A& vec) noexcept {
+	return std::sqrt(dot(vec, vec));
+}
+
+/**
+ * @brief Normalizes x, y and z, w is kept.
+ */
+inline Vect3A	normalize(const Vect3A& vec) noexcept {
+	const float	inverse = 1.0f / norm(vec);
+	return Vect3A(vec.x * inverse, vec.y * inverse, vec.z * inverse, vec.w);
+}
+
+} // namespace math
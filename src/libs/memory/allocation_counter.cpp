@@ -0,0 +1,72 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   allocation_counter.cpp                             :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/06/27 11:05:47 by etran             #+#    #+#             */
+/*   Updated: 2024/06/27 11:05:47 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "allocation_counter.h"
+
+#ifdef __ALLOC_COUNT
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<u64> g_allocationCount = 0;
+
+/* ========================================================================== */
+/*                          GLOBAL ALLOCATION FUNCTIONS                       */
+/* ========================================================================== */
+
+// Array and nothrow versions forward to these by default.
+
+void* operator new(std::size_t size) {
+    g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size ? size : 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    const std::size_t align = (std::size_t)alignment;
+    if (void* ptr = std::aligned_alloc(align, (size + align - 1) & ~(align - 1)))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+#endif // __ALLOC_COUNT
+
+namespace mem {
+
+u64 getAllocationCount() noexcept {
+#ifdef __ALLOC_COUNT
+    return g_allocationCount.load(std::memory_order_relaxed);
+#else
+    return 0;
+#endif
+}
+
+} // namespace mem
@@ -0,0 +1,26 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   allocation_counter.h                               :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/06/27 11:05:47 by etran             #+#    #+#             */
+/*   Updated: 2024/06/27 11:05:47 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#pragma once
+
+#include "types.h"
+
+namespace mem {
+
+/**
+ * @brief Number of global heap allocations since startup.
+ *
+ * @note Only tracked when built with __ALLOC_COUNT, returns 0 otherwise.
+ */
+u64 getAllocationCount() noexcept;
+
+} // namespace mem
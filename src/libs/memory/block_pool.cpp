@@ -0,0 +1,148 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   block_pool.cpp                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/06/28 09:31:14 by etran             #+#    #+#             */
+/*   Updated: 2024/06/28 09:31:14 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "block_pool.h"
+
+#include "debug.h"
+
+#include <algorithm>
+#include <new>
+#include <stdexcept>
+
+#ifdef __LINUX
+# include <sys/mman.h>
+#endif
+
+namespace mem {
+
+/* ========================================================================== */
+/*                                   PUBLIC                                   */
+/* ========================================================================== */
+
+/**
+ * @param blockSize Size of a block, rounded up to BLOCK_ALIGNMENT.
+ * @param useHugePages Back the slab with huge pages when the system allows
+ * it (Linux only), falls back to regular pages otherwise.
+ */
+void BlockPool::init(const std::size_t blockSize, const u32 blockCount, const bool useHugePages) {
+    m_blockSize = (std::max(blockSize, sizeof(FreeBlock)) + BLOCK_ALIGNMENT - 1) & ~(BLOCK_ALIGNMENT - 1);
+    m_capacity = blockCount;
+    m_usedCount = 0;
+    m_reservedSize = m_blockSize * blockCount;
+
+    _reserve(useHugePages);
+
+    // Chain every block, lowest address first
+    m_freeList = nullptr;
+    for (u32 i = blockCount; i > 0; --i) {
+        FreeBlock* block = (FreeBlock*)(m_data + (i - 1) * m_blockSize);
+        block->m_next = m_freeList;
+        m_freeList = block;
+    }
+
+    LDEBUG("Block pool initialized: " << blockCount << " x " << m_blockSize << " bytes.");
+}
+
+void BlockPool::destroy() {
+#ifdef __LINUX
+    if (m_isMapped)
+        munmap(m_data, m_reservedSize);
+    else
+#endif
+        ::operator delete(m_data, std::align_val_t(BLOCK_ALIGNMENT));
+
+    m_data = nullptr;
+    m_freeList = nullptr;
+    m_capacity = 0;
+    m_usedCount = 0;
+}
+
+/* ========================================================================== */
+
+/**
+ * @brief Pops a free block. Its content is left as is.
+ *
+ * @throw std::runtime_error when every block is in use.
+ */
+void* BlockPool::acquire() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_freeList == nullptr)
+        throw std::runtime_error("block pool exhausted");
+
+    FreeBlock* block = m_freeList;
+    m_freeList = block->m_next;
+    ++m_usedCount;
+    return block;
+}
+
+void BlockPool::release(void* block) noexcept {
+    if (block == nullptr)
+        return;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    FreeBlock* freeBlock = (FreeBlock*)block;
+    freeBlock->m_next = m_freeList;
+    m_freeList = freeBlock;
+    --m_usedCount;
+}
+
+/* ========================================================================== */
+
+u32 BlockPool::getUsedCount() const noexcept {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_usedCount;
+}
+
+u32 BlockPool::getCapacity() const noexcept {
+    return m_capacity;
+}
+
+std::size_t BlockPool::getBlockSize() const noexcept {
+    return m_blockSize;
+}
+
+/* ========================================================================== */
+/*                                   PRIVATE                                  */
+/* ========================================================================== */
+
+void BlockPool::_reserve(const bool useHugePages) {
+    m_isMapped = false;
+
+#ifdef __LINUX
+    if (useHugePages) {
+        constexpr std::size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+        m_reservedSize = (m_reservedSize + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+
+        // Explicit huge pages first, then transparent ones
+        void* data = mmap(nullptr, m_reservedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (data == MAP_FAILED) {
+            data = mmap(nullptr, m_reservedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (data != MAP_FAILED)
+                madvise(data, m_reservedSize, MADV_HUGEPAGE);
+        }
+        if (data != MAP_FAILED) {
+            m_data = (u8*)data;
+            m_isMapped = true;
+            return;
+        }
+        LINFO("Huge pages unavailable, using regular allocation.");
+    }
+#else
+    (void)useHugePages;
+#endif
+
+    m_data = (u8*)::operator new(m_reservedSize, std::align_val_t(BLOCK_ALIGNMENT));
+}
+
+} // namespace mem
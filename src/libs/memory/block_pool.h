@@ -0,0 +1,94 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   block_pool.h                                       :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/06/28 09:31:14 by etran             #+#    #+#             */
+/*   Updated: 2024/06/28 09:31:14 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#pragma once
+
+#include "types.h"
+
+#include <cstddef>
+#include <mutex>
+
+namespace mem {
+
+/**
+ * @brief Slab of fixed-size blocks reserved in one go.
+ *
+ * Free blocks are chained through their own first bytes, so `acquire` and
+ * `release` are O(1) and never reach the global allocator. Blocks are
+ * cache-line aligned. Thread-safe.
+ */
+class BlockPool final {
+public:
+    /* ====================================================================== */
+    /*                             STATIC MEMBERS                             */
+    /* ====================================================================== */
+
+    static constexpr std::size_t    BLOCK_ALIGNMENT = 64;
+
+    /* ====================================================================== */
+    /*                                 METHODS                                */
+    /* ====================================================================== */
+
+    BlockPool() = default;
+    ~BlockPool() = default;
+
+    BlockPool(BlockPool&& other) = delete;
+    BlockPool(const BlockPool& other) = delete;
+    BlockPool& operator=(BlockPool&& other) = delete;
+    BlockPool& operator=(const BlockPool& other) = delete;
+
+    /* ====================================================================== */
+
+    void    init(const std::size_t blockSize, const u32 blockCount, const bool useHugePages = false);
+    void    destroy();
+
+    void*   acquire();
+    void    release(void* block) noexcept;
+
+    /* ====================================================================== */
+
+    u32         getUsedCount() const noexcept;
+    u32         getCapacity() const noexcept;
+    std::size_t getBlockSize() const noexcept;
+
+private:
+    /* ====================================================================== */
+    /*                                TYPEDEFS                                */
+    /* ====================================================================== */
+
+    struct FreeBlock {
+        FreeBlock*  m_next;
+    };
+
+    /* ====================================================================== */
+    /*                                  DATA                                  */
+    /* ====================================================================== */
+
+    u8*                 m_data = nullptr;
+    std::size_t         m_reservedSize = 0;
+    std::size_t         m_blockSize = 0;
+    u32                 m_capacity = 0;
+    u32                 m_usedCount = 0;
+    bool                m_isMapped = false;
+
+    FreeBlock*          m_freeList = nullptr;
+    mutable std::mutex  m_mutex;
+
+    /* ====================================================================== */
+    /*                                 METHODS                                */
+    /* ====================================================================== */
+
+    void    _reserve(const bool useHugePages);
+
+}; // class BlockPool
+
+} // namespace mem
@@ -0,0 +1,108 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   frame_arena.cpp                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/06/27 10:40:02 by etran             #+#    #+#             */
+/*   Updated: 2024/07/07 15:32:40 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "frame_arena.h"
+
+#include "debug.h"
+
+#include <new>
+
+namespace mem {
+
+std::array<LinearArena, FrameArena::FRAME_COUNT>  FrameArena::ms_arenas;
+u32                                               FrameArena::ms_currentFrame = 0;
+
+std::array<std::vector<FrameArena::Overflow>, FrameArena::FRAME_COUNT>  FrameArena::ms_overflows;
+std::array<std::size_t, FrameArena::FRAME_COUNT>                        FrameArena::ms_overflowSizes{};
+std::mutex                                                              FrameArena::ms_overflowMutex;
+
+/* ========================================================================== */
+/*                                   PUBLIC                                   */
+/* ========================================================================== */
+
+/**
+ * @param capacity Size of each arena, in bytes.
+ */
+void FrameArena::init(const std::size_t capacity) {
+    for (LinearArena& arena: ms_arenas)
+        arena.init(capacity);
+    ms_currentFrame = 0;
+
+    LDEBUG("Frame arenas initialized: " << FRAME_COUNT << " x " << capacity << " bytes.");
+}
+
+void FrameArena::destroy() {
+    for (u32 frame = 0; frame < FRAME_COUNT; ++frame) {
+        _releaseOverflows(frame);
+        ms_arenas[frame].destroy();
+    }
+}
+
+/**
+ * @brief Rewinds the arena of the new current frame. If that frame spilled to
+ * the heap last time, its arena is grown to hold the whole frame.
+ */
+void FrameArena::nextFrame() {
+    ms_currentFrame = (ms_currentFrame + 1) % FRAME_COUNT;
+
+    LinearArena&        arena = ms_arenas[ms_currentFrame];
+    const std::size_t   overflow = ms_overflowSizes[ms_currentFrame];
+    _releaseOverflows(ms_currentFrame);
+
+    if (overflow != 0) {
+        const std::size_t capacity = arena.getCapacity() + overflow;
+        arena.destroy();
+        arena.init(capacity);
+        LDEBUG("Frame arena grown to " << capacity << " bytes.");
+    } else {
+        arena.reset();
+    }
+}
+
+void* FrameArena::allocate(const std::size_t size, const std::size_t alignment) {
+    if (void* data = ms_arenas[ms_currentFrame].tryAllocate(size, alignment))
+        return data;
+    return _allocateOverflow(size, alignment);
+}
+
+/* ========================================================================== */
+
+const LinearArena& FrameArena::getCurrent() noexcept {
+    return ms_arenas[ms_currentFrame];
+}
+
+/* ========================================================================== */
+/*                                   PRIVATE                                  */
+/* ========================================================================== */
+
+void* FrameArena::_allocateOverflow(const std::size_t size, const std::size_t alignment) {
+    void* data = ::operator new(size, std::align_val_t(alignment));
+
+    std::lock_guard<std::mutex> lock(ms_overflowMutex);
+    try {
+        ms_overflows[ms_currentFrame].push_back({ data, alignment });
+    } catch (...) {
+        ::operator delete(data, std::align_val_t(alignment));
+        throw;
+    }
+    ms_overflowSizes[ms_currentFrame] += size + alignment;
+    return data;
+}
+
+void FrameArena::_releaseOverflows(const u32 frame) {
+    for (const Overflow& overflow: ms_overflows[frame])
+        ::operator delete(overflow.m_data, std::align_val_t(overflow.m_alignment));
+    ms_overflows[frame].clear();
+    ms_overflowSizes[frame] = 0;
+}
+
+} // namespace mem
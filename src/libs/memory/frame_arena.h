@@ -0,0 +1,118 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   frame_arena.h                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/06/27 10:40:02 by etran             #+#    #+#             */
+/*   Updated: 2024/07/07 15:32:40 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#pragma once
+
+#include "linear_arena.h"
+
+#include <array>
+#include <mutex>
+#include <vector>
+
+namespace mem {
+
+/**
+ * @brief Per-frame scratch memory.
+ *
+ * One linear arena per frame in flight. `nextFrame` is called once the fence
+ * of the oldest frame was awaited: its arena is rewound and becomes current.
+ * Anything allocated here must not outlive FRAME_COUNT frames.
+ *
+ * A frame outgrowing its arena never fails: the excess goes to the heap, and
+ * the arena grows to fit it the next time it becomes current.
+ */
+class FrameArena final {
+public:
+    /* ====================================================================== */
+    /*                             STATIC MEMBERS                             */
+    /* ====================================================================== */
+
+    static constexpr u32    FRAME_COUNT = 2;
+
+    /* ====================================================================== */
+    /*                                 METHODS                                */
+    /* ====================================================================== */
+
+    FrameArena() = delete;
+
+    /* ====================================================================== */
+
+    static void     init(const std::size_t capacity);
+    static void     destroy();
+
+    static void     nextFrame();
+    static void*    allocate(const std::size_t size, const std::size_t alignment);
+
+    /* ====================================================================== */
+
+    static const LinearArena&   getCurrent() noexcept;
+
+private:
+    /* ====================================================================== */
+    /*                             STATIC MEMBERS                             */
+    /* ====================================================================== */
+
+    struct Overflow {
+        void*       m_data;
+        std::size_t m_alignment;
+    };
+
+    static std::array<LinearArena, FRAME_COUNT> ms_arenas;
+    static u32                                  ms_currentFrame;
+
+    // Heap blocks of each frame, freed with its arena
+    static std::array<std::vector<Overflow>, FRAME_COUNT>   ms_overflows;
+    static std::array<std::size_t, FRAME_COUNT>             ms_overflowSizes;
+    static std::mutex                                       ms_overflowMutex;
+
+    /* ====================================================================== */
+    /*                                 METHODS                                */
+    /* ====================================================================== */
+
+    static void*    _allocateOverflow(const std::size_t size, const std::size_t alignment);
+    static void     _releaseOverflows(const u32 frame);
+
+}; // class FrameArena
+
+/* ========================================================================== */
+/*                                  ADAPTORS                                  */
+/* ========================================================================== */
+
+/**
+ * @brief Standard allocator drawing from the current frame arena.
+ * `deallocate` is a no-op, memory is reclaimed by `FrameArena::nextFrame`.
+ */
+template <typename T>
+class FrameAllocator {
+public:
+    using value_type = T;
+
+    FrameAllocator() noexcept = default;
+
+    template <typename U>
+    FrameAllocator(const FrameAllocator<U>&) noexcept {}
+
+    T* allocate(const std::size_t count) {
+        return (T*)FrameArena::allocate(count * sizeof(T), alignof(T));
+    }
+
+    void deallocate(T*, const std::size_t) noexcept {}
+
+    template <typename U>
+    bool operator==(const FrameAllocator<U>&) const noexcept { return true; }
+
+}; // class FrameAllocator
+
+template <typename T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
+
+} // namespace mem
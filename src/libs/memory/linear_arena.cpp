@@ -0,0 +1,81 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   linear_arena.cpp                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/06/27 10:12:31 by etran             #+#    #+#             */
+/*   Updated: 2024/07/07 15:32:40 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "linear_arena.h"
+
+#include <new>
+#include <stdexcept>
+
+namespace mem {
+
+/* ========================================================================== */
+/*                                   PUBLIC                                   */
+/* ========================================================================== */
+
+static constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+void LinearArena::init(const std::size_t capacity) {
+    m_data = (u8*)::operator new(capacity, std::align_val_t(CACHE_LINE_SIZE));
+    m_capacity = capacity;
+    m_offset.store(0, std::memory_order_relaxed);
+}
+
+void LinearArena::destroy() {
+    ::operator delete(m_data, std::align_val_t(CACHE_LINE_SIZE));
+    m_data = nullptr;
+    m_capacity = 0;
+}
+
+/**
+ * @brief Reserves `size` bytes aligned on `alignment` (a power of 2).
+ *
+ * @throw std::runtime_error when the arena is full: its capacity must cover
+ * a whole frame.
+ */
+void* LinearArena::allocate(const std::size_t size, const std::size_t alignment) {
+    void* data = tryAllocate(size, alignment);
+    if (data == nullptr)
+        throw std::runtime_error("linear arena exhausted");
+    return data;
+}
+
+/**
+ * @brief Same as allocate, but returns nullptr when the arena is full.
+ */
+void* LinearArena::tryAllocate(const std::size_t size, const std::size_t alignment) noexcept {
+    std::size_t offset = m_offset.load(std::memory_order_relaxed);
+    std::size_t begin;
+
+    do {
+        begin = (offset + alignment - 1) & ~(alignment - 1);
+        if (begin + size > m_capacity)
+            return nullptr;
+    } while (!m_offset.compare_exchange_weak(offset, begin + size, std::memory_order_relaxed));
+
+    return m_data + begin;
+}
+
+void LinearArena::reset() noexcept {
+    m_offset.store(0, std::memory_order_relaxed);
+}
+
+/* ========================================================================== */
+
+std::size_t LinearArena::getUsed() const noexcept {
+    return m_offset.load(std::memory_order_relaxed);
+}
+
+std::size_t LinearArena::getCapacity() const noexcept {
+    return m_capacity;
+}
+
+} // namespace mem
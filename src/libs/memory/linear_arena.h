@@ -0,0 +1,67 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   linear_arena.h                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/06/27 10:12:31 by etran             #+#    #+#             */
+/*   Updated: 2024/07/07 15:32:40 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#pragma once
+
+#include "types.h"
+
+#include <atomic>
+#include <cstddef>
+
+namespace mem {
+
+/**
+ * @brief Bump allocator over a single block reserved once.
+ *
+ * Allocations are never freed one by one: the whole arena is rewound with
+ * `reset`. `allocate` may be called concurrently, `reset` may not.
+ */
+class LinearArena final {
+public:
+    /* ====================================================================== */
+    /*                                 METHODS                                */
+    /* ====================================================================== */
+
+    LinearArena() = default;
+    ~LinearArena() = default;
+
+    LinearArena(LinearArena&& other) = delete;
+    LinearArena(const LinearArena& other) = delete;
+    LinearArena& operator=(LinearArena&& other) = delete;
+    LinearArena& operator=(const LinearArena& other) = delete;
+
+    /* ====================================================================== */
+
+    void    init(const std::size_t capacity);
+    void    destroy();
+
+    void*   allocate(const std::size_t size, const std::size_t alignment);
+    void*   tryAllocate(const std::size_t size, const std::size_t alignment) noexcept;
+    void    reset() noexcept;
+
+    /* ====================================================================== */
+
+    std::size_t getUsed() const noexcept;
+    std::size_t getCapacity() const noexcept;
+
+private:
+    /* ====================================================================== */
+    /*                                  DATA                                  */
+    /* ====================================================================== */
+
+    u8*                         m_data = nullptr;
+    std::size_t                 m_capacity = 0;
+    std::atomic<std::size_t>    m_offset = 0;
+
+}; // class LinearArena
+
+} // namespace mem
@@ -0,0 +1,186 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   biome_map.cpp                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/07/03 17:22:51 by etran             #+#    #+#             */
+/*   Updated: 2024/07/03 17:22:51 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "biome_map.h"
+#include "job_system.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace proc {
+
+/* ========================================================================== */
+/*                                   PUBLIC                                   */
+/* ========================================================================== */
+
+/**
+ * @note Keep the noise settings in sync with `setVoronoi` in the offline map
+ * generator.
+ */
+void BiomeMap::init(const u32 seed, const u32 capacity) {
+    m_noise.SetNoiseType(FastNoiseLite::NoiseType::NoiseType_Cellular);
+    m_noise.SetSeed(seed);
+    m_noise.SetFrequency(0.01f);
+
+    m_noise.SetCellularDistanceFunction(FastNoiseLite::CellularDistanceFunction::CellularDistanceFunction_Euclidean);
+    m_noise.SetCellularReturnType(FastNoiseLite::CellularReturnType::CellularReturnType_CellValue);
+    m_noise.SetCellularJitter(1.0f);
+
+    m_noise.SetDomainWarpType(FastNoiseLite::DomainWarpType::DomainWarpType_BasicGrid);
+    m_noise.SetDomainWarpAmp(150.0f);
+
+    m_capacity = std::max(capacity, 1U);
+}
+
+void BiomeMap::destroy() noexcept {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_index.clear();
+    m_entries.clear();
+}
+
+/* ========================================================================== */
+
+/**
+ * @brief Tile covering [tileX, tileX + 1) * TILE_SIZE on x, same on y.
+ *
+ * Computed outside of the lock on a miss: concurrent misses on different
+ * tiles run in parallel.
+ */
+BiomeMap::TilePtr BiomeMap::getTile(const i64 tileX, const i64 tileY) {
+    const u64 key = _toKey(tileX, tileY);
+
+    if (TilePtr tile = _find(key))
+        return tile;
+    return _insert(key, _computeTile(tileX, tileY));
+}
+
+f32 BiomeMap::getValue(const i64 x, const i64 y) {
+    return getTile(toTile(x), toTile(y))->getValue(toLocal(x), toLocal(y));
+}
+
+/**
+ * @brief Computes the missing tiles overlapping [min, max] in parallel.
+ */
+void BiomeMap::prefetch(const i64 minX, const i64 minY, const i64 maxX, const i64 maxY) {
+    struct Request {
+        i64     m_tileX;
+        i64     m_tileY;
+        TilePtr m_tile;
+    };
+
+    std::vector<Request> requests;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        for (i64 tileY = toTile(minY); tileY <= toTile(maxY); ++tileY) {
+            for (i64 tileX = toTile(minX); tileX <= toTile(maxX); ++tileX) {
+                if (!m_index.contains(_toKey(tileX, tileY)))
+                    requests.push_back({ tileX, tileY, nullptr });
+            }
+        }
+    }
+
+    jobs::JobSystem::parallelFor(requests.size(), 1, [&](const u32 i) {
+        requests[i].m_tile = _computeTile(requests[i].m_tileX, requests[i].m_tileY);
+    });
+
+    for (Request& request: requests)
+        _insert(_toKey(request.m_tileX, request.m_tileY), std::move(request.m_tile));
+}
+
+/**
+ * @brief Uncached value at (x, y), in [0, 1].
+ */
+f32 BiomeMap::evaluate(const f32 x, const f32 y) const noexcept {
+    f32 warpedX = x;
+    f32 warpedY = y;
+
+    m_noise.DomainWarp(warpedX, warpedY);
+    return m_noise.GetNoise(warpedX, warpedY) * 0.5f + 0.5f;
+}
+
+/* ========================================================================== */
+
+/**
+ * @brief Floored division: negative coordinates land in negative tiles.
+ */
+i64 BiomeMap::toTile(const i64 coord) noexcept {
+    return coord >= 0 ? coord / TILE_SIZE : (coord - (i64)TILE_SIZE + 1) / (i64)TILE_SIZE;
+}
+
+u32 BiomeMap::toLocal(const i64 coord) noexcept {
+    return (u32)(coord - toTile(coord) * TILE_SIZE);
+}
+
+f32 BiomeMap::Tile::getValue(const u32 x, const u32 y) const noexcept {
+    return m_values[y * TILE_SIZE + x];
+}
+
+/* ========================================================================== */
+/*                                   PRIVATE                                  */
+/* ========================================================================== */
+
+/**
+ * @brief Looks the tile up and marks it as most recently used.
+ */
+BiomeMap::TilePtr BiomeMap::_find(const u64 key) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    const auto it = m_index.find(key);
+    if (it == m_index.end())
+        return nullptr;
+
+    m_entries.splice(m_entries.begin(), m_entries, it->second);
+    return it->second->m_tile;
+}
+
+/**
+ * @brief Keeps the tile already cached if another thread was faster, evicts
+ * the least recently used one past capacity.
+ */
+BiomeMap::TilePtr BiomeMap::_insert(const u64 key, TilePtr tile) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    const auto it = m_index.find(key);
+    if (it != m_index.end()) {
+        m_entries.splice(m_entries.begin(), m_entries, it->second);
+        return it->second->m_tile;
+    }
+
+    m_entries.push_front({ key, tile });
+    m_index.emplace(key, m_entries.begin());
+
+    if (m_entries.size() > m_capacity) {
+        m_index.erase(m_entries.back().m_key);
+        m_entries.pop_back();
+    }
+    return tile;
+}
+
+BiomeMap::TilePtr BiomeMap::_computeTile(const i64 tileX, const i64 tileY) const {
+    auto tile = std::make_shared<Tile>();
+
+    const i64 originX = tileX * TILE_SIZE;
+    const i64 originY = tileY * TILE_SIZE;
+    for (u32 y = 0; y < TILE_SIZE; ++y) {
+        for (u32 x = 0; x < TILE_SIZE; ++x)
+            tile->m_values[y * TILE_SIZE + x] = evaluate((f32)(originX + x), (f32)(originY + y));
+    }
+    return tile;
+}
+
+u64 BiomeMap::_toKey(const i64 tileX, const i64 tileY) noexcept {
+    return ((u64)(u32)tileX << 32) | (u32)tileY;
+}
+
+} // namespace proc
@@ -0,0 +1,117 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   biome_map.h                                        :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/07/03 17:22:51 by etran             #+#    #+#             */
+/*   Updated: 2024/07/07 19:20:33 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#pragma once
+
+#include "types.h"
+#include "other/FastNoiseLite.h"
+
+#include <array>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace proc {
+
+/**
+ * @brief Biome cell values, computed on demand by square tiles.
+ *
+ * Same noise as the map baked by `src/setup/map_generator.cpp` (domain warped
+ * cellular noise, remapped to [0, 1]): for the same seed, the value at (x, y)
+ * matches the offline map, but any coordinate can be sampled.
+ *
+ * The most recently used tiles are kept. Tiles are handed out as shared
+ * pointers, so an evicted tile stays valid for whoever still holds it.
+ * Thread-safe.
+ */
+class BiomeMap final {
+public:
+    /* ====================================================================== */
+    /*                                TYPEDEFS                                */
+    /* ====================================================================== */
+
+    static constexpr u32    TILE_SIZE = 64;
+    static constexpr u32    DEFAULT_CAPACITY = 64;
+
+    struct Tile {
+        std::array<f32, TILE_SIZE * TILE_SIZE>  m_values;
+
+        f32     getValue(const u32 x, const u32 y) const noexcept;
+    };
+
+    using TilePtr = std::shared_ptr<const Tile>;
+
+    /* ====================================================================== */
+    /*                                 METHODS                                */
+    /* ====================================================================== */
+
+    BiomeMap() = default;
+    ~BiomeMap() = default;
+
+    BiomeMap(BiomeMap&& other) = delete;
+    BiomeMap(const BiomeMap& other) = delete;
+    BiomeMap& operator=(BiomeMap&& other) = delete;
+    BiomeMap& operator=(const BiomeMap& other) = delete;
+
+    /* ====================================================================== */
+
+    void    init(const u32 seed, const u32 capacity = DEFAULT_CAPACITY);
+    void    destroy() noexcept;
+
+    TilePtr getTile(const i64 tileX, const i64 tileY);
+    f32     getValue(const i64 x, const i64 y);
+    void    prefetch(const i64 minX, const i64 minY, const i64 maxX, const i64 maxY);
+
+    f32     evaluate(const f32 x, const f32 y) const noexcept;
+
+    /* ====================================================================== */
+
+    static i64  toTile(const i64 coord) noexcept;
+    static u32  toLocal(const i64 coord) noexcept;
+
+private:
+    /* ====================================================================== */
+    /*                                TYPEDEFS                                */
+    /* ====================================================================== */
+
+    struct Entry {
+        u64     m_key;
+        TilePtr m_tile;
+    };
+
+    using EntryList = std::list<Entry>;
+
+    /* ====================================================================== */
+    /*                                  DATA                                  */
+    /* ====================================================================== */
+
+    FastNoiseLite   m_noise;
+    u32             m_capacity = 0;
+
+    std::mutex                                      m_mutex;
+    EntryList                                       m_entries;
+    std::unordered_map<u64, EntryList::iterator>    m_index;
+
+    /* ====================================================================== */
+    /*                                 METHODS                                */
+    /* ====================================================================== */
+
+    TilePtr _find(const u64 key);
+    TilePtr _insert(const u64 key, TilePtr tile);
+    TilePtr _computeTile(const i64 tileX, const i64 tileY) const;
+
+    static u64  _toKey(const i64 tileX, const i64 tileY) noexcept;
+
+}; // class BiomeMap
+
+} // namespace proc
@@ -0,0 +1,198 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   counter_rng.h                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/07/04 09:48:03 by etran             #+#    #+#             */
+/*   Updated: 2024/07/06 11:47:22 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#pragma once
+
+#include "types.h"
+
+#include <limits>
+
+namespace proc {
+
+/**
+ * @brief Independent random sequences used by generation. Each stream gets
+ * its own numbers for a given seed and position.
+ */
+enum class RngStream: u32 {
+    Default,
+    SsaoKernel,
+    Decoration,
+    Simulation
+};
+
+/**
+ * @brief Counter-based random numbers (SplitMix64).
+ *
+ * The key is hashed from a seed, a position and a stream, and value n of the
+ * sequence is a hash of (key, n): no state is shared, any value can be drawn
+ * in any order, from any thread, and always comes out the same. Two keys
+ * differing in any input give unrelated sequences.
+ *
+ * Satisfies UniformRandomBitGenerator, for use with <random> distributions
+ * and std::shuffle.
+ */
+class CounterRng final {
+public:
+    /* ====================================================================== */
+    /*                                TYPEDEFS                                */
+    /* ====================================================================== */
+
+    using result_type = u64;
+
+    /* ====================================================================== */
+    /*                                 METHODS                                */
+    /* ====================================================================== */
+
+    constexpr CounterRng(
+        const u64 seed,
+        const i64 x = 0,
+        const i64 y = 0,
+        const i64 z = 0,
+        const RngStream stream = RngStream::Default) noexcept;
+
+    ~CounterRng() = default;
+    CounterRng(CounterRng&& other) = default;
+    CounterRng(const CounterRng& other) = default;
+    CounterRng& operator=(CounterRng&& other) = default;
+    CounterRng& operator=(const CounterRng& other) = default;
+
+    /* ====================================================================== */
+
+    constexpr u64   at(const u64 counter) const noexcept;
+
+    constexpr u64   next() noexcept;
+    constexpr u32   nextU32() noexcept;
+    constexpr f32   nextFloat() noexcept;
+    constexpr f32   nextFloat(const f32 min, const f32 max) noexcept;
+    constexpr u32   nextBelow(const u32 bound) noexcept;
+
+    constexpr void  seek(const u64 counter) noexcept;
+    constexpr u64   tell() const noexcept;
+
+    /* ====================================================================== */
+
+    static constexpr u64    min() noexcept;
+    static constexpr u64    max() noexcept;
+    constexpr u64           operator()() noexcept;
+
+private:
+    /* ====================================================================== */
+    /*                             STATIC MEMBERS                             */
+    /* ====================================================================== */
+
+    static constexpr u64    GOLDEN_GAMMA = 0x9E3779B97F4A7C15ULL;
+
+    /* ====================================================================== */
+    /*                                  DATA                                  */
+    /* ====================================================================== */
+
+    u64 m_key;
+    u64 m_counter = 0;
+
+    /* ====================================================================== */
+    /*                                 METHODS                                */
+    /* ====================================================================== */
+
+    static constexpr u64    _mix(u64 value) noexcept;
+
+}; // class CounterRng
+
+/* ========================================================================== */
+/*                                   INLINE                                   */
+/* ========================================================================== */
+
+/**
+ * @brief Each input goes through the mixer, so keys of neighboring positions
+ * share no structure.
+ */
+constexpr CounterRng::CounterRng(
+    const u64 seed,
+    const i64 x,
+    const i64 y,
+    const i64 z,
+    const RngStream stream
+) noexcept {
+    u64 key = _mix(seed + GOLDEN_GAMMA);
+    key = _mix(key ^ (u64)x);
+    key = _mix(key ^ (u64)y);
+    key = _mix(key ^ (u64)z);
+    m_key = _mix(key ^ (u64)stream);
+}
+
+/**
+ * @brief Value `counter` of the sequence, leaves the position untouched.
+ */
+constexpr u64 CounterRng::at(const u64 counter) const noexcept {
+    return _mix(m_key + (counter + 1) * GOLDEN_GAMMA);
+}
+
+constexpr u64 CounterRng::next() noexcept {
+    return at(m_counter++);
+}
+
+constexpr u32 CounterRng::nextU32() noexcept {
+    return (u32)(next() >> 32);
+}
+
+/**
+ * @brief Uniform in [0, 1), 24 bits of precision.
+ */
+constexpr f32 CounterRng::nextFloat() noexcept {
+    return (f32)(next() >> 40) * (1.0f / (1U << 24));
+}
+
+constexpr f32 CounterRng::nextFloat(const f32 min, const f32 max) noexcept {
+    return min + (max - min) * nextFloat();
+}
+
+/**
+ * @brief Uniform in [0, bound), by multiply and shift. The bias is below
+ * bound / 2^32.
+ */
+constexpr u32 CounterRng::nextBelow(const u32 bound) noexcept {
+    return (u32)(((u64)nextU32() * bound) >> 32);
+}
+
+constexpr void CounterRng::seek(const u64 counter) noexcept {
+    m_counter = counter;
+}
+
+constexpr u64 CounterRng::tell() const noexcept {
+    return m_counter;
+}
+
+/* ========================================================================== */
+
+constexpr u64 CounterRng::min() noexcept {
+    return std::numeric_limits<u64>::min();
+}
+
+constexpr u64 CounterRng::max() noexcept {
+    return std::numeric_limits<u64>::max();
+}
+
+constexpr u64 CounterRng::operator()() noexcept {
+    return next();
+}
+
+/* ========================================================================== */
+
+/**
+ * @brief SplitMix64 finalizer.
+ */
+constexpr u64 CounterRng::_mix(u64 value) noexcept {
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+    return value ^ (value >> 31);
+}
+
+} // namespace proc
@@ -0,0 +1,204 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   noise_sampler.cpp                                  :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/07/03 11:05:37 by etran             #+#    #+#             */
+/*   Updated: 2024/07/03 11:05:37 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "noise_sampler.h"
+#include "maths.h"
+
+#include <cmath>
+#include <random>
+
+namespace proc {
+
+/* ========================================================================== */
+/*                               NOISE SAMPLER                                */
+/* ========================================================================== */
+
+NoiseSampler::NoiseSampler(const NoiseMapInfo& info):
+    m_seed(info.seed.has_value() ? info.seed.value() : std::random_device()()),
+    m_layers(info.layers),
+    m_frequency(info.frequency_0),
+    m_frequencyMult(info.frequency_mult),
+    m_amplitudeMult(info.amplitude_mult),
+    m_scale(info.scale),
+    m_shift(info.shift)
+{
+    f32 amplitude = 1.0f;
+    f32 sum = 0.0f;
+    for (u32 layer = 0; layer < m_layers; ++layer) {
+        sum += amplitude;
+        amplitude *= m_amplitudeMult;
+    }
+    m_normalization = sum > 0.0f ? 1.0f / sum : 0.0f;
+}
+
+/* ========================================================================== */
+
+/**
+ * @brief Layered value noise, in [0, 1].
+ */
+f32 NoiseSampler::evaluate(const f32 x, const f32 y) const noexcept {
+    f32 frequency = m_frequency;
+    f32 amplitude = 1.0f;
+    f32 noise = 0.0f;
+
+    for (u32 layer = 0; layer < m_layers; ++layer) {
+        noise = std::fma(_valueNoise(m_seed + layer, x * frequency, y * frequency), amplitude, noise);
+        frequency *= m_frequencyMult;
+        amplitude *= m_amplitudeMult;
+    }
+    return noise * m_normalization;
+}
+
+/**
+ * @brief Layered gradient noise, in [0, 1].
+ */
+f32 NoiseSampler::evaluate(const f32 x, const f32 y, const f32 z) const noexcept {
+    f32 frequency = m_frequency;
+    f32 amplitude = 1.0f;
+    f32 noise = 0.0f;
+
+    for (u32 layer = 0; layer < m_layers; ++layer) {
+        const f32 value = _gradientNoise(m_seed + layer, x * frequency, y * frequency, z * frequency);
+        noise = std::fma(value * 0.5f + 0.5f, amplitude, noise);
+        frequency *= m_frequencyMult;
+        amplitude *= m_amplitudeMult;
+    }
+    return noise * m_normalization;
+}
+
+/**
+ * @brief Same scaling as PerlinNoise::noiseAt.
+ */
+f32 NoiseSampler::noiseAt(const i64 x, const i64 y) const noexcept {
+    return std::floor(std::fma(evaluate((f32)x, (f32)y), m_scale, m_shift));
+}
+
+f32 NoiseSampler::noiseAt(const i64 x, const i64 y, const i64 z) const noexcept {
+    return std::floor(std::fma(evaluate((f32)x, (f32)y, (f32)z), m_scale, m_shift));
+}
+
+u32 NoiseSampler::getSeed() const noexcept {
+    return m_seed;
+}
+
+/* ========================================================================== */
+
+/**
+ * @brief Smoothed interpolation of the hashed values at the 4 surrounding
+ * lattice points.
+ */
+f32 NoiseSampler::_valueNoise(const u32 seed, const f32 x, const f32 y) noexcept {
+    constexpr f32 TO_UNIT = 1.0f / (1U << 24);
+
+    const f32 floorX = std::floor(x);
+    const f32 floorY = std::floor(y);
+    const i32 x0 = (i32)floorX;
+    const i32 y0 = (i32)floorY;
+
+    const f32 c00 = (_hash(seed, x0, y0) >> 8) * TO_UNIT;
+    const f32 c10 = (_hash(seed, x0 + 1, y0) >> 8) * TO_UNIT;
+    const f32 c01 = (_hash(seed, x0, y0 + 1) >> 8) * TO_UNIT;
+    const f32 c11 = (_hash(seed, x0 + 1, y0 + 1) >> 8) * TO_UNIT;
+
+    const f32 sx = math::smoothen(x - floorX);
+    const f32 sy = math::smoothen(y - floorY);
+
+    return math::lerp(math::lerp(c00, c10, sx), math::lerp(c01, c11, sx), sy);
+}
+
+/**
+ * @brief Perlin gradient noise, gradients picked among the 12 cube edge
+ * directions. Roughly in [-1, 1].
+ */
+f32 NoiseSampler::_gradientNoise(const u32 seed, const f32 x, const f32 y, const f32 z) noexcept {
+    static constexpr i8 GRADIENTS[12][3] = {
+        { 1, 1, 0 }, { -1, 1, 0 }, { 1, -1, 0 }, { -1, -1, 0 },
+        { 1, 0, 1 }, { -1, 0, 1 }, { 1, 0, -1 }, { -1, 0, -1 },
+        { 0, 1, 1 }, { 0, -1, 1 }, { 0, 1, -1 }, { 0, -1, -1 }
+    };
+
+    const f32 floorX = std::floor(x);
+    const f32 floorY = std::floor(y);
+    const f32 floorZ = std::floor(z);
+    const i32 x0 = (i32)floorX;
+    const i32 y0 = (i32)floorY;
+    const i32 z0 = (i32)floorZ;
+    const f32 tx = x - floorX;
+    const f32 ty = y - floorY;
+    const f32 tz = z - floorZ;
+
+    const auto corner = [&](const i32 dx, const i32 dy, const i32 dz) {
+        const i8* gradient = GRADIENTS[_hash(seed, x0 + dx, y0 + dy, z0 + dz) % 12];
+        return gradient[0] * (tx - dx) + gradient[1] * (ty - dy) + gradient[2] * (tz - dz);
+    };
+
+    const f32 sx = math::smoothen(tx);
+    const f32 sy = math::smoothen(ty);
+    const f32 sz = math::smoothen(tz);
+
+    return math::lerp(
+        math::lerp(
+            math::lerp(corner(0, 0, 0), corner(1, 0, 0), sx),
+            math::lerp(corner(0, 1, 0), corner(1, 1, 0), sx),
+            sy),
+        math::lerp(
+            math::lerp(corner(0, 0, 1), corner(1, 0, 1), sx),
+            math::lerp(corner(0, 1, 1), corner(1, 1, 1), sx),
+            sy),
+        sz);
+}
+
+/**
+ * @brief Integer hash of a lattice point (murmur3 finalizer).
+ */
+u32 NoiseSampler::_hash(const u32 seed, const i32 x, const i32 y, const i32 z) noexcept {
+    u32 hash = seed;
+    hash ^= (u32)x * 0x8DA6B343U;
+    hash ^= (u32)y * 0xD8163841U;
+    hash ^= (u32)z * 0xCB1AB31FU;
+
+    hash ^= hash >> 16;
+    hash *= 0x85EBCA6BU;
+    hash ^= hash >> 13;
+    hash *= 0xC2B2AE35U;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+/* ========================================================================== */
+/*                                 NOISE TILE                                 */
+/* ========================================================================== */
+
+void NoiseTile::fill(
+    const NoiseSampler& sampler,
+    const i64 originX,
+    const i64 originY,
+    const u32 width,
+    const u32 height
+) {
+    m_values.resize(width * height);
+    m_width = width;
+
+    for (u32 y = 0; y < height; ++y) {
+        for (u32 x = 0; x < width; ++x)
+            m_values[y * width + x] = sampler.noiseAt(originX + x, originY + y);
+    }
+}
+
+/**
+ * @brief Sample at (originX + x, originY + y).
+ */
+f32 NoiseTile::noiseAt(const u32 x, const u32 y) const noexcept {
+    return m_values[y * m_width + x];
+}
+
+} // namespace proc
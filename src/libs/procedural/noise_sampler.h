@@ -0,0 +1,121 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   noise_sampler.h                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/07/03 11:05:37 by etran             #+#    #+#             */
+/*   Updated: 2024/07/03 11:05:37 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#pragma once
+
+#include "types.h"
+#include "perlin_noise.h"
+
+#include <vector>
+
+namespace proc {
+
+/**
+ * @brief Stateless layered noise.
+ *
+ * Lattice values are hashed from the seed and the integer coordinates, so the
+ * noise can be evaluated anywhere without a precomputed map or table, and
+ * from any thread. Layers are stacked like PerlinNoise does, then normalized
+ * by the sum of their amplitudes.
+ *
+ * @note `width`, `height` and `depth` of the NoiseMapInfo are ignored.
+ */
+class NoiseSampler final {
+public:
+    /* ====================================================================== */
+    /*                                 METHODS                                */
+    /* ====================================================================== */
+
+    NoiseSampler(const NoiseMapInfo& info);
+    ~NoiseSampler() = default;
+
+    NoiseSampler() = delete;
+    NoiseSampler(NoiseSampler&& other) = delete;
+    NoiseSampler(const NoiseSampler& other) = delete;
+    NoiseSampler& operator=(NoiseSampler&& other) = delete;
+    NoiseSampler& operator=(const NoiseSampler& other) = delete;
+
+    /* ====================================================================== */
+
+    f32     evaluate(const f32 x, const f32 y) const noexcept;
+    f32     evaluate(const f32 x, const f32 y, const f32 z) const noexcept;
+
+    f32     noiseAt(const i64 x, const i64 y) const noexcept;
+    f32     noiseAt(const i64 x, const i64 y, const i64 z) const noexcept;
+
+    u32     getSeed() const noexcept;
+
+private:
+    /* ====================================================================== */
+    /*                                  DATA                                  */
+    /* ====================================================================== */
+
+    const u32   m_seed;
+    const u32   m_layers;
+    const f32   m_frequency;
+    const f32   m_frequencyMult;
+    const f32   m_amplitudeMult;
+    const f32   m_scale;
+    const f32   m_shift;
+    f32         m_normalization;
+
+    /* ====================================================================== */
+    /*                                 METHODS                                */
+    /* ====================================================================== */
+
+    static f32  _valueNoise(const u32 seed, const f32 x, const f32 y) noexcept;
+    static f32  _gradientNoise(const u32 seed, const f32 x, const f32 y, const f32 z) noexcept;
+    static u32  _hash(const u32 seed, const i32 x, const i32 y, const i32 z = 0) noexcept;
+
+}; // class NoiseSampler
+
+/**
+ * @brief Samples of a NoiseSampler over a rectangle of integer coordinates,
+ * evaluated once and read as often as needed.
+ */
+class NoiseTile final {
+public:
+    /* ====================================================================== */
+    /*                                 METHODS                                */
+    /* ====================================================================== */
+
+    NoiseTile() = default;
+    ~NoiseTile() = default;
+
+    NoiseTile(NoiseTile&& other) = default;
+    NoiseTile& operator=(NoiseTile&& other) = default;
+
+    NoiseTile(const NoiseTile& other) = delete;
+    NoiseTile& operator=(const NoiseTile& other) = delete;
+
+    /* ====================================================================== */
+
+    void    fill(
+        const NoiseSampler& sampler,
+        const i64 originX,
+        const i64 originY,
+        const u32 width,
+        const u32 height);
+
+    f32     noiseAt(const u32 x, const u32 y) const noexcept;
+
+private:
+    /* ====================================================================== */
+    /*                                  DATA                                  */
+    /* ====================================================================== */
+
+    std::vector<f32>    m_values;
+    u32                 m_width = 0;
+
+}; // class NoiseTile
+
+} // namespace proc
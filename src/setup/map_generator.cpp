@@ -6,7 +6,7 @@
 /*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2024/06/10 18:06:14 by etran             #+#    #+#             */
-/*   Updated: 2024/06/13 19:07:00 by etran            ###   ########.fr       */
+/*   Updated: 2024/07/03 17:22:51 by etran            ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -56,6 +56,8 @@ void debug(const FastNoiseLite& noise, u32 size) {
 
 // https://auburn.github.io/FastNoiseLite/
 // https://github.com/Auburn/FastNoiseLite/wiki/Documentation
+// Same settings as proc::BiomeMap, which computes the map in game: keep them
+// in sync.
 static
 void setVoronoi() {
     noise.SetNoiseType(FastNoiseLite::NoiseType::NoiseType_Cellular);
@@ -0,0 +1,159 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   allocation_test.cpp                                :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/07/08 00:11:52 by etran             #+#    #+#             */
+/*   Updated: 2024/07/08 00:11:52 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "allocation_counter.h"
+#include "frame_arena.h"
+#include "draw_range_list.h"
+#include "chunk_scheduler.h"
+#include "chunk_visibility.h"
+#include "occlusion_culler.h"
+#include "job_system.h"
+#include "controller.h"
+#include "game_decl.h"
+#include "check.h"
+
+#include <atomic>
+
+using vox::gfx::DrawRangeList;
+using vox::gfx::ChunkVisibility;
+using vox::gfx::OcclusionCuller;
+using game::ChunkScheduler;
+using game::ChunkTask;
+using math::Vect3;
+
+static constexpr u32    FACE_COUNT = 6;
+static constexpr u32    LOD_COUNT = 3;
+static constexpr u32    FRAME_COUNT = 16;
+
+static DrawRangeList    s_drawRanges;
+static ChunkScheduler   s_scheduler;
+static ChunkVisibility  s_visibility;
+static OcclusionCuller  s_culler;
+
+/**
+ * @brief Contiguous ranges at the same level merge, anything else starts a
+ * new range.
+ */
+static
+void _testMerging() {
+    s_drawRanges.clear();
+    s_drawRanges.push(0, 4, 0);
+    s_drawRanges.push(4, 2, 0);
+    s_drawRanges.push(8, 1, 0);
+    s_drawRanges.push(9, 3, 1);
+    s_drawRanges.push(12, 0, 1);
+
+    const auto& ranges = s_drawRanges.getRanges();
+    CHECK(ranges.size() == 3);
+    if (ranges.size() != 3)
+        return;
+    CHECK(ranges[0].m_firstInstance == 0 && ranges[0].m_instanceCount == 6 && ranges[0].m_lod == 0);
+    CHECK(ranges[1].m_firstInstance == 8 && ranges[1].m_instanceCount == 1 && ranges[1].m_lod == 0);
+    CHECK(ranges[2].m_firstInstance == 9 && ranges[2].m_instanceCount == 3 && ranges[2].m_lod == 1);
+}
+
+/**
+ * @brief The per-frame work of the renderer and the world, as the engine
+ * loop runs it. Everything it touches is sized at init.
+ */
+static
+void _runFrame(const u32 frame) {
+    mem::FrameArena::nextFrame();
+
+    // Frame scratch: reserved, then grown past the reservation
+    mem::FrameVector<u32> visible;
+    visible.reserve(RENDER_VOLUME);
+    for (u32 i = 0; i < RENDER_VOLUME; ++i)
+        visible.push_back(i);
+    mem::FrameVector<u64> grown;
+    for (u32 i = 0; i < 4096; ++i)
+        grown.push_back(i);
+
+    // Draw ranges, worst case: no bucket follows the previous one
+    s_drawRanges.clear();
+    for (u32 i = 0; i < RENDER_VOLUME * FACE_COUNT; ++i)
+        s_drawRanges.push(i * 2, 1, i % LOD_COUNT);
+    // Then the usual case, mostly merged
+    s_drawRanges.clear();
+    for (u32 i = 0; i < RENDER_VOLUME * FACE_COUNT; ++i)
+        s_drawRanges.push(i, 1, i / (RENDER_VOLUME * 2));
+
+    // Camera moving far enough to reorder pending work
+    const Vect3 eye(frame * 48.0f, 8.0f, frame * 16.0f);
+    s_scheduler.setFocus(eye, Vect3(1.0f, 0.0f, 0.0f));
+    for (u32 i = 0; i < RENDER_VOLUME; i += 1 + frame % 3)
+        s_scheduler.push(ChunkTask::Mesh, i);
+    s_scheduler.cancel(ChunkTask::Mesh, frame % RENDER_VOLUME);
+    u32 meshed = 0;
+    s_scheduler.process(ChunkTask::Mesh, 1.0f, [&](const u32) { ++meshed; });
+    u32 chunk;
+    while (s_scheduler.pop(ChunkTask::Mesh, chunk))
+        ++meshed;
+
+    CHECK(meshed > 0);
+
+    s_visibility.update(eye);
+
+    ui::Camera camera{};
+    camera.m_position = eye;
+    camera.m_front = Vect3(0.0f, 0.0f, 1.0f);
+    camera.m_right = Vect3(-1.0f, 0.0f, 0.0f);
+    camera.m_up = Vect3(0.0f, 1.0f, 0.0f);
+    s_culler.begin(camera);
+    s_culler.addOccluder(eye + Vect3(-8.0f, -8.0f, 10.0f), eye + Vect3(8.0f, 8.0f, 11.0f));
+    s_culler.end();
+    CHECK(!s_culler.isVisible(eye + Vect3(-1.0f, -1.0f, 20.0f), eye + Vect3(1.0f, 1.0f, 21.0f)));
+
+    std::atomic<u32> sum = 0;
+    jobs::JobSystem::parallelFor(RENDER_VOLUME, 16, [&](const u32 i) {
+        sum.fetch_add(visible[i], std::memory_order_relaxed);
+    });
+    CHECK(sum == RENDER_VOLUME * (RENDER_VOLUME - 1) / 2);
+}
+
+/**
+ * @brief After a warm-up, frames must not reach the global heap.
+ */
+static
+void _testFrames() {
+    // Counting works at all: kept out of reach of allocation elision
+    const u64 before = mem::getAllocationCount();
+    int* volatile probe = new int(0);
+    delete probe;
+    CHECK(mem::getAllocationCount() > before);
+
+    // First frames may grow the arenas
+    for (u32 frame = 0; frame < mem::FrameArena::FRAME_COUNT * 2; ++frame)
+        _runFrame(frame);
+
+    const u64 start = mem::getAllocationCount();
+    for (u32 frame = 0; frame < FRAME_COUNT; ++frame)
+        _runFrame(frame);
+    CHECK(mem::getAllocationCount() == start);
+}
+
+int main() {
+    mem::FrameArena::init(1 << 20);
+    jobs::JobSystem::init(3);
+    s_drawRanges.init(RENDER_VOLUME * FACE_COUNT);
+    s_scheduler.init(RENDER_DISTANCE, RENDER_HEIGHT, RENDER_DISTANCE);
+    s_visibility.init(RENDER_DISTANCE, RENDER_HEIGHT, RENDER_DISTANCE);
+    s_culler.init();
+
+    _testMerging();
+    _testFrames();
+
+    s_scheduler.destroy();
+    jobs::JobSystem::destroy();
+    mem::FrameArena::destroy();
+    return test::conclude("allocation");
+}
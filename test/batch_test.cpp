@@ -0,0 +1,110 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   batch_test.cpp                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/07/07 21:17:45 by etran             #+#    #+#             */
+/*   Updated: 2024/07/07 22:38:50 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "batch.h"
+#include "check.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace math;
+
+// Relative to coordinates in [-100, 100]
+static constexpr f64    MAX_ERROR = 1e-4;
+
+/**
+ * @brief Every kernel against its single element version, sizes with and
+ * without a scalar tail.
+ */
+static
+void _testKernels(const std::size_t count) {
+    std::mt19937 generator(count);
+    std::uniform_real_distribution<f32> distribution(-100.0f, 100.0f);
+
+    Vect3Soa lhs(count);
+    Vect3Soa rhs(count);
+    Vect3Soa halfExtents(count);
+    Vect3Soa transformed(count);
+    std::vector<f32> result(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        lhs.set(i, Vect3(distribution(generator), distribution(generator), distribution(generator)));
+        rhs.set(i, Vect3(distribution(generator), distribution(generator), distribution(generator)));
+        halfExtents.set(i, Vect3(
+            std::fabs(distribution(generator)),
+            std::fabs(distribution(generator)),
+            std::fabs(distribution(generator))));
+    }
+    Mat4 mat;
+    for (u32 i = 0; i < 16; ++i)
+        mat[i] = distribution(generator) / 100.0f;
+    const Vect3 direction(distribution(generator), distribution(generator), distribution(generator));
+    const Vect4 plane(normalize(direction), distribution(generator));
+
+    f64 error = 0.0;
+    transform(mat, lhs, transformed);
+    for (std::size_t i = 0; i < count; ++i) {
+        const Vect3 expected = mat * lhs.get(i);
+        error = std::max({ error,
+            (f64)std::fabs(transformed.x[i] - expected.x),
+            (f64)std::fabs(transformed.y[i] - expected.y),
+            (f64)std::fabs(transformed.z[i] - expected.z) });
+    }
+    CHECK(error < MAX_ERROR);
+
+    // Products reach 3e4
+    error = 0.0;
+    dot(lhs, rhs, result);
+    for (std::size_t i = 0; i < count; ++i)
+        error = std::max(error, (f64)std::fabs(dot(lhs.get(i), rhs.get(i)) - result[i]) / 3e4);
+    dot(lhs, direction, result);
+    for (std::size_t i = 0; i < count; ++i)
+        error = std::max(error, (f64)std::fabs(dot(lhs.get(i), direction) - result[i]) / 3e4);
+    CHECK(error < MAX_ERROR);
+
+    // Visibility must not change
+    error = 0.0;
+    u32 mismatches = 0;
+    planeDistance(plane, lhs, halfExtents, result);
+    for (std::size_t i = 0; i < count; ++i) {
+        const f32 expected = planeDistance(plane, lhs.get(i), halfExtents.get(i));
+        error = std::max(error, (f64)std::fabs(expected - result[i]));
+        mismatches += (expected >= 0.0f) != (result[i] >= 0.0f);
+    }
+    CHECK(error < MAX_ERROR * 100.0);
+    CHECK(mismatches == 0);
+}
+
+/**
+ * @brief The result may alias the input.
+ */
+static
+void _testAliasing() {
+    Vect3Soa points(5);
+    for (std::size_t i = 0; i < points.size(); ++i)
+        points.set(i, Vect3((f32)i, (f32)i * 2.0f, 1.0f));
+    const Mat4 translation = translate(Mat4(1.0f), Vect3(1.0f, 2.0f, 3.0f));
+
+    transform(translation, points, points);
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        const Vect3 point = points.get(i);
+        CHECK(point.x == (f32)i + 1.0f && point.y == (f32)i * 2.0f + 2.0f && point.z == 4.0f);
+    }
+}
+
+int main() {
+    for (const std::size_t count: { 0, 1, 3, 4, 7, 256, 4099 })
+        _testKernels(count);
+    _testAliasing();
+    return test::conclude(MATH_SIMD_SSE ? "batch" : "batch, scalar");
+}
@@ -0,0 +1,46 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   check.h                                            :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/07/07 18:40:12 by etran             #+#    #+#             */
+/*   Updated: 2024/07/07 18:40:12 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#pragma once
+
+#include "types.h"
+
+#include <iostream>
+
+namespace test {
+
+inline u32 g_failures = 0;
+
+/**
+ * @brief Reports a failed expectation, the test goes on.
+ */
+inline void check(const bool condition, const char* expression, const char* file, const int line) {
+    if (condition)
+        return;
+    ++g_failures;
+    std::cerr << file << ":" << line << ": check failed: " << expression << std::endl;
+}
+
+/**
+ * @return Exit status of the test program.
+ */
+inline int conclude(const char* name) {
+    if (g_failures == 0)
+        std::cout << name << ": OK" << std::endl;
+    else
+        std::cout << name << ": " << g_failures << " failed" << std::endl;
+    return g_failures == 0 ? 0 : 1;
+}
+
+} // namespace test
+
+#define CHECK(condition) test::check((condition), #condition, __FILE__, __LINE__)
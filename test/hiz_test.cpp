@@ -0,0 +1,215 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   hiz_test.cpp                                       :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/07/08 09:14:02 by etran             #+#    #+#             */
+/*   Updated: 2024/07/08 09:14:02 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "hiz_pyramid.h"
+#include "check.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using vox::gfx::HiZPyramid;
+
+static HiZPyramid   s_pyramid;
+
+/**
+ * @brief First level pixels a texel covers, end excluded: texels at the end
+ * of a row or column run up to the image edge.
+ */
+static
+void _getSpan(const u32 level, const u32 texel, const u32 size, const u32 baseSize, u32& start, u32& end) {
+    start = texel << level;
+    end = texel + 1 == size ? baseSize : (texel + 1) << level;
+}
+
+static
+std::vector<f32> _makeImage(const u32 width, const u32 height, std::mt19937& generator) {
+    std::uniform_real_distribution<f32> distribution(0.0f, 1.0f);
+    std::vector<f32> image(width * height);
+    for (f32& depth: image)
+        depth = distribution(generator);
+
+    // Some holes, where nothing was drawn
+    for (u32 i = 0; i < image.size(); i += 7)
+        image[i] = 0.0f;
+    return image;
+}
+
+/**
+ * @brief Per pixel reference of HiZPyramid::isVisible.
+ */
+static
+bool _isVisible(
+    const std::vector<f32>& image,
+    const u32 width,
+    const u32 height,
+    const f32 minX,
+    const f32 minY,
+    const f32 maxX,
+    const f32 maxY,
+    const f32 nearest
+) {
+    const i32 startX = std::max((i32)std::floor(minX), 0);
+    const i32 endX = std::min((i32)std::ceil(maxX), (i32)width);
+    const i32 startY = std::max((i32)std::floor(minY), 0);
+    const i32 endY = std::min((i32)std::ceil(maxY), (i32)height);
+
+    for (i32 y = startY; y < endY; ++y) {
+        for (i32 x = startX; x < endX; ++x) {
+            if (image[y * width + x] <= nearest)
+                return true;
+        }
+    }
+    return false;
+}
+
+/* ========================================================================== */
+
+/**
+ * @brief Levels halve down to a single texel, odd sizes rounded down.
+ */
+static
+void _testLevels() {
+    s_pyramid.init(7, 5);
+    CHECK(s_pyramid.getLevelCount() == 3);
+    CHECK(s_pyramid.getWidth(1) == 3 && s_pyramid.getHeight(1) == 2);
+    CHECK(s_pyramid.getWidth(2) == 1 && s_pyramid.getHeight(2) == 1);
+
+    s_pyramid.init(8, 8);
+    CHECK(s_pyramid.getLevelCount() == 4);
+    CHECK(s_pyramid.getWidth(3) == 1 && s_pyramid.getHeight(3) == 1);
+
+    s_pyramid.init(16, 3);
+    CHECK(s_pyramid.getLevelCount() == 5);
+    CHECK(s_pyramid.getWidth(1) == 8 && s_pyramid.getHeight(1) == 1);
+    CHECK(s_pyramid.getWidth(4) == 1 && s_pyramid.getHeight(4) == 1);
+
+    s_pyramid.init(1, 1);
+    CHECK(s_pyramid.getLevelCount() == 1);
+}
+
+/**
+ * @brief Every texel keeps the farthest depth of the first level pixels under
+ * it, leftover rows and columns included.
+ */
+static
+void _testReduce() {
+    std::mt19937 generator(42);
+    const u32 sizes[][2] = { { 7, 5 }, { 8, 8 }, { 33, 17 }, { 64, 3 }, { 1, 9 } };
+
+    for (const auto& size: sizes) {
+        const u32 width = size[0];
+        const u32 height = size[1];
+        const std::vector<f32> image = _makeImage(width, height, generator);
+
+        s_pyramid.init(width, height);
+        s_pyramid.build(image.data());
+
+        u32 mismatches = 0;
+        for (u32 level = 0; level < s_pyramid.getLevelCount(); ++level) {
+            for (u32 y = 0; y < s_pyramid.getHeight(level); ++y) {
+                for (u32 x = 0; x < s_pyramid.getWidth(level); ++x) {
+                    u32 startX, endX, startY, endY;
+                    _getSpan(level, x, s_pyramid.getWidth(level), width, startX, endX);
+                    _getSpan(level, y, s_pyramid.getHeight(level), height, startY, endY);
+
+                    f32 farthest = 1.0f;
+                    for (u32 py = startY; py < endY; ++py)
+                        for (u32 px = startX; px < endX; ++px)
+                            farthest = std::min(farthest, image[py * width + px]);
+                    mismatches += s_pyramid.getDepth(level, x, y) != farthest;
+                }
+            }
+        }
+        CHECK(mismatches == 0);
+    }
+}
+
+/**
+ * @brief The box test matches a per pixel test, and the coarse one never
+ * drops what it keeps.
+ */
+static
+void _testVisible() {
+    std::mt19937 generator(7);
+    std::uniform_real_distribution<f32> unit(0.0f, 1.0f);
+    const u32 sizes[][2] = { { 7, 5 }, { 64, 64 }, { 100, 37 } };
+
+    for (const auto& size: sizes) {
+        const u32 width = size[0];
+        const u32 height = size[1];
+        const std::vector<f32> image = _makeImage(width, height, generator);
+
+        s_pyramid.init(width, height);
+        s_pyramid.build(image.data());
+
+        u32 mismatches = 0;
+        u32 dropped = 0;
+        for (u32 i = 0; i < 2000; ++i) {
+            // Partly off screen at times
+            const f32 x0 = unit(generator) * (width + 8) - 4.0f;
+            const f32 y0 = unit(generator) * (height + 8) - 4.0f;
+            const f32 x1 = x0 + unit(generator) * width;
+            const f32 y1 = y0 + unit(generator) * height;
+            const f32 nearest = unit(generator) * 0.3f;
+
+            const bool visible = s_pyramid.isVisible(x0, y0, x1, y1, nearest);
+            mismatches += visible != _isVisible(image, width, height, x0, y0, x1, y1, nearest);
+            dropped += visible && !s_pyramid.isVisibleCoarse(x0, y0, x1, y1, nearest);
+        }
+        CHECK(mismatches == 0);
+        CHECK(dropped == 0);
+    }
+}
+
+/**
+ * @brief Screen covered by an occluder at depth 0.5 but for a hole in a
+ * corner, boxes projected over it.
+ */
+static
+void _testOccluder() {
+    constexpr u32 size = 64;
+    std::vector<f32> image(size * size, 0.5f);
+    for (u32 y = 56; y < size; ++y)
+        for (u32 x = 56; x < size; ++x)
+            image[y * size + x] = 0.0f;
+
+    s_pyramid.init(size, size);
+    s_pyramid.build(image.data());
+
+    // Behind it, in front of it
+    CHECK(!s_pyramid.isVisible(8.0f, 8.0f, 24.0f, 24.0f, 0.3f));
+    CHECK(!s_pyramid.isVisibleCoarse(8.0f, 8.0f, 24.0f, 24.0f, 0.3f));
+    CHECK(s_pyramid.isVisible(8.0f, 8.0f, 24.0f, 24.0f, 0.6f));
+    CHECK(s_pyramid.isVisibleCoarse(8.0f, 8.0f, 24.0f, 24.0f, 0.6f));
+
+    // Over the hole
+    CHECK(s_pyramid.isVisible(50.0f, 50.0f, 60.0f, 60.0f, 0.3f));
+    CHECK(s_pyramid.isVisibleCoarse(50.0f, 50.0f, 60.0f, 60.0f, 0.3f));
+
+    // Next to the hole: the coarse texel covering both keeps it
+    CHECK(!s_pyramid.isVisible(40.0f, 40.0f, 54.0f, 54.0f, 0.3f));
+    CHECK(s_pyramid.isVisibleCoarse(40.0f, 40.0f, 54.0f, 54.0f, 0.3f));
+
+    // Off screen
+    CHECK(!s_pyramid.isVisible(-20.0f, 8.0f, -4.0f, 24.0f, 0.9f));
+    CHECK(!s_pyramid.isVisibleCoarse(70.0f, 8.0f, 80.0f, 24.0f, 0.9f));
+}
+
+int main() {
+    _testLevels();
+    _testReduce();
+    _testVisible();
+    _testOccluder();
+    return test::conclude("hiz");
+}
@@ -0,0 +1,162 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   job_system_test.cpp                                :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/07/07 22:47:26 by etran             #+#    #+#             */
+/*   Updated: 2024/07/07 22:47:26 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "job_system.h"
+#include "check.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using jobs::Counter;
+using jobs::JobSystem;
+
+/**
+ * @brief Every index runs exactly once, queues overflowing or not.
+ */
+static
+void _testCoverage() {
+    for (const u32 count: { 0U, 1U, 1000U, 3U * JobSystem::QUEUE_CAPACITY }) {
+        for (const u32 grain: { 1U, 7U, 64U }) {
+            std::unique_ptr<std::atomic<u32>[]> hits(new std::atomic<u32>[count + 1]());
+            JobSystem::parallelFor(count, grain, [&](const u32 i) {
+                hits[i].fetch_add(1, std::memory_order_relaxed);
+            });
+
+            u32 wrong = 0;
+            for (u32 i = 0; i < count; ++i)
+                wrong += hits[i].load() != 1;
+            CHECK(wrong == 0);
+        }
+    }
+}
+
+/**
+ * @brief Jobs waiting on jobs of their own: workers run pending jobs while
+ * they wait, nothing deadlocks.
+ */
+static
+void _testNested() {
+    constexpr u32 OUTER = 64;
+    constexpr u32 INNER = 1000;
+
+    std::atomic<u64> sum = 0;
+    JobSystem::parallelFor(OUTER, 1, [&](const u32 i) {
+        JobSystem::parallelFor(INNER, 16, [&](const u32 j) {
+            JobSystem::parallelFor(2, 1, [&](const u32 k) {
+                sum.fetch_add((u64)i * INNER * 2 + j * 2 + k, std::memory_order_relaxed);
+            });
+        });
+    });
+
+    constexpr u64 TOTAL = (u64)OUTER * INNER * 2;
+    CHECK(sum.load() == TOTAL * (TOTAL - 1) / 2);
+}
+
+/**
+ * @brief Slow jobs pushed by the main thread only: the workers get them by
+ * stealing. Several rounds, so steals race with the owner popping.
+ */
+static
+void _testSteals() {
+    constexpr u32 ROUNDS = 50;
+    constexpr u32 JOBS = 200;
+
+    std::vector<std::atomic<u32>> jobsPerThread(JobSystem::getWorkerCount() + 1);
+    u32 wrong = 0;
+    for (u32 round = 0; round < ROUNDS; ++round) {
+        std::vector<std::atomic<u32>> hits(JOBS);
+        JobSystem::parallelFor(JOBS, 1, [&](const u32 i) {
+            hits[i].fetch_add(1, std::memory_order_relaxed);
+            jobsPerThread[JobSystem::getThreadIndex()].fetch_add(1, std::memory_order_relaxed);
+
+            const auto end = std::chrono::steady_clock::now() + std::chrono::microseconds(20);
+            while (std::chrono::steady_clock::now() < end);
+        });
+        for (const std::atomic<u32>& hit: hits)
+            wrong += hit.load() != 1;
+    }
+    CHECK(wrong == 0);
+
+    u32 stolen = 0;
+    for (u32 thread = 1; thread < jobsPerThread.size(); ++thread)
+        stolen += jobsPerThread[thread].load();
+    CHECK(JobSystem::getWorkerCount() == 0 || stolen > 0);
+}
+
+/**
+ * @brief A throwing job still counts down, its exception reaches the waiting
+ * thread, and the other jobs of the batch run.
+ */
+static
+void _testExceptions() {
+    constexpr u32 COUNT = 1000;
+
+    std::atomic<u32> ran = 0;
+    bool caught = false;
+    try {
+        JobSystem::parallelFor(COUNT, 1, [&](const u32 i) {
+            ran.fetch_add(1, std::memory_order_relaxed);
+            if (i % 100 == 37)
+                throw std::runtime_error("job failed");
+        });
+    } catch (const std::runtime_error&) {
+        caught = true;
+    }
+    CHECK(caught);
+    CHECK(ran.load() == COUNT);
+
+    // Thrown from a nested batch, forwarded through both counters
+    caught = false;
+    try {
+        JobSystem::parallelFor(8, 1, [](const u32 i) {
+            JobSystem::parallelFor(8, 1, [i](const u32 j) {
+                if (i == 3 && j == 5)
+                    throw std::out_of_range("nested job failed");
+            });
+        });
+    } catch (const std::out_of_range&) {
+        caught = true;
+    }
+    CHECK(caught);
+
+    // Counters are not reused: a fresh batch succeeds
+    Counter counter;
+    std::atomic<u32> after = 0;
+    JobSystem::parallelFor(COUNT, 8, [&](const u32) { after.fetch_add(1, std::memory_order_relaxed); }, counter);
+    JobSystem::wait(counter);
+    CHECK(after.load() == COUNT);
+}
+
+static
+void _runAll() {
+    _testCoverage();
+    _testNested();
+    _testSteals();
+    _testExceptions();
+}
+
+int main() {
+    // Not initialized: jobs run inline
+    _runAll();
+
+    for (const u32 workerCount: { 1U, 3U, 7U }) {
+        JobSystem::init(workerCount);
+        CHECK(JobSystem::getWorkerCount() == workerCount);
+        _runAll();
+        JobSystem::destroy();
+    }
+    return test::conclude("job system");
+}
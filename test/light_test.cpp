@@ -0,0 +1,103 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   light_test.cpp                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/07/07 20:03:47 by etran             #+#    #+#             */
+/*   Updated: 2024/07/07 22:31:09 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "world.h"
+#include "job_system.h"
+#include "counter_rng.h"
+#include "check.h"
+
+#include <vector>
+
+using namespace game;
+
+static World    s_world;
+
+
+static
+std::vector<u8> _snapshot(const LightChannel channel) {
+    std::vector<u8> levels;
+    levels.reserve(WORLD_BLOCK_SIZE * WORLD_BLOCK_SIZE * WORLD_BLOCK_HEIGHT);
+    for (i32 z = 0; z < WORLD_BLOCK_SIZE; ++z) {
+        for (i32 y = 0; y < WORLD_BLOCK_HEIGHT; ++y) {
+            for (i32 x = 0; x < WORLD_BLOCK_SIZE; ++x)
+                levels.push_back(s_world.getLight().getLight(channel, x, y, z));
+        }
+    }
+    return levels;
+}
+
+/**
+ * @brief Sky light runs down open columns at full level and stops at the
+ * ground.
+ */
+static
+void _testSky() {
+    const LightEngine& light = s_world.getLight();
+
+    u32 wrong = 0;
+    for (i32 z = 0; z < WORLD_BLOCK_SIZE; ++z) {
+        for (i32 x = 0; x < WORLD_BLOCK_SIZE; ++x) {
+            for (i32 y = WORLD_BLOCK_HEIGHT - 1; y >= 0 && s_world.getBlock(x, y, z).getMaterial() == MaterialType::Air; --y)
+                wrong += light.getLight(LightChannel::Sky, x, y, z) != LightEngine::MAX_LIGHT;
+        }
+    }
+    CHECK(wrong == 0);
+}
+
+/**
+ * @brief Edits relit in place end up as if the world was lit from scratch.
+ */
+static
+void _testIncremental() {
+    constexpr u32 EDITS = 2000;
+
+    LightEngine& light = s_world.getLight();
+    proc::CounterRng rng(5);
+
+    for (u32 i = 0; i < EDITS; ++i) {
+        const i32 x = rng.nextBelow(WORLD_BLOCK_SIZE);
+        const i32 y = rng.nextBelow(WORLD_BLOCK_HEIGHT);
+        const i32 z = rng.nextBelow(WORLD_BLOCK_SIZE);
+
+        switch (rng.nextBelow(4)) {
+            case 0:
+                light.setEmitter(x, y, z, rng.nextBelow(LightEngine::MAX_LIGHT + 1));
+                break;
+            case 1:
+                s_world.setBlock(x, y, z, MaterialType::Water);
+                break;
+            case 2:
+                s_world.setBlock(x, y, z, MaterialType::Stone);
+                break;
+            default:
+                s_world.setBlock(x, y, z, MaterialType::Air);
+        }
+    }
+
+    const std::vector<u8> sky = _snapshot(LightChannel::Sky);
+    const std::vector<u8> block = _snapshot(LightChannel::Block);
+    light.compute();
+    CHECK(sky == _snapshot(LightChannel::Sky));
+    CHECK(block == _snapshot(LightChannel::Block));
+}
+
+int main() {
+    jobs::JobSystem::init();
+    s_world.init(42);
+
+    _testSky();
+    _testIncremental();
+
+    s_world.destroy();
+    jobs::JobSystem::destroy();
+    return test::conclude("light");
+}
@@ -0,0 +1,211 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   math_test.cpp                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/07/07 20:52:37 by etran             #+#    #+#             */
+/*   Updated: 2024/07/07 22:38:50 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "matrix.h"
+#include "check.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace math;
+
+// Reference results computed in double precision, matrices in [-2, 2]
+
+static constexpr u32    SAMPLES = 100000;
+static constexpr f64    MAX_ERROR = 1e-5;
+static constexpr f64    MAX_INVERSE_ERROR = 1e-3;
+static constexpr f64    MAX_INVERSE_NORM = 50.0;
+
+static
+void _multiply(const f64* lhs, const f64* rhs, f64* result) {
+    for (u32 i = 0; i < 4; ++i) {
+        for (u32 j = 0; j < 4; ++j) {
+            result[i * 4 + j] = 0.0;
+            for (u32 k = 0; k < 4; ++k)
+                result[i * 4 + j] += lhs[k * 4 + j] * rhs[i * 4 + k];
+        }
+    }
+}
+
+/**
+ * @brief Gauss-Jordan with partial pivoting.
+ *
+ * @return False if the matrix is singular.
+ */
+static
+bool _inverse(const f64* mat, f64* result) {
+    f64 rows[4][8];
+    for (u32 row = 0; row < 4; ++row) {
+        for (u32 col = 0; col < 4; ++col) {
+            rows[row][col] = mat[col * 4 + row];
+            rows[row][4 + col] = row == col;
+        }
+    }
+    for (u32 col = 0; col < 4; ++col) {
+        u32 pivot = col;
+        for (u32 row = col; row < 4; ++row) {
+            if (std::abs(rows[row][col]) > std::abs(rows[pivot][col]))
+                pivot = row;
+        }
+        if (rows[pivot][col] == 0.0)
+            return false;
+        std::swap(rows[pivot], rows[col]);
+
+        const f64 scale = rows[col][col];
+        for (u32 k = 0; k < 8; ++k)
+            rows[col][k] /= scale;
+        for (u32 row = 0; row < 4; ++row) {
+            if (row == col)
+                continue;
+            const f64 factor = rows[row][col];
+            for (u32 k = 0; k < 8; ++k)
+                rows[row][k] -= factor * rows[col][k];
+        }
+    }
+    for (u32 row = 0; row < 4; ++row) {
+        for (u32 col = 0; col < 4; ++col)
+            result[col * 4 + row] = rows[row][4 + col];
+    }
+    return true;
+}
+
+static
+void _testRandom() {
+    std::mt19937 generator(1);
+    std::uniform_real_distribution<f32> distribution(-2.0f, 2.0f);
+
+    f64 mulError = 0.0;
+    f64 transposeError = 0.0;
+    f64 inverseError = 0.0;
+    f64 pointError = 0.0;
+    u32 inverted = 0;
+    for (u32 n = 0; n < SAMPLES; ++n) {
+        Mat4 lhs;
+        Mat4 rhs;
+        f64 lhsRef[16];
+        f64 rhsRef[16];
+        for (u32 i = 0; i < 16; ++i) {
+            lhs[i] = distribution(generator);
+            rhs[i] = distribution(generator);
+            lhsRef[i] = lhs[i];
+            rhsRef[i] = rhs[i];
+        }
+
+        f64 productRef[16];
+        _multiply(lhsRef, rhsRef, productRef);
+        const Mat4 product = lhs * rhs;
+        for (u32 i = 0; i < 16; ++i)
+            mulError = std::max(mulError, std::abs(product[i] - productRef[i]));
+
+        const Mat4 transposed = lhs.transpose();
+        for (u32 i = 0; i < 4; ++i) {
+            for (u32 j = 0; j < 4; ++j)
+                transposeError = std::max(transposeError, (f64)std::abs(transposed[i * 4 + j] - lhs[j * 4 + i]));
+        }
+
+        // Error relative to the size of the inverse, ill-conditioned samples skipped
+        f64 inverseRef[16];
+        if (_inverse(lhsRef, inverseRef)) {
+            f64 norm = 0.0;
+            for (u32 i = 0; i < 16; ++i)
+                norm = std::max(norm, std::abs(inverseRef[i]));
+            if (norm < MAX_INVERSE_NORM) {
+                const Mat4 inverted4 = inverse(lhs);
+                for (u32 i = 0; i < 16; ++i)
+                    inverseError = std::max(inverseError, std::abs(inverted4[i] - inverseRef[i]) / std::max(1.0, norm));
+                ++inverted;
+            }
+        }
+
+        const Vect3 point(distribution(generator), distribution(generator), distribution(generator));
+        const Vect3 transformed = lhs * point;
+        for (u32 j = 0; j < 3; ++j) {
+            f64 expected = lhsRef[12 + j];
+            for (u32 k = 0; k < 3; ++k)
+                expected += lhsRef[k * 4 + j] * point[k];
+            pointError = std::max(pointError, std::abs(transformed[j] - expected));
+        }
+    }
+    CHECK(mulError < MAX_ERROR);
+    CHECK(transposeError == 0.0);
+    CHECK(inverted > SAMPLES / 2);
+    CHECK(inverseError < MAX_INVERSE_ERROR);
+    CHECK(pointError < MAX_ERROR);
+}
+
+static
+void _testSpecialCases() {
+    const Mat4 identity(1.0f);
+    Mat4 singular(1.0f);
+    singular[15] = 0.0f;
+
+    bool thrown = false;
+    try {
+        inverse(singular);
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    CHECK(thrown);
+
+    const Mat4 scaleTranslate{ 2, 0, 0, 0, 0, 3, 0, 0, 0, 0, 4, 0, 1, 2, 3, 1 };
+    CHECK(std::abs(scaleTranslate.det() - 24.0f) < MAX_ERROR);
+
+    const Mat4 product = scaleTranslate * inverse(scaleTranslate);
+    for (u32 i = 0; i < 16; ++i)
+        CHECK(std::abs(product[i] - identity[i]) < MAX_ERROR);
+}
+
+/**
+ * @brief 4-component and batch products match the Vect3 one.
+ */
+static
+void _testVect3A() {
+    const Vect3A lhs(1.0f, 2.0f, 3.0f);
+    const Vect3A rhs(4.0f, 5.0f, 6.0f);
+    const Vect3A crossed = cross(lhs, rhs);
+    CHECK(dot(lhs, rhs) == 32.0f);
+    CHECK(crossed.x == -3.0f && crossed.y == 6.0f && crossed.z == -3.0f && crossed.w == 0.0f);
+
+    std::mt19937 generator(2);
+    std::uniform_real_distribution<f32> distribution(-2.0f, 2.0f);
+    Mat4 mat;
+    for (u32 i = 0; i < 16; ++i)
+        mat[i] = distribution(generator);
+
+    std::vector<Vect3A> points(1000);
+    std::vector<Vect3A> transformed(points.size());
+    for (Vect3A& point: points)
+        point = Vect3A(distribution(generator), distribution(generator), distribution(generator), 1.0f);
+    transform(mat, points, transformed);
+
+    f64 error = 0.0;
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        const Vect3 expected = mat * points[i].xyz();
+        error = std::max({ error,
+            (f64)std::abs(transformed[i].x - expected.x),
+            (f64)std::abs(transformed[i].y - expected.y),
+            (f64)std::abs(transformed[i].z - expected.z) });
+        const Vect3A single = mat * points[i];
+        CHECK(single.x == transformed[i].x && single.y == transformed[i].y && single.z == transformed[i].z);
+    }
+    CHECK(error < MAX_ERROR);
+}
+
+int main() {
+    _testRandom();
+    _testSpecialCases();
+    _testVect3A();
+    return test::conclude(MATH_SIMD_SSE ? "math" : "math, scalar");
+}
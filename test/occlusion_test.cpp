@@ -0,0 +1,163 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   occlusion_test.cpp                                 :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/07/07 22:58:37 by etran             #+#    #+#             */
+/*   Updated: 2024/07/07 22:58:37 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "occlusion_culler.h"
+#include "controller.h"
+#include "chunk.h"
+#include "block_pool.h"
+#include "maths.h"
+#include "check.h"
+
+using vox::gfx::OcclusionCuller;
+using math::Vect3;
+
+static OcclusionCuller  s_culler;
+
+/**
+ * @brief Camera at `eye`, looking along +z, set up as the controller does.
+ */
+static
+ui::Camera _makeCamera(const Vect3& eye) {
+    ui::Camera camera{};
+    camera.m_position = eye;
+    camera.m_front = Vect3(0.0f, 0.0f, 1.0f);
+    camera.m_right = math::normalize(math::cross(camera.m_front, Vect3(0.0f, 1.0f, 0.0f)));
+    camera.m_up = math::cross(camera.m_right, camera.m_front);
+    return camera;
+}
+
+/**
+ * @brief Nothing drawn: everything is visible.
+ */
+static
+void _testEmpty() {
+    s_culler.begin(_makeCamera(Vect3(0.0f)));
+    s_culler.end();
+
+    CHECK(s_culler.isVisible(Vect3(-1.0f, -1.0f, 20.0f), Vect3(1.0f, 1.0f, 21.0f)));
+    CHECK(s_culler.isVisible(Vect3(-1.0f, -1.0f, 200.0f), Vect3(1.0f, 1.0f, 201.0f)));
+}
+
+/**
+ * @brief A 16x16 wall 10 blocks ahead, boxes around it.
+ */
+static
+void _testWall() {
+    s_culler.begin(_makeCamera(Vect3(0.0f)));
+    s_culler.addOccluder(Vect3(-8.0f, -8.0f, 10.0f), Vect3(8.0f, 8.0f, 11.0f));
+    s_culler.end();
+
+    // Behind it, whatever the distance
+    CHECK(!s_culler.isVisible(Vect3(-1.0f, -1.0f, 20.0f), Vect3(1.0f, 1.0f, 21.0f)));
+    CHECK(!s_culler.isVisible(Vect3(-4.0f, -4.0f, 12.0f), Vect3(4.0f, 4.0f, 16.0f)));
+    CHECK(!s_culler.isVisible(Vect3(-10.0f, -10.0f, 100.0f), Vect3(10.0f, 10.0f, 110.0f)));
+
+    // In front of it, or touching its front face
+    CHECK(s_culler.isVisible(Vect3(-1.0f, -1.0f, 5.0f), Vect3(1.0f, 1.0f, 6.0f)));
+    CHECK(s_culler.isVisible(Vect3(-1.0f, -1.0f, 9.0f), Vect3(1.0f, 1.0f, 10.0f)));
+
+    // Beside it, partly behind its edge, or wider than its shadow
+    CHECK(s_culler.isVisible(Vect3(20.0f, -1.0f, 20.0f), Vect3(22.0f, 1.0f, 21.0f)));
+    CHECK(s_culler.isVisible(Vect3(14.0f, -1.0f, 20.0f), Vect3(18.0f, 1.0f, 21.0f)));
+    CHECK(s_culler.isVisible(Vect3(-30.0f, -1.0f, 30.0f), Vect3(30.0f, 1.0f, 31.0f)));
+
+    // Crossing the near plane or behind the camera: kept, frustum culling
+    // handles them
+    CHECK(s_culler.isVisible(Vect3(-1.0f, -1.0f, -5.0f), Vect3(1.0f, 1.0f, 1.0f)));
+    CHECK(s_culler.isVisible(Vect3(-1.0f, -1.0f, -10.0f), Vect3(1.0f, 1.0f, -9.0f)));
+}
+
+/**
+ * @brief Occluders only hide what they cover together, and only from the side
+ * they were drawn from.
+ */
+static
+void _testCombined() {
+    s_culler.begin(_makeCamera(Vect3(0.0f)));
+    s_culler.addOccluder(Vect3(-8.0f, -8.0f, 10.0f), Vect3(0.5f, 8.0f, 11.0f));
+    s_culler.addOccluder(Vect3(-0.5f, -8.0f, 10.0f), Vect3(8.0f, 8.0f, 11.0f));
+    s_culler.end();
+
+    // Overlapping halves hide the seam
+    CHECK(!s_culler.isVisible(Vect3(-1.0f, -1.0f, 20.0f), Vect3(1.0f, 1.0f, 21.0f)));
+
+    // Occluders behind the camera hide nothing ahead
+    s_culler.begin(_makeCamera(Vect3(0.0f)));
+    s_culler.addOccluder(Vect3(-8.0f, -8.0f, -11.0f), Vect3(8.0f, 8.0f, -10.0f));
+    s_culler.end();
+    CHECK(s_culler.isVisible(Vect3(-1.0f, -1.0f, 20.0f), Vect3(1.0f, 1.0f, 21.0f)));
+}
+
+/**
+ * @brief Solid ground seen from above, as chunk bases are: what lies inside
+ * it is hidden, what stands on it is not.
+ */
+static
+void _testGround() {
+    s_culler.begin(_makeCamera(Vect3(0.0f, 10.0f, 0.0f)));
+    s_culler.addOccluder(Vect3(-64.0f, -16.0f, 2.0f), Vect3(64.0f, 0.0f, 128.0f));
+    s_culler.end();
+
+    CHECK(!s_culler.isVisible(Vect3(-2.0f, -10.0f, 30.0f), Vect3(2.0f, -6.0f, 34.0f)));
+    CHECK(!s_culler.isVisible(Vect3(-8.0f, -12.0f, 40.0f), Vect3(0.0f, -4.0f, 48.0f)));
+    CHECK(s_culler.isVisible(Vect3(-2.0f, 0.0f, 30.0f), Vect3(2.0f, 4.0f, 34.0f)));
+    CHECK(s_culler.isVisible(Vect3(-2.0f, -4.0f, 30.0f), Vect3(2.0f, 1.0f, 34.0f)));
+}
+
+/**
+ * @brief Solid base and top of a chunk, as the vertex buffer takes them for
+ * occluders and occludees.
+ */
+static
+void _testMeasureChunk() {
+    mem::BlockPool pool;
+    pool.init(sizeof(game::Block) * CHUNK_VOLUME, 1);
+
+    game::Chunk chunk;
+    chunk.init(pool);
+
+    u32 solidHeight, topHeight;
+    OcclusionCuller::measureChunk(chunk, solidHeight, topHeight);
+    CHECK(solidHeight == 0);
+    CHECK(topHeight == 0);
+
+    for (u32 z = 0; z < CHUNK_SIZE; ++z)
+        for (u32 y = 0; y < 3; ++y)
+            for (u32 x = 0; x < CHUNK_SIZE; ++x)
+                chunk.setBlock(x, y, z, game::MaterialType::Stone);
+    for (u32 y = 3; y < 11; ++y)
+        chunk.setBlock(4, y, 7, game::MaterialType::Stone);
+
+    OcclusionCuller::measureChunk(chunk, solidHeight, topHeight);
+    CHECK(solidHeight == 3);
+    CHECK(topHeight == 11);
+
+    // A hole in the base lowers it for the whole chunk
+    chunk.setBlock(9, 1, 2, game::MaterialType::Air);
+    OcclusionCuller::measureChunk(chunk, solidHeight, topHeight);
+    CHECK(solidHeight == 1);
+    CHECK(topHeight == 11);
+
+    chunk.destroy(pool);
+    pool.destroy();
+}
+
+int main() {
+    s_culler.init();
+
+    _testEmpty();
+    _testWall();
+    _testCombined();
+    _testGround();
+    _testMeasureChunk();
+    return test::conclude("occlusion");
+}
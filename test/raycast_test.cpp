@@ -0,0 +1,215 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   raycast_test.cpp                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/07/07 19:41:08 by etran             #+#    #+#             */
+/*   Updated: 2024/07/07 22:31:09 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "world.h"
+#include "job_system.h"
+#include "counter_rng.h"
+#include "check.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+using namespace game;
+using Ray = VoxelRaycaster::Ray;
+using Hit = VoxelRaycaster::Hit;
+
+static World    s_world;
+
+static constexpr std::array<i32, 3> AREA = { WORLD_BLOCK_SIZE, WORLD_BLOCK_HEIGHT, WORLD_BLOCK_SIZE };
+
+/**
+ * @brief Reference: plain DDA over every block, no skipping.
+ */
+static
+Hit _castNaive(const Ray& ray) {
+    constexpr f32 INF = std::numeric_limits<f32>::infinity();
+    constexpr std::array<BlockFace, 3> ENTERED_FORWARD = { BlockFace::Left, BlockFace::Bottom, BlockFace::Back };
+    constexpr std::array<BlockFace, 3> ENTERED_BACKWARD = { BlockFace::Right, BlockFace::Top, BlockFace::Front };
+
+    const f32 length = math::norm(ray.m_direction);
+    const std::array<f32, 3> origin = { ray.m_origin.x, ray.m_origin.y, ray.m_origin.z };
+    const std::array<f32, 3> direction = { ray.m_direction.x / length, ray.m_direction.y / length, ray.m_direction.z / length };
+
+    // Clip the ray to the world box
+    f32 t = 0.0f;
+    f32 end = ray.m_maxDistance;
+    i32 axis = -1;
+    for (u32 i = 0; i < 3; ++i) {
+        if (direction[i] == 0.0f) {
+            if (origin[i] < 0.0f || origin[i] >= AREA[i])
+                return Hit{};
+            continue;
+        }
+        const f32 near = std::min(-origin[i] / direction[i], (AREA[i] - origin[i]) / direction[i]);
+        const f32 far = std::max(-origin[i] / direction[i], (AREA[i] - origin[i]) / direction[i]);
+        if (near > t) {
+            t = near;
+            axis = i;
+        }
+        end = std::min(end, far);
+    }
+    if (t > end)
+        return Hit{};
+
+    std::array<i32, 3> block, step;
+    std::array<f32, 3> next, delta;
+    for (u32 i = 0; i < 3; ++i) {
+        step[i] = direction[i] > 0.0f ? 1 : direction[i] < 0.0f ? -1 : 0;
+        delta[i] = step[i] ? std::abs(1.0f / direction[i]) : INF;
+        block[i] = std::clamp((i32)std::floor(origin[i] + direction[i] * t), 0, AREA[i] - 1);
+        next[i] = step[i] ? std::max(t, (block[i] + (step[i] > 0) - origin[i]) / direction[i]) : INF;
+    }
+
+    while (t <= end) {
+        for (u32 i = 0; i < 3; ++i) {
+            if (block[i] < 0 || block[i] >= AREA[i])
+                return Hit{};
+        }
+
+        const Block& current = s_world.getBlock(block[0], block[1], block[2]);
+        if (!current.isVoid()) {
+            Hit hit{};
+            hit.m_hit = true;
+            hit.m_x = block[0];
+            hit.m_y = block[1];
+            hit.m_z = block[2];
+            hit.m_material = current.getMaterial();
+            if (axis >= 0) {
+                hit.m_face = step[axis] > 0 ? ENTERED_FORWARD[axis] : ENTERED_BACKWARD[axis];
+                hit.m_distance = t;
+            }
+            return hit;
+        }
+
+        axis = next[0] < next[1] ? (next[0] < next[2] ? 0 : 2) : (next[1] < next[2] ? 1 : 2);
+        t = next[axis];
+        block[axis] += step[axis];
+        next[axis] += delta[axis];
+    }
+    return Hit{};
+}
+
+static
+bool _isSameHit(const Hit& a, const Hit& b) noexcept {
+    if (a.m_hit != b.m_hit)
+        return false;
+    return !a.m_hit || (a.m_x == b.m_x && a.m_y == b.m_y && a.m_z == b.m_z && a.m_face == b.m_face);
+}
+
+/**
+ * @brief Same hit, or two blocks met at the same distance: a ray grazing a
+ * block edge enters both within float precision.
+ */
+static
+bool _isEquivalentHit(const Hit& a, const Hit& b) noexcept {
+    constexpr f32 EDGE_EPSILON = 1e-4f;
+
+    if (_isSameHit(a, b))
+        return true;
+    return a.m_hit && b.m_hit && std::abs(a.m_distance - b.m_distance) < EDGE_EPSILON;
+}
+
+/**
+ * @brief Rays from above, grazing, from outside the world and along the
+ * grid axes and diagonals.
+ */
+static
+std::vector<Ray> _generateRays(const u32 count) {
+    proc::CounterRng rng(3);
+    std::vector<Ray> rays(count);
+
+    for (u32 i = 0; i < count; ++i) {
+        Ray& ray = rays[i];
+        const f32 x = rng.nextFloat(0.0f, AREA[0]);
+        const f32 y = rng.nextFloat(0.0f, AREA[1]);
+        const f32 z = rng.nextFloat(0.0f, AREA[2]);
+
+        switch (i % 4) {
+            case 0:
+                ray.m_origin = math::Vect3(x, AREA[1] + rng.nextFloat(0.0f, 10.0f), z);
+                ray.m_direction = math::Vect3(rng.nextFloat(-0.5f, 0.5f), -rng.nextFloat(0.01f, 1.0f), rng.nextFloat(-0.5f, 0.5f));
+                break;
+            case 1:
+                ray.m_origin = math::Vect3(x, y, z);
+                ray.m_direction = math::Vect3(rng.nextFloat(-0.5f, 0.5f), rng.nextFloat(-0.1f, 0.1f), rng.nextFloat(-0.5f, 0.5f));
+                break;
+            case 2:
+                ray.m_origin = math::Vect3(x * 1.2f - 20.0f, y * 2.0f - 5.0f, z * 1.2f - 20.0f);
+                ray.m_direction = math::Vect3(rng.nextFloat(-0.5f, 0.5f), rng.nextFloat(-0.5f, 0.5f), rng.nextFloat(-0.5f, 0.5f));
+                break;
+            default:
+                // Off the block corners: crossing several planes at once has
+                // no single right answer
+                ray.m_origin = math::Vect3(std::floor(x) + 0.2f, std::floor(y) + 0.5f, std::floor(z) + 0.9f);
+                do {
+                    ray.m_direction = math::Vect3((f32)rng.nextBelow(3) - 1.0f, (f32)rng.nextBelow(3) - 1.0f, (f32)rng.nextBelow(3) - 1.0f);
+                } while (ray.m_direction.x == 0.0f && ray.m_direction.y == 0.0f && ray.m_direction.z == 0.0f);
+        }
+        ray.m_maxDistance = 400.0f;
+    }
+    return rays;
+}
+
+static
+void _testAgainstNaive() {
+    const std::vector<Ray> rays = _generateRays(100000);
+    std::vector<Hit> hits(rays.size());
+    s_world.getRaycaster().cast(rays, hits);
+
+    u32 mismatches = 0;
+    u32 hitCount = 0;
+    for (u32 i = 0; i < rays.size(); ++i) {
+        hitCount += hits[i].m_hit;
+        mismatches += !_isEquivalentHit(hits[i], _castNaive(rays[i]));
+        // Batched and single casts agree
+        mismatches += !_isSameHit(hits[i], s_world.getRaycaster().cast(rays[i]));
+    }
+    CHECK(mismatches == 0);
+    CHECK(hitCount > rays.size() / 4);
+}
+
+/**
+ * @brief Blocks placed in empty bricks and removed again are seen at once.
+ */
+static
+void _testEdits() {
+    const Ray ray = { math::Vect3(100.5f, AREA[1] - 0.5f, 100.5f), math::Vect3(0.0f, -1.0f, 0.0f), 400.0f };
+    const Hit ground = s_world.getRaycaster().cast(ray);
+    CHECK(ground.m_hit && ground.m_y < AREA[1] - 2);
+
+    s_world.setBlock(100, AREA[1] - 2, 100, MaterialType::Stone);
+    const Hit placed = s_world.getRaycaster().cast(ray);
+    CHECK(placed.m_hit && placed.m_y == AREA[1] - 2 && placed.m_face == BlockFace::Top);
+
+    s_world.setBlock(100, AREA[1] - 2, 100, MaterialType::Air);
+    CHECK(_isSameHit(s_world.getRaycaster().cast(ray), ground));
+
+    s_world.setBlock(ground.m_x, ground.m_y, ground.m_z, MaterialType::Air);
+    const Hit dug = s_world.getRaycaster().cast(ray);
+    CHECK(!dug.m_hit || dug.m_y < ground.m_y);
+    CHECK(_isSameHit(dug, _castNaive(ray)));
+}
+
+int main() {
+    jobs::JobSystem::init();
+    s_world.init(42);
+
+    _testAgainstNaive();
+    _testEdits();
+
+    s_world.destroy();
+    jobs::JobSystem::destroy();
+    return test::conclude("raycast");
+}
@@ -0,0 +1,173 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   rng_test.cpp                                       :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/07/07 18:40:12 by etran             #+#    #+#             */
+/*   Updated: 2024/07/07 18:40:12 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "counter_rng.h"
+#include "check.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+using proc::CounterRng;
+using proc::RngStream;
+
+// Bounds sit about 5 standard deviations away from the expected values: a
+// failure is a bug, not bad luck.
+
+static
+f64 _chiSquare(const std::vector<u64>& buckets, const u64 samples) {
+    const f64 expected = (f64)samples / buckets.size();
+
+    f64 chi = 0.0;
+    for (const u64 count: buckets)
+        chi += (count - expected) * (count - expected) / expected;
+    return chi;
+}
+
+/**
+ * @brief Top bytes fall evenly in 256 buckets, whatever the key.
+ */
+static
+void _testByteDistribution() {
+    constexpr u64 SAMPLES = 1 << 22;
+
+    for (CounterRng rng: { CounterRng(42), CounterRng(42, 1, 0, 0), CounterRng(0, 0, 0, 0, RngStream::SsaoKernel) }) {
+        std::vector<u64> buckets(256);
+        for (u64 i = 0; i < SAMPLES; ++i)
+            ++buckets[rng.next() >> 56];
+
+        const f64 chi = _chiSquare(buckets, SAMPLES); // 255 degrees of freedom
+        CHECK(chi > 150.0 && chi < 370.0);
+    }
+}
+
+/**
+ * @brief Half the bits set, and neighboring chunk keys or counters sharing
+ * half their bits only.
+ */
+static
+void _testAvalanche() {
+    f64 bitsSet = 0.0;
+    f64 keyDistance = 0.0;
+    u32 count = 0;
+    for (i64 x = 0; x < 256; ++x) {
+        for (i64 z = 0; z < 256; ++z, ++count) {
+            const u64 value = CounterRng(7, x, 0, z).at(0);
+            bitsSet += std::popcount(value);
+            keyDistance += std::popcount(value ^ CounterRng(7, x + 1, 0, z).at(0));
+        }
+    }
+    CHECK(std::abs(bitsSet / count - 32.0) < 0.1);
+    CHECK(std::abs(keyDistance / count - 32.0) < 0.1);
+
+    constexpr u64 SAMPLES = 1000000;
+    const CounterRng rng(9);
+    f64 counterDistance = 0.0;
+    for (u64 i = 0; i < SAMPLES; ++i)
+        counterDistance += std::popcount(rng.at(i) ^ rng.at(i + 1));
+    CHECK(std::abs(counterDistance / SAMPLES - 32.0) < 0.05);
+}
+
+static
+void _testFloats() {
+    constexpr u64 SAMPLES = 10000000;
+
+    CounterRng rng(3);
+    f64 sum = 0.0;
+    f64 squares = 0.0;
+    bool inRange = true;
+    for (u64 i = 0; i < SAMPLES; ++i) {
+        const f64 value = rng.nextFloat();
+        inRange = inRange && value >= 0.0 && value < 1.0;
+        sum += value;
+        squares += value * value;
+    }
+    const f64 mean = sum / SAMPLES;
+    CHECK(inRange);
+    CHECK(std::abs(mean - 0.5) < 0.001);
+    CHECK(std::abs(squares / SAMPLES - mean * mean - 1.0 / 12.0) < 0.001);
+}
+
+static
+void _testBelow() {
+    constexpr u64 SAMPLES = 10000000;
+
+    CounterRng rng(3);
+    std::vector<u64> buckets(10);
+    for (u64 i = 0; i < SAMPLES; ++i) {
+        const u32 value = rng.nextBelow(10);
+        if (value < buckets.size())
+            ++buckets[value];
+    }
+    CHECK(std::accumulate(buckets.begin(), buckets.end(), 0ULL) == SAMPLES);
+    CHECK(_chiSquare(buckets, SAMPLES) < 30.0); // 9 degrees of freedom
+}
+
+/**
+ * @brief Consecutive values are not correlated.
+ */
+static
+void _testSerialCorrelation() {
+    constexpr u64 SAMPLES = 10000000;
+
+    CounterRng rng(11);
+    f64 previous = rng.nextFloat();
+    f64 products = 0.0;
+    f64 sum = 0.0;
+    f64 squares = 0.0;
+    for (u64 i = 0; i < SAMPLES; ++i) {
+        const f64 value = rng.nextFloat();
+        products += previous * value;
+        sum += value;
+        squares += value * value;
+        previous = value;
+    }
+    const f64 mean = sum / SAMPLES;
+    const f64 correlation = (products / SAMPLES - mean * mean) / (squares / SAMPLES - mean * mean);
+    CHECK(std::abs(correlation) < 0.002);
+}
+
+/**
+ * @brief Values drawn in any order match the serial sequence, and streams
+ * of the same position differ.
+ */
+static
+void _testOrderIndependence() {
+    static_assert(CounterRng(1, 2, 3, 4).at(5) == CounterRng(1, 2, 3, 4).at(5));
+
+    CounterRng rng(5, 10, 0, -3);
+    std::array<u64, 1000> serial;
+    for (u64& value: serial)
+        value = rng.next();
+
+    bool same = true;
+    for (u64 i = serial.size(); i-- > 0;)
+        same = same && rng.at(i) == serial[i];
+    CHECK(same);
+
+    rng.seek(500);
+    CHECK(rng.next() == serial[500]);
+    CHECK(CounterRng(5, 10, 0, -3, RngStream::Decoration).at(0) != serial[0]);
+}
+
+int main() {
+    _testByteDistribution();
+    _testAvalanche();
+    _testFloats();
+    _testBelow();
+    _testSerialCorrelation();
+    _testOrderIndependence();
+    return test::conclude("rng");
+}
@@ -0,0 +1,131 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   simulation_test.cpp                                :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/07/07 20:26:15 by etran             #+#    #+#             */
+/*   Updated: 2024/07/07 22:31:09 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "world.h"
+#include "job_system.h"
+#include "controller.h"
+#include "check.h"
+
+#include <memory>
+#include <vector>
+
+using namespace game;
+
+static constexpr i32    FLOOR_HEIGHT = 3;
+static constexpr i32    CENTER = WORLD_BLOCK_SIZE / 2;
+static constexpr u32    MAX_TICKS = 2000;
+
+/**
+ * @brief Flat stone floor, a walled basin with a water tank on one side and
+ * a sand pile falling on the other.
+ */
+static
+std::unique_ptr<World> _createScene() {
+    std::unique_ptr<World> world = std::make_unique<World>();
+    world->init(42);
+
+    world->fillBlocks({ CENTER - 32, 0, CENTER - 32 }, { CENTER + 32, FLOOR_HEIGHT, CENTER + 32 }, MaterialType::Stone);
+    world->fillBlocks({ CENTER - 32, FLOOR_HEIGHT, CENTER - 32 }, { CENTER + 32, WORLD_BLOCK_HEIGHT, CENTER + 32 }, MaterialType::Air);
+    world->getLight().compute();
+
+    std::vector<BlockEdit> edits;
+    for (i32 i = CENTER - 24; i <= CENTER + 24; ++i) {
+        for (i32 y = FLOOR_HEIGHT; y < FLOOR_HEIGHT + 2; ++y) {
+            edits.push_back({ i, y, CENTER - 24, MaterialType::Stone });
+            edits.push_back({ i, y, CENTER + 24, MaterialType::Stone });
+            edits.push_back({ CENTER - 24, y, i, MaterialType::Stone });
+            edits.push_back({ CENTER + 24, y, i, MaterialType::Stone });
+        }
+    }
+    for (i32 z = CENTER - 4; z < CENTER + 4; ++z) {
+        for (i32 y = WORLD_BLOCK_HEIGHT - 6; y < WORLD_BLOCK_HEIGHT; ++y) {
+            for (i32 x = CENTER - 16; x < CENTER - 8; ++x)
+                edits.push_back({ x, y, z, MaterialType::Water });
+            for (i32 x = CENTER + 8; x < CENTER + 16; ++x)
+                edits.push_back({ x, y, z, MaterialType::Sand });
+        }
+    }
+    world->applyEdits(edits);
+    return world;
+}
+
+/**
+ * @return Ticks run, MAX_TICKS if the scene never came to rest.
+ */
+static
+u32 _settle(World& world) {
+    ui::Camera camera{};
+    u32 ticks = 0;
+    for (; ticks < MAX_TICKS && world.getSimulation().getActiveCount() != 0; ++ticks)
+        world.update(camera, (ticks + 1) * BlockSimulation::TICK_DURATION);
+    return ticks;
+}
+
+static
+std::vector<MaterialType> _snapshot(const World& world) {
+    std::vector<MaterialType> materials;
+    for (i32 z = CENTER - 32; z < CENTER + 32; ++z) {
+        for (i32 y = 0; y < WORLD_BLOCK_HEIGHT; ++y) {
+            for (i32 x = CENTER - 32; x < CENTER + 32; ++x)
+                materials.push_back(world.getBlock(x, y, z).getMaterial());
+        }
+    }
+    return materials;
+}
+
+/**
+ * @brief Blocks are moved, never created or lost, and sand ends up resting
+ * on something.
+ */
+static
+void _testRest(const World& world, const std::vector<MaterialType>& materials) {
+    u32 sand = 0;
+    u32 water = 0;
+    u32 floating = 0;
+    for (const MaterialType material: materials) {
+        sand += material == MaterialType::Sand;
+        water += material == MaterialType::Water;
+    }
+    for (i32 z = CENTER - 32; z < CENTER + 32; ++z) {
+        for (i32 y = 1; y < WORLD_BLOCK_HEIGHT; ++y) {
+            for (i32 x = CENTER - 32; x < CENTER + 32; ++x) {
+                floating += world.getBlock(x, y, z).getMaterial() == MaterialType::Sand
+                    && world.getBlock(x, y - 1, z).getMaterial() == MaterialType::Air;
+            }
+        }
+    }
+    CHECK(sand == 8 * 8 * 6);
+    CHECK(water == 8 * 8 * 6);
+    CHECK(floating == 0);
+}
+
+int main() {
+    std::vector<MaterialType> reference;
+
+    // Same world whatever the amount of threads
+    for (const u32 workerCount: { 1U, 3U }) {
+        jobs::JobSystem::init(workerCount);
+        std::unique_ptr<World> world = _createScene();
+
+        CHECK(_settle(*world) < MAX_TICKS);
+        const std::vector<MaterialType> materials = _snapshot(*world);
+        _testRest(*world, materials);
+        if (reference.empty())
+            reference = materials;
+        else
+            CHECK(materials == reference);
+
+        world->destroy();
+        jobs::JobSystem::destroy();
+    }
+    return test::conclude("simulation");
+}
@@ -0,0 +1,249 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   visibility_test.cpp                                :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: etran <etran@student.42.fr>                +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2024/07/07 23:11:48 by etran             #+#    #+#             */
+/*   Updated: 2024/07/07 23:11:48 by etran            ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "chunk_visibility.h"
+#include "chunk.h"
+#include "block_pool.h"
+#include "check.h"
+
+#include <vector>
+
+using vox::gfx::ChunkVisibility;
+using game::MaterialType;
+
+enum Face: u32 {
+    Left = 0,
+    Right,
+    Front,
+    Back,
+    Top,
+    Bottom
+};
+
+/**
+ * @brief A small area of chunks, edited by block ranges.
+ */
+class Area {
+public:
+    static constexpr u32    WIDTH = 5;
+    static constexpr u32    HEIGHT = 3;
+    static constexpr u32    DEPTH = 5;
+    static constexpr u32    COUNT = WIDTH * HEIGHT * DEPTH;
+
+    Area() {
+        m_pool.init(sizeof(game::Block) * CHUNK_VOLUME, COUNT);
+        m_chunks.resize(COUNT);
+        for (game::Chunk& chunk: m_chunks)
+            chunk.init(m_pool);
+        m_visibility.init(WIDTH, HEIGHT, DEPTH);
+    }
+
+    ~Area() {
+        for (game::Chunk& chunk: m_chunks)
+            chunk.destroy(m_pool);
+        m_pool.destroy();
+    }
+
+    /**
+     * @brief Sets the blocks of [min, max), in blocks.
+     */
+    void fill(
+        const u32 minX, const u32 minY, const u32 minZ,
+        const u32 maxX, const u32 maxY, const u32 maxZ,
+        const MaterialType material
+    ) {
+        for (u32 z = minZ; z < maxZ; ++z)
+            for (u32 y = minY; y < maxY; ++y)
+                for (u32 x = minX; x < maxX; ++x)
+                    getChunk(x / CHUNK_SIZE, y / CHUNK_HEIGHT, z / CHUNK_SIZE)
+                        .setBlock(x % CHUNK_SIZE, y % CHUNK_HEIGHT, z % CHUNK_SIZE, material);
+    }
+
+    void fillAll(const MaterialType material) {
+        fill(0, 0, 0, WIDTH * CHUNK_SIZE, HEIGHT * CHUNK_HEIGHT, DEPTH * CHUNK_SIZE, material);
+    }
+
+    void update(const f32 x, const f32 y, const f32 z) {
+        for (u32 i = 0; i < COUNT; ++i)
+            m_visibility.build(i, m_chunks[i]);
+        m_visibility.update(math::Vect3(x, y, z));
+    }
+
+    bool isReachable(const u32 x, const u32 y, const u32 z) const noexcept {
+        return m_visibility.isReachable(getIndex(x, y, z));
+    }
+
+    u32 countReachable() const noexcept {
+        u32 count = 0;
+        for (u32 i = 0; i < COUNT; ++i)
+            count += m_visibility.isReachable(i);
+        return count;
+    }
+
+    game::Chunk& getChunk(const u32 x, const u32 y, const u32 z) noexcept {
+        return m_chunks[getIndex(x, y, z)];
+    }
+
+    static u32 getIndex(const u32 x, const u32 y, const u32 z) noexcept {
+        return (z * WIDTH + x) * HEIGHT + y;
+    }
+
+private:
+    mem::BlockPool              m_pool;
+    std::vector<game::Chunk>    m_chunks;
+    ChunkVisibility             m_visibility;
+};
+
+/**
+ * @brief Center of a chunk, in blocks.
+ */
+static constexpr f32 _center(const u32 chunk, const u32 size) noexcept {
+    return chunk * size + size / 2.0f;
+}
+
+/**
+ * @brief Nothing in the way: everything is reachable.
+ */
+static
+void _testOpen() {
+    Area area;
+    CHECK(area.countReachable() == Area::COUNT);
+
+    area.update(_center(2, CHUNK_SIZE), _center(1, CHUNK_HEIGHT), _center(2, CHUNK_SIZE));
+    CHECK(area.countReachable() == Area::COUNT);
+
+    const ChunkVisibility::Connectivity open = ChunkVisibility::computeConnectivity(area.getChunk(0, 0, 0));
+    for (u32 from = 0; from < ChunkVisibility::FACE_COUNT; ++from)
+        for (u32 to = 0; to < ChunkVisibility::FACE_COUNT; ++to)
+            CHECK(open.connects(from, to));
+}
+
+/**
+ * @brief The camera in rock sees its own chunk and the ones right next to it,
+ * nothing farther.
+ */
+static
+void _testInsideRock() {
+    Area area;
+    area.fillAll(MaterialType::Stone);
+    area.update(_center(2, CHUNK_SIZE), _center(1, CHUNK_HEIGHT), _center(2, CHUNK_SIZE));
+
+    CHECK(area.countReachable() == 7);
+    CHECK(area.isReachable(2, 1, 2));
+    CHECK(area.isReachable(1, 1, 2));
+    CHECK(area.isReachable(3, 1, 2));
+    CHECK(area.isReachable(2, 0, 2));
+    CHECK(area.isReachable(2, 2, 2));
+    CHECK(area.isReachable(2, 1, 1));
+    CHECK(area.isReachable(2, 1, 3));
+    CHECK(!area.isReachable(0, 0, 0));
+    CHECK(!area.isReachable(4, 1, 2));
+
+    const ChunkVisibility::Connectivity solid = ChunkVisibility::computeConnectivity(area.getChunk(0, 0, 0));
+    for (u32 from = 0; from < ChunkVisibility::FACE_COUNT; ++from)
+        for (u32 to = 0; to < ChunkVisibility::FACE_COUNT; ++to)
+            CHECK(!solid.connects(from, to));
+}
+
+/**
+ * @brief A pocket of air touching no face connects nothing, and is not seen
+ * from another pocket of the rock nor from above the ground.
+ */
+static
+void _testSealedCave() {
+    Area area;
+    area.fillAll(MaterialType::Stone);
+
+    // Sealed cave inside chunk (3, 0, 3)
+    area.fill(
+        3 * CHUNK_SIZE + 2, 2, 3 * CHUNK_SIZE + 2,
+        4 * CHUNK_SIZE - 2, CHUNK_HEIGHT - 2, 4 * CHUNK_SIZE - 2,
+        MaterialType::Air);
+    const ChunkVisibility::Connectivity cave = ChunkVisibility::computeConnectivity(area.getChunk(3, 0, 3));
+    for (u32 from = 0; from < ChunkVisibility::FACE_COUNT; ++from)
+        for (u32 to = 0; to < ChunkVisibility::FACE_COUNT; ++to)
+            CHECK(!cave.connects(from, to));
+
+    // Camera in another sealed pocket
+    area.fill(
+        CHUNK_SIZE + 4, 4, CHUNK_SIZE + 4,
+        CHUNK_SIZE + 8, 8, CHUNK_SIZE + 8,
+        MaterialType::Air);
+    area.update(CHUNK_SIZE + 6.0f, 6.0f, CHUNK_SIZE + 6.0f);
+    CHECK(area.isReachable(1, 0, 1));
+    CHECK(!area.isReachable(3, 0, 3));
+    CHECK(area.countReachable() == 6);
+
+    // Open sky over two layers of rock: the surface chunks are drawn, the
+    // cave below them is not
+    area.fill(0, 2 * CHUNK_HEIGHT, 0, Area::WIDTH * CHUNK_SIZE, 3 * CHUNK_HEIGHT, Area::DEPTH * CHUNK_SIZE, MaterialType::Air);
+    area.update(_center(2, CHUNK_SIZE), 3.0f * CHUNK_HEIGHT + 20.0f, _center(2, CHUNK_SIZE));
+    for (u32 z = 0; z < Area::DEPTH; ++z) {
+        for (u32 x = 0; x < Area::WIDTH; ++x) {
+            CHECK(area.isReachable(x, 2, z));
+            CHECK(area.isReachable(x, 1, z));
+        }
+    }
+    CHECK(!area.isReachable(3, 0, 3));
+}
+
+/**
+ * @brief A tunnel through the rock is followed across chunks, around a bend,
+ * but not when it turns back towards the camera.
+ */
+static
+void _testTunnel() {
+    constexpr u32 LOW = CHUNK_HEIGHT + 6;
+    constexpr u32 HIGH = CHUNK_HEIGHT + 10;
+    constexpr u32 NEAR = 2 * CHUNK_SIZE + 6;
+    constexpr u32 FAR = 2 * CHUNK_SIZE + 10;
+
+    Area area;
+    area.fillAll(MaterialType::Stone);
+
+    // Along +x from chunk (0, 1, 2) to chunk (3, 1, 2)
+    area.fill(0, LOW, NEAR, 3 * CHUNK_SIZE + 10, HIGH, FAR, MaterialType::Air);
+
+    const ChunkVisibility::Connectivity straight = ChunkVisibility::computeConnectivity(area.getChunk(1, 1, 2));
+    CHECK(straight.connects(Face::Left, Face::Right));
+    CHECK(straight.connects(Face::Right, Face::Left));
+    CHECK(!straight.connects(Face::Left, Face::Top));
+    CHECK(!straight.connects(Face::Left, Face::Front));
+
+    area.update(4.0f, _center(1, CHUNK_HEIGHT), _center(2, CHUNK_SIZE));
+    for (u32 x = 0; x < 4; ++x)
+        CHECK(area.isReachable(x, 1, 2));
+    for (u32 x = 1; x < Area::WIDTH; ++x) {
+        CHECK(!area.isReachable(x, 1, 1));
+        CHECK(!area.isReachable(x, 0, 2));
+        CHECK(!area.isReachable(x, 2, 2));
+    }
+    // The chunk the tunnel ends in is entered, not the one past it
+    CHECK(!area.isReachable(4, 1, 2));
+
+    // Then along +z into chunk (3, 1, 4), and back along -x into (2, 1, 4)
+    area.fill(3 * CHUNK_SIZE + 6, LOW, NEAR, 3 * CHUNK_SIZE + 10, HIGH, 4 * CHUNK_SIZE + 10, MaterialType::Air);
+    area.fill(2 * CHUNK_SIZE + 6, LOW, 4 * CHUNK_SIZE + 6, 3 * CHUNK_SIZE + 10, HIGH, 4 * CHUNK_SIZE + 10, MaterialType::Air);
+    area.update(4.0f, _center(1, CHUNK_HEIGHT), _center(2, CHUNK_SIZE));
+
+    CHECK(area.isReachable(3, 1, 3));
+    CHECK(area.isReachable(3, 1, 4));
+    CHECK(!area.isReachable(2, 1, 4));
+}
+
+int main() {
+    _testOpen();
+    _testInsideRock();
+    _testSealedCave();
+    _testTunnel();
+    return test::conclude("visibility");
+}